@@ -0,0 +1,155 @@
+/*
+ Copyright (C) 2010 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../../test/src/Catch2.h"
+#include "BenchmarkUtils.h"
+#include "bvh.h"
+#include "octree.h"
+
+#include "vm/bbox.h"
+#include "vm/ray.h"
+#include "vm/vec.h"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace tb
+{
+namespace
+{
+
+constexpr size_t NumBoxes = 100'000;
+constexpr size_t NumRays = 10'000;
+
+/**
+ * Creates boxes of brush-like sizes that are distributed over a map of 16k units with a
+ * density similar to that of a detailed map.
+ */
+std::vector<vm::bbox3d> makeBoxes(std::mt19937& rng)
+{
+  auto coord = std::uniform_int_distribution<int>{-256, 255};
+  auto extent = std::uniform_int_distribution<int>{1, 16};
+
+  auto result = std::vector<vm::bbox3d>{};
+  result.reserve(NumBoxes);
+  for (size_t i = 0; i < NumBoxes; ++i)
+  {
+    const auto min = vm::vec3i{coord(rng), coord(rng), coord(rng)};
+    const auto max = min + vm::vec3i{extent(rng), extent(rng), extent(rng)};
+    result.emplace_back(vm::vec3d{min} * 32.0, vm::vec3d{max} * 32.0);
+  }
+  return result;
+}
+
+std::vector<vm::ray3d> makeRays(std::mt19937& rng)
+{
+  auto coord = std::uniform_real_distribution<double>{-8192.0, 8192.0};
+
+  auto result = std::vector<vm::ray3d>{};
+  result.reserve(NumRays);
+  for (size_t i = 0; i < NumRays; ++i)
+  {
+    const auto origin = vm::vec3d{coord(rng), coord(rng), coord(rng)};
+    const auto target = vm::vec3d{coord(rng), coord(rng), coord(rng)};
+    result.emplace_back(origin, vm::normalize(target - origin));
+  }
+  return result;
+}
+
+template <typename Tree>
+void benchmarkTree(
+  Tree& tree,
+  const std::string& name,
+  const std::vector<vm::bbox3d>& boxes,
+  const std::vector<vm::ray3d>& rays)
+{
+  timeLambda(
+    [&]() {
+      for (size_t i = 0; i < boxes.size(); ++i)
+      {
+        tree.insert(boxes[i], i);
+      }
+    },
+    fmt::format("insert {} boxes into {}", boxes.size(), name));
+
+  auto numHits = size_t(0);
+  timeLambda(
+    [&]() {
+      auto hits = std::vector<size_t>{};
+      for (const auto& ray : rays)
+      {
+        hits.clear();
+        tree.find_intersectors(ray, std::back_inserter(hits));
+        numHits += hits.size();
+      }
+    },
+    fmt::format("find intersectors of {} rays in {}", rays.size(), name));
+  printf("found %zu candidates in %s\n", numHits, name.c_str());
+
+  timeLambda(
+    [&]() {
+      for (size_t i = 0; i < boxes.size(); i += 10)
+      {
+        tree.update(boxes[i].translate(vm::vec3d{16, 16, 16}), i);
+      }
+    },
+    fmt::format("update {} boxes in {}", boxes.size() / 10, name));
+}
+
+} // namespace
+
+TEST_CASE("NodeTreeBenchmark.findIntersectors")
+{
+  auto rng = std::mt19937{0};
+  const auto boxes = makeBoxes(rng);
+  const auto rays = makeRays(rng);
+
+  auto octreeTree = octree<double, size_t>{256.0};
+  benchmarkTree(octreeTree, "octree", boxes, rays);
+
+  auto bvhTree = bvh<double, size_t>{};
+  benchmarkTree(bvhTree, "bvh", boxes, rays);
+
+  // for a pick, only the closest box that is hit matters
+  auto numClosestHits = size_t(0);
+  timeLambda(
+    [&]() {
+      for (const auto& ray : rays)
+      {
+        auto closest = std::numeric_limits<double>::max();
+        bvhTree.visit_intersectors(ray, [&](const size_t, const double distance) {
+          closest = std::min(closest, distance);
+          return closest;
+        });
+        if (closest < std::numeric_limits<double>::max())
+        {
+          ++numClosestHits;
+        }
+      }
+    },
+    fmt::format("find closest intersectors of {} rays in bvh", rays.size()));
+
+  CHECK(numClosestHits > 0);
+}
+
+} // namespace tb
@@ -0,0 +1,143 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../../test/src/Catch2.h"
+#include "BenchmarkUtils.h"
+#include "Logger.h"
+#include "io/DiskFileSystem.h"
+#include "io/DiskIO.h"
+#include "io/File.h"
+#include "io/MdlLoader.h"
+#include "io/PathMatcher.h"
+#include "io/ReadMipTexture.h"
+#include "io/TraversalMode.h"
+#include "io/WadFileSystem.h"
+#include "mdl/EntityModel.h"
+#include "mdl/Palette.h"
+#include "mdl/Texture.h"
+
+#include "kdl/result.h"
+#include "kdl/task_manager.h"
+
+#include <fmt/format.h>
+
+#include <filesystem>
+#include <memory>
+
+namespace tb::io
+{
+namespace
+{
+
+constexpr size_t NumIterations = 100;
+
+auto loadPalette()
+{
+  const auto palettePath = "fixture/test/palette.lmp";
+  auto fs = DiskFileSystem{std::filesystem::current_path()};
+  auto paletteFile = fs.openFile(palettePath) | kdl::value();
+  return mdl::loadPalette(*paletteFile, palettePath) | kdl::value();
+}
+
+} // namespace
+
+TEST_CASE("ReaderBenchmark.decodeWadTextures")
+{
+  const auto palette = loadPalette();
+
+  const auto wadPath =
+    std::filesystem::current_path() / "fixture/test/io/Wad/cr8_czg.wad";
+  auto wadFS = WadFileSystem{Disk::openFile(wadPath) | kdl::value()};
+  REQUIRE(wadFS.reload().is_success());
+
+  const auto texturePaths =
+    wadFS.find("", TraversalMode::Flat, makeExtensionPathMatcher({".D"}))
+    | kdl::value();
+  REQUIRE(!texturePaths.empty());
+
+  timeLambda(
+    [&]() {
+      for (size_t i = 0; i < NumIterations; ++i)
+      {
+        for (const auto& texturePath : texturePaths)
+        {
+          const auto file = wadFS.openFile(texturePath) | kdl::value();
+          auto reader = file->reader().buffer();
+          CHECK(readIdMipTexture(reader, palette, mdl::TextureMask::Off).is_success());
+        }
+      }
+    },
+    fmt::format(
+      "decode {} WAD textures {} times", texturePaths.size(), NumIterations));
+}
+
+TEST_CASE("ReaderBenchmark.readConcurrently")
+{
+  constexpr auto EntrySize = size_t(4096);
+
+  const auto wadPath =
+    std::filesystem::current_path() / "fixture/test/io/Wad/cr8_czg.wad";
+  auto taskManager = kdl::task_manager{};
+
+  for (const auto memoryMapping : {MemoryMapping::Disabled, MemoryMapping::Enabled})
+  {
+    const auto file = createCFile(wadPath, memoryMapping) | kdl::value();
+    const auto entryCount = file->size() / EntrySize;
+
+    timeLambda(
+      [&]() {
+        for (size_t i = 0; i < NumIterations; ++i)
+        {
+          taskManager.parallel_for(entryCount, [&](const size_t entryIndex) {
+            const auto entry = FileView{file, entryIndex * EntrySize, EntrySize};
+            auto reader = entry.reader();
+            reader.readBytes(EntrySize);
+          });
+        }
+      },
+      fmt::format(
+        "read {} entries of {} concurrently {} times",
+        entryCount,
+        memoryMapping == MemoryMapping::Enabled ? "mapped file" : "file",
+        NumIterations));
+  }
+}
+
+TEST_CASE("ReaderBenchmark.loadMdl")
+{
+  auto logger = NullLogger{};
+  const auto palette = loadPalette();
+
+  const auto mdlPath =
+    std::filesystem::current_path() / "fixture/test/io/Mdl/armor.mdl";
+  const auto mdlFile = Disk::openFile(mdlPath) | kdl::value();
+
+  timeLambda(
+    [&]() {
+      for (size_t i = 0; i < NumIterations; ++i)
+      {
+        auto reader = mdlFile->reader().buffer();
+        auto loader = MdlLoader{"armor", reader, palette};
+        CHECK(loader.load(logger).is_success());
+      }
+    },
+    fmt::format("load MDL {} times", NumIterations));
+}
+
+} // namespace tb::io
@@ -0,0 +1,152 @@
+/*
+ Copyright (C) 2010 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../../test/src/Catch2.h"
+#include "BenchmarkUtils.h"
+#include "mdl/Polyhedron.h"
+#include "mdl/Polyhedron3.h"
+
+#include "kdl/slab_pool.h"
+
+#include "vm/bbox.h"
+#include "vm/plane.h"
+#include "vm/vec.h"
+
+#include <fmt/format.h>
+
+#include <cmath>
+#include <vector>
+
+namespace tb::mdl
+{
+namespace
+{
+
+constexpr size_t NumPolyhedra = 100'000;
+
+std::vector<vm::vec3d> makeCylinderPoints(const size_t numSides)
+{
+  auto result = std::vector<vm::vec3d>{};
+  result.reserve(2 * numSides);
+  for (size_t i = 0; i < numSides; ++i)
+  {
+    const auto angle = vm::Cd::two_pi() * double(i) / double(numSides);
+    const auto x = std::round(64.0 * std::cos(angle));
+    const auto y = std::round(64.0 * std::sin(angle));
+    result.emplace_back(x, y, -32.0);
+    result.emplace_back(x, y, +32.0);
+  }
+  return result;
+}
+
+} // namespace
+
+TEST_CASE("PolyhedronBenchmark.constructCopyClip")
+{
+  const auto points = makeCylinderPoints(16);
+
+  auto polyhedra = std::vector<Polyhedron3>{};
+  polyhedra.reserve(NumPolyhedra);
+
+  timeLambda(
+    [&]() {
+      for (size_t i = 0; i < NumPolyhedra; ++i)
+      {
+        polyhedra.emplace_back(points);
+      }
+    },
+    fmt::format("construct {} polyhedra from {} points", NumPolyhedra, points.size()));
+
+  auto copies = std::vector<Polyhedron3>{};
+  copies.reserve(NumPolyhedra);
+
+  timeLambda(
+    [&]() {
+      for (const auto& polyhedron : polyhedra)
+      {
+        copies.push_back(polyhedron);
+      }
+    },
+    fmt::format("copy {} polyhedra", NumPolyhedra));
+
+  const auto plane = vm::plane3d{8.0, vm::normalize(vm::vec3d{1, 1, 1})};
+  timeLambda(
+    [&]() {
+      for (auto& copy : copies)
+      {
+        copy.clip(plane);
+      }
+    },
+    fmt::format("clip {} polyhedra", NumPolyhedra));
+
+  timeLambda(
+    [&]() {
+      copies.clear();
+      polyhedra.clear();
+    },
+    fmt::format("destroy {} polyhedra", 2 * NumPolyhedra));
+
+  CHECK(copies.empty());
+}
+
+TEST_CASE("PolyhedronBenchmark.allocateVertices")
+{
+  // compares the slab pool to the global allocator for blocks the size of a vertex
+  constexpr auto NumBlocks = size_t(10'000'000);
+  constexpr auto BlockSize = sizeof(Polyhedron3::Vertex);
+  constexpr auto BlockAlign = alignof(Polyhedron3::Vertex);
+
+  using Pool = kdl::slab_pool<BlockSize, BlockAlign>;
+
+  auto blocks = std::vector<void*>(NumBlocks / 10, nullptr);
+
+  timeLambda(
+    [&]() {
+      for (size_t i = 0; i < 10; ++i)
+      {
+        for (auto& block : blocks)
+        {
+          block = ::operator new(BlockSize);
+        }
+        for (auto* block : blocks)
+        {
+          ::operator delete(block);
+        }
+      }
+    },
+    fmt::format("allocate {} blocks with operator new", NumBlocks));
+
+  timeLambda(
+    [&]() {
+      for (size_t i = 0; i < 10; ++i)
+      {
+        for (auto& block : blocks)
+        {
+          block = Pool::allocate();
+        }
+        for (auto* block : blocks)
+        {
+          Pool::deallocate(block);
+        }
+      }
+    },
+    fmt::format("allocate {} blocks with slab_pool", NumBlocks));
+}
+
+} // namespace tb::mdl
@@ -0,0 +1,113 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../../test/src/Catch2.h"
+#include "BenchmarkUtils.h"
+#include "mdl/Resource.h"
+#include "mdl/ResourceManager.h"
+
+#include "kdl/reflection_impl.h"
+
+#include <fmt/format.h>
+
+#include <chrono>
+#include <future>
+#include <memory>
+#include <vector>
+
+namespace tb::mdl
+{
+namespace
+{
+
+constexpr size_t NumResources = 100'000;
+constexpr size_t NumIdleFrames = 1'000;
+
+struct BenchmarkResource
+{
+  void upload(bool) const {}
+  void drop(bool) const {}
+
+  kdl_reflect_inline_empty(BenchmarkResource);
+};
+
+using BenchmarkResourceT = Resource<BenchmarkResource>;
+
+auto runTaskSync(Task task)
+{
+  auto promise = std::promise<std::unique_ptr<TaskResult>>{};
+  promise.set_value(task());
+  return promise.get_future();
+}
+
+} // namespace
+
+TEST_CASE("ResourceManagerBenchmark.process")
+{
+  using namespace std::chrono_literals;
+
+  const auto processContext = ProcessContext{false, [](auto, auto) {}};
+
+  auto resourceManager = ResourceManager{};
+  auto resources = std::vector<std::shared_ptr<BenchmarkResourceT>>{};
+  resources.reserve(NumResources);
+
+  timeLambda(
+    [&]() {
+      for (size_t i = 0; i < NumResources; ++i)
+      {
+        resources.push_back(resourceManager.addResource(
+          std::make_shared<BenchmarkResourceT>([]() {
+            return Result<BenchmarkResource>{BenchmarkResource{}};
+          })));
+      }
+      while (resourceManager.needsProcessing())
+      {
+        resourceManager.process(runTaskSync, processContext);
+      }
+    },
+    fmt::format("load {} resources", NumResources));
+
+  timeLambda(
+    [&]() {
+      for (size_t i = 0; i < NumIdleFrames; ++i)
+      {
+        if (resourceManager.needsProcessing())
+        {
+          resourceManager.process(runTaskSync, processContext, 20ms);
+        }
+      }
+    },
+    fmt::format("{} idle frames with {} resources", NumIdleFrames, NumResources));
+
+  timeLambda(
+    [&]() {
+      for (size_t i = 0; i < NumIdleFrames; ++i)
+      {
+        resources[i * (NumResources / NumIdleFrames)].reset();
+        resourceManager.process(runTaskSync, processContext, 20ms);
+      }
+    },
+    fmt::format(
+      "{} frames that each release one of {} resources", NumIdleFrames, NumResources));
+
+  CHECK(resourceManager.resources().size() == NumResources - NumIdleFrames);
+}
+
+} // namespace tb::mdl
@@ -0,0 +1,101 @@
+/*
+ Copyright (C) 2010 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../../test/src/Catch2.h"
+#include "BenchmarkUtils.h"
+#include "mdl/Brush.h"
+#include "mdl/BrushBuilder.h"
+#include "mdl/MapFormat.h"
+
+#include "kdl/result.h"
+#include "kdl/result_fold.h"
+#include "kdl/task_manager.h"
+
+#include "vm/bbox.h"
+#include "vm/mat.h"
+#include "vm/mat_ext.h"
+
+#include <fmt/format.h>
+
+#include <functional>
+#include <ranges>
+#include <vector>
+
+namespace tb::mdl
+{
+namespace
+{
+
+constexpr size_t NumBrushes = 500'000;
+
+const auto worldBounds = vm::bbox3d{8192.0};
+
+auto makeBrushes()
+{
+  auto builder = BrushBuilder{MapFormat::Standard, worldBounds};
+
+  auto result = std::vector<Brush>{};
+  result.reserve(NumBrushes);
+  for (size_t i = 0; i < NumBrushes; ++i)
+  {
+    result.push_back(builder.createCube(64.0, "material") | kdl::value());
+  }
+  return result;
+}
+
+Result<vm::bbox3d> transformBrush(const Brush& brush, const vm::mat4x4d& transformation)
+{
+  // only return the bounds to keep the memory footprint of the results small
+  auto copy = brush;
+  return copy.transform(worldBounds, transformation, false)
+         | kdl::transform([&]() { return copy.bounds(); });
+}
+
+} // namespace
+
+TEST_CASE("TaskManagerBenchmark.transformBrushes")
+{
+  const auto brushes = makeBrushes();
+  const auto transformation = vm::translation_matrix(vm::vec3d{16, 32, 8});
+
+  auto taskManager = kdl::task_manager{};
+
+  timeLambda(
+    [&]() {
+      auto tasks = brushes | std::views::transform([&](const auto& brush) {
+                     return std::function{
+                       [&]() { return transformBrush(brush, transformation); }};
+                   });
+      CHECK((taskManager.run_tasks_and_wait(tasks) | kdl::fold).is_success());
+    },
+    fmt::format("transform {} brushes with run_tasks_and_wait", brushes.size()));
+
+  timeLambda(
+    [&]() {
+      CHECK(
+        (taskManager.parallel_transform(
+           brushes,
+           [&](const auto& brush) { return transformBrush(brush, transformation); })
+         | kdl::fold)
+          .is_success());
+    },
+    fmt::format("transform {} brushes with parallel_transform", brushes.size()));
+}
+
+} // namespace tb::mdl
@@ -0,0 +1,78 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../../test/src/Catch2.h"
+#include "BenchmarkUtils.h"
+#include "mdl/TextureStatistics.h"
+
+#include <fmt/format.h>
+
+#include <array>
+#include <vector>
+
+namespace tb::mdl
+{
+namespace
+{
+
+constexpr size_t NumIterations = 100;
+
+} // namespace
+
+TEST_CASE("TextureStatisticsBenchmark")
+{
+  auto palette = std::array<unsigned char, 1024>{};
+  for (size_t i = 0; i < palette.size(); ++i)
+  {
+    palette[i] = (i % 4 == 3) ? 0xFF : static_cast<unsigned char>(i * 7);
+  }
+
+  for (const size_t size : {64, 128, 256, 512, 1024})
+  {
+    const auto pixelCount = size * size;
+
+    auto indices = std::vector<unsigned char>(pixelCount);
+    for (size_t i = 0; i < pixelCount; ++i)
+    {
+      indices[i] = static_cast<unsigned char>(i * 31 + i / size);
+    }
+    auto pixels = std::vector<unsigned char>(4 * pixelCount);
+
+    timeLambda(
+      [&]() {
+        for (size_t i = 0; i < NumIterations; ++i)
+        {
+          CHECK(expandIndexedPixels(indices, palette, pixels).alphaAnd == 0xFF);
+        }
+      },
+      fmt::format("expand {}x{} indexed pixels {} times", size, size, NumIterations));
+
+    timeLambda(
+      [&]() {
+        for (size_t i = 0; i < NumIterations; ++i)
+        {
+          CHECK(computeTextureStatistics(pixels).alphaAnd == 0xFF);
+        }
+      },
+      fmt::format(
+        "compute statistics of {}x{} pixels {} times", size, size, NumIterations));
+  }
+}
+
+} // namespace tb::mdl
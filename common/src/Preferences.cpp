@@ -183,12 +183,15 @@ Preference<float> Brightness("render/Brightness", 1.4f);
 Preference<float> GridAlpha("render/Grid/Alpha", 0.5f);
 Preference<Color> GridColor2D("Rendere/Grid/Color2D", Color(0.8f, 0.8f, 0.8f, 0.8f));
 
+Preference<float> EntityModelMaxDistance("render/Entity model max distance", 0.0f);
+
 Preference<int> TextureMinFilter("render/Texture mode min filter", 0x2700);
 Preference<int> TextureMagFilter("render/Texture mode mag filter", 0x2600);
 Preference<bool> EnableMSAA("render/Enable multisampling", true);
 
 Preference<bool> AlignmentLock("Editor/Texture lock", true);
 Preference<bool> UVLock("Editor/UV lock", false);
+Preference<bool> CacheMaps("Editor/Cache loaded maps", false);
 
 Preference<std::filesystem::path>& RendererFontPath()
 {
@@ -379,10 +382,12 @@ const std::vector<PreferenceBase*>& staticPreferences()
     &Brightness,
     &GridAlpha,
     &GridColor2D,
+    &EntityModelMaxDistance,
     &TextureMinFilter,
     &TextureMagFilter,
     &AlignmentLock,
     &UVLock,
+    &CacheMaps,
     &RendererFontPath(),
     &RendererFontSize,
     &BrowserFontSize,
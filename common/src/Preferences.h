@@ -127,12 +127,19 @@ extern Preference<float> Brightness;
 extern Preference<float> GridAlpha;
 extern Preference<Color> GridColor2D;
 
+/**
+ * Entity models farther away from the 3D camera than this are not rendered. Disabled if
+ * not positive.
+ */
+extern Preference<float> EntityModelMaxDistance;
+
 extern Preference<int> TextureMinFilter;
 extern Preference<int> TextureMagFilter;
 extern Preference<bool> EnableMSAA;
 
 extern Preference<bool> AlignmentLock;
 extern Preference<bool> UVLock;
+extern Preference<bool> CacheMaps;
 
 Preference<std::filesystem::path>& RendererFontPath();
 extern Preference<int> RendererFontSize;
@@ -0,0 +1,931 @@
+/*
+ Copyright (C) 2010 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Exceptions.h"
+
+#include "vm/bbox.h"
+#include "vm/ray.h"
+#include "vm/scalar.h"
+#include "vm/vec.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <numeric>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace tb
+{
+
+/**
+ * A bounding volume hierarchy that allows for quick ray intersection queries.
+ *
+ * Every node of the hierarchy has up to four children. The bounds of the children are
+ * stored in one array per coordinate, and the nodes are stored in a contiguous array, so
+ * that a ray can be tested against all children of a node at once with loops that the
+ * compiler can vectorize.
+ *
+ * Inserting, removing and updating a data item only refits the bounds of the nodes
+ * along the path from the item to the root. Since this degrades the quality of the
+ * hierarchy over time, it is rebuilt from scratch once the number of such modifications
+ * exceeds the number of items in it.
+ *
+ * @tparam T the floating point type
+ * @tparam U the data to store in the hierarchy
+ */
+template <typename T, typename U>
+class bvh
+{
+private:
+  static constexpr std::size_t width = 4;
+  static constexpr std::size_t min_rebuild_threshold = 64;
+  static constexpr auto no_node = std::numeric_limits<std::uint32_t>::max();
+
+  /**
+   * A reference to a child of a node, which is either another node or an item. Items
+   * are stored as the bitwise complement of their index.
+   */
+  using child_ref = std::int32_t;
+
+  static child_ref node_ref(const std::uint32_t node_index)
+  {
+    return child_ref(node_index);
+  }
+
+  static child_ref item_ref(const std::uint32_t item_index)
+  {
+    return ~child_ref(item_index);
+  }
+
+  static bool is_item(const child_ref ref) { return ref < 0; }
+
+  static std::uint32_t node_index(const child_ref ref)
+  {
+    assert(!is_item(ref));
+    return std::uint32_t(ref);
+  }
+
+  static std::uint32_t item_index(const child_ref ref)
+  {
+    assert(is_item(ref));
+    return std::uint32_t(~ref);
+  }
+
+  struct node
+  {
+    std::array<T, width> min_x{};
+    std::array<T, width> min_y{};
+    std::array<T, width> min_z{};
+    std::array<T, width> max_x{};
+    std::array<T, width> max_y{};
+    std::array<T, width> max_z{};
+    std::array<child_ref, width> children{};
+    std::uint32_t count = 0;
+    std::uint32_t parent = no_node;
+    std::uint32_t parent_slot = 0;
+
+    vm::bbox<T, 3> bounds(const std::size_t slot) const
+    {
+      return {
+        {min_x[slot], min_y[slot], min_z[slot]},
+        {max_x[slot], max_y[slot], max_z[slot]}};
+    }
+
+    vm::bbox<T, 3> bounds() const
+    {
+      assert(count > 0);
+      auto result = bounds(0);
+      for (std::size_t i = 1; i < count; ++i)
+      {
+        result = vm::merge(result, bounds(i));
+      }
+      return result;
+    }
+
+    void set_bounds(const std::size_t slot, const vm::bbox<T, 3>& bounds)
+    {
+      min_x[slot] = bounds.min.x();
+      min_y[slot] = bounds.min.y();
+      min_z[slot] = bounds.min.z();
+      max_x[slot] = bounds.max.x();
+      max_y[slot] = bounds.max.y();
+      max_z[slot] = bounds.max.z();
+    }
+  };
+
+  struct item
+  {
+    vm::bbox<T, 3> bounds;
+    U data;
+    std::uint32_t node = no_node;
+    std::uint32_t slot = 0;
+  };
+
+  /**
+   * The ray in the form used by the slab test. Zero direction components are replaced by
+   * tiny values so that the test never computes 0 * inf.
+   */
+  struct ray_data
+  {
+    std::array<T, 3> origin;
+    std::array<T, 3> inv_direction;
+
+    explicit ray_data(const vm::ray<T, 3>& ray)
+    {
+      for (std::size_t i = 0; i < 3; ++i)
+      {
+        const auto d = ray.direction[i];
+        origin[i] = ray.origin[i];
+        inv_direction[i] = std::abs(d) >= std::numeric_limits<T>::min()
+                             ? T(1) / d
+                             : std::copysign(std::numeric_limits<T>::max(), d);
+      }
+    }
+  };
+
+  std::vector<node> m_nodes;
+  std::vector<std::uint32_t> m_free_nodes;
+  std::vector<item> m_items;
+  std::unordered_map<U, std::uint32_t> m_item_index_for_data;
+  std::uint32_t m_root = no_node;
+  std::size_t m_modifications = 0;
+
+public:
+  /**
+   * Indicates whether the given data exists in this hierarchy.
+   *
+   * @param data the data to find
+   * @return true if the given data exists and false otherwise
+   */
+  bool contains(const U& data) const { return m_item_index_for_data.count(data) > 0; }
+
+  /**
+   * Inserts the given data with the given bounds.
+   *
+   * @throws NodeTreeException if the bounds are invalid or the data is already contained
+   * in this hierarchy
+   */
+  void insert(const vm::bbox<T, 3>& bounds, U data)
+  {
+    check(bounds);
+
+    if (contains(data))
+    {
+      throw NodeTreeException("Data already in tree");
+    }
+
+    const auto index = std::uint32_t(m_items.size());
+    m_item_index_for_data.emplace(data, index);
+    m_items.push_back(item{bounds, std::move(data)});
+
+    if (m_root == no_node)
+    {
+      m_root = allocate_node();
+      add_child(m_root, bounds, item_ref(index));
+    }
+    else
+    {
+      insert_item(index);
+    }
+
+    did_modify();
+  }
+
+  /**
+   * Removes the given data from this hierarchy.
+   *
+   * @param data the data to remove
+   * @return true if the given data was removed, and false otherwise
+   */
+  bool remove(const U& data)
+  {
+    const auto i_index = m_item_index_for_data.find(data);
+    if (i_index == m_item_index_for_data.end())
+    {
+      return false;
+    }
+
+    const auto index = i_index->second;
+    m_item_index_for_data.erase(i_index);
+
+    if (m_items.size() == 1)
+    {
+      clear();
+      return true;
+    }
+
+    remove_child(m_items[index].node, m_items[index].slot);
+
+    const auto last = std::uint32_t(m_items.size() - 1);
+    if (index != last)
+    {
+      auto& moved = m_items[index];
+      moved = std::move(m_items[last]);
+      m_nodes[moved.node].children[moved.slot] = item_ref(index);
+      m_item_index_for_data[moved.data] = index;
+    }
+    m_items.pop_back();
+
+    did_modify();
+    return true;
+  }
+
+  /**
+   * Updates the bounds of the given data. Only the bounds of the nodes on the path from
+   * the data to the root are recomputed.
+   *
+   * @param new_bounds the new bounds of the data
+   * @param data the data to update
+   *
+   * @throws NodeTreeException if the given data cannot be found in this hierarchy
+   */
+  void update(const vm::bbox<T, 3>& new_bounds, const U& data)
+  {
+    check(new_bounds);
+
+    const auto i_index = m_item_index_for_data.find(data);
+    if (i_index == m_item_index_for_data.end())
+    {
+      throw NodeTreeException("node not found");
+    }
+
+    auto& updated = m_items[i_index->second];
+    updated.bounds = new_bounds;
+    m_nodes[updated.node].set_bounds(updated.slot, new_bounds);
+    refit(updated.node);
+
+    did_modify();
+  }
+
+  /**
+   * Clears this hierarchy.
+   */
+  void clear()
+  {
+    m_nodes.clear();
+    m_free_nodes.clear();
+    m_items.clear();
+    m_item_index_for_data.clear();
+    m_root = no_node;
+    m_modifications = 0;
+  }
+
+  /**
+   * Indicates whether this hierarchy is empty.
+   *
+   * @return true if this hierarchy is empty and false otherwise
+   */
+  bool empty() const { return m_items.empty(); }
+
+  /**
+   * Rebuilds this hierarchy from scratch.
+   */
+  void rebuild()
+  {
+    m_nodes.clear();
+    m_free_nodes.clear();
+    m_root = no_node;
+    m_modifications = 0;
+
+    if (!m_items.empty())
+    {
+      auto indices = std::vector<std::uint32_t>(m_items.size());
+      std::iota(indices.begin(), indices.end(), 0u);
+
+      m_nodes.reserve(m_items.size() / (width - 1) + 1);
+      m_root = allocate_node();
+      build_node(m_root, indices.begin(), indices.end());
+    }
+  }
+
+  /**
+   * Finds every data item in this hierarchy whose bounding box intersects with the given
+   * ray and returns a list of those items, ordered roughly by their distance from the
+   * ray origin.
+   *
+   * @param ray the ray to test
+   * @return a list containing all found data items
+   */
+  std::vector<U> find_intersectors(const vm::ray<T, 3>& ray) const
+  {
+    auto result = std::vector<U>{};
+    find_intersectors(ray, std::back_inserter(result));
+    return result;
+  }
+
+  /**
+   * Finds every data item in this hierarchy whose bounding box intersects with the given
+   * ray and appends it to the given output iterator.
+   *
+   * @tparam O the output iterator type
+   * @param ray the ray to test
+   * @param out the output iterator to append to
+   */
+  template <typename O>
+  void find_intersectors(const vm::ray<T, 3>& ray, O out) const
+  {
+    visit_intersectors(ray, [&](const U& data, const T) {
+      *out++ = data;
+      return std::numeric_limits<T>::max();
+    });
+  }
+
+  /**
+   * Visits every data item in this hierarchy whose bounding box intersects with the given
+   * ray within the given maximum distance.
+   *
+   * The children of every node are visited in the order of the distances at which the
+   * ray enters their bounds. The visitor is passed the data item and the distance to its
+   * bounding box, and returns the new maximum distance. Items and subtrees whose bounds
+   * the ray enters beyond the maximum distance are skipped, so returning the distance to
+   * the closest hit found so far stops the traversal early.
+   *
+   * @tparam F the visitor type, must be callable with (const U&, T) and return T
+   * @param ray the ray to test
+   * @param visitor the visitor to call
+   * @param max_distance the initial maximum distance
+   */
+  template <typename F>
+  void visit_intersectors(
+    const vm::ray<T, 3>& ray,
+    const F& visitor,
+    T max_distance = std::numeric_limits<T>::max()) const
+  {
+    if (m_root == no_node)
+    {
+      return;
+    }
+
+    const auto r = ray_data{ray};
+
+    auto stack = std::vector<std::pair<child_ref, T>>{};
+    stack.reserve(64);
+    stack.emplace_back(node_ref(m_root), T(0));
+
+    while (!stack.empty())
+    {
+      const auto [ref, distance] = stack.back();
+      stack.pop_back();
+
+      if (distance > max_distance)
+      {
+        continue;
+      }
+
+      if (is_item(ref))
+      {
+        max_distance = visitor(m_items[item_index(ref)].data, distance);
+        continue;
+      }
+
+      const auto& n = m_nodes[node_index(ref)];
+
+      auto entry = std::array<T, width>{};
+      auto exit = std::array<T, width>{};
+      intersect(n, r, max_distance, entry, exit);
+
+      // push the hit children so that the closest one is popped first
+      const auto first = stack.size();
+      for (std::size_t i = 0; i < n.count; ++i)
+      {
+        if (entry[i] <= exit[i])
+        {
+          auto j = stack.size();
+          stack.emplace_back(n.children[i], entry[i]);
+          while (j > first && stack[j - 1].second < stack[j].second)
+          {
+            std::swap(stack[j - 1], stack[j]);
+            --j;
+          }
+        }
+      }
+    }
+  }
+
+  /**
+   * Finds every data item in this hierarchy whose bounding box intersects with the given
+   * bbox and returns a list of those items.
+   *
+   * @param bbox the bbox to test
+   * @return a list containing all found data items
+   */
+  std::vector<U> find_intersectors(const vm::bbox<T, 3>& bbox) const
+  {
+    auto result = std::vector<U>{};
+    find_intersectors(bbox, std::back_inserter(result));
+    return result;
+  }
+
+  /**
+   * Finds every data item in this hierarchy whose bounding box intersects with the given
+   * bbox and appends it to the given output iterator.
+   *
+   * @tparam O the output iterator type
+   * @param bbox the bbox to test
+   * @param out the output iterator to append to
+   */
+  template <typename O>
+  void find_intersectors(const vm::bbox<T, 3>& bbox, O out) const
+  {
+    visit_if(
+      [&](const node& n, const std::size_t i) {
+        return n.min_x[i] <= bbox.max.x() && n.max_x[i] >= bbox.min.x()
+               && n.min_y[i] <= bbox.max.y() && n.max_y[i] >= bbox.min.y()
+               && n.min_z[i] <= bbox.max.z() && n.max_z[i] >= bbox.min.z();
+      },
+      out);
+  }
+
+  /**
+   * Finds every data item in this hierarchy whose bounding box contains the given point
+   * and returns a list of those items.
+   *
+   * @param point the point to test
+   * @return a list containing all found data items
+   */
+  std::vector<U> find_containers(const vm::vec<T, 3>& point) const
+  {
+    auto result = std::vector<U>{};
+    find_containers(point, std::back_inserter(result));
+    return result;
+  }
+
+  /**
+   * Finds every data item in this hierarchy whose bounding box contains the given point
+   * and appends it to the given output iterator.
+   *
+   * @tparam O the output iterator type
+   * @param point the point to test
+   * @param out the output iterator to append to
+   */
+  template <typename O>
+  void find_containers(const vm::vec<T, 3>& point, O out) const
+  {
+    visit_if(
+      [&](const node& n, const std::size_t i) {
+        return n.min_x[i] <= point.x() && n.max_x[i] >= point.x()
+               && n.min_y[i] <= point.y() && n.max_y[i] >= point.y()
+               && n.min_z[i] <= point.z() && n.max_z[i] >= point.z();
+      },
+      out);
+  }
+
+  /**
+   * Finds every data item in this hierarchy whose bounding box satisfies the given
+   * predicate and returns a list of those items.
+   *
+   * @tparam P the predicate type, must be callable with (const vm::bbox<T, 3>&)
+   * @param predicate the predicate to test
+   * @return a list containing all found data items
+   */
+  template <typename P>
+  std::vector<U> find_if(const P& predicate) const
+  {
+    auto result = std::vector<U>{};
+    find_if(predicate, std::back_inserter(result));
+    return result;
+  }
+
+  /**
+   * Finds every data item in this hierarchy whose bounding box satisfies the given
+   * predicate and appends it to the given output iterator.
+   *
+   * The predicate is also tested against the bounds of the inner nodes, and the subtree
+   * of a node is skipped if its bounds don't satisfy it. Therefore, if the predicate
+   * accepts a bounding box, it must also accept every bounding box that contains it.
+   *
+   * @tparam P the predicate type, must be callable with (const vm::bbox<T, 3>&)
+   * @tparam O the output iterator type
+   * @param predicate the predicate to test
+   * @param out the output iterator to append to
+   */
+  template <typename P, typename O>
+  void find_if(const P& predicate, O out) const
+  {
+    visit_if(
+      [&](const node& n, const std::size_t i) { return predicate(n.bounds(i)); }, out);
+  }
+
+private:
+  void check(const vm::bbox<T, 3>& bounds) const
+  {
+    if (vm::is_nan(bounds.min) || vm::is_nan(bounds.max))
+    {
+      throw NodeTreeException("Cannot add node to bvh with invalid bounds");
+    }
+  }
+
+  /**
+   * Computes the distances at which the given ray enters and exits the bounds of all
+   * children of the given node. A child is hit if the entry distance is not greater than
+   * the exit distance. Does not branch on the number of children so that the loop can be
+   * vectorized, the caller must ignore the results for the unused slots.
+   */
+  static void intersect(
+    const node& n,
+    const ray_data& r,
+    const T max_distance,
+    std::array<T, width>& entry,
+    std::array<T, width>& exit)
+  {
+    for (std::size_t i = 0; i < width; ++i)
+    {
+      const auto x1 = (n.min_x[i] - r.origin[0]) * r.inv_direction[0];
+      const auto x2 = (n.max_x[i] - r.origin[0]) * r.inv_direction[0];
+      const auto y1 = (n.min_y[i] - r.origin[1]) * r.inv_direction[1];
+      const auto y2 = (n.max_y[i] - r.origin[1]) * r.inv_direction[1];
+      const auto z1 = (n.min_z[i] - r.origin[2]) * r.inv_direction[2];
+      const auto z2 = (n.max_z[i] - r.origin[2]) * r.inv_direction[2];
+
+      entry[i] = std::max(
+        std::max(std::min(x1, x2), std::min(y1, y2)), std::max(std::min(z1, z2), T(0)));
+      exit[i] = std::min(
+        std::min(std::max(x1, x2), std::max(y1, y2)),
+        std::min(std::max(z1, z2), max_distance));
+    }
+  }
+
+  template <typename P, typename O>
+  void visit_if(const P& predicate, O out) const
+  {
+    if (m_root == no_node)
+    {
+      return;
+    }
+
+    auto stack = std::vector<std::uint32_t>{m_root};
+    while (!stack.empty())
+    {
+      const auto& n = m_nodes[stack.back()];
+      stack.pop_back();
+
+      for (std::size_t i = 0; i < n.count; ++i)
+      {
+        if (predicate(n, i))
+        {
+          if (is_item(n.children[i]))
+          {
+            *out++ = m_items[item_index(n.children[i])].data;
+          }
+          else
+          {
+            stack.push_back(node_index(n.children[i]));
+          }
+        }
+      }
+    }
+  }
+
+  std::uint32_t allocate_node()
+  {
+    if (!m_free_nodes.empty())
+    {
+      const auto index = m_free_nodes.back();
+      m_free_nodes.pop_back();
+      m_nodes[index] = node{};
+      return index;
+    }
+
+    m_nodes.emplace_back();
+    return std::uint32_t(m_nodes.size() - 1);
+  }
+
+  void free_node(const std::uint32_t index) { m_free_nodes.push_back(index); }
+
+  /**
+   * Updates the parent reference of the child in the given slot of the given node.
+   */
+  void link_child(const std::uint32_t node_index_, const std::uint32_t slot)
+  {
+    const auto ref = m_nodes[node_index_].children[slot];
+    if (is_item(ref))
+    {
+      auto& i = m_items[item_index(ref)];
+      i.node = node_index_;
+      i.slot = slot;
+    }
+    else
+    {
+      auto& n = m_nodes[node_index(ref)];
+      n.parent = node_index_;
+      n.parent_slot = slot;
+    }
+  }
+
+  void add_child(
+    const std::uint32_t node_index_, const vm::bbox<T, 3>& bounds, const child_ref ref)
+  {
+    auto& n = m_nodes[node_index_];
+    assert(n.count < width);
+
+    const auto slot = n.count++;
+    n.set_bounds(slot, bounds);
+    n.children[slot] = ref;
+    link_child(node_index_, slot);
+  }
+
+  void remove_child(const std::uint32_t node_index_, const std::uint32_t slot)
+  {
+    auto& n = m_nodes[node_index_];
+    assert(slot < n.count);
+
+    const auto last = n.count - 1;
+    if (slot != last)
+    {
+      n.set_bounds(slot, n.bounds(last));
+      n.children[slot] = n.children[last];
+      link_child(node_index_, slot);
+    }
+    --n.count;
+
+    if (n.parent == no_node)
+    {
+      if (n.count == 1 && !is_item(n.children[0]))
+      {
+        // the only child of the root becomes the new root
+        m_root = node_index(n.children[0]);
+        m_nodes[m_root].parent = no_node;
+        free_node(node_index_);
+      }
+    }
+    else if (n.count == 0)
+    {
+      free_node(node_index_);
+      remove_child(n.parent, n.parent_slot);
+    }
+    else if (n.count == 1)
+    {
+      // replace this node by its only child
+      auto& parent = m_nodes[n.parent];
+      parent.set_bounds(n.parent_slot, n.bounds(0));
+      parent.children[n.parent_slot] = n.children[0];
+      link_child(n.parent, n.parent_slot);
+      free_node(node_index_);
+      refit(n.parent);
+    }
+    else
+    {
+      refit(node_index_);
+    }
+  }
+
+  /**
+   * Recomputes the bounds of the ancestors of the given node until they don't change
+   * anymore.
+   */
+  void refit(std::uint32_t node_index_)
+  {
+    while (m_nodes[node_index_].parent != no_node)
+    {
+      const auto& n = m_nodes[node_index_];
+      auto& parent = m_nodes[n.parent];
+
+      const auto bounds = n.bounds();
+      if (bounds == parent.bounds(n.parent_slot))
+      {
+        break;
+      }
+
+      parent.set_bounds(n.parent_slot, bounds);
+      node_index_ = n.parent;
+    }
+  }
+
+  static T surface_area(const vm::bbox<T, 3>& bounds)
+  {
+    const auto size = bounds.size();
+    return size.x() * size.y() + size.y() * size.z() + size.z() * size.x();
+  }
+
+  /**
+   * Inserts the given item into the child whose surface area increases the least, or
+   * into the first node on the way that has a free slot.
+   */
+  void insert_item(const std::uint32_t index)
+  {
+    const auto bounds = m_items[index].bounds;
+
+    auto current = m_root;
+    while (m_nodes[current].count == width)
+    {
+      const auto& n = m_nodes[current];
+
+      auto best_slot = std::size_t(0);
+      auto best_cost = std::numeric_limits<T>::max();
+      for (std::size_t i = 0; i < width; ++i)
+      {
+        const auto child_bounds = n.bounds(i);
+        const auto area = surface_area(child_bounds);
+        const auto cost = surface_area(vm::merge(child_bounds, bounds)) - area;
+        if (cost < best_cost)
+        {
+          best_slot = i;
+          best_cost = cost;
+        }
+      }
+
+      const auto best_child = n.children[best_slot];
+      if (is_item(best_child))
+      {
+        // replace the item by a new node that contains it and the new item
+        const auto new_node = allocate_node();
+        const auto other = item_index(best_child);
+        m_nodes[current].children[best_slot] = node_ref(new_node);
+        link_child(current, std::uint32_t(best_slot));
+        add_child(new_node, m_items[other].bounds, item_ref(other));
+        add_child(new_node, bounds, item_ref(index));
+        m_nodes[current].set_bounds(best_slot, m_nodes[new_node].bounds());
+        refit(current);
+        return;
+      }
+
+      current = node_index(best_child);
+    }
+
+    add_child(current, bounds, item_ref(index));
+    refit(current);
+  }
+
+  void did_modify()
+  {
+    if (++m_modifications > std::max(m_items.size(), min_rebuild_threshold))
+    {
+      rebuild();
+    }
+  }
+
+  using index_iterator = std::vector<std::uint32_t>::iterator;
+
+  /**
+   * Splits the given items into two non-empty groups using the surface area heuristic.
+   * The candidate split positions are the boundaries of a fixed number of equally sized
+   * bins along the axis in which the centers of the items are spread the most. Falls
+   * back to splitting at the median center if the centers cannot be separated.
+   */
+  index_iterator split(const index_iterator first, const index_iterator last) const
+  {
+    static constexpr std::size_t bin_count = 16;
+
+    const auto center = [&](const auto index) {
+      return m_items[index].bounds.min + m_items[index].bounds.max;
+    };
+
+    auto center_bounds = vm::bbox<T, 3>{center(*first), center(*first)};
+    for (auto it = first; it != last; ++it)
+    {
+      center_bounds = vm::merge(center_bounds, center(*it));
+    }
+
+    const auto axis = vm::find_abs_max_component(center_bounds.size());
+    const auto offset = center_bounds.min[axis];
+    const auto extent = center_bounds.max[axis] - offset;
+
+    if (extent > T(0))
+    {
+      const auto bin = [&](const auto index) {
+        const auto b =
+          std::size_t((center(index)[axis] - offset) / extent * T(bin_count));
+        return std::min(b, bin_count - 1);
+      };
+
+      auto bin_bounds = std::array<vm::bbox<T, 3>, bin_count>{};
+      auto bin_sizes = std::array<std::size_t, bin_count>{};
+      for (auto it = first; it != last; ++it)
+      {
+        const auto b = bin(*it);
+        const auto& bounds = m_items[*it].bounds;
+        bin_bounds[b] = bin_sizes[b]++ == 0 ? bounds : vm::merge(bin_bounds[b], bounds);
+      }
+
+      // the cost of the items in bins [i, bin_count), where i > 0
+      auto right_costs = std::array<T, bin_count>{};
+      auto right_bounds = std::optional<vm::bbox<T, 3>>{};
+      auto right_size = std::size_t(0);
+      for (auto i = bin_count - 1; i > 0; --i)
+      {
+        if (bin_sizes[i] > 0)
+        {
+          right_bounds =
+            right_bounds ? vm::merge(*right_bounds, bin_bounds[i]) : bin_bounds[i];
+          right_size += bin_sizes[i];
+        }
+        right_costs[i] =
+          right_bounds ? surface_area(*right_bounds) * T(right_size) : T(0);
+      }
+
+      auto best_bin = std::optional<std::size_t>{};
+      auto best_cost = std::numeric_limits<T>::max();
+      auto left_bounds = std::optional<vm::bbox<T, 3>>{};
+      auto left_size = std::size_t(0);
+      for (std::size_t i = 0; i < bin_count - 1; ++i)
+      {
+        if (bin_sizes[i] > 0)
+        {
+          left_bounds =
+            left_bounds ? vm::merge(*left_bounds, bin_bounds[i]) : bin_bounds[i];
+          left_size += bin_sizes[i];
+        }
+
+        const auto right_size_i = std::size_t(last - first) - left_size;
+        if (left_size > 0 && right_size_i > 0)
+        {
+          const auto cost =
+            surface_area(*left_bounds) * T(left_size) + right_costs[i + 1];
+          if (cost < best_cost)
+          {
+            best_bin = i;
+            best_cost = cost;
+          }
+        }
+      }
+
+      if (best_bin)
+      {
+        return std::partition(
+          first, last, [&](const auto index) { return bin(index) <= *best_bin; });
+      }
+    }
+
+    const auto mid = first + (last - first) / 2;
+    std::nth_element(first, mid, last, [&](const auto lhs, const auto rhs) {
+      return center(lhs)[axis] < center(rhs)[axis];
+    });
+    return mid;
+  }
+
+  /**
+   * Distributes the given items among the children of the given node by splitting the
+   * largest group of items until there are as many groups as a node has children.
+   */
+  void build_node(
+    const std::uint32_t node_index_,
+    const index_iterator first,
+    const index_iterator last)
+  {
+    auto groups = std::array<std::pair<index_iterator, index_iterator>, width>{};
+    auto group_count = std::size_t(1);
+    groups[0] = {first, last};
+
+    while (group_count < width)
+    {
+      const auto i_largest = std::max_element(
+        groups.begin(),
+        groups.begin() + std::ptrdiff_t(group_count),
+        [](const auto& lhs, const auto& rhs) {
+          return lhs.second - lhs.first < rhs.second - rhs.first;
+        });
+
+      const auto [g_first, g_last] = *i_largest;
+      if (g_last - g_first < 2)
+      {
+        break;
+      }
+
+      const auto g_mid = split(g_first, g_last);
+      *i_largest = {g_first, g_mid};
+      groups[group_count++] = {g_mid, g_last};
+    }
+
+    for (std::size_t i = 0; i < group_count; ++i)
+    {
+      const auto [g_first, g_last] = groups[i];
+      if (g_last - g_first == 1)
+      {
+        add_child(node_index_, m_items[*g_first].bounds, item_ref(*g_first));
+      }
+      else
+      {
+        const auto child = allocate_node();
+        build_node(child, g_first, g_last);
+        add_child(node_index_, m_nodes[child].bounds(), node_ref(child));
+      }
+    }
+  }
+};
+
+} // namespace tb
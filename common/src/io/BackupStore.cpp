@@ -0,0 +1,297 @@
+/*
+ Copyright (C) 2010 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BackupStore.h"
+
+#include "io/DiskIO.h"
+#include "io/PathInfo.h"
+#include "io/TraversalMode.h"
+
+#include "kdl/path_utils.h"
+#include "kdl/result.h"
+#include "kdl/result_fold.h"
+#include "kdl/vector_utils.h"
+
+#include <fmt/format.h>
+#include <fmt/std.h>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <sstream>
+#include <unordered_set>
+
+namespace tb::io
+{
+namespace
+{
+
+constexpr auto ManifestHeader = std::string_view{"TrenchBroom Backup 1"};
+
+constexpr uint64_t mix(uint64_t x)
+{
+  // the splitmix64 finalizer
+  x = (x ^ (x >> 30)) * uint64_t(0xbf58476d1ce4e5b9);
+  x = (x ^ (x >> 27)) * uint64_t(0x94d049bb133111eb);
+  return x ^ (x >> 31);
+}
+
+constexpr auto GearTable = [] {
+  auto table = std::array<uint64_t, 256>{};
+  auto state = uint64_t(0);
+  for (auto& value : table)
+  {
+    state += uint64_t(0x9e3779b97f4a7c15);
+    value = mix(state);
+  }
+  return table;
+}();
+
+// The gear hash shifts every byte further to the left, so the high bits depend on the
+// most bytes. Testing 14 bits places a boundary every 16 KiB on average.
+constexpr auto BoundaryMask = uint64_t(0x3fff) << 50;
+
+size_t nextChunkSize(const std::string_view data)
+{
+  if (data.size() <= MinChunkSize)
+  {
+    return data.size();
+  }
+
+  const auto end = std::min(data.size(), MaxChunkSize);
+  auto hash = uint64_t(0);
+  for (auto i = MinChunkSize; i < end; ++i)
+  {
+    hash = (hash << 1) + GearTable[uint8_t(data[i])];
+    if ((hash & BoundaryMask) == 0)
+    {
+      return i + 1;
+    }
+  }
+  return end;
+}
+
+std::string hashChunk(const std::string_view chunk)
+{
+  // two 64 bit hashes with different constants, so that chunks are only confused if both
+  // collide
+  constexpr auto Prime1 = uint64_t(0x100000001b3);
+  constexpr auto Prime2 = uint64_t(0x9fb21c651e98df25);
+  auto hash1 = uint64_t(0xcbf29ce484222325) ^ uint64_t(chunk.size());
+  auto hash2 = uint64_t(0x84222325cbf29ce4) + uint64_t(chunk.size());
+
+  for (size_t i = 0; i < chunk.size(); i += sizeof(uint64_t))
+  {
+    auto word = uint64_t(0);
+    std::memcpy(&word, chunk.data() + i, std::min(sizeof(uint64_t), chunk.size() - i));
+    hash1 = std::rotl((hash1 ^ word) * Prime1, 31);
+    hash2 = std::rotl((hash2 ^ word) * Prime2, 27) + hash1;
+  }
+
+  return fmt::format("{:016x}{:016x}", mix(hash1), mix(hash2));
+}
+
+struct ChunkRef
+{
+  std::string hash;
+  size_t size;
+};
+
+Result<std::string> readFile(const std::filesystem::path& path)
+{
+  return Disk::withInputStream(path, std::ios::in | std::ios::binary, [](auto& stream) {
+    return std::string{
+      std::istreambuf_iterator<char>{stream}, std::istreambuf_iterator<char>{}};
+  });
+}
+
+Result<void> writeFile(
+  const std::filesystem::path& path,
+  const std::ios::openmode mode,
+  const std::string_view contents)
+{
+  return Disk::withOutputStream(path, mode, [&](auto& stream) {
+    stream.write(contents.data(), std::streamsize(contents.size()));
+    return stream ? Result<void>{}
+                  : Result<void>{Error{fmt::format("Failed to write {}", path)}};
+  });
+}
+
+/**
+ * Writes to a temporary file first so that a file is never left incomplete. An
+ * incomplete chunk would otherwise be mistaken for a complete one by a later backup.
+ */
+Result<void> writeFileAtomic(
+  const std::filesystem::path& path, const std::string_view contents)
+{
+  const auto tmpPath = kdl::path_add_extension(path, ".tmp");
+  return writeFile(tmpPath, std::ios::out | std::ios::binary, contents)
+         | kdl::and_then([&]() { return Disk::moveFile(tmpPath, path); });
+}
+
+Result<std::vector<ChunkRef>> readManifest(const std::filesystem::path& manifestPath)
+{
+  return readFile(manifestPath) | kdl::and_then([&](const auto& contents) {
+           auto stream = std::istringstream{contents};
+           auto line = std::string{};
+           if (!std::getline(stream, line) || line != ManifestHeader)
+           {
+             return Result<std::vector<ChunkRef>>{
+               Error{fmt::format("{} is not a backup manifest", manifestPath)}};
+           }
+
+           auto chunkRefs = std::vector<ChunkRef>{};
+           auto chunkRef = ChunkRef{};
+           while (stream >> chunkRef.hash >> chunkRef.size)
+           {
+             chunkRefs.push_back(chunkRef);
+           }
+           if (!stream.eof())
+           {
+             return Result<std::vector<ChunkRef>>{
+               Error{fmt::format("Backup manifest {} is corrupt", manifestPath)}};
+           }
+           return Result<std::vector<ChunkRef>>{std::move(chunkRefs)};
+         });
+}
+
+} // namespace
+
+std::vector<std::string_view> splitIntoChunks(std::string_view data)
+{
+  auto result = std::vector<std::string_view>{};
+  while (!data.empty())
+  {
+    const auto size = nextChunkSize(data);
+    result.push_back(data.substr(0, size));
+    data.remove_prefix(size);
+  }
+  return result;
+}
+
+BackupStore::BackupStore(std::filesystem::path chunkDirectory)
+  : m_chunkDirectory{std::move(chunkDirectory)}
+{
+}
+
+const std::filesystem::path& BackupStore::chunkDirectory() const
+{
+  return m_chunkDirectory;
+}
+
+Result<size_t> BackupStore::writeBackup(
+  const std::filesystem::path& manifestPath, const std::string_view contents) const
+{
+  return Disk::createDirectory(m_chunkDirectory) | kdl::and_then([&](auto) {
+           auto manifest = std::string{ManifestHeader} + "\n";
+           return kdl::vec_transform(
+                    splitIntoChunks(contents),
+                    [&](const auto chunk) {
+                      const auto hash = hashChunk(chunk);
+                      manifest += fmt::format("{} {}\n", hash, chunk.size());
+
+                      const auto chunkPath = m_chunkDirectory / hash;
+                      return Disk::pathInfo(chunkPath) == PathInfo::File
+                               ? Result<bool>{false}
+                               : writeFileAtomic(chunkPath, chunk)
+                                   | kdl::transform([]() { return true; });
+                    })
+                  | kdl::fold | kdl::and_then([&](const auto& chunksWritten) {
+                      return writeFileAtomic(manifestPath, manifest)
+                             | kdl::transform([&]() {
+                                 return size_t(std::ranges::count(chunksWritten, true));
+                               });
+                    });
+         });
+}
+
+Result<std::string> BackupStore::readBackup(
+  const std::filesystem::path& manifestPath) const
+{
+  return readManifest(manifestPath) | kdl::and_then([&](const auto& chunkRefs) {
+           auto contents = std::string{};
+           for (const auto& chunkRef : chunkRefs)
+           {
+             const auto chunkPath = m_chunkDirectory / chunkRef.hash;
+             auto chunk = readFile(chunkPath);
+             if (chunk.is_error())
+             {
+               return Result<std::string>{
+                 Error{fmt::format("Backup chunk {} is missing", chunkPath)}};
+             }
+             if (chunk.value().size() != chunkRef.size)
+             {
+               return Result<std::string>{
+                 Error{fmt::format("Backup chunk {} is corrupt", chunkPath)}};
+             }
+             contents += chunk.value();
+           }
+           return Result<std::string>{std::move(contents)};
+         });
+}
+
+Result<void> BackupStore::restoreBackup(
+  const std::filesystem::path& manifestPath, const std::filesystem::path& mapPath) const
+{
+  // the map is written in text mode, like a saved map
+  return readBackup(manifestPath) | kdl::and_then([&](const auto& contents) {
+           return writeFile(mapPath, std::ios::out, contents);
+         });
+}
+
+Result<size_t> BackupStore::collectGarbage(
+  const std::vector<std::filesystem::path>& manifestPaths) const
+{
+  if (Disk::pathInfo(m_chunkDirectory) != PathInfo::Directory)
+  {
+    return size_t(0);
+  }
+
+  return kdl::vec_transform(manifestPaths, readManifest) | kdl::fold
+         | kdl::and_then([&](const auto& manifests) {
+             auto referencedChunks = std::unordered_set<std::string>{};
+             for (const auto& chunkRefs : manifests)
+             {
+               for (const auto& chunkRef : chunkRefs)
+               {
+                 referencedChunks.insert(chunkRef.hash);
+               }
+             }
+
+             return Disk::find(m_chunkDirectory, TraversalMode::Flat)
+                    | kdl::and_then([&](auto chunkPaths) {
+                        const auto unreferencedChunkPaths =
+                          kdl::vec_filter(std::move(chunkPaths), [&](const auto& path) {
+                            return !referencedChunks.contains(path.filename().string());
+                          });
+                        return kdl::vec_transform(
+                                 unreferencedChunkPaths,
+                                 [](const auto& path) { return Disk::deleteFile(path); })
+                               | kdl::fold;
+                      })
+                    | kdl::transform([](const auto& deleted) {
+                        return size_t(std::ranges::count(deleted, true));
+                      });
+           });
+}
+
+} // namespace tb::io
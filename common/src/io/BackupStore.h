@@ -0,0 +1,91 @@
+/*
+ Copyright (C) 2010 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Result.h"
+
+#include <cstddef>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace tb::io
+{
+
+/**
+ * Splits the given data into chunks whose boundaries depend only on the data around
+ * them. Inserting or removing data only changes the chunks around the change, all other
+ * chunks stay the same.
+ *
+ * Every chunk except for the last one is at least MinChunkSize bytes long, and no chunk
+ * is longer than MaxChunkSize bytes.
+ */
+std::vector<std::string_view> splitIntoChunks(std::string_view data);
+
+constexpr auto MinChunkSize = size_t(4 * 1024);
+constexpr auto MaxChunkSize = size_t(64 * 1024);
+
+/**
+ * Stores backups as small manifests that reference chunks of their contents. Every chunk
+ * is stored once in the chunk directory under the hash of its contents, so writing a
+ * backup that is similar to an existing one only writes the chunks that changed.
+ *
+ * Chunks are never modified once they are written. Chunks that are no longer referenced
+ * by any backup are removed by collectGarbage.
+ */
+class BackupStore
+{
+private:
+  std::filesystem::path m_chunkDirectory;
+
+public:
+  explicit BackupStore(std::filesystem::path chunkDirectory);
+
+  const std::filesystem::path& chunkDirectory() const;
+
+  /**
+   * Writes the chunks of the given contents that are not yet stored, and then writes a
+   * manifest for the contents to the given path. Returns the number of chunks that were
+   * written.
+   */
+  Result<size_t> writeBackup(
+    const std::filesystem::path& manifestPath, std::string_view contents) const;
+
+  /**
+   * Returns the contents of the backup with the given manifest.
+   */
+  Result<std::string> readBackup(const std::filesystem::path& manifestPath) const;
+
+  /**
+   * Writes the contents of the backup with the given manifest to the given map file.
+   */
+  Result<void> restoreBackup(
+    const std::filesystem::path& manifestPath, const std::filesystem::path& mapPath) const;
+
+  /**
+   * Deletes every chunk that is not referenced by any of the given manifests. Returns the
+   * number of chunks that were deleted.
+   */
+  Result<size_t> collectGarbage(
+    const std::vector<std::filesystem::path>& manifestPaths) const;
+};
+
+} // namespace tb::io
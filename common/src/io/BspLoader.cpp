@@ -35,6 +35,7 @@
 #include "kdl/path_utils.h"
 #include "kdl/result.h"
 #include "kdl/string_format.h"
+#include "kdl/vector_utils.h"
 
 #include <fmt/format.h>
 
@@ -152,23 +153,14 @@ std::vector<MaterialInfo> parseMaterialInfos(Reader reader, const size_t count)
 
 std::vector<vm::vec3f> parseVertices(Reader reader, const size_t vertexCount)
 {
-  auto result = std::vector<vm::vec3f>(vertexCount);
-  for (size_t i = 0; i < vertexCount; ++i)
-  {
-    result[i] = reader.readVec<float, 3>();
-  }
-  return result;
+  return reader.readVecArray<float, 3>(vertexCount);
 }
 
 std::vector<EdgeInfo> parseEdgeInfos(Reader reader, const size_t edgeInfoCount)
 {
-  auto result = std::vector<EdgeInfo>(edgeInfoCount);
-  for (size_t i = 0; i < edgeInfoCount; ++i)
-  {
-    result[i].vertexIndex1 = reader.readSize<uint16_t>();
-    result[i].vertexIndex2 = reader.readSize<uint16_t>();
-  }
-  return result;
+  return kdl::vec_transform(
+    reader.readVecArray<uint16_t, 2, size_t>(edgeInfoCount),
+    [](const auto& edge) { return EdgeInfo{edge[0], edge[1]}; });
 }
 
 std::vector<FaceInfo> parseFaceInfos(Reader reader, const size_t faceInfoCount)
@@ -187,12 +179,7 @@ std::vector<FaceInfo> parseFaceInfos(Reader reader, const size_t faceInfoCount)
 
 std::vector<int> parseFaceEdges(Reader reader, const size_t faceEdgeCount)
 {
-  auto result = std::vector<int>(faceEdgeCount);
-  for (size_t i = 0; i < faceEdgeCount; ++i)
-  {
-    result[i] = reader.readInt<int32_t>();
-  }
-  return result;
+  return reader.readArray<int32_t, int>(faceEdgeCount);
 }
 
 vm::vec2f uvCoords(
@@ -0,0 +1,63 @@
+/*
+ Copyright (C) 2010 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "io/ParserStatus.h"
+
+#include <string>
+#include <vector>
+
+namespace tb::io
+{
+
+/**
+ * Records the messages logged to it and forwards them to another parser status later.
+ *
+ * This allows a part of a file to be parsed on a worker thread while the messages are
+ * still reported to the target status in file order and on the calling thread.
+ */
+class BufferedParserStatus : public ParserStatus
+{
+private:
+  struct Message
+  {
+    LogLevel level;
+    std::string str;
+  };
+
+  std::vector<Message> m_messages;
+
+public:
+  /**
+   * Creates a status that formats its messages like the given target status.
+   */
+  explicit BufferedParserStatus(ParserStatus& target);
+
+  /**
+   * Forwards all recorded messages to the given target and clears them.
+   */
+  void flush(ParserStatus& target);
+
+private:
+  void doProgress(double progress) override;
+  void doLog(LogLevel level, const std::string& str) override;
+};
+
+} // namespace tb::io
@@ -157,7 +157,8 @@ Result<std::vector<std::filesystem::path>> find(
   return result;
 }
 
-Result<std::shared_ptr<CFile>> openFile(const std::filesystem::path& path)
+Result<std::shared_ptr<CFile>> openFile(
+  const std::filesystem::path& path, const MemoryMapping memoryMapping)
 {
   const auto fixedPath = fixPath(path);
   if (pathInfoForFixedPath(fixedPath) != PathInfo::File)
@@ -165,7 +166,7 @@ Result<std::shared_ptr<CFile>> openFile(const std::filesystem::path& path)
     return Error{fmt::format("Failed to open {}: path does not denote a file", path)};
   }
 
-  return createCFile(fixedPath);
+  return createCFile(fixedPath, memoryMapping);
 }
 
 Result<bool> createDirectory(const std::filesystem::path& path)
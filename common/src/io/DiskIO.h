@@ -50,7 +50,9 @@ Result<std::vector<std::filesystem::path>> find(
   const TraversalMode& traversalMode,
   const PathMatcher& pathMatcher = matchAnyPath);
 
-Result<std::shared_ptr<CFile>> openFile(const std::filesystem::path& path);
+Result<std::shared_ptr<CFile>> openFile(
+  const std::filesystem::path& path,
+  MemoryMapping memoryMapping = MemoryMapping::Disabled);
 
 template <typename Stream, typename F>
 auto withStream(
@@ -27,6 +27,10 @@
 #include <cstdio>
 #include <cstring>
 
+#ifndef _WIN32
+#include <sys/mman.h>
+#endif
+
 namespace tb::io
 {
 
@@ -102,17 +106,45 @@ Result<size_t> fileSize(std::FILE* file)
 
   return static_cast<size_t>(size);
 }
+
+/**
+ * Maps the given file into memory. Returns a null mapping if the file cannot be mapped,
+ * in which case it must be read using the C file API.
+ */
+kdl::resource<const char*> mapFile(
+  [[maybe_unused]] std::FILE* file,
+  [[maybe_unused]] const size_t size,
+  [[maybe_unused]] const MemoryMapping memoryMapping)
+{
+#ifndef _WIN32
+  if (memoryMapping == MemoryMapping::Enabled && size > 0)
+  {
+    auto* memory = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fileno(file), 0);
+    if (memory != MAP_FAILED)
+    {
+      return kdl::resource<const char*>{
+        static_cast<const char*>(memory), [=](auto) { munmap(memory, size); }};
+    }
+  }
+#endif
+
+  return kdl::resource<const char*>{nullptr, [](auto) {}};
+}
+
 } // namespace
 
-CFile::CFile(kdl::resource<std::FILE*> file, const size_t size)
+CFile::CFile(
+  kdl::resource<std::FILE*> file, const size_t size, kdl::resource<const char*> memory)
   : m_file{std::move(file)}
   , m_size{size}
+  , m_memory{std::move(memory)}
 {
 }
 
 Reader CFile::reader() const
 {
-  return Reader::from(*this, m_size);
+  return memory() ? Reader::from(memory(), memory() + m_size)
+                  : Reader::from(*this, m_size);
 }
 
 size_t CFile::size() const
@@ -125,8 +157,20 @@ std::FILE* CFile::file() const
   return *m_file;
 }
 
+const char* CFile::memory() const
+{
+  return *m_memory;
+}
+
 std::unique_ptr<OwningBufferFile> CFile::buffer() const
 {
+  if (memory())
+  {
+    auto buffer = std::make_unique<char[]>(size());
+    std::memcpy(buffer.get(), memory(), size());
+    return std::make_unique<OwningBufferFile>(std::move(buffer), size());
+  }
+
   if (std::fseek(file(), 0, SEEK_SET))
   {
     return nullptr;
@@ -185,12 +229,15 @@ Error CFile::makeError(const std::string& msg) const
                             : Error{fmt::format("{}: {}", msg, std::strerror(errno))};
 }
 
-Result<std::shared_ptr<CFile>> createCFile(const std::filesystem::path& path)
+Result<std::shared_ptr<CFile>> createCFile(
+  const std::filesystem::path& path, const MemoryMapping memoryMapping)
 {
-  return openPathAsFILE(path, "rb") | kdl::and_then([](auto file) {
+  return openPathAsFILE(path, "rb") | kdl::and_then([&](auto file) {
            return fileSize(*file) | kdl::transform([&](auto size) {
+                    auto memory = mapFile(*file, size, memoryMapping);
                     // NOLINTNEXTLINE
-                    return std::shared_ptr<CFile>{new CFile{std::move(file), size}};
+                    return std::shared_ptr<CFile>{
+                      new CFile{std::move(file), size, std::move(memory)}};
                   });
          });
 }
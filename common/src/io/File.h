@@ -76,9 +76,26 @@ public:
   size_t size() const override;
 };
 
+/**
+ * Controls whether a physical file is mapped into memory when it is opened.
+ */
+enum class MemoryMapping
+{
+  Enabled,
+  Disabled,
+};
+
 /**
  * A file that is backed by a physical file on the disk. The file is opened in the
  * constructor and closed in the destructor.
+ *
+ * If requested and possible, the file is mapped into memory. The readers of a mapped file
+ * read directly from the mapping and can be used concurrently without locking. Otherwise,
+ * the readers read from the file and share the file position, so every read is guarded by
+ * a mutex.
+ *
+ * Reading from a mapping raises a signal if the file is truncated by another process
+ * while it is mapped, so only archives that are read concurrently should be mapped.
  */
 class CFile : public File
 {
@@ -93,15 +110,18 @@ public:
 private:
   kdl::resource<std::FILE*> m_file;
   size_t m_size;
+  kdl::resource<const char*> m_memory;
   mutable std::mutex m_mutex;
 
   /**
-   * Creates a new file with the given file ptr and size in bytes.
+   * Creates a new file with the given file ptr, size in bytes and memory mapping. The
+   * mapping is null if the file is not mapped into memory.
    */
-  CFile(kdl::resource<std::FILE*> file, size_t size);
+  CFile(kdl::resource<std::FILE*> file, size_t size, kdl::resource<const char*> memory);
 
 public:
-  friend Result<std::shared_ptr<CFile>> createCFile(const std::filesystem::path& path);
+  friend Result<std::shared_ptr<CFile>> createCFile(
+    const std::filesystem::path& path, MemoryMapping memoryMapping);
 
   Reader reader() const override;
   size_t size() const override;
@@ -111,6 +131,11 @@ public:
    */
   std::FILE* file() const;
 
+  /**
+   * Returns the contents of this file if it is mapped into memory, and null otherwise.
+   */
+  const char* memory() const;
+
   std::unique_ptr<OwningBufferFile> buffer() const;
 
 private:
@@ -122,7 +147,9 @@ private:
   Error makeError(const std::string& msg) const;
 };
 
-Result<std::shared_ptr<CFile>> createCFile(const std::filesystem::path& path);
+Result<std::shared_ptr<CFile>> createCFile(
+  const std::filesystem::path& path,
+  MemoryMapping memoryMapping = MemoryMapping::Disabled);
 
 /**
  * A file that is backed by a portion of a physical file.
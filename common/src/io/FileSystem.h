@@ -75,6 +75,11 @@ public:
    */
   Result<std::shared_ptr<File>> openFile(const std::filesystem::path& path) const;
 
+  /** Indicates whether the contents of this file system never change after it was
+   * created. The paths of an immutable file system can be indexed.
+   */
+  virtual bool isImmutable() const;
+
 protected:
   virtual Result<std::vector<std::filesystem::path>> doFind(
     const std::filesystem::path& path, const TraversalMode& traversalMode) const = 0;
@@ -192,6 +192,12 @@ Result<std::filesystem::path> ImageFileSystemBase::makeAbsolute(
   return Result<std::filesystem::path>{"/" / path};
 }
 
+bool ImageFileSystemBase::isImmutable() const
+{
+  // the contents are only read when the file system is created
+  return true;
+}
+
 Result<void> ImageFileSystemBase::reload()
 {
   m_root = ImageDirectoryEntry{{}, {}, {}};
@@ -70,6 +70,8 @@ public:
   Result<std::filesystem::path> makeAbsolute(
     const std::filesystem::path& path) const override;
 
+  bool isImmutable() const override;
+
   /**
    * Reload this file system.
    */
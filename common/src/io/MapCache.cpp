@@ -0,0 +1,665 @@
+/*
+ Copyright (C) 2010 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MapCache.h"
+
+#include "Color.h"
+#include "Ensure.h"
+#include "Error.h" // IWYU pragma: keep
+#include "FileLocation.h"
+#include "io/NodeSerializer.h"
+#include "io/NodeWriter.h"
+#include "io/Reader.h"
+#include "io/ReaderException.h"
+#include "mdl/BezierPatch.h"
+#include "mdl/Brush.h"
+#include "mdl/BrushFace.h"
+#include "mdl/BrushFaceAttributes.h"
+#include "mdl/BrushGeometry.h"
+#include "mdl/BrushNode.h"
+#include "mdl/EntityNode.h"
+#include "mdl/EntityProperties.h"
+#include "mdl/GroupNode.h"
+#include "mdl/LayerNode.h"
+#include "mdl/MapFormat.h"
+#include "mdl/PatchNode.h"
+#include "mdl/WorldNode.h"
+
+#include "kdl/overload.h"
+#include "kdl/result.h"
+#include "kdl/result_fold.h"
+#include "kdl/task_manager.h"
+
+#include "vm/vec.h"
+
+#include <bit>
+#include <cstring>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <variant>
+
+namespace tb::io
+{
+namespace
+{
+
+constexpr auto Magic = uint32_t(0x434d4254); // "TBMC"
+
+/**
+ * Increment this whenever the layout of the cache changes.
+ */
+constexpr auto Version = uint32_t(2);
+
+enum class RecordType : uint8_t
+{
+  BeginEntity,
+  EndEntity,
+  EntityProperty,
+  Brush,
+  Patch,
+  End,
+};
+
+// writing
+
+template <typename T>
+void writeValue(std::string& out, const T& value)
+{
+  static_assert(std::is_trivially_copyable_v<T>);
+  out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T, size_t S>
+void writeVec(std::string& out, const vm::vec<T, S>& vec)
+{
+  for (size_t i = 0; i < S; ++i)
+  {
+    writeValue(out, vec[i]);
+  }
+}
+
+template <typename T>
+void writeOptional(std::string& out, const std::optional<T>& value)
+{
+  writeValue(out, uint8_t(value ? 1 : 0));
+  if (value)
+  {
+    writeValue(out, *value);
+  }
+}
+
+void writeString(std::string& out, const std::string_view str)
+{
+  writeValue(out, uint32_t(str.size()));
+  out.append(str);
+}
+
+void writeBrushFace(
+  std::string& out, const mdl::BrushFace& face, const mdl::MapFormat mapFormat)
+{
+  writeValue(out, uint64_t(face.lineNumber()));
+  writeValue(out, uint64_t(face.lineCount()));
+  for (const auto& point : face.points())
+  {
+    writeVec(out, point);
+  }
+
+  const auto& attributes = face.attributes();
+  writeString(out, attributes.materialName());
+  writeVec(out, attributes.offset());
+  writeVec(out, attributes.scale());
+  writeValue(out, attributes.rotation());
+  writeOptional(out, attributes.surfaceContents());
+  writeOptional(out, attributes.surfaceFlags());
+  writeOptional(out, attributes.surfaceValue());
+  writeOptional(out, attributes.color());
+
+  if (mdl::isParallelUVCoordSystem(mapFormat))
+  {
+    writeVec(out, face.uAxis());
+    writeVec(out, face.vAxis());
+  }
+}
+
+std::string writeBrush(const mdl::BrushNode& brushNode, const mdl::MapFormat mapFormat)
+{
+  const auto& brush = brushNode.brush();
+
+  auto body = std::string{};
+  writeValue(body, uint64_t(brushNode.lineNumber()));
+  writeValue(body, uint64_t(brushNode.lineCount()));
+
+  writeValue(body, uint32_t(brush.faceCount()));
+  for (const auto& face : brush.faces())
+  {
+    writeBrushFace(body, face, mapFormat);
+  }
+
+  // the faces are stored in the order of the geometry's faces, so we only need to store
+  // their boundaries to restore the geometry
+  auto vertexIndices = std::unordered_map<const mdl::BrushVertex*, uint32_t>{};
+  writeValue(body, uint32_t(brush.vertexCount()));
+  for (const auto* vertex : brush.vertices())
+  {
+    vertexIndices.emplace(vertex, uint32_t(vertexIndices.size()));
+    writeVec(body, vertex->position());
+  }
+
+  for (const auto& face : brush.faces())
+  {
+    const auto& boundary = face.geometry()->boundary();
+    writeValue(body, uint32_t(boundary.size()));
+    for (const auto* halfEdge : boundary)
+    {
+      writeValue(body, vertexIndices.at(halfEdge->origin()));
+    }
+  }
+
+  // the size allows the reader to skip the brush and read it later
+  auto record = std::string{};
+  writeValue(record, RecordType::Brush);
+  writeValue(record, uint64_t(body.size()));
+  return record + body;
+}
+
+std::string writePatch(const mdl::PatchNode& patchNode)
+{
+  const auto& patch = patchNode.patch();
+
+  auto record = std::string{};
+  writeValue(record, RecordType::Patch);
+  writeValue(record, uint64_t(patchNode.lineNumber()));
+  writeValue(record, uint64_t(patchNode.lineCount()));
+  writeValue(record, uint32_t(patch.pointRowCount()));
+  writeValue(record, uint32_t(patch.pointColumnCount()));
+  writeString(record, patch.materialName());
+  for (const auto& controlPoint : patch.controlPoints())
+  {
+    writeVec(record, controlPoint);
+  }
+  return record;
+}
+
+class MapCacheSerializer : public NodeSerializer
+{
+private:
+  std::ostream& m_stream;
+  mdl::MapFormat m_mapFormat;
+  std::unordered_map<const mdl::Node*, std::string> m_nodeToRecord;
+
+public:
+  MapCacheSerializer(std::ostream& stream, const mdl::MapFormat mapFormat)
+    : m_stream{stream}
+    , m_mapFormat{mapFormat}
+  {
+  }
+
+private:
+  void doBeginFile(
+    const std::vector<const mdl::Node*>& rootNodes,
+    kdl::task_manager& taskManager) override
+  {
+    ensure(m_nodeToRecord.empty(), "MapCacheSerializer may not be reused");
+
+    auto nodesToSerialize = std::vector<const mdl::Node*>{};
+    mdl::Node::visitAll(
+      rootNodes,
+      kdl::overload(
+        [](auto&& thisLambda, const mdl::WorldNode* world) {
+          world->visitChildren(thisLambda);
+        },
+        [](auto&& thisLambda, const mdl::LayerNode* layer) {
+          layer->visitChildren(thisLambda);
+        },
+        [](auto&& thisLambda, const mdl::GroupNode* group) {
+          group->visitChildren(thisLambda);
+        },
+        [](auto&& thisLambda, const mdl::EntityNode* entity) {
+          entity->visitChildren(thisLambda);
+        },
+        [&](const mdl::BrushNode* brushNode) { nodesToSerialize.push_back(brushNode); },
+        [&](const mdl::PatchNode* patchNode) { nodesToSerialize.push_back(patchNode); }));
+
+    // serialize brushes and patches in parallel
+    auto records =
+      taskManager.parallel_transform(nodesToSerialize, [&](const mdl::Node* node) {
+        return node->accept(kdl::overload(
+          [](const mdl::WorldNode*) { return std::string{}; },
+          [](const mdl::LayerNode*) { return std::string{}; },
+          [](const mdl::GroupNode*) { return std::string{}; },
+          [](const mdl::EntityNode*) { return std::string{}; },
+          [&](const mdl::BrushNode* brushNode) {
+            return writeBrush(*brushNode, m_mapFormat);
+          },
+          [](const mdl::PatchNode* patchNode) { return writePatch(*patchNode); }));
+      });
+
+    m_nodeToRecord.reserve(records.size());
+    for (size_t i = 0; i < records.size(); ++i)
+    {
+      m_nodeToRecord.emplace(nodesToSerialize[i], std::move(records[i]));
+    }
+  }
+
+  void doEndFile() override { writeRecord(RecordType::End); }
+
+  void doBeginEntity(const mdl::Node* node) override
+  {
+    auto record = std::string{};
+    writeValue(record, RecordType::BeginEntity);
+    writeValue(record, uint64_t(node->lineNumber()));
+    writeValue(record, uint64_t(node->lineCount()));
+    m_stream.write(record.data(), std::streamsize(record.size()));
+  }
+
+  void doEndEntity(const mdl::Node* /* node */) override
+  {
+    writeRecord(RecordType::EndEntity);
+  }
+
+  void doEntityProperty(const mdl::EntityProperty& property) override
+  {
+    auto record = std::string{};
+    writeValue(record, RecordType::EntityProperty);
+    writeString(record, property.key());
+    writeString(record, property.value());
+    m_stream.write(record.data(), std::streamsize(record.size()));
+  }
+
+  void doBrush(const mdl::BrushNode* brushNode) override { writeNode(brushNode); }
+
+  void doBrushFace(const mdl::BrushFace& /* face */) override
+  {
+    // brush faces are written together with their brushes
+  }
+
+  void doPatch(const mdl::PatchNode* patchNode) override { writeNode(patchNode); }
+
+  void writeRecord(const RecordType type)
+  {
+    m_stream.put(char(type));
+  }
+
+  void writeNode(const mdl::Node* node)
+  {
+    const auto it = m_nodeToRecord.find(node);
+    ensure(
+      it != m_nodeToRecord.end(),
+      "attempted to serialize a node which was not passed to doBeginFile");
+    m_stream.write(it->second.data(), std::streamsize(it->second.size()));
+  }
+};
+
+// reading
+
+template <typename T>
+T readValue(Reader& reader)
+{
+  static_assert(std::is_trivially_copyable_v<T>);
+  auto value = T{};
+  reader.read(reinterpret_cast<char*>(&value), sizeof(T));
+  return value;
+}
+
+template <typename T, size_t S>
+vm::vec<T, S> readVec(Reader& reader)
+{
+  auto vec = vm::vec<T, S>{};
+  for (size_t i = 0; i < S; ++i)
+  {
+    vec[i] = readValue<T>(reader);
+  }
+  return vec;
+}
+
+template <typename T>
+std::optional<T> readOptional(Reader& reader)
+{
+  return readValue<uint8_t>(reader) != 0 ? std::optional{readValue<T>(reader)}
+                                         : std::nullopt;
+}
+
+std::string readString(Reader& reader)
+{
+  const auto size = readValue<uint32_t>(reader);
+  auto str = std::string(size, '\0');
+  reader.read(str.data(), size);
+  return str;
+}
+
+FileLocation readEndLocation(Reader& reader, const FileLocation& startLocation)
+{
+  return FileLocation{startLocation.line + readValue<uint64_t>(reader)};
+}
+
+Result<mdl::BrushFace> readBrushFace(Reader& reader, const mdl::MapFormat mapFormat)
+{
+  const auto line = readValue<uint64_t>(reader);
+  const auto lineCount = readValue<uint64_t>(reader);
+  const auto point0 = readVec<double, 3>(reader);
+  const auto point1 = readVec<double, 3>(reader);
+  const auto point2 = readVec<double, 3>(reader);
+
+  auto attributes = mdl::BrushFaceAttributes{readString(reader)};
+  attributes.setOffset(readVec<float, 2>(reader));
+  attributes.setScale(readVec<float, 2>(reader));
+  attributes.setRotation(readValue<float>(reader));
+  attributes.setSurfaceContents(readOptional<int>(reader));
+  attributes.setSurfaceFlags(readOptional<int>(reader));
+  attributes.setSurfaceValue(readOptional<float>(reader));
+  attributes.setColor(readOptional<Color>(reader));
+
+  const auto setFilePosition = [&](mdl::BrushFace face) {
+    face.setFilePosition(line, lineCount);
+    return face;
+  };
+
+  if (mdl::isParallelUVCoordSystem(mapFormat))
+  {
+    const auto uAxis = readVec<double, 3>(reader);
+    const auto vAxis = readVec<double, 3>(reader);
+    return mdl::BrushFace::createFromValve(
+             point0, point1, point2, attributes, uAxis, vAxis, mapFormat)
+           | kdl::transform(setFilePosition);
+  }
+
+  return mdl::BrushFace::createFromStandard(point0, point1, point2, attributes, mapFormat)
+         | kdl::transform(setFilePosition);
+}
+
+Result<MapReader::BrushInfo> readBrush(
+  Reader reader, const std::optional<size_t> parentIndex, const mdl::MapFormat mapFormat)
+{
+  try
+  {
+    const auto startLocation = FileLocation{readValue<uint64_t>(reader)};
+    const auto endLocation = readEndLocation(reader, startLocation);
+
+    const auto faceCount = readValue<uint32_t>(reader);
+    auto faces = std::vector<mdl::BrushFace>{};
+    faces.reserve(faceCount);
+    for (size_t i = 0; i < faceCount; ++i)
+    {
+      if (auto face = readBrushFace(reader, mapFormat); face.is_success())
+      {
+        faces.push_back(std::move(face).value());
+      }
+      else
+      {
+        return Error{"Invalid brush face"};
+      }
+    }
+
+    const auto vertexCount = readValue<uint32_t>(reader);
+    auto positions = std::vector<vm::vec3d>{};
+    positions.reserve(vertexCount);
+    for (size_t i = 0; i < vertexCount; ++i)
+    {
+      positions.push_back(readVec<double, 3>(reader));
+    }
+
+    auto faceSizes = std::vector<size_t>{};
+    auto faceVertices = std::vector<size_t>{};
+    auto facePlanes = std::vector<vm::plane3d>{};
+    faceSizes.reserve(faceCount);
+    facePlanes.reserve(faceCount);
+    for (const auto& face : faces)
+    {
+      const auto faceSize = readValue<uint32_t>(reader);
+      faceSizes.push_back(faceSize);
+      for (size_t i = 0; i < faceSize; ++i)
+      {
+        faceVertices.push_back(readValue<uint32_t>(reader));
+      }
+      facePlanes.push_back(face.boundary());
+    }
+
+    if (!reader.eof())
+    {
+      return Error{"Unexpected data after brush"};
+    }
+
+    // if the cached geometry is invalid, the brush is built from its faces instead
+    return MapReader::BrushInfo{
+      std::move(faces),
+      startLocation,
+      endLocation,
+      parentIndex,
+      mdl::BrushGeometry::fromTopology(positions, faceSizes, faceVertices, facePlanes)};
+  }
+  catch (const ReaderException& e)
+  {
+    return Error{e.what()};
+  }
+}
+
+MapReader::PatchInfo readPatch(Reader& reader, const std::optional<size_t> parentIndex)
+{
+  const auto startLocation = FileLocation{readValue<uint64_t>(reader)};
+  const auto endLocation = readEndLocation(reader, startLocation);
+  const auto rowCount = size_t(readValue<uint32_t>(reader));
+  const auto columnCount = size_t(readValue<uint32_t>(reader));
+  auto materialName = readString(reader);
+
+  auto controlPoints = std::vector<mdl::BezierPatch::Point>{};
+  controlPoints.reserve(rowCount * columnCount);
+  for (size_t i = 0; i < rowCount * columnCount; ++i)
+  {
+    controlPoints.push_back(readVec<double, 5>(reader));
+  }
+
+  return MapReader::PatchInfo{
+    rowCount,
+    columnCount,
+    std::move(controlPoints),
+    std::move(materialName),
+    startLocation,
+    endLocation,
+    parentIndex};
+}
+
+struct BrushRecord
+{
+  size_t objectIndex;
+  std::optional<size_t> parentIndex;
+  Reader reader;
+};
+
+Result<CachedMap> readRecords(Reader& reader, kdl::task_manager& taskManager)
+{
+  const auto mapFormat = mdl::MapFormat(readValue<int32_t>(reader));
+  if (mapFormat == mdl::MapFormat::Unknown)
+  {
+    return Error{"Unknown map format"};
+  }
+
+  // Read the entities and patches and collect the brush records, which are read in
+  // parallel afterwards.
+  auto objectInfos = std::vector<MapReader::ObjectInfo>{};
+  auto brushRecords = std::vector<BrushRecord>{};
+  auto currentEntityIndex = std::optional<size_t>{};
+
+  auto currentEntity = [&]() -> MapReader::EntityInfo* {
+    return currentEntityIndex
+             ? &std::get<MapReader::EntityInfo>(objectInfos[*currentEntityIndex])
+             : nullptr;
+  };
+
+  while (true)
+  {
+    switch (readValue<RecordType>(reader))
+    {
+    case RecordType::BeginEntity: {
+      if (currentEntityIndex)
+      {
+        return Error{"Unexpected entity"};
+      }
+      const auto startLocation = FileLocation{readValue<uint64_t>(reader)};
+      const auto endLocation = readEndLocation(reader, startLocation);
+      currentEntityIndex = objectInfos.size();
+      objectInfos.emplace_back(MapReader::EntityInfo{{}, startLocation, endLocation});
+      break;
+    }
+    case RecordType::EndEntity:
+      if (!currentEntityIndex)
+      {
+        return Error{"Unexpected end of entity"};
+      }
+      currentEntityIndex = std::nullopt;
+      break;
+    case RecordType::EntityProperty: {
+      auto* entityInfo = currentEntity();
+      if (!entityInfo)
+      {
+        return Error{"Unexpected entity property"};
+      }
+      auto key = readString(reader);
+      auto value = readString(reader);
+      entityInfo->properties.emplace_back(std::move(key), std::move(value));
+      break;
+    }
+    case RecordType::Brush: {
+      const auto size = size_t(readValue<uint64_t>(reader));
+      brushRecords.push_back(
+        {objectInfos.size(), currentEntityIndex, reader.subReaderFromCurrent(size)});
+      reader.seekForward(size);
+      // placeholder that is replaced once the brush has been read
+      objectInfos.emplace_back(MapReader::EntityInfo{});
+      break;
+    }
+    case RecordType::Patch:
+      objectInfos.emplace_back(readPatch(reader, currentEntityIndex));
+      break;
+    case RecordType::End:
+      if (currentEntityIndex || !reader.eof())
+      {
+        return Error{"Unexpected end of map cache"};
+      }
+      return taskManager.parallel_transform(
+               brushRecords,
+               [&](BrushRecord& brushRecord) {
+                 return readBrush(
+                   std::move(brushRecord.reader), brushRecord.parentIndex, mapFormat);
+               })
+             | kdl::fold | kdl::transform([&](auto brushInfos) {
+                 for (size_t i = 0; i < brushInfos.size(); ++i)
+                 {
+                   objectInfos[brushRecords[i].objectIndex] = std::move(brushInfos[i]);
+                 }
+                 return CachedMap{mapFormat, std::move(objectInfos)};
+               });
+    default:
+      return Error{"Unknown record type"};
+    }
+  }
+}
+
+uint64_t hashMapText(const std::string_view str)
+{
+  // FNV-1a applied to 64 bit words, with a rotation to mix the high bits back into the
+  // low bits; every step is a bijection, so inputs that differ in a single word always
+  // have different hashes
+  constexpr auto Prime = uint64_t(0x100000001b3);
+  auto hash = uint64_t(0xcbf29ce484222325) ^ uint64_t(str.size());
+
+  auto i = size_t(0);
+  for (; i + sizeof(uint64_t) <= str.size(); i += sizeof(uint64_t))
+  {
+    auto word = uint64_t(0);
+    std::memcpy(&word, str.data() + i, sizeof(uint64_t));
+    hash = std::rotl((hash ^ word) * Prime, 31);
+  }
+  for (; i < str.size(); ++i)
+  {
+    hash = (hash ^ uint64_t(uint8_t(str[i]))) * Prime;
+  }
+  return hash;
+}
+
+} // namespace
+
+MapCacheKey makeMapCacheKey(const std::string_view mapText, const vm::bbox3d& worldBounds)
+{
+  return {hashMapText(mapText), worldBounds};
+}
+
+std::filesystem::path mapCachePath(const std::filesystem::path& mapPath)
+{
+  auto result = mapPath;
+  result += ".tbcache";
+  return result;
+}
+
+void writeMapCache(
+  std::ostream& stream,
+  const MapCacheKey& key,
+  const mdl::WorldNode& world,
+  kdl::task_manager& taskManager)
+{
+  auto header = std::string{};
+  writeValue(header, Magic);
+  writeValue(header, Version);
+  writeValue(header, key.contentHash);
+  writeVec(header, key.worldBounds.min);
+  writeVec(header, key.worldBounds.max);
+  writeValue(header, int32_t(world.mapFormat()));
+  stream.write(header.data(), std::streamsize(header.size()));
+
+  auto writer = NodeWriter{
+    world, std::make_unique<MapCacheSerializer>(stream, world.mapFormat())};
+  writer.setExporting(false);
+  writer.writeMap(taskManager);
+}
+
+Result<CachedMap> readMapCache(
+  const Reader& reader, const MapCacheKey& key, kdl::task_manager& taskManager)
+{
+  try
+  {
+    // brushes are read in parallel, so the data must be in memory
+    auto bufferedReader = reader.buffer();
+
+    if (readValue<uint32_t>(bufferedReader) != Magic)
+    {
+      return Error{"Not a map cache"};
+    }
+    if (readValue<uint32_t>(bufferedReader) != Version)
+    {
+      return Error{"Unsupported map cache version"};
+    }
+
+    const auto contentHash = readValue<uint64_t>(bufferedReader);
+    const auto min = readVec<double, 3>(bufferedReader);
+    const auto max = readVec<double, 3>(bufferedReader);
+    if (MapCacheKey{contentHash, vm::bbox3d{min, max}} != key)
+    {
+      return Error{"Map cache is stale"};
+    }
+
+    return readRecords(bufferedReader, taskManager);
+  }
+  catch (const ReaderException& e)
+  {
+    return Error{e.what()};
+  }
+}
+
+} // namespace tb::io
@@ -0,0 +1,104 @@
+/*
+ Copyright (C) 2010 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Result.h"
+#include "io/MapReader.h"
+
+#include "vm/bbox.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <iosfwd>
+#include <string_view>
+#include <vector>
+
+namespace kdl
+{
+class task_manager;
+}
+
+namespace tb::mdl
+{
+enum class MapFormat;
+class WorldNode;
+} // namespace tb::mdl
+
+namespace tb::io
+{
+class Reader;
+
+/**
+ * Identifies the map a cache was written for. A cache is stale if its key does not match
+ * the key of the map that is being loaded.
+ */
+struct MapCacheKey
+{
+  uint64_t contentHash;
+  vm::bbox3d worldBounds;
+
+  bool operator==(const MapCacheKey& other) const = default;
+};
+
+/**
+ * Computes the cache key of a map with the given text and world bounds.
+ */
+MapCacheKey makeMapCacheKey(std::string_view mapText, const vm::bbox3d& worldBounds);
+
+/**
+ * Returns the path of the cache file for the map file at the given path. The cache file
+ * is stored next to the map file.
+ */
+std::filesystem::path mapCachePath(const std::filesystem::path& mapPath);
+
+/**
+ * The contents of a map cache. The object infos can be passed to WorldReader to create
+ * the world without parsing the map text.
+ */
+struct CachedMap
+{
+  mdl::MapFormat mapFormat;
+  std::vector<MapReader::ObjectInfo> objectInfos;
+};
+
+/**
+ * Writes a binary cache of the given world to the given stream.
+ *
+ * The cache contains the entities with their properties, the brush faces with their
+ * attributes and UV axes, the patches and the file positions of all objects. Brushes are
+ * stored together with the topology of their geometry so that it does not have to be
+ * computed again when the cache is read.
+ */
+void writeMapCache(
+  std::ostream& stream,
+  const MapCacheKey& key,
+  const mdl::WorldNode& world,
+  kdl::task_manager& taskManager);
+
+/**
+ * Reads a map cache that was written by writeMapCache.
+ *
+ * Returns an error if the cache was written for a different key or by a different version
+ * of the cache format, or if it is corrupt.
+ */
+Result<CachedMap> readMapCache(
+  const Reader& reader, const MapCacheKey& key, kdl::task_manager& taskManager);
+
+} // namespace tb::io
@@ -341,22 +341,21 @@ void MapFileSerializer::doBeginFile(
 
   // serialize brushes to strings in parallel
   using Entry = std::pair<const mdl::Node*, PrecomputedString>;
-  auto tasks = nodesToSerialize | std::views::transform([&](const auto& node) {
-                 return std::function{[&]() {
-                   return std::visit(
-                     kdl::overload(
-                       [&](const mdl::BrushNode* brushNode) {
-                         return Entry{brushNode, writeBrushFaces(brushNode->brush())};
-                       },
-                       [&](const mdl::PatchNode* patchNode) {
-                         return Entry{patchNode, writePatch(patchNode->patch())};
-                       }),
-                     node);
-                 }};
-               });
-
-  // render strings and move them into a map
-  for (auto& entry : taskManager.run_tasks_and_wait(std::move(tasks)))
+  auto entries = taskManager.parallel_transform(nodesToSerialize, [&](const auto& node) {
+    return std::visit(
+      kdl::overload(
+        [&](const mdl::BrushNode* brushNode) {
+          return Entry{brushNode, writeBrushFaces(brushNode->brush())};
+        },
+        [&](const mdl::PatchNode* patchNode) {
+          return Entry{patchNode, writePatch(patchNode->patch())};
+        }),
+      node);
+  });
+
+  // move the strings into a map
+  m_nodeToPrecomputedString.reserve(entries.size());
+  for (auto& entry : entries)
   {
     m_nodeToPrecomputedString.insert(std::move(entry));
   }
@@ -366,8 +365,12 @@ void MapFileSerializer::doEndFile() {}
 
 void MapFileSerializer::doBeginEntity(const mdl::Node* /* node */)
 {
-  fmt::format_to(std::ostreambuf_iterator<char>(m_stream), "// entity {}\n", entityNo());
-  ++m_line;
+  if (writeObjectNumbers())
+  {
+    fmt::format_to(
+      std::ostreambuf_iterator<char>(m_stream), "// entity {}\n", entityNo());
+    ++m_line;
+  }
   m_startLineStack.push_back(m_line);
   fmt::format_to(std::ostreambuf_iterator<char>(m_stream), "{{\n");
   ++m_line;
@@ -392,8 +395,11 @@ void MapFileSerializer::doEntityProperty(const mdl::EntityProperty& attribute)
 
 void MapFileSerializer::doBrush(const mdl::BrushNode* brush)
 {
-  fmt::format_to(std::ostreambuf_iterator<char>(m_stream), "// brush {}\n", brushNo());
-  ++m_line;
+  if (writeObjectNumbers())
+  {
+    fmt::format_to(std::ostreambuf_iterator<char>(m_stream), "// brush {}\n", brushNo());
+    ++m_line;
+  }
   m_startLineStack.push_back(m_line);
   fmt::format_to(std::ostreambuf_iterator<char>(m_stream), "{{\n");
   ++m_line;
@@ -422,8 +428,11 @@ void MapFileSerializer::doBrushFace(const mdl::BrushFace& face)
 
 void MapFileSerializer::doPatch(const mdl::PatchNode* patchNode)
 {
-  fmt::format_to(std::ostreambuf_iterator<char>(m_stream), "// brush {}\n", brushNo());
-  ++m_line;
+  if (writeObjectNumbers())
+  {
+    fmt::format_to(std::ostreambuf_iterator<char>(m_stream), "// brush {}\n", brushNo());
+    ++m_line;
+  }
   m_startLineStack.push_back(m_line);
 
   // write pre-serialized patch
@@ -22,6 +22,7 @@
 #include "Error.h" // IWYU pragma: keep
 #include "FileLocation.h"
 #include "Uuid.h"
+#include "io/BufferedParserStatus.h"
 #include "io/ParserStatus.h"
 #include "mdl/BrushFace.h"
 #include "mdl/BrushNode.h"
@@ -37,6 +38,7 @@
 #include "mdl/WorldNode.h"
 
 #include "kdl/result.h"
+#include "kdl/result_fold.h"
 #include "kdl/string_format.h"
 #include "kdl/string_utils.h"
 #include "kdl/task_manager.h"
@@ -47,9 +49,12 @@
 #include <fmt/ostream.h>
 
 #include <cassert>
+#include <functional>
 #include <optional>
 #include <ostream>
+#include <ranges>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -68,23 +73,487 @@ auto getFilePosition(const T& info)
   return std::tuple{startLine, lineCount};
 }
 
+/**
+ * Inputs are split into chunks of roughly this many bytes for parallel parsing. Smaller
+ * inputs are parsed on the calling thread.
+ */
+constexpr auto ParseChunkSize = size_t(256 * 1024);
+
+/** The location of a character in the input. */
+struct ScanPosition
+{
+  size_t offset = 0;
+  size_t line = 1;
+  size_t column = 1;
+};
+
+/** The locations of the braces of a top level entity and of its objects. */
+struct EntityBraces
+{
+  ScanPosition begin;
+  std::vector<ScanPosition> objects;
+  ScanPosition end;
+};
+
+bool isWhitespace(const char c)
+{
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+/**
+ * Checks whether the given string would be read as an integer or decimal number by the
+ * tokenizer.
+ */
+bool isNumber(const std::string_view str)
+{
+  const auto isDigit = [](const char c) { return c >= '0' && c <= '9'; };
+  const auto at = [&](const size_t i) { return i < str.size() ? str[i] : '\0'; };
+  const auto skipDigits = [&](size_t i) {
+    while (isDigit(at(i)))
+    {
+      ++i;
+    }
+    return i;
+  };
+
+  // integer
+  auto i = size_t(0);
+  if (at(i) == '+' || at(i) == '-')
+  {
+    ++i;
+  }
+  if (skipDigits(i) == str.size())
+  {
+    return true;
+  }
+
+  // decimal
+  i = 0;
+  if (at(i) != '.')
+  {
+    i = skipDigits(i + 1);
+  }
+  if (at(i) == '.')
+  {
+    i = skipDigits(i + 1);
+  }
+  if (at(i) == 'e' || at(i) == 'E')
+  {
+    ++i;
+    if (at(i) == '+' || at(i) == '-' || isDigit(at(i)))
+    {
+      i = skipDigits(i + 1);
+    }
+  }
+  return i == str.size();
+}
+
+/**
+ * Finds the braces of the top level entities and their objects without tokenizing the
+ * input. The lexical rules of QuakeMapTokenizer are followed to skip comments, quoted
+ * strings and words, so every brace that the tokenizer would return as a token is
+ * found.
+ *
+ * Material names are not tokenized by the parser, so braces at the start of a material
+ * name are not returned as tokens. A material name is expected after the opening brace
+ * of a patch and after the last parenthesized group of a brush face, i.e., after a
+ * closing parenthesis that is not followed by another opening parenthesis.
+ *
+ * Returns an empty optional if the input is not well formed. In that case, the caller
+ * should parse the input as a whole to obtain the appropriate error.
+ */
+std::optional<std::vector<EntityBraces>> scanEntityBraces(const std::string_view str)
+{
+  auto result = std::vector<EntityBraces>{};
+  auto pos = ScanPosition{};
+  auto depth = size_t(0);
+  auto parenthesisDepth = size_t(0);
+  auto patchDepth = std::optional<size_t>{};
+  auto previousWord = std::string_view{};
+  auto expectMaterialName = false;
+
+  const auto eof = [&](const size_t offset) { return offset >= str.size(); };
+  const auto cur = [&]() { return str[pos.offset]; };
+  const auto lookAhead = [&](const size_t offset = 1) {
+    return !eof(pos.offset + offset) ? str[pos.offset + offset] : '\0';
+  };
+  const auto skipWhitespace = [&](size_t offset) {
+    while (!eof(offset) && isWhitespace(str[offset]))
+    {
+      ++offset;
+    }
+    return offset;
+  };
+  const auto findWhitespace = [&](size_t offset) {
+    while (!eof(offset) && !isWhitespace(str[offset]))
+    {
+      ++offset;
+    }
+    return offset;
+  };
+
+  // keep track of lines and columns like the tokenizer does
+  const auto advance = [&]() {
+    if (cur() == '\r' && lookAhead() == '\n')
+    {
+      ++pos.column;
+    }
+    else if (cur() == '\r' || cur() == '\n')
+    {
+      ++pos.line;
+      pos.column = 1;
+    }
+    else
+    {
+      ++pos.column;
+    }
+    ++pos.offset;
+  };
+  const auto advanceTo = [&](const size_t offset) {
+    while (pos.offset < offset)
+    {
+      advance();
+    }
+  };
+  const auto discardLine = [&]() {
+    while (!eof(pos.offset) && cur() != '\n' && cur() != '\r')
+    {
+      advance();
+    }
+  };
+  const auto skipQuotedString = [&]() {
+    advance();
+    auto escaped = false;
+    while (!eof(pos.offset) && (cur() != '"' || escaped))
+    {
+      // mirrors the tokenizer's handling of trailing backslashes in quoted strings
+      if (cur() == '"' && (lookAhead() == '\n' || lookAhead() == '}'))
+      {
+        break;
+      }
+      escaped = cur() == '\\' ? !escaped : false;
+      advance();
+    }
+    if (eof(pos.offset))
+    {
+      return false;
+    }
+    advance();
+    return true;
+  };
+
+  while (!eof(pos.offset))
+  {
+    const auto c = cur();
+    if (isWhitespace(c))
+    {
+      advance();
+    }
+    else if (expectMaterialName)
+    {
+      // the material name is read as a quoted string or up to the next whitespace
+      if (c == '"')
+      {
+        if (!skipQuotedString())
+        {
+          return std::nullopt;
+        }
+      }
+      else
+      {
+        advanceTo(findWhitespace(pos.offset));
+      }
+      expectMaterialName = false;
+      previousWord = {};
+    }
+    else if (c == '/')
+    {
+      advance();
+      if (!eof(pos.offset) && cur() == '/')
+      {
+        advance();
+        if (!eof(pos.offset) && cur() == '/' && lookAhead() == ' ')
+        {
+          advance();
+        }
+        else
+        {
+          discardLine();
+        }
+      }
+    }
+    else if (c == ';')
+    {
+      discardLine();
+    }
+    else if (c == '{')
+    {
+      if (depth == 0)
+      {
+        result.push_back(EntityBraces{pos, {}, {}});
+      }
+      else if (depth == 1)
+      {
+        result.back().objects.push_back(pos);
+      }
+      ++depth;
+
+      if (previousWord == "patchDef2")
+      {
+        patchDepth = depth;
+        expectMaterialName = true;
+      }
+      parenthesisDepth = 0;
+      previousWord = {};
+      advance();
+    }
+    else if (c == '}')
+    {
+      if (depth == 0)
+      {
+        return std::nullopt;
+      }
+      if (patchDepth == depth)
+      {
+        patchDepth = std::nullopt;
+      }
+      if (--depth == 0)
+      {
+        result.back().end = pos;
+      }
+
+      parenthesisDepth = 0;
+      previousWord = {};
+      advance();
+    }
+    else if (depth == 0)
+    {
+      // only entities and comments are expected at the top level
+      return std::nullopt;
+    }
+    else if (c == '(')
+    {
+      ++parenthesisDepth;
+      previousWord = {};
+      advance();
+    }
+    else if (c == ')')
+    {
+      if (parenthesisDepth > 0 && --parenthesisDepth == 0 && depth > 1 && !patchDepth)
+      {
+        const auto next = skipWhitespace(pos.offset + 1);
+        expectMaterialName = !eof(next) && str[next] != '(';
+      }
+      previousWord = {};
+      advance();
+    }
+    else if (c == '[' || c == ']')
+    {
+      previousWord = {};
+      advance();
+    }
+    else if (c == '"')
+    {
+      if (!skipQuotedString())
+      {
+        return std::nullopt;
+      }
+      previousWord = {};
+    }
+    else
+    {
+      // a number ends at whitespace or a closing parenthesis, anything else only ends at
+      // whitespace
+      auto end = findWhitespace(pos.offset + 1);
+
+      const auto word = str.substr(pos.offset, end - pos.offset);
+      if (const auto closingParenthesis = word.find(')');
+          closingParenthesis != std::string_view::npos
+          && isNumber(word.substr(0, closingParenthesis)))
+      {
+        end = pos.offset + closingParenthesis;
+      }
+
+      previousWord = str.substr(pos.offset, end - pos.offset);
+      advanceTo(end);
+    }
+  }
+
+  if (depth != 0)
+  {
+    return std::nullopt;
+  }
+
+  return result;
+}
+
+/**
+ * The kind of a chunk determines how it is parsed and how the parsed objects are merged
+ * into the objects of the preceding chunks.
+ */
+enum class ParseChunkKind
+{
+  /** A sequence of complete entities. */
+  Entities,
+  /** The opening brace and properties of a large entity. */
+  EntityHeader,
+  /** A sequence of objects of the preceding large entity. */
+  EntityObjects,
+};
+
+struct ParseChunk
+{
+  ParseChunkKind kind;
+  ScanPosition begin;
+  size_t endOffset;
+  /** The location of the closing brace of an entity, only set for entity headers. */
+  std::optional<FileLocation> entityEndLocation;
+};
+
+/**
+ * Groups the given entities into chunks of roughly ParseChunkSize bytes. The objects of
+ * entities that are larger than that, such as worldspawn in many maps, are split into
+ * separate chunks.
+ */
+std::vector<ParseChunk> makeParseChunks(const std::vector<EntityBraces>& entities)
+{
+  auto result = std::vector<ParseChunk>{};
+  auto currentChunk = std::optional<ParseChunk>{};
+
+  const auto flushCurrentChunk = [&]() {
+    if (currentChunk)
+    {
+      result.push_back(std::move(*currentChunk));
+      currentChunk = std::nullopt;
+    }
+  };
+
+  for (const auto& entity : entities)
+  {
+    const auto entitySize = entity.end.offset + 1 - entity.begin.offset;
+    if (entitySize > ParseChunkSize && !entity.objects.empty())
+    {
+      flushCurrentChunk();
+
+      // include the opening brace of the first object so that the parser can see where
+      // the properties end
+      result.push_back(ParseChunk{
+        ParseChunkKind::EntityHeader,
+        entity.begin,
+        entity.objects.front().offset + 1,
+        FileLocation{entity.end.line, entity.end.column}});
+
+      auto objectsBegin = entity.objects.front();
+      for (const auto& object : entity.objects)
+      {
+        if (object.offset - objectsBegin.offset >= ParseChunkSize)
+        {
+          result.push_back(ParseChunk{
+            ParseChunkKind::EntityObjects, objectsBegin, object.offset, std::nullopt});
+          objectsBegin = object;
+        }
+      }
+      result.push_back(ParseChunk{
+        ParseChunkKind::EntityObjects, objectsBegin, entity.end.offset, std::nullopt});
+    }
+    else
+    {
+      if (!currentChunk)
+      {
+        currentChunk =
+          ParseChunk{ParseChunkKind::Entities, entity.begin, 0, std::nullopt};
+      }
+      currentChunk->endOffset = entity.end.offset + 1;
+
+      if (currentChunk->endOffset - currentChunk->begin.offset >= ParseChunkSize)
+      {
+        flushCurrentChunk();
+      }
+    }
+  }
+
+  flushCurrentChunk();
+  return result;
+}
+
 } // namespace
 
+/**
+ * Parses a single chunk of the input into object infos. The node creation callbacks are
+ * never called because the object infos are merged into the reader that owns the entire
+ * input.
+ */
+class MapReader::ChunkReader : public MapReader
+{
+public:
+  ChunkReader(
+    const std::string_view str,
+    const size_t line,
+    const size_t column,
+    const mdl::MapFormat sourceMapFormat,
+    const mdl::MapFormat targetMapFormat)
+    : MapReader{str, line, column, sourceMapFormat, targetMapFormat}
+  {
+  }
+
+  Result<std::vector<ObjectInfo>> read(const ParseChunkKind kind, ParserStatus& status)
+  {
+    auto result = Result<void>{};
+    switch (kind)
+    {
+    case ParseChunkKind::Entities:
+      result = parseEntities(status);
+      break;
+    case ParseChunkKind::EntityHeader:
+      result = parseEntityHeader(status);
+      break;
+    case ParseChunkKind::EntityObjects:
+      result = parseEntityObjects(status);
+      break;
+      switchDefault();
+    }
+
+    return result | kdl::transform([&]() { return std::move(m_objectInfos); });
+  }
+
+private:
+  mdl::Node* onWorldNode(std::unique_ptr<mdl::WorldNode>, ParserStatus&) override
+  {
+    return nullptr;
+  }
+
+  void onLayerNode(std::unique_ptr<mdl::Node>, ParserStatus&) override {}
+
+  void onNode(mdl::Node*, std::unique_ptr<mdl::Node>, ParserStatus&) override {}
+};
+
 MapReader::MapReader(
   const std::string_view str,
   const mdl::MapFormat sourceMapFormat,
   const mdl::MapFormat targetMapFormat,
   mdl::EntityPropertyConfig entityPropertyConfig)
   : StandardMapParser{str, sourceMapFormat, targetMapFormat}
+  , m_str{str}
   , m_entityPropertyConfig{std::move(entityPropertyConfig)}
 {
 }
 
+MapReader::MapReader(
+  const std::string_view str,
+  const size_t line,
+  const size_t column,
+  const mdl::MapFormat sourceMapFormat,
+  const mdl::MapFormat targetMapFormat)
+  : StandardMapParser{str, line, column, sourceMapFormat, targetMapFormat}
+  , m_str{str}
+{
+}
+
 Result<void> MapReader::readEntities(
   const vm::bbox3d& worldBounds, ParserStatus& status, kdl::task_manager& taskManager)
 {
   m_worldBounds = worldBounds;
-  return parseEntities(status)
+  return parseEntitiesInChunks(status, taskManager)
          | kdl::transform([&]() { createNodes(status, taskManager); });
 }
 
@@ -103,6 +572,18 @@ Result<void> MapReader::readBrushFaces(
   return parseBrushFaces(status);
 }
 
+Result<void> MapReader::readObjectInfos(
+  std::vector<ObjectInfo> objectInfos,
+  const vm::bbox3d& worldBounds,
+  ParserStatus& status,
+  kdl::task_manager& taskManager)
+{
+  m_worldBounds = worldBounds;
+  m_objectInfos = std::move(objectInfos);
+  createNodes(status, taskManager);
+  return kdl::void_success;
+}
+
 // implement MapParser interface
 
 void MapReader::onBeginEntity(
@@ -127,7 +608,8 @@ void MapReader::onEndEntity(const FileLocation& endLocation, ParserStatus& /* st
 
 void MapReader::onBeginBrush(const FileLocation& location, ParserStatus& /* status */)
 {
-  m_objectInfos.emplace_back(BrushInfo{{}, location, std::nullopt, m_currentEntityInfo});
+  m_objectInfos.emplace_back(
+    BrushInfo{{}, location, std::nullopt, m_currentEntityInfo, std::nullopt});
 }
 
 void MapReader::onEndBrush(const FileLocation& endLocation, ParserStatus& /* status */)
@@ -199,6 +681,93 @@ void MapReader::onPatch(
 
 // helper methods
 
+Result<void> MapReader::parseEntitiesInChunks(
+  ParserStatus& status, kdl::task_manager& taskManager)
+{
+  if (m_str.size() < 2 * ParseChunkSize)
+  {
+    return parseEntities(status);
+  }
+
+  const auto entities = scanEntityBraces(m_str);
+  if (!entities)
+  {
+    return parseEntities(status);
+  }
+
+  const auto chunks = makeParseChunks(*entities);
+  if (chunks.size() < 2)
+  {
+    return parseEntities(status);
+  }
+
+  struct ParsedChunk
+  {
+    std::vector<ObjectInfo> objectInfos;
+    BufferedParserStatus status;
+  };
+
+  auto tasks = chunks | std::views::transform([&](const auto& chunk) {
+                 return std::function{[&]() -> Result<ParsedChunk> {
+                   auto chunkStatus = BufferedParserStatus{status};
+                   auto chunkReader = ChunkReader{
+                     m_str.substr(
+                       chunk.begin.offset, chunk.endOffset - chunk.begin.offset),
+                     chunk.begin.line,
+                     chunk.begin.column,
+                     m_sourceMapFormat,
+                     m_targetMapFormat};
+
+                   return chunkReader.read(chunk.kind, chunkStatus)
+                          | kdl::transform([&](auto objectInfos) {
+                              return ParsedChunk{
+                                std::move(objectInfos), std::move(chunkStatus)};
+                            });
+                 }};
+               });
+
+  return taskManager.run_tasks_and_wait(std::move(tasks)) | kdl::fold
+         | kdl::transform([&](auto parsedChunks) {
+             // merge the parsed chunks in order and fix up the parent indices
+             auto splitEntityIndex = std::optional<size_t>{};
+             for (size_t i = 0; i < parsedChunks.size(); ++i)
+             {
+               const auto& chunk = chunks[i];
+               auto& parsedChunk = parsedChunks[i];
+               const auto indexOffset = m_objectInfos.size();
+
+               for (auto& objectInfo : parsedChunk.objectInfos)
+               {
+                 std::visit(
+                   kdl::overload(
+                     [](EntityInfo&) {},
+                     [&](auto& brushOrPatchInfo) {
+                       if (chunk.kind == ParseChunkKind::EntityObjects)
+                       {
+                         brushOrPatchInfo.parentIndex = splitEntityIndex;
+                       }
+                       else if (brushOrPatchInfo.parentIndex)
+                       {
+                         *brushOrPatchInfo.parentIndex += indexOffset;
+                       }
+                     }),
+                   objectInfo);
+                 m_objectInfos.push_back(std::move(objectInfo));
+               }
+
+               if (chunk.kind == ParseChunkKind::EntityHeader)
+               {
+                 assert(parsedChunk.objectInfos.size() == 1);
+                 splitEntityIndex = indexOffset;
+                 std::get<EntityInfo>(m_objectInfos[indexOffset]).endLocation =
+                   chunk.entityEndLocation;
+               }
+
+               parsedChunk.status.flush(status);
+             }
+           });
+}
+
 namespace
 {
 /** The type of a node's container. */
@@ -581,13 +1150,18 @@ CreateNodeResult createNodeFromEntityInfo(
 }
 
 /**
- * Creates a brush node from the given brush info. Returns an error if the brush could not
- * be created.
+ * Creates a brush node from the given brush info. If the brush info contains a geometry,
+ * it is used instead of computing the geometry from the faces. Returns an error if the
+ * brush could not be created.
  */
 CreateNodeResult createBrushNode(
   MapReader::BrushInfo brushInfo, const vm::bbox3d& worldBounds)
 {
-  return mdl::Brush::create(worldBounds, std::move(brushInfo.faces))
+  auto brushResult =
+    brushInfo.geometry
+      ? mdl::Brush::create(std::move(brushInfo.faces), std::move(*brushInfo.geometry))
+      : mdl::Brush::create(worldBounds, std::move(brushInfo.faces));
+  return std::move(brushResult)
          | kdl::transform([&](auto brush) {
              auto brushNode = std::make_unique<mdl::BrushNode>(std::move(brush));
              const auto [startLine, lineCount] = getFilePosition(brushInfo);
@@ -641,27 +1215,23 @@ std::vector<std::optional<NodeInfo>> createNodesFromObjectInfos(
   kdl::task_manager& taskManager)
 {
   // create nodes in parallel, moving data out of objectInfos
-  // we store optionals in the result vector to make the elements default constructible,
-  // which is a requirement for parallel transform
-  auto tasks = objectInfos | std::views::transform([&](auto& objectInfo) {
-                 return std::function{[&]() -> CreateNodeResult {
-                   return std::visit(
-                     kdl::overload(
-                       [&](MapReader::EntityInfo& entityInfo) {
-                         return createNodeFromEntityInfo(
-                           entityPropertyConfig, std::move(entityInfo), mapFormat);
-                       },
-                       [&](MapReader::BrushInfo& brushInfo) {
-                         return createBrushNode(std::move(brushInfo), worldBounds);
-                       },
-                       [&](MapReader::PatchInfo& patchInfo) {
-                         return createPatchNode(std::move(patchInfo));
-                       }),
-                     objectInfo);
-                 }};
-               });
+  auto results = taskManager.parallel_transform(
+    objectInfos, [&](MapReader::ObjectInfo& objectInfo) -> CreateNodeResult {
+      return std::visit(
+        kdl::overload(
+          [&](MapReader::EntityInfo& entityInfo) {
+            return createNodeFromEntityInfo(
+              entityPropertyConfig, std::move(entityInfo), mapFormat);
+          },
+          [&](MapReader::BrushInfo& brushInfo) {
+            return createBrushNode(std::move(brushInfo), worldBounds);
+          },
+          [&](MapReader::PatchInfo& patchInfo) {
+            return createPatchNode(std::move(patchInfo));
+          }),
+        objectInfo);
+    });
 
-  auto results = taskManager.run_tasks_and_wait(std::move(tasks));
   return results | std::views::transform([&](auto& createNodeResult) {
            return std::move(createNodeResult)
                   | kdl::transform([&](NodeInfo&& nodeInfo) -> std::optional<NodeInfo> {
@@ -25,6 +25,7 @@
 #include "mdl/BezierPatch.h"
 #include "mdl/Brush.h"
 #include "mdl/BrushFace.h"
+#include "mdl/BrushGeometry.h"
 #include "mdl/EntityProperties.h"
 
 #include "vm/bbox.h"
@@ -67,7 +68,8 @@ class ParserStatus;
  * The flow of control is:
  *
  * 1. MapParser callbacks get called with the raw data, which we just store
- * (m_objectInfos).
+ * (m_objectInfos). Large inputs are split into chunks of entities, which are parsed in
+ * parallel (parseEntitiesInChunks).
  * 2. Convert the raw data to nodes in parallel (createNodes) and record any additional
  * information necessary to restore the parent / child relationships.
  * 3. Validate the created nodes.
@@ -90,6 +92,8 @@ public: // only public so that helper methods can see these declarations
     FileLocation startLocation;
     std::optional<FileLocation> endLocation;
     std::optional<size_t> parentIndex;
+    // if set, the brush is created from this geometry instead of computing it
+    std::optional<mdl::BrushGeometry> geometry;
   };
 
   struct PatchInfo
@@ -106,6 +110,9 @@ public: // only public so that helper methods can see these declarations
   using ObjectInfo = std::variant<EntityInfo, BrushInfo, PatchInfo>;
 
 private:
+  class ChunkReader;
+
+  std::string_view m_str;
   mdl::EntityPropertyConfig m_entityPropertyConfig;
   vm::bbox3d m_worldBounds;
 
@@ -130,6 +137,18 @@ protected:
     mdl::MapFormat targetMapFormat,
     mdl::EntityPropertyConfig entityPropertyConfig);
 
+private:
+  /**
+   * Creates a new reader for a chunk of a larger string. Only used by ChunkReader.
+   */
+  MapReader(
+    std::string_view str,
+    size_t line,
+    size_t column,
+    mdl::MapFormat sourceMapFormat,
+    mdl::MapFormat targetMapFormat);
+
+protected:
   /**
    * Attempts to parse as one or more entities.
    */
@@ -144,6 +163,15 @@ protected:
    * Attempts to parse as one or more brush faces.
    */
   Result<void> readBrushFaces(const vm::bbox3d& worldBounds, ParserStatus& status);
+  /**
+   * Creates nodes from the given object infos instead of parsing them, e.g. when they were
+   * restored from a cache.
+   */
+  Result<void> readObjectInfos(
+    std::vector<ObjectInfo> objectInfos,
+    const vm::bbox3d& worldBounds,
+    ParserStatus& status,
+    kdl::task_manager& taskManager);
 
 protected: // implement MapParser interface
   void onBeginEntity(
@@ -182,6 +210,15 @@ protected: // implement MapParser interface
     ParserStatus& status) override;
 
 private: // helper methods
+  /**
+   * Splits the input at the top level entity braces and parses the chunks in parallel.
+   * Falls back to parsing the entire input on the calling thread if the input cannot be
+   * split. If parsing any of the chunks fails, the error of the first failing chunk is
+   * returned. Its location refers to the entire input because every chunk is parsed with
+   * the line and column at which it starts.
+   */
+  Result<void> parseEntitiesInChunks(
+    ParserStatus& status, kdl::task_manager& taskManager);
   void createNodes(ParserStatus& status, kdl::task_manager& taskManager);
 
 private: // subclassing interface - these will be called in the order that nodes should be
@@ -31,6 +31,7 @@
 #include "render/PrimType.h"
 
 #include "kdl/path_utils.h"
+#include "kdl/vector_utils.h"
 
 #include <fmt/format.h>
 
@@ -268,19 +269,10 @@ std::vector<std::string> parseSkins(Reader reader, const size_t count)
 
 auto parseVertices(Reader& reader, const size_t vertexCount)
 {
-  auto vertices = std::vector<Md2Vertex>{};
-  vertices.reserve(vertexCount);
-
-  for (size_t i = 0; i < vertexCount; ++i)
-  {
-    const auto x = reader.readUnsignedChar<char>();
-    const auto y = reader.readUnsignedChar<char>();
-    const auto z = reader.readUnsignedChar<char>();
-    const auto normalIndex = reader.readUnsignedChar<char>();
-    vertices.push_back({x, y, z, normalIndex});
-  }
-
-  return vertices;
+  return kdl::vec_transform(
+    reader.readVecArray<unsigned char, 4>(vertexCount), [](const auto& vertex) {
+      return Md2Vertex{vertex[0], vertex[1], vertex[2], vertex[3]};
+    });
 }
 
 auto parseFrame(Reader reader, const size_t /* frameIndex */, const size_t vertexCount)
@@ -32,6 +32,7 @@
 
 #include "kdl/path_utils.h"
 #include "kdl/string_format.h"
+#include "kdl/vector_utils.h"
 
 #include <fmt/format.h>
 
@@ -255,15 +256,7 @@ auto parseFrameVertices(
   const vm::vec3f& origin,
   const vm::vec3f& scale)
 {
-  auto packedVertices = std::vector<vm::vec<unsigned char, 4>>{vertices.size()};
-  for (size_t i = 0; i < vertices.size(); ++i)
-  {
-    for (size_t j = 0; j < 4; ++j)
-    {
-      packedVertices[i][j] = reader.readUnsignedChar<char>();
-    }
-  }
-
+  const auto packedVertices = reader.readVecArray<unsigned char, 4>(vertices.size());
   return kdl::vec_transform(packedVertices, [&](const auto& vertex) {
     return unpackFrameVertex(vertex, origin, scale);
   });
@@ -387,34 +380,16 @@ void parseFrame(
 
 std::vector<MdlSkinTriangle> parseTriangles(Reader& reader, size_t count)
 {
-  auto triangles = std::vector<MdlSkinTriangle>{};
-  triangles.reserve(count);
-
-  for (size_t i = 0; i < count; ++i)
-  {
-    const auto front = reader.readBool<int32_t>();
-    const auto v1 = reader.readSize<int32_t>();
-    const auto v2 = reader.readSize<int32_t>();
-    const auto v3 = reader.readSize<int32_t>();
-    triangles.push_back(MdlSkinTriangle{front, {v1, v2, v3}});
-  }
-  return triangles;
+  return kdl::vec_transform(reader.readVecArray<int32_t, 4>(count), [](const auto& t) {
+    return MdlSkinTriangle{t[0] != 0, {size_t(t[1]), size_t(t[2]), size_t(t[3])}};
+  });
 }
 
 std::vector<MdlSkinVertex> parseVertices(Reader& reader, size_t count)
 {
-  auto vertices = std::vector<MdlSkinVertex>{};
-  vertices.reserve(count);
-
-  for (size_t i = 0; i < count; ++i)
-  {
-    const auto onSeam = reader.readBool<int32_t>();
-    const auto u = reader.readInt<int32_t>();
-    const auto v = reader.readInt<int32_t>();
-    vertices.push_back(MdlSkinVertex{onSeam, u, v});
-  }
-
-  return vertices;
+  return kdl::vec_transform(reader.readVecArray<int32_t, 3>(count), [](const auto& v) {
+    return MdlSkinVertex{v[0] != 0, int(v[1]), int(v[2])};
+  });
 }
 
 mdl::Material parseSkin(
@@ -63,6 +63,16 @@ void NodeSerializer::setExporting(const bool exporting)
   m_exporting = exporting;
 }
 
+bool NodeSerializer::writeObjectNumbers() const
+{
+  return m_writeObjectNumbers;
+}
+
+void NodeSerializer::setWriteObjectNumbers(const bool writeObjectNumbers)
+{
+  m_writeObjectNumbers = writeObjectNumbers;
+}
+
 void NodeSerializer::beginFile(
   const std::vector<const mdl::Node*>& rootNodes, kdl::task_manager& taskManager)
 {
@@ -67,6 +67,7 @@ private:
   ObjectNo m_entityNo = 0;
   ObjectNo m_brushNo = 0;
   bool m_exporting = false;
+  bool m_writeObjectNumbers = true;
 
 public:
   virtual ~NodeSerializer();
@@ -79,6 +80,14 @@ public:
   bool exporting() const;
   void setExporting(bool exporting);
 
+  /**
+   * Controls whether entities and brushes are preceded by comments containing their
+   * numbers. Omitting these comments makes the output for unchanged objects independent of
+   * the objects that precede them.
+   */
+  bool writeObjectNumbers() const;
+  void setWriteObjectNumbers(bool writeObjectNumbers);
+
 public:
   /**
    * Prepares to serialize the given nodes and all of their children.
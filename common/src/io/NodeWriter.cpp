@@ -106,6 +106,11 @@ void NodeWriter::setExporting(const bool exporting)
   m_serializer->setExporting(exporting);
 }
 
+void NodeWriter::setWriteObjectNumbers(const bool writeObjectNumbers)
+{
+  m_serializer->setWriteObjectNumbers(writeObjectNumbers);
+}
+
 void NodeWriter::writeMap(kdl::task_manager& taskManager)
 {
   m_serializer->beginFile({&m_world}, taskManager);
@@ -56,6 +56,7 @@ public:
   ~NodeWriter();
 
   void setExporting(bool exporting);
+  void setWriteObjectNumbers(bool writeObjectNumbers);
   void writeMap(kdl::task_manager& taskManager);
 
 private:
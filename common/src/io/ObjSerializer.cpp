@@ -23,15 +23,25 @@
 #include "io/ExportOptions.h"
 #include "mdl/BrushFace.h"
 #include "mdl/BrushNode.h"
+#include "mdl/EntityNode.h"
+#include "mdl/GroupNode.h"
+#include "mdl/LayerNode.h"
 #include "mdl/Material.h"
 #include "mdl/PatchNode.h"
 #include "mdl/Polyhedron.h"
+#include "mdl/WorldNode.h"
 
 #include "kdl/overload.h"
+#include "kdl/task_manager.h"
+#include "kdl/vector_utils.h"
 
 #include <fmt/format.h>
 
+#include <algorithm>
 #include <iostream>
+#include <map>
+#include <ranges>
+#include <sstream>
 #include <utility>
 
 namespace tb::io
@@ -100,9 +110,197 @@ ObjSerializer::ObjSerializer(
   ensure(m_mtlStream.good(), "mtl stream is good");
 }
 
+namespace
+{
+
+/**
+ * Builds an object with local indices. This only reads the given node, so it can be
+ * called for many nodes in parallel.
+ */
+class LocalObjectBuilder
+{
+private:
+  std::unordered_map<vm::vec3d, size_t, ObjSerializer::VecHash> m_vertexIndices;
+  ObjSerializer::IndexMap<vm::vec2f> m_uvCoords;
+  ObjSerializer::IndexMap<vm::vec3d> m_normals;
+  std::vector<vm::vec3d> m_vertices;
+
+public:
+  ObjSerializer::LocalObject build(const mdl::BrushNode* brushNode)
+  {
+    const auto& brush = brushNode->brush();
+
+    auto brushObject = ObjSerializer::BrushObject{0, 0, {}};
+    brushObject.faces.reserve(brush.faceCount());
+
+    for (const auto& face : brush.faces())
+    {
+      const auto normalIndex = m_normals.index(face.boundary().normal);
+
+      auto indexedVertices = std::vector<ObjSerializer::IndexedVertex>{};
+      indexedVertices.reserve(face.vertexCount());
+
+      for (const auto* vertex : face.vertices())
+      {
+        const auto& position = vertex->position();
+        indexedVertices.push_back(ObjSerializer::IndexedVertex{
+          vertexIndex(position), m_uvCoords.index(face.uvCoords(position)), normalIndex});
+      }
+
+      brushObject.faces.push_back(ObjSerializer::BrushFace{
+        std::move(indexedVertices), face.attributes().materialName(), face.material()});
+    }
+
+    return finish(std::move(brushObject));
+  }
+
+  ObjSerializer::LocalObject build(const mdl::PatchNode* patchNode)
+  {
+    const auto& patch = patchNode->patch();
+    auto patchObject = ObjSerializer::PatchObject{
+      0, 0, {}, patch.materialName(), patch.material()};
+
+    const auto& patchGrid = patchNode->grid();
+    patchObject.quads.reserve(patchGrid.quadRowCount() * patchGrid.quadColumnCount());
+
+    const auto makeIndexedVertex = [&](const auto& p) {
+      return ObjSerializer::IndexedVertex{
+        vertexIndex(p.position),
+        m_uvCoords.index(vm::vec2f{p.uvCoords}),
+        m_normals.index(p.normal)};
+    };
+
+    for (size_t row = 0u; row < patchGrid.pointRowCount - 1u; ++row)
+    {
+      for (size_t col = 0u; col < patchGrid.pointColumnCount - 1u; ++col)
+      {
+        // counter clockwise order
+        patchObject.quads.push_back(ObjSerializer::PatchQuad{{
+          makeIndexedVertex(patchGrid.point(row, col)),
+          makeIndexedVertex(patchGrid.point(row + 1u, col)),
+          makeIndexedVertex(patchGrid.point(row + 1u, col + 1u)),
+          makeIndexedVertex(patchGrid.point(row, col + 1u)),
+        }});
+      }
+    }
+
+    return finish(std::move(patchObject));
+  }
+
+private:
+  size_t vertexIndex(const vm::vec3d& position)
+  {
+    const auto [it, inserted] = m_vertexIndices.emplace(position, m_vertices.size());
+    if (inserted)
+    {
+      m_vertices.push_back(position);
+    }
+    return it->second;
+  }
+
+  ObjSerializer::LocalObject finish(ObjSerializer::Object object)
+  {
+    return {
+      std::move(m_vertices), m_uvCoords.list(), m_normals.list(), std::move(object)};
+  }
+};
+
+template <typename IndexedVertices>
+void remapIndices(
+  IndexedVertices& indexedVertices,
+  const size_t vertexOffset,
+  const std::vector<size_t>& uvCoordsIndices,
+  const std::vector<size_t>& normalIndices)
+{
+  for (auto& indexedVertex : indexedVertices)
+  {
+    indexedVertex.vertex += vertexOffset;
+    indexedVertex.uvCoords = uvCoordsIndices[indexedVertex.uvCoords];
+    indexedVertex.normal = normalIndices[indexedVertex.normal];
+  }
+}
+
+/**
+ * Formats the given elements in chunks on the given task manager and writes the results
+ * to the given stream in order. Only a limited number of chunks is kept in memory.
+ */
+template <typename T, typename F>
+void writeChunked(
+  std::ostream& str,
+  const std::vector<T>& elements,
+  kdl::task_manager& taskManager,
+  const F& writeElement)
+{
+  constexpr auto ChunkSize = size_t(1024);
+  constexpr auto ChunksPerBatch = size_t(64);
+
+  const auto chunkCount = (elements.size() + ChunkSize - 1) / ChunkSize;
+  for (size_t batchStart = 0; batchStart < chunkCount; batchStart += ChunksPerBatch)
+  {
+    const auto batchEnd = std::min(batchStart + ChunksPerBatch, chunkCount);
+    const auto chunks = taskManager.parallel_transform(
+      std::views::iota(batchStart, batchEnd), [&](const size_t chunkIndex) {
+        const auto begin = chunkIndex * ChunkSize;
+        const auto end = std::min(begin + ChunkSize, elements.size());
+
+        auto chunkStr = std::ostringstream{};
+        for (auto i = begin; i < end; ++i)
+        {
+          writeElement(chunkStr, elements[i]);
+        }
+        return std::move(chunkStr).str();
+      });
+
+    for (const auto& chunk : chunks)
+    {
+      str.write(chunk.data(), std::streamsize(chunk.size()));
+    }
+  }
+}
+
+} // namespace
+
 void ObjSerializer::doBeginFile(
-  const std::vector<const mdl::Node*>& /* rootNodes */, kdl::task_manager&)
+  const std::vector<const mdl::Node*>& rootNodes, kdl::task_manager& taskManager)
 {
+  ensure(m_localObjects.empty(), "ObjSerializer may not be reused");
+  m_taskManager = &taskManager;
+
+  auto nodes = std::vector<const mdl::Node*>{};
+  mdl::Node::visitAll(
+    rootNodes,
+    kdl::overload(
+      [](auto&& thisLambda, const mdl::WorldNode* world) {
+        world->visitChildren(thisLambda);
+      },
+      [](auto&& thisLambda, const mdl::LayerNode* layer) {
+        layer->visitChildren(thisLambda);
+      },
+      [](auto&& thisLambda, const mdl::GroupNode* group) {
+        group->visitChildren(thisLambda);
+      },
+      [](auto&& thisLambda, const mdl::EntityNode* entity) {
+        entity->visitChildren(thisLambda);
+      },
+      [&](const mdl::BrushNode* brushNode) { nodes.push_back(brushNode); },
+      [&](const mdl::PatchNode* patchNode) { nodes.push_back(patchNode); }));
+
+  auto localObjects = taskManager.parallel_transform(nodes, [](const mdl::Node* node) {
+    auto builder = LocalObjectBuilder{};
+    return node->accept(kdl::overload(
+      [](const mdl::WorldNode*) -> LocalObject { return {}; },
+      [](const mdl::LayerNode*) -> LocalObject { return {}; },
+      [](const mdl::GroupNode*) -> LocalObject { return {}; },
+      [](const mdl::EntityNode*) -> LocalObject { return {}; },
+      [&](const mdl::BrushNode* brushNode) { return builder.build(brushNode); },
+      [&](const mdl::PatchNode* patchNode) { return builder.build(patchNode); }));
+  });
+
+  m_localObjects.reserve(nodes.size());
+  for (size_t i = 0; i < nodes.size(); ++i)
+  {
+    m_localObjects.emplace(nodes[i], std::move(localObjects[i]));
+  }
 }
 
 static void writeMtlFile(
@@ -153,42 +351,52 @@ static void writeMtlFile(
   }
 }
 
-static void writeVertices(std::ostream& str, const std::vector<vm::vec3d>& vertices)
+static void writeVertices(
+  std::ostream& str,
+  const std::vector<vm::vec3d>& vertices,
+  kdl::task_manager& taskManager)
 {
   str << "# vertices\n";
-  for (const auto& elem : vertices)
-  {
+  writeChunked(str, vertices, taskManager, [](auto& chunkStr, const auto& elem) {
     // no idea why I have to switch Y and Z
     fmt::format_to(
-      std::ostreambuf_iterator<char>(str), "v {} {} {}\n", elem.x(), elem.z(), -elem.y());
-  }
+      std::ostreambuf_iterator<char>(chunkStr),
+      "v {} {} {}\n",
+      elem.x(),
+      elem.z(),
+      -elem.y());
+  });
 }
 
-static void writeUVCoords(std::ostream& str, const std::vector<vm::vec2f>& uvCoords)
+static void writeUVCoords(
+  std::ostream& str,
+  const std::vector<vm::vec2f>& uvCoords,
+  kdl::task_manager& taskManager)
 {
   str << "# texture coordinates\n";
-  for (const auto& elem : uvCoords)
-  {
+  writeChunked(str, uvCoords, taskManager, [](auto& chunkStr, const auto& elem) {
     // multiplying Y by -1 needed to get the UV's to appear correct in Blender and UE4
     // (see: https://github.com/TrenchBroom/TrenchBroom/issues/2851 )
     fmt::format_to(
-      std::ostreambuf_iterator<char>(str), "vt {} {}\n", elem.x(), -elem.y());
-  }
+      std::ostreambuf_iterator<char>(chunkStr), "vt {} {}\n", elem.x(), -elem.y());
+  });
 }
 
-static void writeNormals(std::ostream& str, const std::vector<vm::vec3d>& normals)
+static void writeNormals(
+  std::ostream& str,
+  const std::vector<vm::vec3d>& normals,
+  kdl::task_manager& taskManager)
 {
   str << "# normals\n";
-  for (const auto& elem : normals)
-  {
+  writeChunked(str, normals, taskManager, [](auto& chunkStr, const auto& elem) {
     // no idea why I have to switch Y and Z
     fmt::format_to(
-      std::ostreambuf_iterator<char>(str),
+      std::ostreambuf_iterator<char>(chunkStr),
       "vn {} {} {}\n",
       elem.x(),
       elem.z(),
       -elem.y());
-  }
+  });
 }
 
 static void writeObjFile(
@@ -197,22 +405,22 @@ static void writeObjFile(
   const std::vector<vm::vec3d>& vertices,
   const std::vector<vm::vec2f>& uvCoords,
   const std::vector<vm::vec3d>& normals,
-  const std::vector<ObjSerializer::Object>& objects)
+  const std::vector<ObjSerializer::Object>& objects,
+  kdl::task_manager& taskManager)
 {
 
   str << "mtllib " << mtlFilename << "\n";
-  writeVertices(str, vertices);
+  writeVertices(str, vertices, taskManager);
   str << "\n";
-  writeUVCoords(str, uvCoords);
+  writeUVCoords(str, uvCoords, taskManager);
   str << "\n";
-  writeNormals(str, normals);
+  writeNormals(str, normals, taskManager);
   str << "\n";
 
-  for (const auto& object : objects)
-  {
-    str << object;
-    str << "\n";
-  }
+  writeChunked(str, objects, taskManager, [](auto& chunkStr, const auto& object) {
+    chunkStr << object;
+    chunkStr << "\n";
+  });
 }
 
 void ObjSerializer::doEndFile()
@@ -221,10 +429,11 @@ void ObjSerializer::doEndFile()
   writeObjFile(
     m_objStream,
     m_mtlFilename,
-    m_vertices.list(),
+    m_vertices,
     m_uvCoords.list(),
     m_normals.list(),
-    m_objects);
+    m_objects,
+    *m_taskManager);
 }
 
 void ObjSerializer::doBeginEntity(const mdl::Node*) {}
@@ -233,79 +442,66 @@ void ObjSerializer::doEntityProperty(const mdl::EntityProperty&) {}
 
 void ObjSerializer::doBrush(const mdl::BrushNode* brush)
 {
-  m_currentBrush = BrushObject{entityNo(), brushNo(), {}};
-  m_currentBrush->faces.reserve(brush->brush().faceCount());
-
-  // Vertex positions inserted from now on should get new indices
-  m_vertices.clearIndices();
-
-  for (const auto& face : brush->brush().faces())
-  {
-    doBrushFace(face);
-  }
-
-  m_objects.emplace_back(std::move(*m_currentBrush));
-  m_currentBrush = std::nullopt;
+  addObject(brush, entityNo(), brushNo());
 }
 
-void ObjSerializer::doBrushFace(const mdl::BrushFace& face)
+void ObjSerializer::doBrushFace(const mdl::BrushFace&)
 {
-  const auto& normal = face.boundary().normal;
-  const auto normalIndex = m_normals.index(normal);
-
-  auto indexedVertices = std::vector<IndexedVertex>{};
-  indexedVertices.reserve(face.vertexCount());
-
-  for (const auto* vertex : face.vertices())
-  {
-    const auto& position = vertex->position();
-    const auto uvCoords = face.uvCoords(position);
-
-    const auto vertexIndex = m_vertices.index(position);
-    const auto uvCoordsIndex = m_uvCoords.index(uvCoords);
-
-    indexedVertices.push_back(IndexedVertex{vertexIndex, uvCoordsIndex, normalIndex});
-  }
-
-  m_currentBrush->faces.emplace_back(BrushFace{
-    std::move(indexedVertices), face.attributes().materialName(), face.material()});
+  // brush faces are exported as part of their brushes
 }
 
 void ObjSerializer::doPatch(const mdl::PatchNode* patchNode)
 {
-  const auto& patch = patchNode->patch();
-  auto patchObject =
-    PatchObject{entityNo(), brushNo(), {}, patch.materialName(), patch.material()};
-
-  const auto& patchGrid = patchNode->grid();
-  patchObject.quads.reserve(patchGrid.quadRowCount() * patchGrid.quadColumnCount());
-
-  // Vertex positions inserted from now on should get new indices
-  m_vertices.clearIndices();
-
-  const auto makeIndexedVertex = [&](const auto& p) {
-    const auto positionIndex = m_vertices.index(p.position);
-    const auto uvCoordsIndex = m_uvCoords.index(vm::vec2f{p.uvCoords});
-    const auto normalIndex = m_normals.index(p.normal);
+  addObject(patchNode, entityNo(), brushNo());
+}
 
-    return IndexedVertex{positionIndex, uvCoordsIndex, normalIndex};
-  };
+/**
+ * Adds the given node's precomputed object, translating its local indices to indices
+ * into the file's lists. The UV coordinates and normals are deduplicated across the
+ * entire file, and since the objects are added in file order, the resulting indices are
+ * the same as if the objects had been built one after the other.
+ */
+void ObjSerializer::addObject(
+  const mdl::Node* node, const size_t entityNo, const size_t brushNo)
+{
+  const auto it = m_localObjects.find(node);
+  ensure(
+    it != m_localObjects.end(),
+    "attempted to serialize a node which was not passed to doBeginFile");
+  auto& localObject = it->second;
+
+  const auto vertexOffset = m_vertices.size();
+  m_vertices.insert(
+    m_vertices.end(), localObject.vertices.begin(), localObject.vertices.end());
+
+  const auto uvCoordsIndices = kdl::vec_transform(
+    localObject.uvCoords,
+    [&](const auto& uvCoords) { return m_uvCoords.index(uvCoords); });
+  const auto normalIndices = kdl::vec_transform(
+    localObject.normals, [&](const auto& normal) { return m_normals.index(normal); });
 
-  for (size_t row = 0u; row < patchGrid.pointRowCount - 1u; ++row)
-  {
-    for (size_t col = 0u; col < patchGrid.pointColumnCount - 1u; ++col)
-    {
-      // counter clockwise order
-      patchObject.quads.push_back(PatchQuad{{
-        makeIndexedVertex(patchGrid.point(row, col)),
-        makeIndexedVertex(patchGrid.point(row + 1u, col)),
-        makeIndexedVertex(patchGrid.point(row + 1u, col + 1u)),
-        makeIndexedVertex(patchGrid.point(row, col + 1u)),
-      }});
-    }
-  }
+  std::visit(
+    kdl::overload(
+      [&](BrushObject& brushObject) {
+        brushObject.entityNo = entityNo;
+        brushObject.brushNo = brushNo;
+        for (auto& face : brushObject.faces)
+        {
+          remapIndices(face.verts, vertexOffset, uvCoordsIndices, normalIndices);
+        }
+      },
+      [&](PatchObject& patchObject) {
+        patchObject.entityNo = entityNo;
+        patchObject.patchNo = brushNo;
+        for (auto& quad : patchObject.quads)
+        {
+          remapIndices(quad.verts, vertexOffset, uvCoordsIndices, normalIndices);
+        }
+      }),
+    localObject.object);
 
-  m_objects.emplace_back(std::move(patchObject));
+  m_objects.push_back(std::move(localObject.object));
+  m_localObjects.erase(it);
 }
 
 } // namespace tb::io
@@ -25,10 +25,11 @@
 #include "vm/vec.h"
 
 #include <array>
+#include <cstddef>
+#include <functional>
 #include <iosfwd>
-#include <map>
-#include <optional>
 #include <string>
+#include <unordered_map>
 #include <variant>
 #include <vector>
 
@@ -47,11 +48,29 @@ namespace tb::io
 class ObjSerializer : public NodeSerializer
 {
 public:
+  /**
+   * Hashes vectors such that vectors that compare equal have equal hashes.
+   */
+  struct VecHash
+  {
+    template <typename T, std::size_t S>
+    std::size_t operator()(const vm::vec<T, S>& v) const
+    {
+      auto result = std::size_t(0);
+      for (std::size_t i = 0; i < S; ++i)
+      {
+        // adding zero maps -0 to +0, which compare equal
+        result = result * 31u + std::hash<T>{}(v[i] + T(0));
+      }
+      return result;
+    }
+  };
+
   template <typename V>
   class IndexMap
   {
   private:
-    std::map<V, size_t> m_map;
+    std::unordered_map<V, size_t, VecHash> m_map;
     std::vector<V> m_list;
 
   public:
@@ -67,12 +86,6 @@ public:
       }
       return index;
     }
-
-    /**
-     * Values inserted after this is called will not reuse indices from before this
-     * is called.
-     */
-    void clearIndices() { m_map.clear(); }
   };
 
   struct IndexedVertex
@@ -112,6 +125,19 @@ public:
 
   using Object = std::variant<BrushObject, PatchObject>;
 
+  /**
+   * An object whose indices refer to its own vertex, UV coordinate and normal lists.
+   * These lists contain each value once, in the order in which they first occur in the
+   * object.
+   */
+  struct LocalObject
+  {
+    std::vector<vm::vec3d> vertices;
+    std::vector<vm::vec2f> uvCoords;
+    std::vector<vm::vec3d> normals;
+    Object object;
+  };
+
   friend std::ostream& operator<<(std::ostream& str, const IndexedVertex& vertex);
   friend std::ostream& operator<<(std::ostream& str, const BrushFace& face);
   friend std::ostream& operator<<(std::ostream& str, const BrushObject& object);
@@ -125,11 +151,14 @@ private:
   std::string m_mtlFilename;
   ObjExportOptions m_options;
 
-  IndexMap<vm::vec3d> m_vertices;
+  kdl::task_manager* m_taskManager = nullptr;
+  std::unordered_map<const mdl::Node*, LocalObject> m_localObjects;
+
+  // Vertices are not shared between objects
+  std::vector<vm::vec3d> m_vertices;
   IndexMap<vm::vec2f> m_uvCoords;
   IndexMap<vm::vec3d> m_normals;
 
-  std::optional<BrushObject> m_currentBrush;
   std::vector<Object> m_objects;
 
 public:
@@ -153,6 +182,8 @@ private:
   void doBrushFace(const mdl::BrushFace& face) override;
 
   void doPatch(const mdl::PatchNode* patchNode) override;
+
+  void addObject(const mdl::Node* node, size_t entityNo, size_t brushNo);
 };
 
 } // namespace tb::io
@@ -26,6 +26,7 @@
 #include "io/Reader.h"
 #include "mdl/Texture.h"
 #include "mdl/TextureBuffer.h"
+#include "mdl/TextureStatistics.h"
 
 #include "kdl/path_utils.h"
 #include "kdl/resource.h"
@@ -82,23 +83,14 @@ Color getAverageColor(const mdl::TextureBuffer& buffer, const GLenum format)
   const auto b = size_t(format == GL_RGBA ? 2 : 0);
   const auto a = size_t(3);
 
-  const auto* const data = buffer.data();
-  const auto bufferSize = buffer.size();
-  const auto numPixels = bufferSize / 4;
+  const auto statistics = mdl::computeTextureStatistics({buffer.data(), buffer.size()});
+  const auto numPixels = float(buffer.size() / 4);
 
-  const auto stride = numPixels <= 4192 ? 1 : numPixels / 64;
-  const auto numSamples = numPixels / stride;
-
-  auto average = Color{};
-  for (std::size_t i = 0; i < numSamples; ++i)
-  {
-    const auto pixel = i * 4 * stride;
-    average =
-      average + Color{data[pixel + r], data[pixel + g], data[pixel + b], data[pixel + a]};
-  }
-  average = average / static_cast<float>(numSamples);
-
-  return average;
+  return Color{
+    float(statistics.channelSums[r]) / (255.0f * numPixels),
+    float(statistics.channelSums[g]) / (255.0f * numPixels),
+    float(statistics.channelSums[b]) / (255.0f * numPixels),
+    float(statistics.channelSums[a]) / (255.0f * numPixels)};
 }
 
 Result<mdl::Texture> readFreeImageTextureFromMemory(
@@ -87,6 +87,12 @@ public:
    * @throw ReaderException if reading fails
    */
   virtual std::shared_ptr<BufferReaderSource> buffer() const = 0;
+
+  /**
+   * Returns a pointer to the contents of this reader source if they are held in memory,
+   * and nullptr otherwise.
+   */
+  virtual const char* memory() const { return nullptr; }
 };
 
 /**
@@ -147,6 +153,8 @@ public:
   {
     return std::make_shared<BufferReaderSource>(m_begin, m_end);
   }
+
+  const char* memory() const override { return m_begin; }
 };
 
 class OwningBufferReaderSource : public BufferReaderSource
@@ -328,6 +336,22 @@ void Reader::read(char* val, const size_t size)
   m_position += size;
 }
 
+std::span<const unsigned char> Reader::readBytes(const size_t size)
+{
+  ensurePosition(position() + size);
+
+  if (const auto* memory = m_source->memory())
+  {
+    const auto* begin = reinterpret_cast<const unsigned char*>(memory + position());
+    m_position += size;
+    return {begin, size};
+  }
+
+  m_bytes.resize(size);
+  read(m_bytes.data(), size);
+  return m_bytes;
+}
+
 std::string Reader::readString(const size_t size)
 {
   auto buffer = std::vector<char>(size + 1, 0);
@@ -22,9 +22,12 @@
 #include "vm/vec.h"
 
 #include <cstdio>
+#include <cstring>
 #include <memory>
+#include <span>
 #include <string>
 #include <string_view>
+#include <vector>
 
 namespace tb::io
 {
@@ -44,6 +47,9 @@ protected:
   std::shared_ptr<ReaderSource> m_source;
   size_t m_position;
 
+  // holds the bytes returned by readBytes if the source is not held in memory
+  std::vector<unsigned char> m_bytes;
+
 protected:
   /**
    * Creates a new reader using the given reader source.
@@ -204,6 +210,77 @@ public:
    */
   void read(char* val, size_t size);
 
+  /**
+   * Reads the given number of bytes and returns a view of them.
+   *
+   * If the underlying source is held in memory, the returned view points directly into
+   * it and no data is copied. Otherwise, the bytes are copied into a buffer owned by this
+   * reader. The view is valid until readBytes is called again or this reader is
+   * destroyed.
+   *
+   * @param size the number of bytes to read
+   * @return a view of the bytes
+   *
+   * @throw ReaderException if reading fails
+   */
+  std::span<const unsigned char> readBytes(size_t size);
+
+  /**
+   * Reads the given number of values of type T, converts them to the given type R and
+   * returns them. The values are decoded from a single view returned by readBytes.
+   *
+   * @tparam T the type of the values to read
+   * @tparam R the type of the values to convert to
+   * @param count the number of values to read
+   * @return the values
+   *
+   * @throw ReaderException if reading fails
+   */
+  template <typename T, typename R = T>
+  std::vector<R> readArray(const size_t count)
+  {
+    const auto bytes = readBytes(count * sizeof(T));
+
+    auto result = std::vector<R>{};
+    result.reserve(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+      result.push_back(static_cast<R>(decode<T>(bytes.data() + i * sizeof(T))));
+    }
+    return result;
+  }
+
+  /**
+   * Reads the given number of records that consist of S values of type T each, and
+   * returns them as vectors of the given type R. The records are decoded from a single
+   * view returned by readBytes.
+   *
+   * @tparam T the type of the values to read
+   * @tparam S the number of values per record
+   * @tparam R the type of the vector components to convert to
+   * @param count the number of records to read
+   * @return the records
+   *
+   * @throw ReaderException if reading fails
+   */
+  template <typename T, size_t S, typename R = T>
+  std::vector<vm::vec<R, S>> readVecArray(const size_t count)
+  {
+    const auto bytes = readBytes(count * S * sizeof(T));
+
+    auto result = std::vector<vm::vec<R, S>>{};
+    result.reserve(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+      auto& vec = result.emplace_back();
+      for (size_t j = 0; j < S; ++j)
+      {
+        vec[j] = static_cast<R>(decode<T>(bytes.data() + (i * S + j) * sizeof(T)));
+      }
+    }
+    return result;
+  }
+
   /**
    * Reads a value of the given type T, converts it into a value of the given type R and
    * returns that.
@@ -396,6 +473,16 @@ public:
 
 protected:
   void ensurePosition(size_t position) const;
+
+private:
+  template <typename T>
+  static T decode(const unsigned char* bytes)
+  {
+    // like read, this assumes that the data has the same byte order as the host
+    T result;
+    std::memcpy(&result, bytes, sizeof(T));
+    return result;
+  }
 };
 
 /**
@@ -61,8 +61,9 @@ const std::string& QuakeMapTokenizer::NumberDelim()
   return numberDelim;
 }
 
-QuakeMapTokenizer::QuakeMapTokenizer(const std::string_view str)
-  : Tokenizer{tokenNames(), str, "\"", '\\'}
+QuakeMapTokenizer::QuakeMapTokenizer(
+  const std::string_view str, const size_t line, const size_t column)
+  : Tokenizer{tokenNames(), str, "\"", '\\', line, column}
 {
 }
 
@@ -183,6 +184,20 @@ StandardMapParser::StandardMapParser(
   assert(targetMapFormat != mdl::MapFormat::Unknown);
 }
 
+StandardMapParser::StandardMapParser(
+  const std::string_view str,
+  const size_t line,
+  const size_t column,
+  const mdl::MapFormat sourceMapFormat,
+  const mdl::MapFormat targetMapFormat)
+  : m_tokenizer{str, line, column}
+  , m_sourceMapFormat{sourceMapFormat}
+  , m_targetMapFormat{targetMapFormat}
+{
+  assert(m_sourceMapFormat != mdl::MapFormat::Unknown);
+  assert(targetMapFormat != mdl::MapFormat::Unknown);
+}
+
 StandardMapParser::~StandardMapParser() = default;
 
 Result<void> StandardMapParser::parseEntities(ParserStatus& status)
@@ -240,6 +255,43 @@ Result<void> StandardMapParser::parseBrushFaces(ParserStatus& status)
   }
 }
 
+Result<void> StandardMapParser::parseEntityHeader(ParserStatus& status)
+{
+  try
+  {
+    const auto token = m_tokenizer.skipAndNextToken(
+      QuakeMapToken::Comment, QuakeMapToken::OBrace);
+    const auto startLocation = token.location();
+
+    auto properties = std::vector<mdl::EntityProperty>();
+    auto propertyKeys = EntityPropertyKeys();
+    parseEntityProperties(properties, propertyKeys, status);
+
+    onBeginEntity(startLocation, properties, status);
+
+    return kdl::void_success;
+  }
+  catch (const ParserException& e)
+  {
+    return Error{e.what()};
+  }
+}
+
+Result<void> StandardMapParser::parseEntityObjects(ParserStatus& status)
+{
+  try
+  {
+    parseObjects(status);
+    m_tokenizer.skipAndNextToken(QuakeMapToken::Comment, QuakeMapToken::Eof);
+
+    return kdl::void_success;
+  }
+  catch (const ParserException& e)
+  {
+    return Error{e.what()};
+  }
+}
+
 void StandardMapParser::reset()
 {
   m_tokenizer.reset();
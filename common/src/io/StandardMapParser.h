@@ -67,7 +67,7 @@ private:
   bool m_skipEol = true;
 
 public:
-  explicit QuakeMapTokenizer(std::string_view str);
+  explicit QuakeMapTokenizer(std::string_view str, size_t line = 1, size_t column = 1);
 
   void setSkipEol(bool skipEol);
 
@@ -102,6 +102,24 @@ public:
   StandardMapParser(
     std::string_view str, mdl::MapFormat sourceMapFormat, mdl::MapFormat targetMapFormat);
 
+  /**
+   * Creates a new parser for a part of a larger string. The given line and column
+   * indicate where the part starts in the larger string so that the locations reported
+   * by the parser refer to the larger string.
+   *
+   * @param str the string to parse
+   * @param line the line at which the given string starts
+   * @param column the column at which the given string starts
+   * @param sourceMapFormat the expected format of the given string
+   * @param targetMapFormat the format to convert the created objects to
+   */
+  StandardMapParser(
+    std::string_view str,
+    size_t line,
+    size_t column,
+    mdl::MapFormat sourceMapFormat,
+    mdl::MapFormat targetMapFormat);
+
   ~StandardMapParser() override;
 
 protected:
@@ -109,6 +127,18 @@ protected:
   Result<void> parseBrushesOrPatches(ParserStatus& status);
   Result<void> parseBrushFaces(ParserStatus& status);
 
+  /**
+   * Parses the opening brace and the properties of a single entity, but neither its
+   * objects nor its closing brace. The remainder of the string is ignored.
+   */
+  Result<void> parseEntityHeader(ParserStatus& status);
+
+  /**
+   * Parses the brushes and patches of an entity, but not its opening or closing brace.
+   * Expects that the entire string is consumed.
+   */
+  Result<void> parseEntityObjects(ParserStatus& status);
+
   void reset();
 
 private:
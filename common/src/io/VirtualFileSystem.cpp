@@ -31,6 +31,7 @@
 #include <fmt/format.h>
 #include <fmt/std.h>
 
+#include <algorithm>
 #include <optional>
 #include <unordered_map>
 
@@ -59,6 +60,28 @@ std::filesystem::path suffix(
   return kdl::path_clip(path, kdl::path_length(mountPoint.path));
 }
 
+/**
+ * Records every path of the given file system in the given index. Returns false if the
+ * paths of the file system could not be listed.
+ */
+bool addToIndex(
+  VirtualPathIndex& index,
+  const size_t mountPointId,
+  const std::filesystem::path& mountPointPath,
+  const FileSystem& fs)
+{
+  return fs.find(std::filesystem::path{}, TraversalMode::Recursive)
+         | kdl::transform([&](const auto& paths) {
+             index.add(mountPointId, mountPointPath, PathInfo::Directory);
+             for (const auto& path : paths)
+             {
+               index.add(mountPointId, mountPointPath / path, fs.pathInfo(path));
+             }
+             return true;
+           })
+         | kdl::value_or(false);
+}
+
 } // namespace
 
 VirtualMountPointId::VirtualMountPointId()
@@ -79,19 +102,14 @@ bool operator!=(const VirtualMountPointId& lhs, const VirtualMountPointId& rhs)
 Result<std::filesystem::path> VirtualFileSystem::makeAbsolute(
   const std::filesystem::path& path) const
 {
-  for (auto it = m_mountPoints.rbegin(); it != m_mountPoints.rend(); ++it)
+  if (const auto match = findMountPoint(path))
   {
-    const auto& mountPoint = *it;
-    if (matches(mountPoint, path))
+    const auto& mountPoint = *match->mountPoint;
+    const auto pathSuffix = suffix(mountPoint, path);
+    if (auto absPath = mountPoint.mountedFileSystem->makeAbsolute(pathSuffix);
+        absPath.is_success())
     {
-      const auto pathSuffix = suffix(mountPoint, path);
-      const auto absPath = mountPoint.mountedFileSystem->makeAbsolute(pathSuffix);
-      if (
-        absPath.is_success()
-        && mountPoint.mountedFileSystem->pathInfo(pathSuffix) != PathInfo::Unknown)
-      {
-        return absPath;
-      }
+      return absPath;
     }
   }
 
@@ -100,27 +118,20 @@ Result<std::filesystem::path> VirtualFileSystem::makeAbsolute(
 
 PathInfo VirtualFileSystem::pathInfo(const std::filesystem::path& path) const
 {
-  for (auto it = m_mountPoints.rbegin(); it != m_mountPoints.rend(); ++it)
+  if (const auto match = findMountPoint(path))
   {
-    const auto& mountPoint = *it;
-    if (matches(mountPoint, path))
-    {
-      const auto pathSuffix = suffix(mountPoint, path);
-      if (const auto pathInfo = mountPoint.mountedFileSystem->pathInfo(pathSuffix);
-          pathInfo != PathInfo::Unknown)
-      {
-        return pathInfo;
-      }
-    }
+    return match->pathInfo;
   }
 
-  return std::any_of(
-           m_mountPoints.rbegin(),
-           m_mountPoints.rend(),
-           [&](const auto& mountPoint) {
-             return kdl::path_has_prefix(
-               kdl::path_to_lower(mountPoint.path), kdl::path_to_lower(path));
-           })
+  return m_index.contains(path)
+             || std::any_of(
+               m_mountPoints.rbegin(),
+               m_mountPoints.rend(),
+               [&](const auto& mountPoint) {
+                 return !mountPoint.indexed
+                        && kdl::path_has_prefix(
+                          kdl::path_to_lower(mountPoint.path), kdl::path_to_lower(path));
+               })
            ? PathInfo::Directory
            : PathInfo::Unknown;
 }
@@ -128,18 +139,10 @@ PathInfo VirtualFileSystem::pathInfo(const std::filesystem::path& path) const
 const FileSystemMetadata* VirtualFileSystem::metadata(
   const std::filesystem::path& path, const std::string& key) const
 {
-  for (auto it = m_mountPoints.rbegin(); it != m_mountPoints.rend(); ++it)
+  if (const auto match = findMountPoint(path))
   {
-    const auto& mountPoint = *it;
-    if (matches(mountPoint, path))
-    {
-      const auto pathSuffix = suffix(mountPoint, path);
-      if (const auto pathInfo = mountPoint.mountedFileSystem->pathInfo(pathSuffix);
-          pathInfo != PathInfo::Unknown)
-      {
-        return mountPoint.mountedFileSystem->metadata(pathSuffix, key);
-      }
-    }
+    const auto& mountPoint = *match->mountPoint;
+    return mountPoint.mountedFileSystem->metadata(suffix(mountPoint, path), key);
   }
 
   return nullptr;
@@ -149,7 +152,8 @@ VirtualMountPointId VirtualFileSystem::mount(
   const std::filesystem::path& path, std::unique_ptr<FileSystem> fs)
 {
   const auto id = VirtualMountPointId{};
-  m_mountPoints.push_back({id, path, std::move(fs)});
+  const auto indexed = fs->isImmutable() && addToIndex(m_index, id.m_id, path, *fs);
+  m_mountPoints.push_back({id, path, std::move(fs), indexed});
   return id;
 }
 
@@ -161,6 +165,10 @@ bool VirtualFileSystem::unmount(const VirtualMountPointId& id)
         [&](const auto& mountPoint) { return mountPoint.id == id; });
       it != m_mountPoints.end())
   {
+    if (it->indexed)
+    {
+      m_index.remove(id.m_id);
+    }
     m_mountPoints.erase(it);
     return true;
   }
@@ -170,6 +178,7 @@ bool VirtualFileSystem::unmount(const VirtualMountPointId& id)
 void VirtualFileSystem::unmountAll()
 {
   m_mountPoints.clear();
+  m_index.clear();
 }
 
 namespace
@@ -253,46 +262,55 @@ Result<std::vector<std::filesystem::path>> findMatchesForMountedFileSystem(
 Result<std::vector<std::filesystem::path>> VirtualFileSystem::doFind(
   const std::filesystem::path& path, const TraversalMode& traversalMode) const
 {
+  auto mountPointsToSearch = std::vector<const VirtualMountPoint*>{};
+  for (const auto& mountPoint : m_mountPoints)
+  {
+    if (!mountPoint.indexed)
+    {
+      mountPointsToSearch.push_back(&mountPoint);
+    }
+  }
+
   return kdl::vec_transform(
-           m_mountPoints,
-           [&](const auto& mountPoint) {
-             return findMatchesForMountedFileSystem(mountPoint, path, traversalMode);
+           mountPointsToSearch,
+           [&](const auto* mountPoint) {
+             return findMatchesForMountedFileSystem(*mountPoint, path, traversalMode)
+                    | kdl::transform([&](auto paths) {
+                        const auto mountPointId = mountPoint->id.m_id;
+                        return kdl::vec_transform(std::move(paths), [&](auto p) {
+                          return VirtualPathIndex::Match{mountPointId, std::move(p)};
+                        });
+                      });
            })
-         | kdl::fold | kdl::transform([](auto nestedPaths) {
-             if (nestedPaths.empty())
-             {
-               return std::vector<std::filesystem::path>{};
-             }
-             if (nestedPaths.size() == 1)
+         | kdl::fold | kdl::transform([&](auto nestedMatches) {
+             auto allMatches = m_index.find(path, traversalMode);
+             for (auto& matchesOfMountPoint : nestedMatches)
              {
-               return std::move(nestedPaths.front());
+               allMatches = kdl::vec_concat(
+                 std::move(allMatches), std::move(matchesOfMountPoint));
              }
 
-             auto result = std::vector<std::filesystem::path>{};
-             auto lastOccurrence = std::unordered_map<std::string, size_t>{};
+             // order the matches by mount point and only keep the last occurrence of
+             // each path
+             std::ranges::stable_sort(allMatches, std::less{}, [](const auto& match) {
+               return match.mountPointId;
+             });
 
-             for (size_t i = 0; i < nestedPaths.size(); ++i)
+             auto lastOccurrence = std::unordered_map<std::string, size_t>{};
+             for (size_t i = 0; i < allMatches.size(); ++i)
              {
-               const auto& paths = nestedPaths[i];
-               for (const auto& p : paths)
-               {
-                 lastOccurrence[p.generic_string()] = i;
-               }
+               lastOccurrence[allMatches[i].path.generic_string()] = i;
              }
 
-             for (size_t i = 0; i < nestedPaths.size(); ++i)
+             auto result = std::vector<std::filesystem::path>{};
+             for (size_t i = 0; i < allMatches.size(); ++i)
              {
-               auto& paths = nestedPaths[i];
-               for (auto& p : paths)
+               if (lastOccurrence[allMatches[i].path.generic_string()] == i)
                {
-                 if (lastOccurrence[p.generic_string()] == i)
-                 {
-                   result.push_back(std::move(p));
-                 }
+                 result.push_back(std::move(allMatches[i].path));
                }
              }
 
-
              return result;
            });
 }
@@ -300,20 +318,51 @@ Result<std::vector<std::filesystem::path>> VirtualFileSystem::doFind(
 Result<std::shared_ptr<File>> VirtualFileSystem::doOpenFile(
   const std::filesystem::path& path) const
 {
-  for (auto it = m_mountPoints.rbegin(); it != m_mountPoints.rend(); ++it)
+  if (const auto match = findMountPoint(path))
+  {
+    const auto& mountPoint = *match->mountPoint;
+    return mountPoint.mountedFileSystem->openFile(suffix(mountPoint, path));
+  }
+
+  return Error{fmt::format("{} not found", path)};
+}
+
+std::optional<VirtualFileSystem::MountPointMatch> VirtualFileSystem::findMountPoint(
+  const std::filesystem::path& path) const
+{
+  // The index yields the indexed mount point that takes precedence, but the mount points
+  // that are not indexed and were mounted after it must still be asked.
+  const auto* entry = m_index.find(path);
+  const auto indexedMountPointId = entry ? entry->mountPointId : size_t(0);
+
+  for (auto it = m_mountPoints.rbegin();
+       it != m_mountPoints.rend() && it->id.m_id > indexedMountPointId;
+       ++it)
   {
     const auto& mountPoint = *it;
-    if (matches(mountPoint, path))
+    if (!mountPoint.indexed && matches(mountPoint, path))
     {
-      const auto pathSuffix = suffix(mountPoint, path);
-      if (mountPoint.mountedFileSystem->pathInfo(pathSuffix) != PathInfo::Unknown)
+      if (const auto pathInfo =
+            mountPoint.mountedFileSystem->pathInfo(suffix(mountPoint, path));
+          pathInfo != PathInfo::Unknown)
       {
-        return mountPoint.mountedFileSystem->openFile(pathSuffix);
+        return MountPointMatch{&mountPoint, pathInfo};
       }
     }
   }
 
-  return Error{fmt::format("{} not found", path)};
+  if (entry)
+  {
+    // mount points are ordered by their IDs
+    const auto it = std::ranges::lower_bound(
+      m_mountPoints, entry->mountPointId, std::less{}, [](const auto& mountPoint) {
+        return mountPoint.id.m_id;
+      });
+    assert(it != m_mountPoints.end() && it->id.m_id == entry->mountPointId);
+    return MountPointMatch{&*it, entry->pathInfo};
+  }
+
+  return std::nullopt;
 }
 
 WritableVirtualFileSystem::WritableVirtualFileSystem(
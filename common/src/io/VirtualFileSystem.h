@@ -21,9 +21,11 @@
 
 #include "Result.h"
 #include "io/FileSystem.h"
+#include "io/VirtualPathIndex.h"
 
 #include <filesystem>
 #include <memory>
+#include <optional>
 #include <vector>
 
 namespace tb::io
@@ -48,12 +50,28 @@ struct VirtualMountPoint
   VirtualMountPointId id;
   std::filesystem::path path;
   std::unique_ptr<FileSystem> mountedFileSystem;
+  bool indexed = false;
 };
 
+/**
+ * Combines several mounted file systems into one. If more than one mounted file system
+ * contains a path, the one that was mounted last takes precedence.
+ *
+ * The paths of immutable file systems are recorded in an index when they are mounted, so
+ * lookups don't have to ask each of them in turn. Other file systems are asked on every
+ * lookup.
+ */
 class VirtualFileSystem : public FileSystem
 {
 private:
   std::vector<VirtualMountPoint> m_mountPoints;
+  VirtualPathIndex m_index;
+
+  struct MountPointMatch
+  {
+    const VirtualMountPoint* mountPoint;
+    PathInfo pathInfo;
+  };
 
 public:
   Result<std::filesystem::path> makeAbsolute(
@@ -72,6 +90,13 @@ protected:
     const std::filesystem::path& path, const TraversalMode& traversalMode) const override;
   Result<std::shared_ptr<File>> doOpenFile(
     const std::filesystem::path& path) const override;
+
+private:
+  /**
+   * Returns the mount point that takes precedence for the given path, or nothing if no
+   * mounted file system contains the given path.
+   */
+  std::optional<MountPointMatch> findMountPoint(const std::filesystem::path& path) const;
 };
 
 class WritableVirtualFileSystem : public WritableFileSystem
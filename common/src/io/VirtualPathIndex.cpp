@@ -0,0 +1,211 @@
+/*
+ Copyright (C) 2010 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "VirtualPathIndex.h"
+
+#include "io/PathInfo.h"
+#include "io/TraversalMode.h"
+
+#include "kdl/string_format.h"
+
+#include <algorithm>
+#include <set>
+#include <utility>
+
+namespace tb::io
+{
+namespace
+{
+
+template <typename Node>
+const std::string& displayName(const Node& node)
+{
+  return node.entries.empty() ? node.name : node.entries.back().name;
+}
+
+template <typename Node>
+size_t depth(const Node* node)
+{
+  auto result = size_t(0);
+  for (; node->parent; node = node->parent)
+  {
+    ++result;
+  }
+  return result;
+}
+
+template <typename Node>
+void findImpl(
+  const Node& node,
+  const std::filesystem::path& nodePath,
+  const size_t depth,
+  const TraversalMode& traversalMode,
+  std::vector<VirtualPathIndex::Match>& result)
+{
+  if (!traversalMode.depth || depth <= *traversalMode.depth)
+  {
+    for (const auto& [key, child] : node.children)
+    {
+      const auto childPath = nodePath / displayName(*child);
+      const auto mountPointId =
+        child->entries.empty() ? size_t(0) : child->entries.back().mountPointId;
+
+      result.push_back({mountPointId, childPath});
+      findImpl(*child, childPath, depth + 1, traversalMode, result);
+    }
+  }
+}
+
+} // namespace
+
+VirtualPathIndex::VirtualPathIndex()
+  : m_root{std::make_unique<Node>()}
+{
+}
+
+void VirtualPathIndex::add(
+  const size_t mountPointId, const std::filesystem::path& path, const PathInfo pathInfo)
+{
+  auto* node = m_root.get();
+  auto name = std::string{};
+  for (const auto& component : path)
+  {
+    name = component.string();
+    if (name.empty())
+    {
+      continue;
+    }
+
+    auto key = kdl::str_to_lower(name);
+    auto& child = node->children[key];
+    if (!child)
+    {
+      child = std::make_unique<Node>(Node{node, std::move(key), name, {}, {}});
+    }
+    node = child.get();
+  }
+
+  const auto it = std::ranges::lower_bound(
+    node->entries, mountPointId, std::less{}, &Entry::mountPointId);
+  if (it == node->entries.end() || it->mountPointId != mountPointId)
+  {
+    node->entries.insert(it, Entry{mountPointId, pathInfo, std::move(name)});
+    m_nodesByMountPoint[mountPointId].push_back(node);
+  }
+}
+
+void VirtualPathIndex::remove(const size_t mountPointId)
+{
+  const auto it = m_nodesByMountPoint.find(mountPointId);
+  if (it == m_nodesByMountPoint.end())
+  {
+    return;
+  }
+
+  // Remove the entries first, then prune the nodes that became empty from the deepest
+  // node upwards, so that no node is visited after it was pruned.
+  auto nodesToPrune = std::set<std::pair<size_t, Node*>>{};
+  for (auto* node : it->second)
+  {
+    std::erase_if(node->entries, [&](const auto& entry) {
+      return entry.mountPointId == mountPointId;
+    });
+    nodesToPrune.emplace(depth(node), node);
+  }
+  m_nodesByMountPoint.erase(it);
+
+  while (!nodesToPrune.empty())
+  {
+    const auto [nodeDepth, node] = *std::prev(nodesToPrune.end());
+    nodesToPrune.erase(std::prev(nodesToPrune.end()));
+
+    if (node->parent && node->entries.empty() && node->children.empty())
+    {
+      auto* parent = node->parent;
+      parent->children.erase(node->key);
+      nodesToPrune.emplace(nodeDepth - 1, parent);
+    }
+  }
+}
+
+void VirtualPathIndex::clear()
+{
+  m_root = std::make_unique<Node>();
+  m_nodesByMountPoint.clear();
+}
+
+const VirtualPathIndex::Entry* VirtualPathIndex::find(
+  const std::filesystem::path& path) const
+{
+  const auto* node = findNode(path);
+  return node && !node->entries.empty() ? &node->entries.back() : nullptr;
+}
+
+bool VirtualPathIndex::contains(const std::filesystem::path& path) const
+{
+  const auto* node = findNode(path);
+  return node && (!node->entries.empty() || !node->children.empty());
+}
+
+std::vector<VirtualPathIndex::Match> VirtualPathIndex::find(
+  const std::filesystem::path& path, const TraversalMode& traversalMode) const
+{
+  auto result = std::vector<Match>{};
+  if (const auto* node = findNode(path))
+  {
+    auto names = std::vector<std::string>{};
+    for (const auto* n = node; n->parent; n = n->parent)
+    {
+      names.push_back(displayName(*n));
+    }
+
+    auto nodePath = std::filesystem::path{};
+    for (auto it = names.rbegin(); it != names.rend(); ++it)
+    {
+      nodePath /= *it;
+    }
+
+    findImpl(*node, nodePath, 0, traversalMode, result);
+  }
+  return result;
+}
+
+const VirtualPathIndex::Node* VirtualPathIndex::findNode(
+  const std::filesystem::path& path) const
+{
+  const auto* node = m_root.get();
+  for (const auto& component : path)
+  {
+    const auto name = component.string();
+    if (name.empty())
+    {
+      continue;
+    }
+
+    const auto it = node->children.find(kdl::str_to_lower(name));
+    if (it == node->children.end())
+    {
+      return nullptr;
+    }
+    node = it->second.get();
+  }
+  return node;
+}
+
+} // namespace tb::io
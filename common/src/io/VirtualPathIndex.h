@@ -0,0 +1,113 @@
+/*
+ Copyright (C) 2010 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace tb::io
+{
+enum class PathInfo;
+struct TraversalMode;
+
+/**
+ * A case insensitive trie of the paths of the file systems mounted in a virtual file
+ * system. Every path records the mount points that contain it, so the mount point that
+ * takes precedence for a path is found with a single lookup.
+ *
+ * Mount points are identified by their IDs. A mount point with a greater ID takes
+ * precedence over a mount point with a smaller ID.
+ */
+class VirtualPathIndex
+{
+public:
+  struct Entry
+  {
+    size_t mountPointId;
+    PathInfo pathInfo;
+    std::string name;
+  };
+
+  struct Match
+  {
+    size_t mountPointId;
+    std::filesystem::path path;
+  };
+
+private:
+  struct Node
+  {
+    Node* parent = nullptr;
+    std::string key;
+    std::string name;
+    std::map<std::string, std::unique_ptr<Node>> children;
+
+    /** Sorted by ascending mount point ID. */
+    std::vector<Entry> entries;
+  };
+
+  std::unique_ptr<Node> m_root;
+  std::unordered_map<size_t, std::vector<Node*>> m_nodesByMountPoint;
+
+public:
+  VirtualPathIndex();
+
+  /**
+   * Records that the mount point with the given ID contains the given path. The parent
+   * directories of the given path are not recorded implicitly.
+   */
+  void add(size_t mountPointId, const std::filesystem::path& path, PathInfo pathInfo);
+
+  /**
+   * Removes every path that was recorded for the mount point with the given ID.
+   */
+  void remove(size_t mountPointId);
+
+  void clear();
+
+  /**
+   * Returns the entry of the mount point that takes precedence for the given path, or
+   * null if no mount point contains the given path.
+   */
+  const Entry* find(const std::filesystem::path& path) const;
+
+  /**
+   * Indicates whether the given path was recorded for any mount point, or whether it is a
+   * parent directory of such a path.
+   */
+  bool contains(const std::filesystem::path& path) const;
+
+  /**
+   * Returns the paths below the given path, each with the ID of the mount point that
+   * takes precedence for it. The spelling of every path component is taken from that
+   * mount point. Parent directories that were not recorded for any mount point have ID 0.
+   */
+  std::vector<Match> find(
+    const std::filesystem::path& path, const TraversalMode& traversalMode) const;
+
+private:
+  const Node* findNode(const std::filesystem::path& path) const;
+};
+
+} // namespace tb::io
@@ -173,13 +173,27 @@ void setLinkIds(mdl::WorldNode& worldNode, ParserStatus& status)
 Result<std::unique_ptr<mdl::WorldNode>> WorldReader::read(
   const vm::bbox3d& worldBounds, ParserStatus& status, kdl::task_manager& taskManager)
 {
-  return readEntities(worldBounds, status, taskManager) | kdl::transform([&]() {
-           sanitizeLayerSortIndicies(*m_worldNode, status);
-           setLinkIds(*m_worldNode, status);
-           m_worldNode->rebuildNodeTree();
-           m_worldNode->enableNodeTreeUpdates();
-           return std::move(m_worldNode);
-         });
+  return readEntities(worldBounds, status, taskManager)
+         | kdl::transform([&]() { return finishWorld(status); });
+}
+
+Result<std::unique_ptr<mdl::WorldNode>> WorldReader::read(
+  std::vector<ObjectInfo> objectInfos,
+  const vm::bbox3d& worldBounds,
+  ParserStatus& status,
+  kdl::task_manager& taskManager)
+{
+  return readObjectInfos(std::move(objectInfos), worldBounds, status, taskManager)
+         | kdl::transform([&]() { return finishWorld(status); });
+}
+
+std::unique_ptr<mdl::WorldNode> WorldReader::finishWorld(ParserStatus& status)
+{
+  sanitizeLayerSortIndicies(*m_worldNode, status);
+  setLinkIds(*m_worldNode, status);
+  m_worldNode->rebuildNodeTree();
+  m_worldNode->enableNodeTreeUpdates();
+  return std::move(m_worldNode);
 }
 
 mdl::Node* WorldReader::onWorldNode(
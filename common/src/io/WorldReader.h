@@ -56,6 +56,16 @@ public:
   Result<std::unique_ptr<mdl::WorldNode>> read(
     const vm::bbox3d& worldBounds, ParserStatus& status, kdl::task_manager& taskManager);
 
+  /**
+   * Creates the world from the given object infos instead of parsing the string given to
+   * the constructor, e.g. when the object infos were restored from a map cache.
+   */
+  Result<std::unique_ptr<mdl::WorldNode>> read(
+    std::vector<ObjectInfo> objectInfos,
+    const vm::bbox3d& worldBounds,
+    ParserStatus& status,
+    kdl::task_manager& taskManager);
+
   /**
    * Try to parse the given string as the given map formats, in order.
    * Returns the world if parsing is successful, otherwise returns an error.
@@ -76,6 +86,9 @@ public:
     ParserStatus& status,
     kdl::task_manager& taskManager);
 
+private:
+  std::unique_ptr<mdl::WorldNode> finishWorld(ParserStatus& status);
+
 private: // implement MapReader interface
   mdl::Node* onWorldNode(
     std::unique_ptr<mdl::WorldNode> worldNode, ParserStatus& status) override;
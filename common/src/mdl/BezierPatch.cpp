@@ -28,7 +28,9 @@
 #include "vm/bezier_surface.h"
 #include "vm/vec_io.h" // IWYU pragma: keep
 
+#include <array>
 #include <cassert>
+#include <tuple>
 
 namespace tb::mdl
 {
@@ -172,90 +174,70 @@ void BezierPatch::transform(const vm::mat4x4d& transformation)
   m_bounds = builder.bounds();
 }
 
-using SurfaceControlPoints = std::array<std::array<BezierPatch::Point, 3u>, 3u>;
-static SurfaceControlPoints collectSurfaceControlPoints(
-  const std::vector<BezierPatch::Point>& controlPoints,
-  const size_t pointColumnCount,
-  const size_t surfaceRow,
-  const size_t surfaceCol)
+size_t BezierPatch::memoryUsage() const
 {
-  // at which column and row do we need to start collecting control points for the
-  // surface?
-  const size_t rowOffset = 2u * surfaceRow;
-  const size_t colOffset = 2u * surfaceCol;
-
-  // collect 3*3 control points
-  auto result = SurfaceControlPoints{};
-  for (size_t row = 0; row < 3u; ++row)
-  {
-    for (size_t col = 0; col < 3u; ++col)
-    {
-      result[row][col] =
-        controlPoints[(row + rowOffset) * pointColumnCount + col + colOffset];
-    }
-  }
-  return result;
+  return m_controlPoints.capacity() * sizeof(Point) + m_materialName.capacity();
 }
 
-static std::vector<SurfaceControlPoints> collectAllSurfaceControlPoints(
+namespace
+{
+
+/**
+ * Evaluates the curves along u of the three rows of control points of the given surface
+ * row at every grid column. The results are the control points of the curves along v
+ * which run through the grid points of each grid column.
+ */
+std::vector<std::array<BezierPatch::Point, 3u>> evaluateSurfaceRow(
   const std::vector<BezierPatch::Point>& controlPoints,
-  const size_t pointRowCount,
-  const size_t pointColumnCount)
+  const size_t pointColumnCount,
+  const size_t surfaceRow,
+  const std::vector<std::tuple<size_t, double>>& gridColumns)
 {
-  // determine how many 3*3 surfaces the patch has in each direction
-  const size_t surfaceRowCount = (pointRowCount - 1u) / 2u;
-  const size_t surfaceColumnCount = (pointColumnCount - 1u) / 2u;
+  const auto controlPoint = [&](const size_t row, const size_t col) {
+    return controlPoints[(2u * surfaceRow + row) * pointColumnCount + col];
+  };
 
-  // collect the control points for each surface
-  auto result = std::vector<SurfaceControlPoints>{};
-  result.reserve(surfaceRowCount * surfaceColumnCount);
+  auto result = std::vector<std::array<BezierPatch::Point, 3u>>{};
+  result.reserve(gridColumns.size());
 
-  for (size_t surfaceRow = 0u; surfaceRow < surfaceRowCount; ++surfaceRow)
+  for (const auto& [surfaceCol, u] : gridColumns)
   {
-    for (size_t surfaceCol = 0u; surfaceCol < surfaceColumnCount; ++surfaceCol)
+    const auto colOffset = 2u * surfaceCol;
+
+    auto curveControlPoints = std::array<BezierPatch::Point, 3u>{};
+    for (size_t row = 0u; row < 3u; ++row)
     {
-      result.push_back(collectSurfaceControlPoints(
-        controlPoints, pointColumnCount, surfaceRow, surfaceCol));
+      curveControlPoints[row] = vm::evaluate_quadratic_bezier_curve<double, 5>(
+        {
+          controlPoint(row, colOffset),
+          controlPoint(row, colOffset + 1u),
+          controlPoint(row, colOffset + 2u),
+        },
+        u);
     }
+    result.push_back(curveControlPoints);
   }
+
   return result;
 }
 
-template <typename O>
-void evaluateSurface(
-  const SurfaceControlPoints& surfaceControlPoints,
-  const size_t subdivisionsPerSurface,
-  const bool isLastCol,
-  const bool isLastRow,
-  O out)
-{
-  const auto maxRow = isLastRow ? subdivisionsPerSurface + 1u : subdivisionsPerSurface;
-  const auto maxCol = isLastCol ? subdivisionsPerSurface + 1u : subdivisionsPerSurface;
-
-  for (size_t row = 0u; row < maxRow; ++row)
-  {
-    const auto v = static_cast<double>(row) / static_cast<double>(subdivisionsPerSurface);
-    for (size_t col = 0u; col < maxCol; ++col)
-    {
-      const auto u =
-        static_cast<double>(col) / static_cast<double>(subdivisionsPerSurface);
-      out = vm::evaluate_quadratic_bezier_surface(surfaceControlPoints, u, v);
-    }
-  }
-}
+} // namespace
 
 std::vector<BezierPatch::Point> BezierPatch::evaluate(
   const size_t subdivisionsPerSurface) const
 {
-  // collect the control points for each surface in this patch
-  const auto allSurfaceControlPoints =
-    collectAllSurfaceControlPoints(m_controlPoints, m_pointRowCount, m_pointColumnCount);
+  return evaluate(subdivisionsPerSurface, subdivisionsPerSurface);
+}
 
-  const auto quadsPerSurfaceSide = (1u << subdivisionsPerSurface);
+std::vector<BezierPatch::Point> BezierPatch::evaluate(
+  const size_t rowSubdivisionsPerSurface, const size_t columnSubdivisionsPerSurface) const
+{
+  const auto quadRowsPerSurface = size_t(1) << rowSubdivisionsPerSurface;
+  const auto quadColumnsPerSurface = size_t(1) << columnSubdivisionsPerSurface;
 
   // determine dimensions of the resulting point grid
-  const size_t gridPointRowCount = surfaceRowCount() * quadsPerSurfaceSide + 1u;
-  const size_t gridPointColumnCount = surfaceColumnCount() * quadsPerSurfaceSide + 1u;
+  const size_t gridPointRowCount = surfaceRowCount() * quadRowsPerSurface + 1u;
+  const size_t gridPointColumnCount = surfaceColumnCount() * quadColumnsPerSurface + 1u;
 
   auto grid = std::vector<BezierPatch::Point>{};
   grid.reserve(gridPointRowCount * gridPointColumnCount);
@@ -308,24 +290,40 @@ std::vector<BezierPatch::Point> BezierPatch::evaluate(
   value of v
   */
 
-  for (size_t gridRow = 0u; gridRow < gridPointRowCount; ++gridRow)
+  // the surface column and the value of u are the same for every row of the grid
+  auto gridColumns = std::vector<std::tuple<size_t, double>>{};
+  gridColumns.reserve(gridPointColumnCount);
+  for (size_t gridCol = 0u; gridCol < gridPointColumnCount; ++gridCol)
+  {
+    const size_t surfaceCol =
+      (gridCol > 0u ? gridCol - 1u : gridCol) / quadColumnsPerSurface;
+    const double u = static_cast<double>(gridCol - surfaceCol * quadColumnsPerSurface)
+                     / static_cast<double>(quadColumnsPerSurface);
+    gridColumns.emplace_back(surfaceCol, u);
+  }
+
+  /*
+  A surface is evaluated by first evaluating the curves along u for each of its three
+  rows of control points, and then evaluating the curve along v through the results. The
+  curves along u only depend on the grid column, so we evaluate them once per surface row
+  and reuse them for all grid rows that sample that surface row.
+  */
+  for (size_t surfaceRow = 0u; surfaceRow < surfaceRowCount(); ++surfaceRow)
   {
-    const size_t surfaceRow =
-      (gridRow > 0u ? gridRow - 1u : gridRow) / quadsPerSurfaceSide;
-    const double v = static_cast<double>(gridRow - surfaceRow * quadsPerSurfaceSide)
-                     / static_cast<double>(quadsPerSurfaceSide);
+    const auto curvesAlongV = evaluateSurfaceRow(
+      m_controlPoints, m_pointColumnCount, surfaceRow, gridColumns);
 
-    for (size_t gridCol = 0u; gridCol < gridPointColumnCount; ++gridCol)
+    const auto firstGridRow = surfaceRow > 0u ? surfaceRow * quadRowsPerSurface + 1u : 0u;
+    const auto lastGridRow = (surfaceRow + 1u) * quadRowsPerSurface;
+    for (size_t gridRow = firstGridRow; gridRow <= lastGridRow; ++gridRow)
     {
-      const size_t surfaceCol =
-        (gridCol > 0u ? gridCol - 1u : gridCol) / quadsPerSurfaceSide;
-      const double u = static_cast<double>(gridCol - surfaceCol * quadsPerSurfaceSide)
-                       / static_cast<double>(quadsPerSurfaceSide);
-
-      const auto& surfaceControlPoints =
-        allSurfaceControlPoints[surfaceRow * surfaceColumnCount() + surfaceCol];
-      auto point = vm::evaluate_quadratic_bezier_surface(surfaceControlPoints, u, v);
-      grid.push_back(std::move(point));
+      const double v = static_cast<double>(gridRow - surfaceRow * quadRowsPerSurface)
+                       / static_cast<double>(quadRowsPerSurface);
+
+      for (const auto& curveControlPoints : curvesAlongV)
+      {
+        grid.push_back(vm::evaluate_quadratic_bezier_curve(curveControlPoints, v));
+      }
     }
   }
 
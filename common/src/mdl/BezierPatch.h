@@ -93,7 +93,23 @@ public: // control points:
 
   void transform(const vm::mat4x4d& transformation);
 
+  /**
+   * Returns an estimate of the number of heap allocated bytes that would be released if
+   * this patch was destroyed.
+   */
+  size_t memoryUsage() const;
+
   std::vector<Point> evaluate(size_t subdivisionsPerSurface) const;
+
+  /**
+   * Evaluates the patch on a grid that splits every surface into 2^r rows and 2^c
+   * columns of quads, where r is the given row subdivisions and c is the given column
+   * subdivisions.
+   *
+   * The grid points are returned row by row.
+   */
+  std::vector<Point> evaluate(
+    size_t rowSubdivisionsPerSurface, size_t columnSubdivisionsPerSurface) const;
 };
 
 } // namespace tb::mdl
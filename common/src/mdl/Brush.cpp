@@ -47,10 +47,10 @@
 
 namespace tb::mdl
 {
+namespace
+{
 
-kdl_reflect_impl(Brush);
-
-class Brush::CopyCallback : public BrushGeometry::CopyCallback
+class CopyFacePayloadCallback : public BrushGeometry::CopyCallback
 {
 public:
   void faceWasCopied(
@@ -60,14 +60,15 @@ public:
   }
 };
 
+} // namespace
+
+kdl_reflect_impl(Brush);
+
 Brush::Brush() {}
 
 Brush::Brush(const Brush& other)
   : m_faces{other.m_faces}
-  , m_geometry{
-      other.m_geometry
-        ? std::make_unique<BrushGeometry>(*other.m_geometry, CopyCallback())
-        : nullptr}
+  , m_geometry{other.m_geometry}
 {
   if (m_geometry)
   {
@@ -106,12 +107,42 @@ Result<Brush> Brush::create(const vm::bbox3d& worldBounds, std::vector<BrushFace
          | kdl::transform([&]() { return std::move(brush); });
 }
 
+Result<Brush> Brush::create(std::vector<BrushFace> faces, BrushGeometry geometry)
+{
+  if (faces.size() != geometry.faceCount())
+  {
+    return Error{"Brush geometry does not match faces"};
+  }
+
+  auto brush = Brush{std::move(faces)};
+  auto sharedGeometry = std::make_shared<BrushGeometry>(std::move(geometry));
+
+  auto faceIndex = size_t(0);
+  for (BrushFaceGeometry* faceGeometry : sharedGeometry->faces())
+  {
+    BrushFace& face = brush.m_faces[faceIndex];
+    if (face.boundary() != faceGeometry->plane())
+    {
+      return Error{"Brush geometry does not match faces"};
+    }
+
+    face.setGeometry(faceGeometry);
+    faceGeometry->setPayload(faceIndex++);
+  }
+
+  brush.m_geometry = std::move(sharedGeometry);
+
+  assert(brush.checkFaceLinks());
+
+  return brush;
+}
+
 Result<void> Brush::updateGeometryFromFaces(const vm::bbox3d& worldBounds)
 {
   // First, add all faces to the brush geometry
   BrushFace::sortFaces(m_faces);
 
-  auto geometry = std::make_unique<BrushGeometry>(worldBounds);
+  auto geometry = std::make_shared<BrushGeometry>(worldBounds);
 
   for (size_t i = 0u; i < m_faces.size(); ++i)
   {
@@ -1169,6 +1200,11 @@ Result<void> Brush::transform(
   const vm::mat4x4d& transformation,
   const bool lockMaterials)
 {
+  if (vm::strip_translation(transformation) == vm::mat4x4d::identity())
+  {
+    return translate(worldBounds, transformation * vm::vec3d{0, 0, 0}, lockMaterials);
+  }
+
   for (auto& face : m_faces)
   {
     if (!face.transform(transformation, lockMaterials).is_success())
@@ -1180,6 +1216,45 @@ Result<void> Brush::transform(
   return updateGeometryFromFaces(worldBounds);
 }
 
+Result<void> Brush::translate(
+  const vm::bbox3d& worldBounds, const vm::vec3d& delta, const bool lockMaterials)
+{
+  const auto transformation = vm::translation_matrix(delta);
+  for (auto& face : m_faces)
+  {
+    if (!face.transform(transformation, lockMaterials).is_success())
+    {
+      return Error{"Brush has invalid face"};
+    }
+  }
+
+  // if the brush touches or leaves the world bounds, rebuilding it would clip it
+  if (!m_geometry || !worldBounds.encloses(m_geometry->bounds().translate(delta)))
+  {
+    return updateGeometryFromFaces(worldBounds);
+  }
+
+  auto geometry = std::make_shared<BrushGeometry>(*m_geometry, CopyFacePayloadCallback{});
+  geometry->translate(delta);
+  geometry->correctVertexPositions();
+
+  for (BrushFaceGeometry* faceGeometry : geometry->faces())
+  {
+    if (const auto faceIndex = faceGeometry->payload())
+    {
+      BrushFace& face = m_faces[*faceIndex];
+      faceGeometry->setPlane(face.boundary());
+      face.setGeometry(faceGeometry);
+    }
+  }
+
+  m_geometry = std::move(geometry);
+
+  assert(checkFaceLinks());
+
+  return kdl::void_success;
+}
+
 bool Brush::contains(const vm::bbox3d& bounds) const
 {
   if (!this->bounds().contains(bounds))
@@ -1213,6 +1288,26 @@ bool Brush::intersects(const Brush& brush) const
   return m_geometry->intersects(*brush.m_geometry);
 }
 
+bool Brush::sharesGeometryWith(const Brush& brush) const
+{
+  return m_geometry != nullptr && m_geometry == brush.m_geometry;
+}
+
+size_t Brush::memoryUsage() const
+{
+  // material names are interned and shared by all faces
+  auto result = m_faces.capacity() * sizeof(BrushFace);
+
+  if (m_geometry && m_geometry.use_count() == 1)
+  {
+    result += sizeof(BrushGeometry) + m_geometry->vertexCount() * sizeof(BrushVertex)
+              + m_geometry->edgeCount() * (sizeof(BrushEdge) + 2 * sizeof(BrushHalfEdge))
+              + m_geometry->faceCount() * sizeof(BrushFaceGeometry);
+  }
+
+  return result;
+}
+
 Result<Brush> Brush::createBrush(
   const MapFormat mapFormat,
   const vm::bbox3d& worldBounds,
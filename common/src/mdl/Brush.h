@@ -46,8 +46,6 @@ enum class MapFormat;
 class Brush
 {
 private:
-  class CopyCallback;
-
   /**
    * Epsilon value to use when finding a vertex after applying a vertex operation
    */
@@ -59,7 +57,18 @@ public:
 
 private:
   std::vector<BrushFace> m_faces;
-  std::unique_ptr<BrushGeometry> m_geometry;
+
+  /**
+   * The geometry is not modified once it has been built. Instead, a new geometry is built
+   * whenever the faces change, so copies of a brush can share their geometry. The faces
+   * point into the shared geometry, and the face payloads refer to face indices, which
+   * are the same for all copies.
+   *
+   * The only exception are the vertex payloads, which the brush renderer overwrites on
+   * the main thread while building its vertex cache. Therefore, vertex payloads must not
+   * be relied upon outside of the renderer.
+   */
+  std::shared_ptr<BrushGeometry> m_geometry;
 
   kdl_reflect_decl(Brush, m_faces);
 
@@ -77,6 +86,13 @@ public:
   static Result<Brush> create(
     const vm::bbox3d& worldBounds, std::vector<BrushFace> faces);
 
+  /**
+   * Creates a brush from the given faces and a geometry that was previously computed from
+   * them, e.g. when restoring a brush from a cache. The faces must be given in the order of
+   * the geometry's faces, and their boundaries must match the face planes.
+   */
+  static Result<Brush> create(std::vector<BrushFace> faces, BrushGeometry geometry);
+
 private:
   explicit Brush(std::vector<BrushFace> faces);
 
@@ -322,6 +338,9 @@ public:
   /**
    * Applies the given transformation to this brush.
    *
+   * If the given transformation is a pure translation, then this function delegates to
+   * translate.
+   *
    * If the brush becomes invalid, an error is returned.
    *
    * @param worldBounds the world bounds
@@ -332,12 +351,41 @@ public:
   Result<void> transform(
     const vm::bbox3d& worldBounds, const vm::mat4x4d& transformation, bool lockMaterials);
 
+  /**
+   * Translates this brush by the given delta.
+   *
+   * A translation cannot change the topology of the brush, so unless the translated brush
+   * leaves the world bounds, the existing geometry is offset instead of being rebuilt from
+   * the faces. For brushes whose vertices lie on integer coordinates, the result is
+   * identical to rebuilding the geometry.
+   *
+   * @param worldBounds the world bounds
+   * @param delta the offset by which to translate this brush
+   * @param lockMaterials whether material alignment should be locked
+   * @return a void result or an error if the operation fails
+   */
+  Result<void> translate(
+    const vm::bbox3d& worldBounds, const vm::vec3d& delta, bool lockMaterials);
+
 public:
   bool contains(const vm::bbox3d& bounds) const;
   bool contains(const Brush& brush) const;
   bool intersects(const vm::bbox3d& bounds) const;
   bool intersects(const Brush& brush) const;
 
+public: // memory accounting
+  /**
+   * Indicates whether this brush shares its geometry with the given brush.
+   */
+  bool sharesGeometryWith(const Brush& brush) const;
+
+  /**
+   * Returns an estimate of the number of heap allocated bytes that would be released if
+   * this brush was destroyed. Geometry that is shared with other brushes is not
+   * included.
+   */
+  size_t memoryUsage() const;
+
 private:
   /**
    * Final step of CSG subtraction; takes the geometry that is the result of the
@@ -64,7 +64,7 @@ BrushFace::BrushFace(const BrushFace& other)
   , m_boundary{other.m_boundary}
   , m_attributes{other.m_attributes}
   , m_materialReference{other.m_materialReference}
-  , m_uvCoordSystem{other.m_uvCoordSystem ? other.m_uvCoordSystem->clone() : nullptr}
+  , m_uvCoordSystem{other.m_uvCoordSystem}
   , m_lineNumber{other.m_lineNumber}
   , m_lineCount{other.m_lineCount}
   , m_selected{other.m_selected}
@@ -262,7 +262,7 @@ std::unique_ptr<UVCoordSystemSnapshot> BrushFace::takeUVCoordSystemSnapshot() co
 void BrushFace::restoreUVCoordSystemSnapshot(
   const UVCoordSystemSnapshot& coordSystemSnapshot)
 {
-  coordSystemSnapshot.restore(*m_uvCoordSystem);
+  coordSystemSnapshot.restore(mutableUVCoordSystem());
 }
 
 void BrushFace::copyUVCoordSystemFromFace(
@@ -277,14 +277,14 @@ void BrushFace::copyUVCoordSystemFromFace(
     vm::intersect_plane_plane(sourceFacePlane, m_boundary).value_or(vm::line3d{});
   const auto refPoint = vm::project_point(seam, center());
 
-  coordSystemSnapshot.restore(*m_uvCoordSystem);
+  coordSystemSnapshot.restore(mutableUVCoordSystem());
 
   // Get the UV coords at the refPoint using the source face's attributes and tex coord
   // system
   const auto desriedCoords =
     m_uvCoordSystem->uvCoords(refPoint, attributes, vm::vec2f{1, 1});
 
-  m_uvCoordSystem->setNormal(
+  mutableUVCoordSystem().setNormal(
     sourceFacePlane.normal, m_boundary.normal, m_attributes, wrapStyle);
 
   // Adjust the offset on this face so that the UV coordinates at the refPoint stay
@@ -407,13 +407,14 @@ void BrushFace::setAttributes(const BrushFaceAttributes& attributes)
 {
   const float oldRotation = m_attributes.rotation();
   m_attributes = attributes;
-  m_uvCoordSystem->setRotation(m_boundary.normal, oldRotation, m_attributes.rotation());
+  mutableUVCoordSystem().setRotation(
+    m_boundary.normal, oldRotation, m_attributes.rotation());
 }
 
 bool BrushFace::setAttributes(const BrushFace& other)
 {
   auto result = false;
-  result |= m_attributes.setMaterialName(other.attributes().materialName());
+  result |= m_attributes.setMaterialName(other.attributes().internedMaterialName());
   result |= m_attributes.setXOffset(other.attributes().xOffset());
   result |= m_attributes.setYOffset(other.attributes().yOffset());
   result |= m_attributes.setRotation(other.attributes().rotation());
@@ -488,7 +489,8 @@ void BrushFace::resetUVCoordSystemCache()
 {
   if (m_uvCoordSystem != nullptr)
   {
-    m_uvCoordSystem->resetCache(m_points[0], m_points[1], m_points[2], m_attributes);
+    mutableUVCoordSystem().resetCache(
+      m_points[0], m_points[1], m_points[2], m_attributes);
   }
 }
 
@@ -497,6 +499,18 @@ const UVCoordSystem& BrushFace::uvCoordSystem() const
   return *m_uvCoordSystem;
 }
 
+UVCoordSystem& BrushFace::mutableUVCoordSystem()
+{
+  if (m_uvCoordSystem.use_count() > 1)
+  {
+    m_uvCoordSystem = m_uvCoordSystem->clone();
+  }
+
+  // the coordinate system is not shared with any other face, and it was not created
+  // const, so it is safe to modify it
+  return const_cast<UVCoordSystem&>(*m_uvCoordSystem);
+}
+
 const Material* BrushFace::material() const
 {
   return m_materialReference.get();
@@ -539,12 +553,12 @@ vm::vec3d BrushFace::vAxis() const
 
 void BrushFace::resetUVAxes()
 {
-  m_uvCoordSystem->reset(m_boundary.normal);
+  mutableUVCoordSystem().reset(m_boundary.normal);
 }
 
 void BrushFace::resetUVAxesToParaxial()
 {
-  m_uvCoordSystem->resetToParaxial(m_boundary.normal, 0.0f);
+  mutableUVCoordSystem().resetToParaxial(m_boundary.normal, 0.0f);
 }
 
 void BrushFace::convertToParaxial()
@@ -575,12 +589,13 @@ void BrushFace::rotateUV(const float angle)
 {
   const float oldRotation = m_attributes.rotation();
   m_uvCoordSystem->rotate(m_boundary.normal, angle, m_attributes);
-  m_uvCoordSystem->setRotation(m_boundary.normal, oldRotation, m_attributes.rotation());
+  mutableUVCoordSystem().setRotation(
+    m_boundary.normal, oldRotation, m_attributes.rotation());
 }
 
 void BrushFace::shearUV(const vm::vec2f& factors)
 {
-  m_uvCoordSystem->shear(m_boundary.normal, factors);
+  mutableUVCoordSystem().shear(m_boundary.normal, factors);
 }
 
 void BrushFace::flipUV(
@@ -650,7 +665,7 @@ Result<void> BrushFace::transform(const vm::mat4x4d& transform, const bool lockA
   }
 
   return setPoints(m_points[0], m_points[1], m_points[2]) | kdl::transform([&]() {
-           m_uvCoordSystem->transform(
+           mutableUVCoordSystem().transform(
              oldBoundary,
              m_boundary,
              transform,
@@ -691,7 +706,7 @@ Result<void> BrushFace::updatePointsFromVertices()
                const auto desriedCoords =
                  m_uvCoordSystem->uvCoords(refPoint, m_attributes, vm::vec2f{1, 1});
 
-               m_uvCoordSystem->setNormal(
+               mutableUVCoordSystem().setNormal(
                  oldPlane.normal, m_boundary.normal, m_attributes, WrapStyle::Projection);
 
                // Adjust the offset on this face so that the UV coordinates at the
@@ -785,6 +800,11 @@ size_t BrushFace::lineNumber() const
   return m_lineNumber;
 }
 
+size_t BrushFace::lineCount() const
+{
+  return m_lineCount;
+}
+
 void BrushFace::setFilePosition(const size_t lineNumber, const size_t lineCount) const
 {
   m_lineNumber = lineNumber;
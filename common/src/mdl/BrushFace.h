@@ -86,7 +86,7 @@ private:
   BrushFaceAttributes m_attributes;
 
   AssetReference<Material> m_materialReference;
-  std::unique_ptr<UVCoordSystem> m_uvCoordSystem;
+  std::shared_ptr<const UVCoordSystem> m_uvCoordSystem;
   BrushFaceGeometry* m_geometry = nullptr;
 
   mutable size_t m_lineNumber = 0;
@@ -258,6 +258,7 @@ public:
   void setGeometry(BrushFaceGeometry* geometry);
 
   size_t lineNumber() const;
+  size_t lineCount() const;
   void setFilePosition(size_t lineNumber, size_t lineCount) const;
 
   bool selected() const;
@@ -273,6 +274,12 @@ private:
     const vm::vec3d& point0, const vm::vec3d& point1, const vm::vec3d& point2);
   void correctPoints();
 
+  /**
+   * Returns the UV coordinate system for modification. The coordinate system is shared
+   * between copies of this face, so it is cloned first if it is shared.
+   */
+  UVCoordSystem& mutableUVCoordSystem();
+
 public: // brush renderer
   /**
    * This is used to cache results of evaluating the BrushRenderer Filter.
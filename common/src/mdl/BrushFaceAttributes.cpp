@@ -51,6 +51,11 @@ BrushFaceAttributes::BrushFaceAttributes(
 kdl_reflect_impl(BrushFaceAttributes);
 
 const std::string& BrushFaceAttributes::materialName() const
+{
+  return m_materialName.str();
+}
+
+const MaterialName& BrushFaceAttributes::internedMaterialName() const
 {
   return m_materialName;
 }
@@ -133,6 +138,11 @@ bool BrushFaceAttributes::valid() const
 }
 
 bool BrushFaceAttributes::setMaterialName(const std::string& materialName)
+{
+  return setMaterialName(MaterialName{materialName});
+}
+
+bool BrushFaceAttributes::setMaterialName(const MaterialName& materialName)
 {
   if (materialName != m_materialName)
   {
@@ -0,0 +1,91 @@
+/*
+ Copyright (C) 2010 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BrushFaceTagPlan.h"
+
+#include <utility>
+
+namespace tb::mdl
+{
+
+void BrushFaceTagPlan::addMaterialTag(
+  const TagType::Type tagType, MaterialPredicate predicate)
+{
+  m_materialTags.push_back({tagType, std::move(predicate)});
+  m_tagTypes |= tagType;
+}
+
+void BrushFaceTagPlan::addSurfaceFlagsTag(const TagType::Type tagType, const int flags)
+{
+  m_surfaceFlagsTags.push_back({tagType, flags});
+  m_tagTypes |= tagType;
+}
+
+void BrushFaceTagPlan::addContentFlagsTag(const TagType::Type tagType, const int flags)
+{
+  m_contentFlagsTags.push_back({tagType, flags});
+  m_tagTypes |= tagType;
+}
+
+void BrushFaceTagPlan::addUnmatchedTag(const TagType::Type tagType)
+{
+  m_tagTypes |= tagType;
+}
+
+TagType::Type BrushFaceTagPlan::tagTypes() const
+{
+  return m_tagTypes;
+}
+
+TagType::Type BrushFaceTagPlan::matchMaterial(
+  const std::string_view materialName, const Material* material) const
+{
+  auto result = TagType::NoType;
+  for (const auto& materialTag : m_materialTags)
+  {
+    if (materialTag.predicate(materialName, material))
+    {
+      result |= materialTag.tagType;
+    }
+  }
+  return result;
+}
+
+TagType::Type BrushFaceTagPlan::matchFlags(
+  const int surfaceFlags, const int surfaceContents) const
+{
+  auto result = TagType::NoType;
+  for (const auto& flagsTag : m_surfaceFlagsTags)
+  {
+    if ((surfaceFlags & flagsTag.flags) != 0)
+    {
+      result |= flagsTag.tagType;
+    }
+  }
+  for (const auto& flagsTag : m_contentFlagsTags)
+  {
+    if ((surfaceContents & flagsTag.flags) != 0)
+    {
+      result |= flagsTag.tagType;
+    }
+  }
+  return result;
+}
+
+} // namespace tb::mdl
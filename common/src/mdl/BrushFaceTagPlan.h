@@ -0,0 +1,111 @@
+/*
+ Copyright (C) 2010 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "mdl/TagType.h"
+
+#include <functional>
+#include <string_view>
+#include <vector>
+
+namespace tb::mdl
+{
+class Material;
+
+/**
+ * Evaluates the smart tags of brush faces from the material name, the material, the
+ * surface flags and the surface contents of a face.
+ *
+ * The evaluation is split so that the tags that only depend on the material of a face can
+ * be evaluated once per material and reused for every face that uses it, while the tags
+ * that depend on the surface flags or contents are matched with a few bitwise operations
+ * per face.
+ *
+ * Smart tags add themselves to a plan by means of TagMatcher::compile. Smart tags that
+ * are not part of a plan must be evaluated for every face by calling SmartTag::update.
+ */
+class BrushFaceTagPlan
+{
+public:
+  using MaterialPredicate =
+    std::function<bool(std::string_view materialName, const Material* material)>;
+
+private:
+  struct MaterialTag
+  {
+    TagType::Type tagType;
+    MaterialPredicate predicate;
+  };
+
+  struct FlagsTag
+  {
+    TagType::Type tagType;
+    int flags;
+  };
+
+  std::vector<MaterialTag> m_materialTags;
+  std::vector<FlagsTag> m_surfaceFlagsTags;
+  std::vector<FlagsTag> m_contentFlagsTags;
+  TagType::Type m_tagTypes = TagType::NoType;
+
+public:
+  /**
+   * Adds a tag that matches a face if the given predicate holds for the material name and
+   * the material of the face. The predicate must not depend on anything else.
+   */
+  void addMaterialTag(TagType::Type tagType, MaterialPredicate predicate);
+
+  /**
+   * Adds a tag that matches a face if any of the given flags is set in the face's
+   * surface flags.
+   */
+  void addSurfaceFlagsTag(TagType::Type tagType, int flags);
+
+  /**
+   * Adds a tag that matches a face if any of the given flags is set in the face's
+   * surface contents.
+   */
+  void addContentFlagsTag(TagType::Type tagType, int flags);
+
+  /**
+   * Adds a tag that never matches a face.
+   */
+  void addUnmatchedTag(TagType::Type tagType);
+
+  /**
+   * Returns the types of all tags that were added to this plan.
+   */
+  TagType::Type tagTypes() const;
+
+  /**
+   * Returns the types of the material tags that match the given material name and
+   * material.
+   */
+  TagType::Type matchMaterial(
+    std::string_view materialName, const Material* material) const;
+
+  /**
+   * Returns the types of the surface flags and content flags tags that match the given
+   * surface flags and contents.
+   */
+  TagType::Type matchFlags(int surfaceFlags, int surfaceContents) const;
+};
+
+} // namespace tb::mdl
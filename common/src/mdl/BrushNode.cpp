@@ -30,6 +30,7 @@
 #include "mdl/ModelUtils.h"
 #include "mdl/PatchNode.h"
 #include "mdl/PickResult.h"
+#include "mdl/TagManager.h"
 #include "mdl/TagVisitor.h"
 #include "mdl/Validator.h"
 #include "mdl/WorldNode.h"
@@ -393,6 +394,11 @@ GroupNode* BrushNode::doGetContainingGroup()
   return findContainingGroup(this);
 }
 
+void BrushNode::doLinkIdDidChange(const std::string& oldLinkId)
+{
+  updateLinkIdIndex(this, oldLinkId, m_linkId);
+}
+
 void BrushNode::invalidateVertexCache()
 {
   m_brushRendererBrushCache->invalidateVertexCache();
@@ -430,6 +436,27 @@ void BrushNode::updateTags(TagManager& tagManager)
   Taggable::updateTags(tagManager);
 }
 
+void BrushNode::initializeTags(
+  const std::vector<BrushNode*>& brushNodes,
+  TagManager& tagManager,
+  kdl::task_manager& taskManager)
+{
+  auto faces = std::vector<BrushFace*>{};
+  for (auto* brushNode : brushNodes)
+  {
+    // tag the node itself without tagging its faces one by one
+    brushNode->Taggable::clearTags();
+    brushNode->Taggable::updateTags(tagManager);
+    for (auto& face : brushNode->m_brush.faces())
+    {
+      face.clearTags();
+      faces.push_back(&face);
+    }
+  }
+
+  tagManager.updateFaceTags(faces, taskManager);
+}
+
 bool BrushNode::allFacesHaveAnyTagInMask(TagType::Type tagMask) const
 {
   // Possible optimization: Store the shared face tag mask in the brush and updated it
@@ -34,6 +34,11 @@
 #include <string>
 #include <vector>
 
+namespace kdl
+{
+class task_manager;
+} // namespace kdl
+
 namespace tb::render
 {
 class BrushRendererBrushCache;
@@ -120,6 +125,7 @@ private: // implement Object interface
   Node* doGetContainer() override;
   LayerNode* doGetContainingLayer() override;
   GroupNode* doGetContainingGroup() override;
+  void doLinkIdDidChange(const std::string& oldLinkId) override;
 
 public: // renderer cache
   /**
@@ -134,6 +140,16 @@ public:
   void clearTags() override;
   void updateTags(TagManager& tagManager) override;
 
+  /**
+   * Initializes the tags of the given brush nodes and of their faces. This has the same
+   * effect as calling initializeTags on every node, but the faces of all nodes are tagged
+   * in one batch by TagManager::updateFaceTags, using the given task manager.
+   */
+  static void initializeTags(
+    const std::vector<BrushNode*>& brushNodes,
+    TagManager& tagManager,
+    kdl::task_manager& taskManager);
+
   /**
    * Indicates whether all of the faces of this brush have any of the given tags.
    *
@@ -31,6 +31,7 @@
 #include "mdl/LayerNode.h"
 #include "mdl/Node.h"
 #include "mdl/PatchNode.h"
+#include "mdl/StateEpoch.h"
 #include "mdl/WorldNode.h"
 
 namespace tb::mdl
@@ -39,6 +40,10 @@ namespace tb::mdl
 EditorContext::EditorContext()
 {
   reset();
+
+  auto& prefs = PreferenceManager::instance();
+  m_notifierConnection += prefs.preferenceDidChangeNotifier.connect(
+    this, &EditorContext::preferenceDidChange);
 }
 
 void EditorContext::reset()
@@ -47,6 +52,7 @@ void EditorContext::reset()
   m_hiddenEntityDefinitions.reset();
   m_blockSelection = false;
   m_currentGroup = nullptr;
+  invalidateCaches();
 }
 
 TagType::Type EditorContext::hiddenTags() const
@@ -59,6 +65,7 @@ void EditorContext::setHiddenTags(const TagType::Type hiddenTags)
   if (hiddenTags != m_hiddenTags)
   {
     m_hiddenTags = hiddenTags;
+    invalidateCaches();
     editorContextDidChangeNotifier();
   }
 }
@@ -79,6 +86,7 @@ void EditorContext::setEntityDefinitionHidden(
   if (definition && entityDefinitionHidden(definition) != hidden)
   {
     m_hiddenEntityDefinitions[definition->index()] = hidden;
+    invalidateCaches();
     editorContextDidChangeNotifier();
   }
 }
@@ -127,6 +135,44 @@ void EditorContext::popGroup()
   }
 }
 
+template <typename F>
+bool EditorContext::cached(
+  NodeCache& cache, const mdl::Node* node, const F& compute) const
+{
+  if (m_cacheEpoch != m_epoch || m_cacheStateEpoch != stateEpoch())
+  {
+    m_visibleCache = NodeCache{};
+    m_editableCache = NodeCache{};
+    m_cacheEpoch = m_epoch;
+    m_cacheStateEpoch = stateEpoch();
+  }
+
+  const auto index = node->index();
+  if (!cache.known[index])
+  {
+    const auto value = compute();
+    cache.known[index] = true;
+    cache.values[index] = value;
+    return value;
+  }
+  return cache.values[index];
+}
+
+void EditorContext::invalidateCaches()
+{
+  ++m_epoch;
+}
+
+void EditorContext::preferenceDidChange(const std::filesystem::path& path)
+{
+  if (
+    path == Preferences::ShowBrushes.path()
+    || path == Preferences::ShowPointEntities.path())
+  {
+    invalidateCaches();
+  }
+}
+
 bool EditorContext::visible(const mdl::Node* node) const
 {
   return node->accept(kdl::overload(
@@ -150,75 +196,81 @@ bool EditorContext::visible(const mdl::LayerNode* layerNode) const
 
 bool EditorContext::visible(const mdl::GroupNode* groupNode) const
 {
-  if (groupNode->selected())
-  {
-    return true;
-  }
-  if (!anyChildVisible(groupNode))
-  {
-    return false;
-  }
-  return groupNode->visible();
+  return cached(m_visibleCache, groupNode, [&]() {
+    if (groupNode->selected())
+    {
+      return true;
+    }
+    if (!anyChildVisible(groupNode))
+    {
+      return false;
+    }
+    return groupNode->visible();
+  });
 }
 
 bool EditorContext::visible(const mdl::EntityNode* entityNode) const
 {
-  if (entityNode->selected())
-  {
-    return true;
-  }
+  return cached(m_visibleCache, entityNode, [&]() {
+    if (entityNode->selected())
+    {
+      return true;
+    }
 
-  if (!entityNode->entity().pointEntity())
-  {
-    return anyChildVisible(entityNode);
-  }
+    if (!entityNode->entity().pointEntity())
+    {
+      return anyChildVisible(entityNode);
+    }
 
-  if (!entityNode->visible())
-  {
-    return false;
-  }
+    if (!entityNode->visible())
+    {
+      return false;
+    }
 
-  if (entityNode->entity().pointEntity() && !pref(Preferences::ShowPointEntities))
-  {
-    return false;
-  }
+    if (entityNode->entity().pointEntity() && !pref(Preferences::ShowPointEntities))
+    {
+      return false;
+    }
 
-  if (entityDefinitionHidden(entityNode))
-  {
-    return false;
-  }
+    if (entityDefinitionHidden(entityNode))
+    {
+      return false;
+    }
 
-  return true;
+    return true;
+  });
 }
 
 bool EditorContext::visible(const mdl::BrushNode* brushNode) const
 {
-  if (brushNode->selected())
-  {
-    return true;
-  }
+  return cached(m_visibleCache, brushNode, [&]() {
+    if (brushNode->selected())
+    {
+      return true;
+    }
 
-  if (!pref(Preferences::ShowBrushes))
-  {
-    return false;
-  }
+    if (!pref(Preferences::ShowBrushes))
+    {
+      return false;
+    }
 
-  if (brushNode->hasTag(m_hiddenTags))
-  {
-    return false;
-  }
+    if (brushNode->hasTag(m_hiddenTags))
+    {
+      return false;
+    }
 
-  if (brushNode->allFacesHaveAnyTagInMask(m_hiddenTags))
-  {
-    return false;
-  }
+    if (brushNode->allFacesHaveAnyTagInMask(m_hiddenTags))
+    {
+      return false;
+    }
 
-  if (entityDefinitionHidden(brushNode->entity()))
-  {
-    return false;
-  }
+    if (entityDefinitionHidden(brushNode->entity()))
+    {
+      return false;
+    }
 
-  return brushNode->visible();
+    return brushNode->visible();
+  });
 }
 
 bool EditorContext::visible(
@@ -229,17 +281,19 @@ bool EditorContext::visible(
 
 bool EditorContext::visible(const mdl::PatchNode* patchNode) const
 {
-  if (patchNode->selected())
-  {
-    return true;
-  }
+  return cached(m_visibleCache, patchNode, [&]() {
+    if (patchNode->selected())
+    {
+      return true;
+    }
 
-  if (patchNode->hasTag(m_hiddenTags))
-  {
-    return false;
-  }
+    if (patchNode->hasTag(m_hiddenTags))
+    {
+      return false;
+    }
 
-  return patchNode->visible();
+    return patchNode->visible();
+  });
 }
 
 bool EditorContext::anyChildVisible(const mdl::Node* node) const
@@ -251,7 +305,7 @@ bool EditorContext::anyChildVisible(const mdl::Node* node) const
 
 bool EditorContext::editable(const mdl::Node* node) const
 {
-  return node->editable();
+  return cached(m_editableCache, node, [&]() { return node->editable(); });
 }
 
 bool EditorContext::editable(const mdl::BrushNode* brushNode, const mdl::BrushFace&) const
@@ -20,10 +20,14 @@
 #pragma once
 
 #include "Notifier.h"
+#include "NotifierConnection.h"
 #include "mdl/TagType.h"
 
 #include "kdl/dynamic_bitset.h"
 
+#include <cstdint>
+#include <filesystem>
+
 namespace tb::mdl
 {
 class EntityDefinition;
@@ -38,9 +42,28 @@ class Object;
 class PatchNode;
 class WorldNode;
 
+/**
+ * Decides which nodes are visible, editable and selectable.
+ *
+ * The visibility and editability of the nodes are cached in bitsets indexed by the node
+ * indices. The caches are cleared when the state of this context changes, when a
+ * preference that affects visibility changes, or when the state epoch of the nodes
+ * advances (see stateEpoch()). The caches are not synchronized, so this class must only
+ * be used by one thread at a time.
+ */
 class EditorContext
 {
 private:
+  /**
+   * A cached boolean property of nodes. A node's bit in `known` is set if its bit in
+   * `values` holds the property.
+   */
+  struct NodeCache
+  {
+    kdl::dynamic_bitset known;
+    kdl::dynamic_bitset values;
+  };
+
   TagType::Type m_hiddenTags;
   kdl::dynamic_bitset m_hiddenEntityDefinitions;
 
@@ -48,6 +71,14 @@ private:
 
   mdl::GroupNode* m_currentGroup;
 
+  std::uint64_t m_epoch = 0;
+  mutable std::uint64_t m_cacheEpoch = 0;
+  mutable std::uint64_t m_cacheStateEpoch = 0;
+  mutable NodeCache m_visibleCache;
+  mutable NodeCache m_editableCache;
+
+  NotifierConnection m_notifierConnection;
+
 public:
   Notifier<> editorContextDidChangeNotifier;
 
@@ -84,6 +115,11 @@ public:
 private:
   bool anyChildVisible(const mdl::Node* node) const;
 
+  template <typename F>
+  bool cached(NodeCache& cache, const mdl::Node* node, const F& compute) const;
+  void invalidateCaches();
+  void preferenceDidChange(const std::filesystem::path& path);
+
 public:
   bool editable(const mdl::Node* node) const;
   bool editable(const mdl::BrushNode* brushNode, const mdl::BrushFace& face) const;
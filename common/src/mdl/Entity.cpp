@@ -486,4 +486,19 @@ void Entity::transform(const vm::mat4x4d& transformation, const bool updateAngle
   }
 }
 
+size_t Entity::memoryUsage() const
+{
+  auto result = m_properties.capacity() * sizeof(EntityProperty)
+                + m_protectedProperties.capacity() * sizeof(std::string);
+  for (const auto& property : m_properties)
+  {
+    result += property.key().capacity() + property.value().capacity();
+  }
+  for (const auto& protectedProperty : m_protectedProperties)
+  {
+    result += protectedProperty.capacity();
+  }
+  return result;
+}
+
 } // namespace tb::mdl
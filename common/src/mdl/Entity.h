@@ -182,6 +182,12 @@ public: // property management
   std::vector<EntityProperty> numberedProperties(const std::string& property) const;
 
   void transform(const vm::mat4x4d& transformation, bool updateAngleProperty);
+
+  /**
+   * Returns an estimate of the number of heap allocated bytes that would be released if
+   * this entity was destroyed.
+   */
+  size_t memoryUsage() const;
 };
 
 } // namespace tb::mdl
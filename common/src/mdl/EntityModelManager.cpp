@@ -34,6 +34,9 @@
 
 #include "kdl/range_to_vector.h"
 #include "kdl/result.h"
+#include "kdl/task_manager.h"
+
+#include <variant>
 
 namespace tb::mdl
 {
@@ -53,6 +56,7 @@ void EntityModelManager::clear()
 {
   m_renderers.clear();
   m_models.clear();
+  m_modelErrors.clear();
   m_rendererMismatches.clear();
 
   m_unpreparedRenderers.clear();
@@ -143,6 +147,11 @@ const EntityModel* EntityModelManager::model(const std::filesystem::path& path)
       return &it->second;
     }
 
+    if (const auto errorIt = m_modelErrors.find(path); errorIt != m_modelErrors.end())
+    {
+      throw GameException{errorIt->second};
+    }
+
     return loadModel(path) | kdl::transform([&](auto model) {
              const auto [pos, success] = m_models.emplace(path, std::move(model));
              assert(success);
@@ -153,6 +162,7 @@ const EntityModel* EntityModelManager::model(const std::filesystem::path& path)
            })
            | kdl::if_error([&](auto e) {
                m_logger.error() << e.msg;
+               m_modelErrors.emplace(path, e.msg);
                throw GameException{e.msg};
              })
            | kdl::value();
@@ -161,6 +171,55 @@ const EntityModel* EntityModelManager::model(const std::filesystem::path& path)
   return nullptr;
 }
 
+void EntityModelManager::prefetchModels(
+  const std::vector<std::filesystem::path>& paths, kdl::task_manager& taskManager)
+{
+  auto models = std::vector<EntityModel*>{};
+  for (const auto& path : paths)
+  {
+    if (!path.empty() && !m_models.contains(path) && !m_modelErrors.contains(path))
+    {
+      auto* model =
+        loadModel(path) | kdl::transform([&](auto loadedModel) {
+          const auto [pos, success] = m_models.emplace(path, std::move(loadedModel));
+          assert(success);
+          unused(success);
+
+          m_logger.debug() << "Prefetching entity model " << path;
+          return &(pos->second);
+        })
+        | kdl::transform_error([&](auto e) -> EntityModel* {
+            m_logger.error() << e.msg;
+            m_modelErrors.emplace(path, std::move(e.msg));
+            return nullptr;
+          })
+        | kdl::value();
+
+      if (model)
+      {
+        models.push_back(model);
+      }
+    }
+  }
+
+  // Every model has its own resource, so the resources can be loaded concurrently. The
+  // resource manager only needs to upload them afterwards.
+  taskManager.parallel_for(
+    models.size(), [&](const auto i) { models[i]->dataResource().loadSync(); }, 1);
+
+  // The resource manager only reports the errors of the resources that it loads itself,
+  // and it does not process failed resources again.
+  for (const auto* model : models)
+  {
+    if (
+      const auto* failedState =
+        std::get_if<ResourceFailed>(&model->dataResource().state()))
+    {
+      m_logger.error() << failedState->error;
+    }
+  }
+}
+
 const std::vector<const EntityModel*> EntityModelManager::
   findEntityModelsByTextureResourceId(const std::vector<ResourceId>& resourceIds) const
 {
@@ -27,6 +27,7 @@
 
 #include <filesystem>
 #include <memory>
+#include <string>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -67,6 +68,9 @@ private:
   std::vector<Quake3Shader> m_shaders;
 
   mutable std::unordered_map<std::filesystem::path, EntityModel, kdl::path_hash> m_models;
+  // the errors of models that failed to load, which have already been logged
+  mutable std::unordered_map<std::filesystem::path, std::string, kdl::path_hash>
+    m_modelErrors;
   mutable std::
     unordered_map<ModelSpecification, std::unique_ptr<render::MaterialRenderer>>
       m_renderers;
@@ -88,6 +92,17 @@ public:
   const EntityModelFrame* frame(const ModelSpecification& spec) const;
   const EntityModel* model(const std::filesystem::path& path) const;
 
+  /**
+   * Creates the models with the given paths and loads their data concurrently, so that
+   * they are resident when they are first rendered. Paths of models that are already
+   * known are skipped.
+   *
+   * Models that fail to load are logged once. They are not logged again when they are
+   * requested later.
+   */
+  void prefetchModels(
+    const std::vector<std::filesystem::path>& paths, kdl::task_manager& taskManager);
+
   const std::vector<const EntityModel*> findEntityModelsByTextureResourceId(
     const std::vector<ResourceId>& resourceIds) const;
 
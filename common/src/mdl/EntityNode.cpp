@@ -264,6 +264,11 @@ GroupNode* EntityNode::doGetContainingGroup()
   return findContainingGroup(this);
 }
 
+void EntityNode::doLinkIdDidChange(const std::string& oldLinkId)
+{
+  updateLinkIdIndex(this, oldLinkId, m_linkId);
+}
+
 void EntityNode::invalidateBounds()
 {
   m_cachedBounds = std::nullopt;
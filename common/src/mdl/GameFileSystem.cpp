@@ -124,23 +124,26 @@ Result<std::unique_ptr<io::FileSystem>> createImageFileSystem(
 
   if (kdl::ci::str_is_equal(packageFormat, "idpak"))
   {
-    return io::Disk::openFile(path) | kdl::and_then([&](auto file) {
-             return io::createImageFileSystem<io::IdPakFileSystem>(std::move(file));
-           })
+    return io::Disk::openFile(path, io::MemoryMapping::Enabled)
+           | kdl::and_then([&](auto file) {
+               return io::createImageFileSystem<io::IdPakFileSystem>(std::move(file));
+             })
            | kdl::transform(setMetadataAndCast);
   }
   else if (kdl::ci::str_is_equal(packageFormat, "dkpak"))
   {
-    return io::Disk::openFile(path) | kdl::and_then([&](auto file) {
-             return io::createImageFileSystem<io::DkPakFileSystem>(std::move(file));
-           })
+    return io::Disk::openFile(path, io::MemoryMapping::Enabled)
+           | kdl::and_then([&](auto file) {
+               return io::createImageFileSystem<io::DkPakFileSystem>(std::move(file));
+             })
            | kdl::transform(setMetadataAndCast);
   }
   else if (kdl::ci::str_is_equal(packageFormat, "zip"))
   {
-    return io::Disk::openFile(path) | kdl::and_then([&](auto file) {
-             return io::createImageFileSystem<io::ZipFileSystem>(std::move(file));
-           })
+    return io::Disk::openFile(path, io::MemoryMapping::Enabled)
+           | kdl::and_then([&](auto file) {
+               return io::createImageFileSystem<io::ZipFileSystem>(std::move(file));
+             })
            | kdl::transform(setMetadataAndCast);
   }
   return Error{"Unknown package format: " + packageFormat};
@@ -0,0 +1,255 @@
+/*
+ Copyright (C) 2010 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "IssueIndex.h"
+
+#include "mdl/BrushNode.h"
+#include "mdl/EntityNode.h"
+#include "mdl/EntityNodeBase.h"
+#include "mdl/GroupNode.h"
+#include "mdl/Issue.h"
+#include "mdl/LayerNode.h"
+#include "mdl/PatchNode.h"
+#include "mdl/WorldNode.h"
+
+#include "kdl/overload.h"
+#include "kdl/task_manager.h"
+#include "kdl/vector_utils.h"
+
+#include <unordered_set>
+
+namespace tb::mdl
+{
+namespace
+{
+
+IssueType issueTypes(const std::vector<const Issue*>& issues)
+{
+  auto result = IssueType(0);
+  for (const auto* issue : issues)
+  {
+    result |= issue->type();
+  }
+  return result;
+}
+
+template <typename F>
+void visitIssueTypes(const IssueType issueTypes, const F& f)
+{
+  for (auto bit = IssueType(1); bit != 0; bit <<= 1)
+  {
+    if ((issueTypes & bit) != 0)
+    {
+      f(bit);
+    }
+  }
+}
+
+/**
+ * Calls f for every entity that the given node is linked with.
+ */
+template <typename F>
+void visitLinkedNodes(const Node* node, const F& f)
+{
+  const auto visitEntityLinks = [&](const EntityNodeBase* entityNode) {
+    for (const auto* linkedNodes :
+         {&entityNode->linkSources(),
+          &entityNode->linkTargets(),
+          &entityNode->killSources(),
+          &entityNode->killTargets()})
+    {
+      for (auto* linkedNode : *linkedNodes)
+      {
+        f(linkedNode);
+      }
+    }
+  };
+
+  node->accept(kdl::overload(
+    [&](const WorldNode* worldNode) { visitEntityLinks(worldNode); },
+    [](const LayerNode*) {},
+    [](const GroupNode*) {},
+    [&](const EntityNode* entityNode) { visitEntityLinks(entityNode); },
+    [](const BrushNode*) {},
+    [](const PatchNode*) {}));
+}
+
+} // namespace
+
+void IssueIndex::reset(Node& rootNode, std::vector<const Validator*> validators)
+{
+  clear();
+  m_validators = std::move(validators);
+  addNodes({&rootNode});
+}
+
+void IssueIndex::clear()
+{
+  m_validators.clear();
+  m_dirtyNodes.clear();
+  m_nodeIssueTypes.clear();
+  m_nodesByIssueType.clear();
+}
+
+void IssueIndex::addNodes(const std::vector<Node*>& nodes)
+{
+  for (auto* node : nodes)
+  {
+    node->accept([&](auto&& thisLambda, Node* descendant) {
+      markDirty(descendant);
+      visitLinkedNodes(descendant, [&](Node* linkedNode) { markDirty(linkedNode); });
+      descendant->visitChildren(thisLambda);
+    });
+    markDirty(node->parent());
+  }
+}
+
+void IssueIndex::removeNodes(const std::vector<Node*>& nodes)
+{
+  auto removedNodes = std::unordered_set<Node*>{};
+  auto nodesToValidate = std::vector<Node*>{};
+  for (auto* node : nodes)
+  {
+    node->accept([&](auto&& thisLambda, Node* descendant) {
+      removedNodes.insert(descendant);
+      m_dirtyNodes.erase(descendant);
+      removeFromIndex(descendant);
+      visitLinkedNodes(
+        descendant, [&](Node* linkedNode) { nodesToValidate.push_back(linkedNode); });
+      descendant->visitChildren(thisLambda);
+    });
+    nodesToValidate.push_back(node->parent());
+  }
+
+  // the parents and the linked entities of the removed nodes must be validated again
+  for (auto* node : nodesToValidate)
+  {
+    if (!removedNodes.contains(node))
+    {
+      markDirty(node);
+    }
+  }
+}
+
+void IssueIndex::invalidateNodes(const std::vector<Node*>& nodes)
+{
+  for (auto* node : nodes)
+  {
+    markDirty(node);
+    markDirty(node->parent());
+    visitLinkedNodes(node, [&](Node* linkedNode) { markDirty(linkedNode); });
+  }
+}
+
+bool IssueIndex::hasDirtyNodes() const
+{
+  return !m_dirtyNodes.empty();
+}
+
+void IssueIndex::validate(kdl::task_manager& taskManager)
+{
+  auto leafNodes = std::vector<Node*>{};
+  auto otherNodes = std::vector<Node*>{};
+  for (auto* node : m_dirtyNodes)
+  {
+    node->accept(kdl::overload(
+      [&](WorldNode* worldNode) { otherNodes.push_back(worldNode); },
+      [&](LayerNode* layerNode) { otherNodes.push_back(layerNode); },
+      [&](GroupNode* groupNode) { otherNodes.push_back(groupNode); },
+      [&](EntityNode* entityNode) { otherNodes.push_back(entityNode); },
+      [&](BrushNode* brushNode) { leafNodes.push_back(brushNode); },
+      [&](PatchNode* patchNode) { leafNodes.push_back(patchNode); }));
+  }
+  m_dirtyNodes.clear();
+
+  const auto leafIssueTypes = taskManager.parallel_transform(
+    leafNodes, [&](Node* node) { return issueTypes(node->issues(m_validators)); });
+
+  for (size_t i = 0; i < leafNodes.size(); ++i)
+  {
+    removeFromIndex(leafNodes[i]);
+    addToIndex(leafNodes[i], leafIssueTypes[i]);
+  }
+
+  for (auto* node : otherNodes)
+  {
+    removeFromIndex(node);
+    addToIndex(node, issueTypes(node->issues(m_validators)));
+  }
+}
+
+std::vector<const Issue*> IssueIndex::issues(const IssueType issueTypes) const
+{
+  auto nodes = std::unordered_set<Node*>{};
+  visitIssueTypes(issueTypes, [&](const auto issueType) {
+    if (const auto it = m_nodesByIssueType.find(issueType);
+        it != m_nodesByIssueType.end())
+    {
+      nodes.insert(it->second.begin(), it->second.end());
+    }
+  });
+
+  auto result = std::vector<const Issue*>{};
+  for (auto* node : nodes)
+  {
+    for (const auto* issue : node->issues(m_validators))
+    {
+      if ((issue->type() & issueTypes) != 0)
+      {
+        result.push_back(issue);
+      }
+    }
+  }
+
+  return kdl::vec_sort(std::move(result), [](const auto* lhs, const auto* rhs) {
+    return lhs->seqId() > rhs->seqId();
+  });
+}
+
+void IssueIndex::markDirty(Node* node)
+{
+  if (node)
+  {
+    m_dirtyNodes.insert(node);
+  }
+}
+
+void IssueIndex::removeFromIndex(Node* node)
+{
+  if (const auto it = m_nodeIssueTypes.find(node); it != m_nodeIssueTypes.end())
+  {
+    visitIssueTypes(it->second, [&](const auto issueType) {
+      m_nodesByIssueType[issueType].erase(node);
+    });
+    m_nodeIssueTypes.erase(it);
+  }
+}
+
+void IssueIndex::addToIndex(Node* node, const IssueType issueTypes)
+{
+  if (issueTypes != 0)
+  {
+    m_nodeIssueTypes[node] = issueTypes;
+    visitIssueTypes(issueTypes, [&](const auto issueType) {
+      m_nodesByIssueType[issueType].insert(node);
+    });
+  }
+}
+
+} // namespace tb::mdl
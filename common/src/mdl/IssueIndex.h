@@ -0,0 +1,102 @@
+/*
+ Copyright (C) 2010 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "mdl/IssueType.h"
+
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace kdl
+{
+class task_manager;
+}
+
+namespace tb::mdl
+{
+class Issue;
+class Node;
+class Validator;
+
+/**
+ * Keeps track of which nodes have issues of which type so that the issues of a world can
+ * be collected without visiting every node.
+ *
+ * Nodes that are added or changed are marked as dirty and are only validated again when
+ * validate is called. Nodes whose issues are invalidated by the model without being
+ * marked here still have their issues validated lazily when they are collected.
+ */
+class IssueIndex
+{
+private:
+  std::vector<const Validator*> m_validators;
+  std::unordered_set<Node*> m_dirtyNodes;
+  std::unordered_map<Node*, IssueType> m_nodeIssueTypes;
+  std::unordered_map<IssueType, std::unordered_set<Node*>> m_nodesByIssueType;
+
+public:
+  /**
+   * Clears this index and marks the given node and all of its descendants as dirty.
+   */
+  void reset(Node& rootNode, std::vector<const Validator*> validators);
+  void clear();
+
+  /**
+   * Marks the given nodes, their descendants, their parents and the entities they are
+   * linked with as dirty.
+   */
+  void addNodes(const std::vector<Node*>& nodes);
+
+  /**
+   * Removes the given nodes and their descendants from this index and marks their parents
+   * and the entities they are linked with as dirty. Must be called before the nodes are
+   * removed from their parents.
+   */
+  void removeNodes(const std::vector<Node*>& nodes);
+
+  /**
+   * Marks the given nodes as dirty, together with their parents and the entities they
+   * are linked with.
+   */
+  void invalidateNodes(const std::vector<Node*>& nodes);
+
+  bool hasDirtyNodes() const;
+
+  /**
+   * Validates the dirty nodes and updates the index. Brushes and patches are validated in
+   * parallel, all other nodes are validated on the calling thread because their
+   * validators may access other nodes.
+   */
+  void validate(kdl::task_manager& taskManager);
+
+  /**
+   * Returns the issues of the given types, sorted by descending sequence ID. Dirty nodes
+   * are not considered, so validate should be called first.
+   */
+  std::vector<const Issue*> issues(IssueType issueTypes) const;
+
+private:
+  void markDirty(Node* node);
+  void removeFromIndex(Node* node);
+  void addToIndex(Node* node, IssueType issueTypes);
+};
+
+} // namespace tb::mdl
@@ -19,6 +19,8 @@
 
 #include "MaterialCollection.h"
 
+#include "mdl/MaterialNameIndex.h"
+
 #include "kdl/reflection_impl.h"
 
 #include <algorithm>
@@ -30,15 +32,20 @@ namespace tb::mdl
 
 kdl_reflect_impl(MaterialCollection);
 
-MaterialCollection::MaterialCollection() = default;
+MaterialCollection::MaterialCollection()
+  : m_nameIndex{std::make_shared<MaterialNameIndex>()}
+{
+}
 
 MaterialCollection::MaterialCollection(std::vector<Material> materials)
   : m_materials{std::move(materials)}
+  , m_nameIndex{std::make_shared<MaterialNameIndex>(m_materials)}
 {
 }
 
 MaterialCollection::MaterialCollection(std::filesystem::path path)
   : m_path{std::move(path)}
+  , m_nameIndex{std::make_shared<MaterialNameIndex>()}
 {
 }
 
@@ -46,6 +53,7 @@ MaterialCollection::MaterialCollection(
   std::filesystem::path path, std::vector<Material> materials)
   : m_path{std::move(path)}
   , m_materials{std::move(materials)}
+  , m_nameIndex{std::make_shared<MaterialNameIndex>(m_materials)}
 {
 }
 
@@ -93,4 +101,9 @@ Material* MaterialCollection::materialByName(const std::string& name)
     const_cast<const MaterialCollection*>(this)->materialByName(name));
 }
 
+const std::shared_ptr<const MaterialNameIndex>& MaterialCollection::nameIndex() const
+{
+  return m_nameIndex;
+}
+
 } // namespace tb::mdl
@@ -24,17 +24,20 @@
 #include "kdl/reflection_decl.h"
 
 #include <filesystem>
+#include <memory>
 #include <string>
 #include <vector>
 
 namespace tb::mdl
 {
+class MaterialNameIndex;
 
 class MaterialCollection
 {
 private:
   std::filesystem::path m_path;
   std::vector<Material> m_materials;
+  std::shared_ptr<const MaterialNameIndex> m_nameIndex;
 
   friend class Material;
 
@@ -63,6 +66,12 @@ public:
 
   const Material* materialByName(const std::string& name) const;
   Material* materialByName(const std::string& name);
+
+  /**
+   * Returns an index of the names of this collection's materials. The index is built when
+   * the collection is created, and a new collection always has a new index.
+   */
+  const std::shared_ptr<const MaterialNameIndex>& nameIndex() const;
 };
 
 } // namespace tb::mdl
@@ -23,6 +23,7 @@
 #include "io/LoadMaterialCollections.h"
 #include "mdl/Material.h"
 #include "mdl/MaterialCollection.h"
+#include "mdl/MaterialName.h"
 #include "mdl/Resource.h"
 
 #include "kdl/map_utils.h"
@@ -93,8 +94,19 @@ void MaterialManager::clear()
 
 const Material* MaterialManager::material(const std::string& name) const
 {
-  auto it = m_materialsByName.find(kdl::str_to_lower(name));
-  return it != m_materialsByName.end() ? it->second : nullptr;
+  // Look up the name without interning it, because the looked up names include names
+  // typed by the user and unknown names from maps. Registering a material interns its
+  // name and the lowercase variant, so if neither the given name nor its lowercase
+  // variant are interned, then there is no matching material.
+  if (const auto materialName = MaterialName::find(name))
+  {
+    return material(*materialName);
+  }
+  if (const auto foldedName = MaterialName::find(kdl::str_to_lower(name)))
+  {
+    return material(*foldedName);
+  }
+  return nullptr;
 }
 
 Material* MaterialManager::material(const std::string& name)
@@ -102,6 +114,17 @@ Material* MaterialManager::material(const std::string& name)
   return const_cast<Material*>(const_cast<const MaterialManager*>(this)->material(name));
 }
 
+const Material* MaterialManager::material(const MaterialName& name) const
+{
+  auto it = m_materialsByName.find(name.foldedId());
+  return it != m_materialsByName.end() ? it->second : nullptr;
+}
+
+Material* MaterialManager::material(const MaterialName& name)
+{
+  return const_cast<Material*>(const_cast<const MaterialManager*>(this)->material(name));
+}
+
 const std::vector<const Material*> MaterialManager::findMaterialsByTextureResourceId(
   const std::vector<ResourceId>& textureResourceIds) const
 {
@@ -131,7 +154,7 @@ void MaterialManager::updateMaterials()
   {
     for (auto& material : collection.materials())
     {
-      const auto key = kdl::str_to_lower(material.name());
+      const auto key = MaterialName{material.name()}.foldedId();
 
       auto mIt = m_materialsByName.find(key);
       if (mIt != m_materialsByName.end())
@@ -49,6 +49,7 @@ namespace mdl
 {
 class Material;
 class MaterialCollection;
+class MaterialName;
 class ResourceId;
 
 class MaterialManager
@@ -58,7 +59,8 @@ private:
 
   std::vector<MaterialCollection> m_collections;
 
-  std::unordered_map<std::string, Material*> m_materialsByName;
+  // keyed by the folded ID of the material name
+  std::unordered_map<std::size_t, Material*> m_materialsByName;
   std::vector<const Material*> m_materials;
 
 public:
@@ -83,6 +85,9 @@ public:
   const Material* material(const std::string& name) const;
   Material* material(const std::string& name);
 
+  const Material* material(const MaterialName& name) const;
+  Material* material(const MaterialName& name);
+
   const std::vector<const Material*> findMaterialsByTextureResourceId(
     const std::vector<ResourceId>& textureResourceIds) const;
 
@@ -0,0 +1,195 @@
+/*
+ Copyright (C) 2010 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MaterialName.h"
+
+#include "kdl/string_format.h"
+
+#include <array>
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <ostream>
+#include <shared_mutex>
+#include <unordered_map>
+
+namespace tb::mdl
+{
+namespace detail
+{
+
+struct InternedMaterialName
+{
+  std::string name;
+  std::size_t id;
+  std::size_t foldedId;
+};
+
+} // namespace detail
+
+namespace
+{
+
+/**
+ * The names are distributed among shards by their hash, and every shard has its own lock.
+ * Threads that intern different names, e.g. when parsing a map in parallel, rarely
+ * contend for the same lock.
+ */
+class MaterialNameTable
+{
+private:
+  static constexpr auto ShardCount = std::size_t(64);
+
+  struct Shard
+  {
+    std::shared_mutex mutex;
+    // a deque never moves its elements, so the keys and the handed out pointers remain
+    // valid when new names are added
+    std::deque<detail::InternedMaterialName> entries;
+    std::unordered_map<std::string_view, const detail::InternedMaterialName*> index;
+  };
+
+  std::array<Shard, ShardCount> m_shards;
+  std::atomic<std::size_t> m_nextId = 0;
+
+public:
+  const detail::InternedMaterialName* intern(const std::string_view name)
+  {
+    auto& shard = shardFor(name);
+    if (const auto* entry = find(shard, name))
+    {
+      return entry;
+    }
+
+    // The lowercase variant is interned first so that its ID is known. It lives in a
+    // different shard, so it must be interned before the lock on this shard is taken.
+    const auto foldedName = kdl::str_to_lower(name);
+    const auto foldedId =
+      foldedName != name ? std::optional{intern(foldedName)->id} : std::nullopt;
+
+    const auto lock = std::unique_lock{shard.mutex};
+    if (const auto it = shard.index.find(name); it != shard.index.end())
+    {
+      // another thread may have interned the name after we released the shared lock
+      return it->second;
+    }
+
+    const auto id = m_nextId++;
+    auto& entry = shard.entries.emplace_back(
+      detail::InternedMaterialName{std::string{name}, id, foldedId.value_or(id)});
+    shard.index.emplace(entry.name, &entry);
+    return &entry;
+  }
+
+  const detail::InternedMaterialName* find(const std::string_view name)
+  {
+    return find(shardFor(name), name);
+  }
+
+private:
+  Shard& shardFor(const std::string_view name)
+  {
+    return m_shards[std::hash<std::string_view>{}(name) % ShardCount];
+  }
+
+  static const detail::InternedMaterialName* find(
+    Shard& shard, const std::string_view name)
+  {
+    const auto lock = std::shared_lock{shard.mutex};
+    const auto it = shard.index.find(name);
+    return it != shard.index.end() ? it->second : nullptr;
+  }
+};
+
+MaterialNameTable& materialNameTable()
+{
+  static auto table = MaterialNameTable{};
+  return table;
+}
+
+const detail::InternedMaterialName* emptyMaterialName()
+{
+  static const auto* name = materialNameTable().intern("");
+  return name;
+}
+
+} // namespace
+
+MaterialName::MaterialName()
+  : m_name{emptyMaterialName()}
+{
+}
+
+MaterialName::MaterialName(const std::string_view name)
+  : m_name{materialNameTable().intern(name)}
+{
+}
+
+MaterialName::MaterialName(const detail::InternedMaterialName* name)
+  : m_name{name}
+{
+}
+
+std::optional<MaterialName> MaterialName::find(const std::string_view name)
+{
+  if (const auto* internedName = materialNameTable().find(name))
+  {
+    return MaterialName{internedName};
+  }
+  return std::nullopt;
+}
+
+const std::string& MaterialName::str() const
+{
+  return m_name->name;
+}
+
+std::size_t MaterialName::id() const
+{
+  return m_name->id;
+}
+
+std::size_t MaterialName::foldedId() const
+{
+  return m_name->foldedId;
+}
+
+bool operator==(const MaterialName& lhs, const MaterialName& rhs)
+{
+  return lhs.m_name == rhs.m_name;
+}
+
+std::strong_ordering operator<=>(const MaterialName& lhs, const MaterialName& rhs)
+{
+  return lhs.m_name == rhs.m_name ? std::strong_ordering::equal
+                                  : lhs.m_name->name <=> rhs.m_name->name;
+}
+
+std::ostream& operator<<(std::ostream& lhs, const MaterialName& rhs)
+{
+  return lhs << rhs.str();
+}
+
+} // namespace tb::mdl
+
+std::size_t std::hash<tb::mdl::MaterialName>::operator()(
+  const tb::mdl::MaterialName& materialName) const noexcept
+{
+  return std::hash<std::size_t>{}(materialName.id());
+}
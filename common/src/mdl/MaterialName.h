@@ -0,0 +1,101 @@
+/*
+ Copyright (C) 2010 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <compare>
+#include <cstddef>
+#include <functional>
+#include <iosfwd>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace tb::mdl
+{
+namespace detail
+{
+struct InternedMaterialName;
+}
+
+/**
+ * A material name that is interned in a global, thread-safe table.
+ *
+ * Every distinct name is stored only once, and a material name is just a pointer to its
+ * table entry. Therefore, copying and comparing material names for equality is cheap.
+ * Each name also knows the ID of its lowercase variant, which allows case-insensitive
+ * lookups without creating temporary strings.
+ *
+ * Interned names are never removed from the table, so it grows with every distinct name
+ * that is used during a session, and with the lowercase variant of every name that is not
+ * lowercase. Names come from the material collections and the maps that are loaded, so
+ * the table usually holds a few thousand names of some dozen bytes each. Code that
+ * processes arbitrary strings should use find instead of interning them.
+ */
+class MaterialName
+{
+private:
+  const detail::InternedMaterialName* m_name;
+
+public:
+  /**
+   * Creates an empty material name.
+   */
+  MaterialName();
+
+  explicit MaterialName(std::string_view name);
+
+  /**
+   * Returns the material name for the given string if it has already been interned, and
+   * an empty optional otherwise. Unlike the constructor, this never adds the string to
+   * the table.
+   */
+  static std::optional<MaterialName> find(std::string_view name);
+
+private:
+  explicit MaterialName(const detail::InternedMaterialName* name);
+
+public:
+  const std::string& str() const;
+
+  /**
+   * Returns a unique ID for this name. Two names have the same ID if and only if they are
+   * equal.
+   */
+  std::size_t id() const;
+
+  /**
+   * Returns the ID of the lowercase variant of this name. Two names have the same folded
+   * ID if and only if they are equal when compared case insensitively.
+   */
+  std::size_t foldedId() const;
+
+  friend bool operator==(const MaterialName& lhs, const MaterialName& rhs);
+  friend std::strong_ordering operator<=>(
+    const MaterialName& lhs, const MaterialName& rhs);
+  friend std::ostream& operator<<(std::ostream& lhs, const MaterialName& rhs);
+};
+
+} // namespace tb::mdl
+
+template <>
+struct std::hash<tb::mdl::MaterialName>
+{
+  std::size_t operator()(const tb::mdl::MaterialName& materialName) const noexcept;
+};
@@ -0,0 +1,118 @@
+/*
+ Copyright (C) 2010 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MaterialNameIndex.h"
+
+#include "mdl/Material.h"
+
+#include "kdl/string_format.h"
+
+#include <numeric>
+
+namespace tb::mdl
+{
+namespace
+{
+
+constexpr auto TrigramLength = size_t(3);
+
+std::uint32_t makeTrigram(const std::string_view str, const size_t offset)
+{
+  return (std::uint32_t(static_cast<unsigned char>(str[offset])) << 16)
+         | (std::uint32_t(static_cast<unsigned char>(str[offset + 1u])) << 8)
+         | std::uint32_t(static_cast<unsigned char>(str[offset + 2u]));
+}
+
+} // namespace
+
+MaterialNameIndex::MaterialNameIndex() = default;
+
+MaterialNameIndex::MaterialNameIndex(const std::vector<Material>& materials)
+{
+  m_names.reserve(materials.size());
+  for (size_t i = 0; i < materials.size(); ++i)
+  {
+    auto name = kdl::str_to_lower(materials[i].name());
+    for (size_t offset = 0; offset + TrigramLength <= name.size(); ++offset)
+    {
+      auto& materialIndices = m_materialsByTrigram[makeTrigram(name, offset)];
+
+      // a trigram can occur several times in a name
+      if (materialIndices.empty() || materialIndices.back() != i)
+      {
+        materialIndices.push_back(i);
+      }
+    }
+    m_names.push_back(std::move(name));
+  }
+}
+
+size_t MaterialNameIndex::materialCount() const
+{
+  return m_names.size();
+}
+
+std::vector<size_t> MaterialNameIndex::findMaterials(const std::string_view str) const
+{
+  const auto lowerCaseStr = kdl::str_to_lower(str);
+  if (lowerCaseStr.size() < TrigramLength)
+  {
+    auto allMaterials = std::vector<size_t>(m_names.size());
+    std::iota(allMaterials.begin(), allMaterials.end(), size_t(0));
+    return filterMaterials(lowerCaseStr, allMaterials);
+  }
+
+  const std::vector<size_t>* candidates = nullptr;
+  for (size_t offset = 0; offset + TrigramLength <= lowerCaseStr.size(); ++offset)
+  {
+    const auto it = m_materialsByTrigram.find(makeTrigram(lowerCaseStr, offset));
+    if (it == m_materialsByTrigram.end())
+    {
+      return {};
+    }
+    if (!candidates || it->second.size() < candidates->size())
+    {
+      candidates = &it->second;
+    }
+  }
+
+  return filterMaterials(lowerCaseStr, *candidates);
+}
+
+std::vector<size_t> MaterialNameIndex::findMaterials(
+  const std::string_view str, const std::vector<size_t>& candidates) const
+{
+  return filterMaterials(kdl::str_to_lower(str), candidates);
+}
+
+std::vector<size_t> MaterialNameIndex::filterMaterials(
+  const std::string& lowerCaseStr, const std::vector<size_t>& candidates) const
+{
+  auto result = std::vector<size_t>{};
+  for (const auto i : candidates)
+  {
+    if (i < m_names.size() && m_names[i].find(lowerCaseStr) != std::string::npos)
+    {
+      result.push_back(i);
+    }
+  }
+  return result;
+}
+
+} // namespace tb::mdl
@@ -0,0 +1,78 @@
+/*
+ Copyright (C) 2010 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace tb::mdl
+{
+class Material;
+
+/**
+ * An index of material names that finds the materials whose names contain a given
+ * string, ignoring case.
+ *
+ * The index maps every sequence of three consecutive characters (a trigram) of the lower
+ * case material names to the materials whose names contain it. Only the materials that
+ * contain the least common trigram of a search string must be checked to find the
+ * materials that contain the entire string.
+ *
+ * The materials are identified by their positions in the vector that the index was built
+ * from.
+ */
+class MaterialNameIndex
+{
+private:
+  using Trigram = std::uint32_t;
+
+  std::vector<std::string> m_names;
+  std::unordered_map<Trigram, std::vector<size_t>> m_materialsByTrigram;
+
+public:
+  MaterialNameIndex();
+  explicit MaterialNameIndex(const std::vector<Material>& materials);
+
+  size_t materialCount() const;
+
+  /**
+   * Returns the positions of the materials whose names contain the given string, ignoring
+   * case. The positions are returned in ascending order.
+   */
+  std::vector<size_t> findMaterials(std::string_view str) const;
+
+  /**
+   * Returns the positions of the materials at the given positions whose names contain the
+   * given string, ignoring case. The result retains the order of the given positions.
+   *
+   * Use this to narrow down a previous result when the string is extended.
+   */
+  std::vector<size_t> findMaterials(
+    std::string_view str, const std::vector<size_t>& candidates) const;
+
+private:
+  std::vector<size_t> filterMaterials(
+    const std::string& lowerCaseStr, const std::vector<size_t>& candidates) const;
+};
+
+} // namespace tb::mdl
@@ -346,6 +346,43 @@ vm::bbox3d computePhysicalBounds(
   return builder.initialized() ? builder.bounds() : defaultBounds;
 }
 
+size_t computeMemoryUsage(const std::vector<Node*>& nodes)
+{
+  auto result = size_t(0);
+  const auto addChildren = [&](const auto* node, const auto& visitChild) {
+    result += node->children().capacity() * sizeof(Node*);
+    node->visitChildren(visitChild);
+  };
+
+  Node::visitAll(
+    nodes,
+    kdl::overload(
+      [&](auto&& thisLambda, const WorldNode* world) {
+        result += sizeof(WorldNode) + world->entity().memoryUsage();
+        addChildren(world, thisLambda);
+      },
+      [&](auto&& thisLambda, const LayerNode* layer) {
+        result += sizeof(LayerNode) + layer->name().capacity();
+        addChildren(layer, thisLambda);
+      },
+      [&](auto&& thisLambda, const GroupNode* group) {
+        result += sizeof(GroupNode) + group->name().capacity();
+        addChildren(group, thisLambda);
+      },
+      [&](auto&& thisLambda, const EntityNode* entity) {
+        result += sizeof(EntityNode) + entity->entity().memoryUsage();
+        addChildren(entity, thisLambda);
+      },
+      [&](const BrushNode* brush) {
+        result += sizeof(BrushNode) + brush->brush().memoryUsage();
+      },
+      [&](const PatchNode* patch) {
+        result += sizeof(PatchNode) + patch->patch().memoryUsage()
+                  + patch->grid().points.capacity() * sizeof(PatchGrid::Point);
+      }));
+  return result;
+}
+
 std::vector<BrushNode*> filterBrushNodes(const std::vector<Node*>& nodes)
 {
   auto result = std::vector<BrushNode*>{};
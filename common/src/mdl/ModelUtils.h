@@ -77,6 +77,12 @@ vm::bbox3d computeLogicalBounds(
 vm::bbox3d computePhysicalBounds(
   const std::vector<Node*>& nodes, const vm::bbox3d& defaultBounds = vm::bbox3d());
 
+/**
+ * Returns an estimate of the number of heap allocated bytes that would be released if
+ * the given nodes and their descendants were destroyed.
+ */
+size_t computeMemoryUsage(const std::vector<Node*>& nodes);
+
 std::vector<BrushNode*> filterBrushNodes(const std::vector<Node*>& nodes);
 std::vector<EntityNode*> filterEntityNodes(const std::vector<Node*>& nodes);
 
@@ -23,6 +23,7 @@
 #include "Macros.h"
 #include "mdl/EntityProperties.h"
 #include "mdl/Issue.h"
+#include "mdl/StateEpoch.h"
 #include "mdl/Validator.h"
 
 #include "kdl/range_utils.h"
@@ -31,6 +32,7 @@
 
 #include <cassert>
 #include <iterator>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -39,11 +41,60 @@ namespace tb::mdl
 
 kdl_reflect_impl(NodePath);
 
-Node::Node() = default;
+namespace
+{
+
+class NodeIndexAllocator
+{
+private:
+  std::mutex m_mutex;
+  std::vector<size_t> m_freeIndices;
+  size_t m_nextIndex = 0;
+
+public:
+  size_t allocate()
+  {
+    const auto lock = std::lock_guard{m_mutex};
+    if (m_freeIndices.empty())
+    {
+      return m_nextIndex++;
+    }
+
+    const auto index = m_freeIndices.back();
+    m_freeIndices.pop_back();
+    return index;
+  }
+
+  void release(const size_t index)
+  {
+    const auto lock = std::lock_guard{m_mutex};
+    m_freeIndices.push_back(index);
+  }
+};
+
+NodeIndexAllocator& nodeIndexAllocator()
+{
+  // nodes are created in parallel when a map is loaded, and the allocator is never
+  // destroyed so that nodes can still be destroyed during static destruction
+  static auto* allocator = new NodeIndexAllocator{};
+  return *allocator;
+}
+
+} // namespace
+
+Node::Node()
+  : m_index{nodeIndexAllocator().allocate()}
+{
+}
 
 Node::~Node()
 {
   clearChildren();
+
+  // information that was cached for this node must not be found for a node that reuses
+  // its index
+  advanceStateEpoch();
+  nodeIndexAllocator().release(m_index);
 }
 
 const std::string& Node::name() const
@@ -51,6 +102,11 @@ const std::string& Node::name() const
   return doGetName();
 }
 
+size_t Node::index() const
+{
+  return m_index;
+}
+
 NodePath Node::pathFrom(const Node& ancestor) const
 {
   auto result = NodePath{};
@@ -428,6 +484,7 @@ void Node::setParent(Node* parent)
   {
     parentWillChange();
     m_parent = parent;
+    advanceStateEpoch();
     parentDidChange();
   }
 }
@@ -475,6 +532,7 @@ void Node::nodeWillChange()
 
 void Node::nodeDidChange()
 {
+  advanceStateEpoch();
   if (m_parent)
   {
     m_parent->childDidChange(this);
@@ -571,6 +629,7 @@ void Node::select()
   {
     assert(!m_selected);
     m_selected = true;
+    advanceStateEpoch();
     if (m_parent)
     {
       m_parent->childWasSelected();
@@ -584,6 +643,7 @@ void Node::deselect()
   {
     assert(m_selected);
     m_selected = false;
+    advanceStateEpoch();
     if (m_parent)
     {
       m_parent->childWasDeselected();
@@ -719,6 +779,7 @@ bool Node::setVisibilityState(const VisibilityState visibility)
   if (visibility != m_visibilityState)
   {
     m_visibilityState = visibility;
+    advanceStateEpoch();
     return true;
   }
   return false;
@@ -762,6 +823,7 @@ bool Node::setLockState(const LockState lockState)
   if (lockState != m_lockState)
   {
     m_lockState = lockState;
+    advanceStateEpoch();
     return true;
   }
   return false;
@@ -774,7 +836,11 @@ bool Node::lockedByOtherSelection() const
 
 void Node::setLockedByOtherSelection(const bool lockedByOtherSelection)
 {
-  m_lockedByOtherSelection = lockedByOtherSelection;
+  if (lockedByOtherSelection != m_lockedByOtherSelection)
+  {
+    m_lockedByOtherSelection = lockedByOtherSelection;
+    advanceStateEpoch();
+  }
 }
 
 void Node::pick(
@@ -793,6 +859,11 @@ size_t Node::lineNumber() const
   return m_lineNumber;
 }
 
+size_t Node::lineCount() const
+{
+  return m_lineCount;
+}
+
 void Node::setFilePosition(const size_t lineNumber, const size_t lineCount) const
 {
   m_lineNumber = lineNumber;
@@ -846,6 +917,14 @@ void Node::invalidateIssues() const
   m_issuesValid = false;
 }
 
+void Node::addIssues(const Validator& validator)
+{
+  if (m_issuesValid)
+  {
+    validator.validate(*this, m_issues);
+  }
+}
+
 const EntityPropertyConfig& Node::entityPropertyConfig() const
 {
   return doGetEntityPropertyConfig();
@@ -879,6 +958,12 @@ void Node::removeFromIndex(
   doRemoveFromIndex(node, key, value);
 }
 
+void Node::updateLinkIdIndex(
+  Node* node, const std::string& oldLinkId, const std::string& newLinkId)
+{
+  doUpdateLinkIdIndex(node, oldLinkId, newLinkId);
+}
+
 Node* Node::doCloneRecursively(const vm::bbox3d& worldBounds) const
 {
   auto* clone = Node::clone(worldBounds);
@@ -967,4 +1052,13 @@ void Node::doRemoveFromIndex(
   }
 }
 
+void Node::doUpdateLinkIdIndex(
+  Node* node, const std::string& oldLinkId, const std::string& newLinkId)
+{
+  if (m_parent)
+  {
+    m_parent->updateLinkIdIndex(node, oldLinkId, newLinkId);
+  }
+}
+
 } // namespace tb::mdl
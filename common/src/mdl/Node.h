@@ -59,6 +59,7 @@ struct NodePath
 class Node : public Taggable
 {
 private:
+  size_t m_index;
   Node* m_parent = nullptr;
   std::vector<Node*> m_children;
   size_t m_descendantCount = 0;
@@ -91,6 +92,13 @@ public:
 public: // getters
   const std::string& name() const;
 
+  /**
+   * Returns an index that is unique among all nodes that currently exist. The indices of
+   * destroyed nodes are reused, so the indices are dense and can be used to store
+   * information about nodes in arrays or bitsets.
+   */
+  size_t index() const;
+
   /**
    * Returns a path from the given ancestor to this node.
    *
@@ -345,6 +353,7 @@ public: // picking
 
 public: // file position
   size_t lineNumber() const;
+  size_t lineCount() const;
   void setFilePosition(size_t lineNumber, size_t lineCount) const;
   bool containsLine(size_t lineNumber) const;
 
@@ -357,6 +366,12 @@ public: // issue management
 public: // should only be called from this and from the world
   void invalidateIssues() const;
 
+  /**
+   * Adds the issues found by the given validator to this node's issues if they are
+   * valid. Otherwise, the validator will be applied when the issues are validated.
+   */
+  void addIssues(const Validator& validator);
+
 private:
   void validateIssues(const std::vector<const Validator*>& validators);
 
@@ -502,6 +517,9 @@ protected: // index management
   void removeFromIndex(
     EntityNodeBase* node, const std::string& key, const std::string& value);
 
+  void updateLinkIdIndex(
+    Node* node, const std::string& oldLinkId, const std::string& newLinkId);
+
 private: // subclassing interface
   virtual const std::string& doGetName() const = 0;
   virtual const vm::bbox3d& doGetLogicalBounds() const = 0;
@@ -567,6 +585,8 @@ private: // subclassing interface
     EntityNodeBase* node, const std::string& key, const std::string& value);
   virtual void doRemoveFromIndex(
     EntityNodeBase* node, const std::string& key, const std::string& value);
+  virtual void doUpdateLinkIdIndex(
+    Node* node, const std::string& oldLinkId, const std::string& newLinkId);
 };
 
 } // namespace tb::mdl
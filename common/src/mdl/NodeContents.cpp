@@ -55,4 +55,16 @@ std::variant<Layer, Group, Entity, Brush, BezierPatch>& NodeContents::get()
   return m_contents;
 }
 
+size_t NodeContents::memoryUsage() const
+{
+  return std::visit(
+    kdl::overload(
+      [](const Layer&) -> size_t { return 0; },
+      [](const Group&) -> size_t { return 0; },
+      [](const Entity& entity) { return entity.memoryUsage(); },
+      [](const Brush& brush) { return brush.memoryUsage(); },
+      [](const BezierPatch& patch) { return patch.memoryUsage(); }),
+    m_contents);
+}
+
 } // namespace tb::mdl
@@ -44,6 +44,12 @@ public:
 
   const std::variant<Layer, Group, Entity, Brush, BezierPatch>& get() const;
   std::variant<Layer, Group, Entity, Brush, BezierPatch>& get();
+
+  /**
+   * Returns an estimate of the number of heap allocated bytes held by these contents.
+   * Brush geometry that is shared with other brushes is not included.
+   */
+  size_t memoryUsage() const;
 };
 
 } // namespace tb::mdl
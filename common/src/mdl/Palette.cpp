@@ -26,6 +26,7 @@
 #include "io/ImageLoader.h"
 #include "io/Reader.h"
 #include "mdl/TextureBuffer.h"
+#include "mdl/TextureStatistics.h"
 
 #include "kdl/path_utils.h"
 #include "kdl/reflection_impl.h"
@@ -34,8 +35,11 @@
 #include <fmt/format.h>
 #include <fmt/std.h>
 
+#include <algorithm>
+#include <cassert>
 #include <cstring>
 #include <ostream>
+#include <span>
 #include <string>
 
 namespace tb::mdl
@@ -73,47 +77,26 @@ bool Palette::indexedToRgba(
 {
   ensure(rgbaImage.size() == 4 * pixelCount, "incorrect destination buffer size");
 
-  const unsigned char* paletteData = (transparency == PaletteTransparency::Opaque)
-                                       ? m_data->opaqueData.data()
-                                       : m_data->index255TransparentData.data();
+  const auto& paletteData = (transparency == PaletteTransparency::Opaque)
+                              ? m_data->opaqueData
+                              : m_data->index255TransparentData;
 
-  // Write rgba pixels
-  auto* const rgbaData = rgbaImage.data();
-  for (size_t i = 0; i < pixelCount; ++i)
-  {
-    const int index = reader.readInt<unsigned char>();
+  assert(paletteData.size() >= 1024);
 
-    std::memcpy(rgbaData + (i * 4), &paletteData[index * 4], 4);
-  }
+  const auto statistics = expandIndexedPixels(
+    reader.readBytes(pixelCount),
+    std::span<const unsigned char, 1024>{paletteData.data(), 1024},
+    std::span<unsigned char>{rgbaImage.data(), rgbaImage.size()});
 
-  // Check average color
-  uint32_t colorSum[3] = {0, 0, 0};
-  for (size_t i = 0; i < pixelCount; ++i)
-  {
-    colorSum[0] += uint32_t(rgbaData[(i * 4) + 0]);
-    colorSum[1] += uint32_t(rgbaData[(i * 4) + 1]);
-    colorSum[2] += uint32_t(rgbaData[(i * 4) + 2]);
-  }
   averageColor = Color{
-    float(colorSum[0]) / (255.0f * float(pixelCount)),
-    float(colorSum[1]) / (255.0f * float(pixelCount)),
-    float(colorSum[2]) / (255.0f * float(pixelCount)),
+    float(statistics.channelSums[0]) / (255.0f * float(pixelCount)),
+    float(statistics.channelSums[1]) / (255.0f * float(pixelCount)),
+    float(statistics.channelSums[2]) / (255.0f * float(pixelCount)),
     1.0f};
 
-  // Check for transparency
-  auto hasTransparency = false;
-  if (transparency == PaletteTransparency::Index255Transparent)
-  {
-    // Take the bitwise AND of the alpha channel of all pixels
-    unsigned char andAlpha = 0xFF;
-    for (size_t i = 0; i < pixelCount; ++i)
-    {
-      andAlpha = static_cast<unsigned char>(andAlpha & rgbaData[4 * i + 3]);
-    }
-    hasTransparency = (andAlpha != 0xFF);
-  }
-
-  return hasTransparency;
+  // the alpha channel of the opaque palette is always 0xFF
+  return transparency == PaletteTransparency::Index255Transparent
+         && statistics.alphaAnd != 0xFF;
 }
 
 bool operator==(const Palette& lhs, const Palette& rhs)
@@ -146,13 +129,17 @@ std::ostream& operator<<(std::ostream& lhs, const Palette& rhs)
 Result<Palette> makePalette(
   const std::vector<unsigned char>& data, const PaletteColorFormat colorFormat)
 {
+  // indexed images can refer to any of the 256 palette entries, so shorter palettes are
+  // padded with black
+  constexpr auto PaletteSize = size_t(256);
+
   auto result = std::make_shared<PaletteData>();
 
   switch (colorFormat)
   {
   case PaletteColorFormat::Rgb:
     // transform data to RGBA
-    result->opaqueData.reserve(data.size() / 3 * 4);
+    result->opaqueData.reserve(std::max(data.size() / 3, PaletteSize) * 4);
 
     for (size_t i = 0; i < data.size() / 3; ++i)
     {
@@ -166,17 +153,23 @@ Result<Palette> makePalette(
       result->opaqueData.push_back(0xFF);
     }
 
-    if (!result->opaqueData.empty())
+    for (size_t i = data.size() / 3; i < PaletteSize; ++i)
     {
-      // build index255TransparentData from opaqueData
-      result->index255TransparentData = result->opaqueData;
-      result->index255TransparentData.back() = 0;
+      result->opaqueData.insert(result->opaqueData.end(), {0x00, 0x00, 0x00, 0xFF});
     }
+
+    // build index255TransparentData from opaqueData
+    result->index255TransparentData = result->opaqueData;
+    result->index255TransparentData[4 * 255 + 3] = 0;
     break;
   case PaletteColorFormat::Rgba:
     // The data is already in RGBA format, don't process it
     result->opaqueData = data;
-    result->index255TransparentData = data;
+    if (result->opaqueData.size() < PaletteSize * 4)
+    {
+      result->opaqueData.resize(PaletteSize * 4, 0x00);
+    }
+    result->index255TransparentData = result->opaqueData;
     break;
   }
 
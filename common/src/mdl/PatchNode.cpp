@@ -39,13 +39,16 @@
 #include "vm/intersection.h"
 #include "vm/vec_io.h" // IWYU pragma: keep
 
+#include <algorithm>
 #include <cassert>
 #include <string>
 
 namespace tb::mdl
 {
 
-constexpr static size_t DefaultSubdivisionsPerSurface = 3u;
+constexpr static size_t MaxSubdivisionsPerSurface = 3u;
+constexpr static double MaxPositionError = 0.5;
+constexpr static double MaxUVError = 1.0 / 256.0;
 
 kdl_reflect_impl(PatchGrid::Point);
 
@@ -266,18 +269,29 @@ std::vector<vm::vec3d> computeGridNormals(
 }
 
 PatchGrid makePatchGrid(const BezierPatch& patch, const size_t subdivisionsPerSurface)
+{
+  return makePatchGrid(patch, subdivisionsPerSurface, subdivisionsPerSurface);
+}
+
+PatchGrid makePatchGrid(
+  const BezierPatch& patch,
+  const size_t rowSubdivisionsPerSurface,
+  const size_t columnSubdivisionsPerSurface)
 {
   const size_t gridPointRowCount =
-    patch.surfaceRowCount() * (size_t(1) << subdivisionsPerSurface) + 1u;
+    patch.surfaceRowCount() * (size_t(1) << rowSubdivisionsPerSurface) + 1u;
   const size_t gridPointColumnCount =
-    patch.surfaceColumnCount() * (size_t(1) << subdivisionsPerSurface) + 1u;
+    patch.surfaceColumnCount() * (size_t(1) << columnSubdivisionsPerSurface) + 1u;
 
-  const auto patchGrid = patch.evaluate(subdivisionsPerSurface);
+  const auto patchGrid =
+    patch.evaluate(rowSubdivisionsPerSurface, columnSubdivisionsPerSurface);
   const auto normals =
     computeGridNormals(patchGrid, gridPointRowCount, gridPointColumnCount);
   assert(patchGrid.size() == normals.size());
 
   auto points = std::vector<PatchGrid::Point>{};
+  points.reserve(patchGrid.size());
+
   auto boundsBuilder = vm::bbox3d::builder{};
   for (const auto [point, normal] : kdl::make_zip_range(patchGrid, normals))
   {
@@ -291,11 +305,177 @@ PatchGrid makePatchGrid(const BezierPatch& patch, const size_t subdivisionsPerSu
     gridPointRowCount, gridPointColumnCount, std::move(points), boundsBuilder.bounds()};
 }
 
+kdl_reflect_impl(PatchSubdivisions);
+
+namespace
+{
+
+struct PatchError
+{
+  double position = 0.0;
+  double uv = 0.0;
+
+  void add(const BezierPatch::Point& error)
+  {
+    position = std::max(position, vm::length(vm::slice<3>(error, 0)));
+    uv = std::max(uv, vm::length(vm::slice<2>(error, 3)));
+  }
+};
+
+/**
+ * Returns the distance between the midpoint of the quadratic Bezier curve with the given
+ * control points and the midpoint of its chord, which is the largest distance between the
+ * curve and its chord.
+ */
+BezierPatch::Point flatnessError(
+  const BezierPatch::Point& p0,
+  const BezierPatch::Point& p1,
+  const BezierPatch::Point& p2)
+{
+  return (p0 - 2.0 * p1 + p2) / 4.0;
+}
+
+/**
+ * Returns an upper bound for the distance between the given patch and a grid with the
+ * given subdivisions. Every subdivision quarters the flatness error in its direction and
+ * halves the twist error, and the errors add up.
+ */
+double gridError(
+  const double rowError,
+  const double columnError,
+  const double twistError,
+  const size_t rowSubdivisions,
+  const size_t columnSubdivisions)
+{
+  const auto scale = [](const size_t factor, const size_t subdivisions) {
+    return static_cast<double>(size_t(1) << (factor * subdivisions));
+  };
+  return rowError / scale(2u, rowSubdivisions)
+         + columnError / scale(2u, columnSubdivisions)
+         + twistError / scale(1u, rowSubdivisions + columnSubdivisions);
+}
+
+} // namespace
+
+PatchSubdivisions computePatchSubdivisions(
+  const BezierPatch& patch,
+  const double maxPositionError,
+  const double maxUVError,
+  const size_t maxSubdivisionsPerSurface)
+{
+  const auto rowCount = patch.pointRowCount();
+  const auto columnCount = patch.pointColumnCount();
+
+  // the curves along the rows determine the column subdivisions and vice versa
+  auto columnError = PatchError{};
+  auto rowError = PatchError{};
+
+  // the twist of the control net makes the quads of a grid non-planar
+  auto twistError = PatchError{};
+
+  for (size_t row = 0u; row < rowCount; ++row)
+  {
+    for (size_t col = 0u; col + 2u < columnCount; col += 2u)
+    {
+      columnError.add(flatnessError(
+        patch.controlPoint(row, col),
+        patch.controlPoint(row, col + 1u),
+        patch.controlPoint(row, col + 2u)));
+    }
+  }
+
+  for (size_t col = 0u; col < columnCount; ++col)
+  {
+    for (size_t row = 0u; row + 2u < rowCount; row += 2u)
+    {
+      rowError.add(flatnessError(
+        patch.controlPoint(row, col),
+        patch.controlPoint(row + 1u, col),
+        patch.controlPoint(row + 2u, col)));
+    }
+  }
+
+  for (size_t row = 0u; row + 1u < rowCount; ++row)
+  {
+    for (size_t col = 0u; col + 1u < columnCount; ++col)
+    {
+      twistError.add(
+        patch.controlPoint(row, col) - patch.controlPoint(row, col + 1u)
+        - patch.controlPoint(row + 1u, col) + patch.controlPoint(row + 1u, col + 1u));
+    }
+  }
+
+  // the ratio of the grid error to the max error in world or UV space, whichever is larger
+  const auto relativeGridError = [&](const PatchSubdivisions& subdivisions) {
+    const auto r = subdivisions.rowSubdivisionsPerSurface;
+    const auto c = subdivisions.columnSubdivisionsPerSurface;
+    return std::max(
+      gridError(rowError.position, columnError.position, twistError.position, r, c)
+        / maxPositionError,
+      gridError(rowError.uv, columnError.uv, twistError.uv, r, c) / maxUVError);
+  };
+
+  const auto subdivisionCount = [](const PatchSubdivisions& subdivisions) {
+    return subdivisions.rowSubdivisionsPerSurface
+           + subdivisions.columnSubdivisionsPerSurface;
+  };
+
+  // Find the subdivisions with the fewest grid points that keep the error below the max
+  // error. If no subdivisions achieve that, use the ones with the smallest error.
+  auto result = PatchSubdivisions{0u, 0u};
+  auto resultError = relativeGridError(result);
+
+  for (size_t r = 0u; r <= maxSubdivisionsPerSurface; ++r)
+  {
+    for (size_t c = 0u; c <= maxSubdivisionsPerSurface; ++c)
+    {
+      const auto candidate = PatchSubdivisions{r, c};
+      const auto candidateError = relativeGridError(candidate);
+
+      const auto isBetter =
+        resultError > 1.0
+          ? candidateError < resultError
+              || (candidateError == resultError
+                  && subdivisionCount(candidate) < subdivisionCount(result))
+          : candidateError <= 1.0
+              && (subdivisionCount(candidate) < subdivisionCount(result)
+                  || (subdivisionCount(candidate) == subdivisionCount(result)
+                      && candidateError < resultError));
+      if (isBetter)
+      {
+        result = candidate;
+        resultError = candidateError;
+      }
+    }
+  }
+
+  return result;
+}
+
+namespace
+{
+
+/**
+ * Tessellates the given patch only as finely as its curvature requires. Flat patches are
+ * represented by one quad per surface.
+ */
+PatchGrid makeAdaptivePatchGrid(const BezierPatch& patch)
+{
+  const auto subdivisions = computePatchSubdivisions(
+    patch, MaxPositionError, MaxUVError, MaxSubdivisionsPerSurface);
+  return makePatchGrid(
+    patch,
+    subdivisions.rowSubdivisionsPerSurface,
+    subdivisions.columnSubdivisionsPerSurface);
+}
+
+} // namespace
+
 const HitType::Type PatchNode::PatchHitType = HitType::freeType();
 
 PatchNode::PatchNode(BezierPatch patch)
   : m_patch{std::move(patch)}
-  , m_grid{makePatchGrid(m_patch, DefaultSubdivisionsPerSurface)}
+  , m_grid{makeAdaptivePatchGrid(m_patch)}
 {
 }
 
@@ -336,7 +516,7 @@ BezierPatch PatchNode::setPatch(BezierPatch patch)
   const auto boundsChange = NotifyPhysicalBoundsChange{*this};
 
   auto previousPatch = std::exchange(m_patch, std::move(patch));
-  m_grid = makePatchGrid(m_patch, DefaultSubdivisionsPerSurface);
+  m_grid = makeAdaptivePatchGrid(m_patch);
   return previousPatch;
 }
 
@@ -476,6 +656,11 @@ GroupNode* PatchNode::doGetContainingGroup()
   return findContainingGroup(this);
 }
 
+void PatchNode::doLinkIdDidChange(const std::string& oldLinkId)
+{
+  updateLinkIdIndex(this, oldLinkId, m_linkId);
+}
+
 void PatchNode::doAcceptTagVisitor(TagVisitor& visitor)
 {
   visitor.visit(*this);
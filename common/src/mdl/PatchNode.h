@@ -67,6 +67,37 @@ std::vector<vm::vec3d> computeGridNormals(
 // public for testing
 PatchGrid makePatchGrid(const BezierPatch& patch, size_t subdivisionsPerSurface);
 
+// public for testing
+PatchGrid makePatchGrid(
+  const BezierPatch& patch,
+  size_t rowSubdivisionsPerSurface,
+  size_t columnSubdivisionsPerSurface);
+
+struct PatchSubdivisions
+{
+  size_t rowSubdivisionsPerSurface;
+  size_t columnSubdivisionsPerSurface;
+
+  kdl_reflect_decl(
+    PatchSubdivisions, rowSubdivisionsPerSurface, columnSubdivisionsPerSurface);
+};
+
+/**
+ * Determines how often the surfaces of the given patch must be subdivided along their
+ * rows and columns so that the resulting grid deviates from the patch by at most
+ * maxPositionError in world space and by at most maxUVError in UV space.
+ *
+ * All surfaces are subdivided equally so that adjacent surfaces share their grid points,
+ * but the rows and the columns are subdivided independently. Neither is subdivided more
+ * than maxSubdivisionsPerSurface times. If the error bounds cannot be met within that
+ * limit, the subdivisions with the smallest error are returned.
+ */
+PatchSubdivisions computePatchSubdivisions(
+  const BezierPatch& patch,
+  double maxPositionError,
+  double maxUVError,
+  size_t maxSubdivisionsPerSurface);
+
 class PatchNode : public Node, public Object
 {
 public:
@@ -119,6 +150,7 @@ private: // implement Object interface
   Node* doGetContainer() override;
   LayerNode* doGetContainingLayer() override;
   GroupNode* doGetContainingGroup() override;
+  void doLinkIdDidChange(const std::string& oldLinkId) override;
 
 private: // implement Taggable interface
   void doAcceptTagVisitor(TagVisitor& visitor) override;
@@ -20,6 +20,7 @@
 #pragma once
 
 #include "kdl/intrusive_circular_list.h"
+#include "kdl/slab_pool.h"
 
 #include "vm/bbox.h"
 #include "vm/plane.h"
@@ -78,7 +79,7 @@ struct Polyhedron_GetVertexLink
  * The payload of a vertex can be used to store user data.
  */
 template <typename T, typename FP, typename VP>
-class Polyhedron_Vertex
+class Polyhedron_Vertex : public kdl::slab_allocated<Polyhedron_Vertex<T, FP, VP>>
 {
 private:
   friend class Polyhedron<T, FP, VP>;
@@ -233,7 +234,7 @@ struct Polyhedron_GetEdgeLink
  * intrusive circular list.
  */
 template <typename T, typename FP, typename VP>
-class Polyhedron_Edge
+class Polyhedron_Edge : public kdl::slab_allocated<Polyhedron_Edge<T, FP, VP>>
 {
 private:
   friend class Polyhedron<T, FP, VP>;
@@ -549,7 +550,7 @@ struct Polyhedron_GetHalfEdgeLink
  * boundary the half edge belongs to.
  */
 template <typename T, typename FP, typename VP>
-class Polyhedron_HalfEdge
+class Polyhedron_HalfEdge : public kdl::slab_allocated<Polyhedron_HalfEdge<T, FP, VP>>
 {
 private:
   friend class Polyhedron<T, FP, VP>;
@@ -774,7 +775,7 @@ struct Polyhedron_GetFaceLink
  * intrusive circular list.
  */
 template <typename T, typename FP, typename VP>
-class Polyhedron_Face
+class Polyhedron_Face : public kdl::slab_allocated<Polyhedron_Face<T, FP, VP>>
 {
 private:
   friend class Polyhedron<T, FP, VP>;
@@ -1258,6 +1259,35 @@ public: // Constructors
    */
   Polyhedron(Polyhedron<T, FP, VP>&& other) noexcept;
 
+  /**
+   * Constructs a closed polyhedron from the given topology without computing a convex
+   * hull. This is used to restore a polyhedron that was previously computed.
+   *
+   * The vertex indices of every face are given in the order of its boundary. Every edge
+   * must be shared by exactly two faces which traverse it in opposite directions, and
+   * every vertex must belong to a face. Every vertex must lie on the planes of its faces
+   * and must not be above any face plane, so the polyhedron is convex. The vertices, faces
+   * and edges of the returned polyhedron are stored in the order in which they are given.
+   *
+   * @param positions the vertex positions
+   * @param faceSizes the number of vertices of every face
+   * @param faceVertices the vertex indices of all faces, one face after another
+   * @param facePlanes the plane of every face
+   * @return the polyhedron or std::nullopt if the given topology or geometry is invalid
+   */
+  static std::optional<Polyhedron<T, FP, VP>> fromTopology(
+    const std::vector<vm::vec<T, 3>>& positions,
+    const std::vector<size_t>& faceSizes,
+    const std::vector<size_t>& faceVertices,
+    const std::vector<vm::plane<T, 3>>& facePlanes);
+
+  /**
+   * Returns the memory of destroyed vertices, edges, half edges and faces to the system
+   * where possible. Call this after many polyhedra were destroyed, e.g. when a document is
+   * closed.
+   */
+  static void releaseUnusedMemory();
+
 public: // copy and move assignment
   /**
    * Copy assignment operator.
@@ -1581,6 +1611,19 @@ private:
    */
   void updateBounds();
 
+public: // Translation
+  /**
+   * Translates this polyhedron by the given delta by offsetting the position of every
+   * vertex and the plane of every face. Since a translation cannot change the topology of
+   * this polyhedron, all vertices, edges and faces are retained along with their
+   * payloads.
+   *
+   * Updates the bounds of this polyhedron afterwards.
+   *
+   * @param delta the offset by which to translate
+   */
+  void translate(const vm::vec<T, 3>& delta);
+
 public: // Vertex correction and edge healing
   /**
    * Rounds each component of position of every vertex to the nearest integer if the
@@ -31,6 +31,7 @@
 #include "vm/vec.h"
 #include "vm/vec_io.h" // IWYU pragma: keep
 
+#include <algorithm>
 #include <sstream>
 #include <unordered_map>
 #include <unordered_set>
@@ -195,6 +196,153 @@ Polyhedron<T, FP, VP>::Polyhedron(Polyhedron<T, FP, VP>&& other) noexcept
 {
 }
 
+template <typename T, typename FP, typename VP>
+std::optional<Polyhedron<T, FP, VP>> Polyhedron<T, FP, VP>::fromTopology(
+  const std::vector<vm::vec<T, 3>>& positions,
+  const std::vector<size_t>& faceSizes,
+  const std::vector<size_t>& faceVertices,
+  const std::vector<vm::plane<T, 3>>& facePlanes)
+{
+  if (faceSizes.size() < 4 || faceSizes.size() != facePlanes.size())
+  {
+    return std::nullopt;
+  }
+
+  // Validate the topology before allocating anything. Half edges are identified by their
+  // origin and destination indices and map to their index in faceVertices.
+  const auto vertexCount = positions.size();
+  const auto halfEdgeKey = [&](const size_t origin, const size_t destination) {
+    return origin * vertexCount + destination;
+  };
+
+  auto halfEdgeIndices = std::unordered_map<size_t, size_t>{};
+  halfEdgeIndices.reserve(faceVertices.size());
+
+  auto vertexUsed = std::vector<bool>(vertexCount, false);
+
+  auto offset = size_t(0);
+  for (const auto faceSize : faceSizes)
+  {
+    if (faceSize < 3 || faceVertices.size() - offset < faceSize)
+    {
+      return std::nullopt;
+    }
+
+    for (size_t i = 0; i < faceSize; ++i)
+    {
+      const auto origin = faceVertices[offset + i];
+      const auto destination = faceVertices[offset + (i + 1) % faceSize];
+      if (origin >= vertexCount || destination >= vertexCount || origin == destination)
+      {
+        return std::nullopt;
+      }
+      if (!halfEdgeIndices.emplace(halfEdgeKey(origin, destination), offset + i).second)
+      {
+        return std::nullopt;
+      }
+      vertexUsed[origin] = true;
+    }
+    offset += faceSize;
+  }
+
+  if (
+    offset != faceVertices.size()
+    || std::ranges::find(vertexUsed, false) != vertexUsed.end())
+  {
+    return std::nullopt;
+  }
+
+  for (const auto& entry : halfEdgeIndices)
+  {
+    const auto origin = entry.first / vertexCount;
+    const auto destination = entry.first % vertexCount;
+    if (!halfEdgeIndices.contains(halfEdgeKey(destination, origin)))
+    {
+      return std::nullopt;
+    }
+  }
+
+  // The restored polyhedron must be convex and every face must lie on its plane.
+  offset = 0;
+  for (size_t faceIndex = 0; faceIndex < faceSizes.size(); ++faceIndex)
+  {
+    const auto& plane = facePlanes[faceIndex];
+    for (size_t i = 0; i < faceSizes[faceIndex]; ++i)
+    {
+      if (
+        plane.point_status(positions[faceVertices[offset + i]])
+        != vm::plane_status::inside)
+      {
+        return std::nullopt;
+      }
+    }
+    offset += faceSizes[faceIndex];
+
+    if (std::ranges::any_of(positions, [&](const auto& position) {
+          return plane.point_status(position) == vm::plane_status::above;
+        }))
+    {
+      return std::nullopt;
+    }
+  }
+
+  auto result = Polyhedron<T, FP, VP>{};
+
+  auto vertices = std::vector<Vertex*>{};
+  vertices.reserve(vertexCount);
+  for (const auto& position : positions)
+  {
+    auto* vertex = new Vertex{position};
+    vertices.push_back(vertex);
+    result.m_vertices.push_back(vertex);
+  }
+
+  auto halfEdges = std::vector<HalfEdge*>{};
+  halfEdges.reserve(faceVertices.size());
+
+  offset = 0;
+  for (size_t faceIndex = 0; faceIndex < faceSizes.size(); ++faceIndex)
+  {
+    auto boundary = HalfEdgeList{};
+    for (size_t i = 0; i < faceSizes[faceIndex]; ++i)
+    {
+      auto* halfEdge = new HalfEdge{vertices[faceVertices[offset + i]]};
+      halfEdges.push_back(halfEdge);
+      boundary.push_back(halfEdge);
+    }
+    result.m_faces.push_back(new Face{std::move(boundary), facePlanes[faceIndex]});
+    offset += faceSizes[faceIndex];
+  }
+
+  offset = 0;
+  for (const auto faceSize : faceSizes)
+  {
+    for (size_t i = 0; i < faceSize; ++i)
+    {
+      const auto origin = faceVertices[offset + i];
+      const auto destination = faceVertices[offset + (i + 1) % faceSize];
+      if (origin < destination)
+      {
+        const auto twinIndex = halfEdgeIndices.at(halfEdgeKey(destination, origin));
+        result.m_edges.push_back(new Edge{halfEdges[offset + i], halfEdges[twinIndex]});
+      }
+    }
+    offset += faceSize;
+  }
+
+  result.updateBounds();
+  return result;
+}
+
+template <typename T, typename FP, typename VP>
+void Polyhedron<T, FP, VP>::releaseUnusedMemory()
+{
+  Vertex::release_unused();
+  Edge::release_unused();
+  HalfEdge::release_unused();
+  Face::release_unused();
+}
+
 template <typename T, typename FP, typename VP>
 Polyhedron<T, FP, VP>& Polyhedron<T, FP, VP>::operator=(
   const Polyhedron<T, FP, VP>& other)
@@ -271,6 +419,9 @@ public:
     const CopyCallback& callback)
     : m_destination{destination}
   {
+    m_vertexMap.reserve(originalVertices.size());
+    m_halfEdgeMap.reserve(2u * originalEdges.size());
+
     copyVertices(originalVertices, callback);
     copyFaces(originalFaces, callback);
     copyEdges(originalEdges);
@@ -755,6 +906,22 @@ void Polyhedron<T, FP, VP>::updateBounds()
   }
 }
 
+template <typename T, typename FP, typename VP>
+void Polyhedron<T, FP, VP>::translate(const vm::vec<T, 3>& delta)
+{
+  for (auto* vertex : m_vertices)
+  {
+    vertex->setPosition(vertex->position() + delta);
+  }
+  for (auto* face : m_faces)
+  {
+    const auto& plane = face->plane();
+    face->setPlane(
+      vm::plane<T, 3>{plane.distance + vm::dot(plane.normal, delta), plane.normal});
+  }
+  updateBounds();
+}
+
 template <typename T, typename FP, typename VP>
 void Polyhedron<T, FP, VP>::correctVertexPositions(const size_t decimals, const T epsilon)
 {
@@ -27,6 +27,7 @@
 #include "kdl/reflection_impl.h"
 #include "kdl/result.h"
 
+#include <exception>
 #include <functional>
 #include <future>
 #include <iostream>
@@ -155,7 +156,15 @@ template <typename T>
 ResourceState<T> triggerLoading(ResourceUnloaded<T> state, TaskRunner taskRunner)
 {
   auto future = taskRunner([loader = std::move(state.loader)]() {
-    return std::make_unique<LoaderTaskResult<T>>(loader());
+    // an exception must not escape the task, otherwise the resource never fails
+    try
+    {
+      return std::make_unique<LoaderTaskResult<T>>(loader());
+    }
+    catch (const std::exception& e)
+    {
+      return std::make_unique<LoaderTaskResult<T>>(Error{e.what()});
+    }
   });
   return ResourceLoading<T>{std::move(future)};
 }
@@ -170,7 +179,16 @@ ResourceState<T> finishLoading(ResourceLoading<T> state)
       return ResourceFailed{"Invalid future"};
     }
 
-    auto taskResult = state.future.get();
+    auto taskResult = std::unique_ptr<TaskResult>{};
+    try
+    {
+      taskResult = state.future.get();
+    }
+    catch (const std::exception& e)
+    {
+      return ResourceFailed{e.what()};
+    }
+
     auto loaderTaskResult = static_cast<LoaderTaskResult<T>*>(taskResult.get());
 
     return std::move(loaderTaskResult->get())
@@ -275,6 +293,8 @@ public:
       m_state);
   }
 
+  bool isLoading() const { return std::holds_alternative<ResourceLoading<T>>(m_state); }
+
   bool isDropped() const { return std::holds_alternative<ResourceDropped>(m_state); }
 
   bool needsProcessing() const
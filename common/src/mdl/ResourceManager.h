@@ -21,12 +21,17 @@
 
 #include "mdl/Resource.h"
 
-#include "kdl/collection_utils.h"
 #include "kdl/reflection_impl.h"
-#include "kdl/vector_utils.h"
 
+#include <algorithm>
 #include <chrono>
+#include <functional>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <utility>
 #include <vector>
 
 namespace tb::mdl
@@ -39,8 +44,7 @@ public:
 
   virtual const ResourceId& id() const = 0;
 
-  virtual long useCount() const = 0;
-
+  virtual bool isLoading() const = 0;
   virtual bool isDropped() const = 0;
   virtual bool needsProcessing() const = 0;
 
@@ -63,7 +67,7 @@ public:
   }
 
   const ResourceId& id() const override { return m_resource->id(); }
-  long useCount() const override { return m_resource.use_count(); }
+  bool isLoading() const override { return m_resource->isLoading(); }
   bool isDropped() const override { return m_resource->isDropped(); }
   bool needsProcessing() const override { return m_resource->needsProcessing(); }
   void drop() override { m_resource->drop(); }
@@ -81,31 +85,106 @@ public:
   };
 };
 
-class ResourceManager
+namespace detail
+{
+
+struct ResourceEvent
+{
+  size_t key;
+  bool released;
+};
+
+/**
+ * Collects the resources whose state has changed. Events are pushed from loader tasks and
+ * from wherever the last handle to a resource is released, so this queue is thread safe.
+ */
+class ResourceEventQueue
 {
 private:
-  std::vector<std::unique_ptr<ResourceWrapperBase>> m_resources;
+  mutable std::mutex m_mutex;
+  std::vector<ResourceEvent> m_events;
 
 public:
-  bool needsProcessing() const
+  void push(const ResourceEvent event)
   {
-    return kdl::any_of(m_resources, [](const auto& resourceWrapper) {
-      return resourceWrapper->useCount() == 1 || resourceWrapper->needsProcessing();
-    });
+    const auto lock = std::lock_guard{m_mutex};
+    m_events.push_back(event);
   }
 
+  std::vector<ResourceEvent> takeAll()
+  {
+    const auto lock = std::lock_guard{m_mutex};
+    return std::exchange(m_events, {});
+  }
+
+  bool empty() const
+  {
+    const auto lock = std::lock_guard{m_mutex};
+    return m_events.empty();
+  }
+};
+
+} // namespace detail
+
+/**
+ * Manages the lifecycle of resources.
+ *
+ * Resources are only processed when their state changes, that is, when they are added,
+ * when their loader task completes, or when the last handle returned by addResource is
+ * released. Resources that are waiting for their loader task are not touched at all.
+ */
+class ResourceManager
+{
+private:
+  struct Entry
+  {
+    std::unique_ptr<ResourceWrapperBase> resourceWrapper;
+    bool released = false;
+  };
+
+  std::map<size_t, Entry> m_resources;
+  size_t m_nextKey = 0;
+  size_t m_loadingCount = 0;
+  std::shared_ptr<detail::ResourceEventQueue> m_events =
+    std::make_shared<detail::ResourceEventQueue>();
+
+public:
+  bool needsProcessing() const { return m_loadingCount > 0 || !m_events->empty(); }
+
   std::vector<const ResourceWrapperBase*> resources() const
   {
-    return kdl::vec_transform(m_resources, [](const auto& resourceWrapper) {
-      return static_cast<const ResourceWrapperBase*>(resourceWrapper.get());
-    });
+    auto result = std::vector<const ResourceWrapperBase*>{};
+    result.reserve(m_resources.size());
+    for (const auto& [key, entry] : m_resources)
+    {
+      result.push_back(entry.resourceWrapper.get());
+    }
+    return result;
   }
 
+  /**
+   * Adds the given resource and returns a handle to it. The resource is dropped once the
+   * returned handle and all of its copies are released.
+   */
   template <typename ResourceT>
-  void addResource(std::shared_ptr<Resource<ResourceT>> resource)
+  std::shared_ptr<Resource<ResourceT>> addResource(
+    std::shared_ptr<Resource<ResourceT>> resource)
   {
-    m_resources.push_back(
-      std::make_unique<ResourceWrapper<ResourceT>>(std::move(resource)));
+    const auto key = m_nextKey++;
+    auto handle = std::shared_ptr<Resource<ResourceT>>{
+      resource.get(), [events = m_events, key, resource](auto*) {
+        events->push({key, true});
+      }};
+
+    if (resource->needsProcessing())
+    {
+      m_events->push({key, false});
+    }
+    m_resources.emplace(
+      key,
+      Entry{std::make_unique<ResourceWrapper<ResourceT>>(std::move(resource))});
+
+    return handle;
   }
 
   std::vector<ResourceId> process(
@@ -120,27 +199,100 @@ public:
       }}
               : std::function{[]() { return true; }};
 
+    auto keys = std::vector<size_t>{};
+    for (const auto& event : m_events->takeAll())
+    {
+      if (const auto it = m_resources.find(event.key); it != m_resources.end())
+      {
+        it->second.released = it->second.released || event.released;
+        keys.push_back(event.key);
+      }
+    }
+
+    // process the resources in the order in which they were added
+    std::ranges::sort(keys);
+    const auto [first, last] = std::ranges::unique(keys);
+    keys.erase(first, last);
+
     auto result = std::vector<ResourceId>{};
 
-    for (auto it = m_resources.begin(); it != m_resources.end() && checkTimeout();)
+    auto it = keys.begin();
+    for (; it != keys.end() && checkTimeout(); ++it)
     {
-      auto& resourceWrapper = *it;
-      if (resourceWrapper->useCount() == 1 && !resourceWrapper->isDropped())
+      if (auto resourceId = processResource(*it, taskRunner, processContext))
       {
-        resourceWrapper->drop();
+        result.push_back(std::move(*resourceId));
       }
+    }
 
-      if (resourceWrapper->needsProcessing())
+    // the remaining resources are processed by the next call
+    for (; it != keys.end(); ++it)
+    {
+      m_events->push({*it, false});
+    }
+
+    return result;
+  }
+
+private:
+  std::optional<ResourceId> processResource(
+    const size_t key, const TaskRunner& taskRunner, const ProcessContext& processContext)
+  {
+    auto entryIt = m_resources.find(key);
+    auto& [resourceWrapper, released] = entryIt->second;
+
+    const auto wasLoading = resourceWrapper->isLoading();
+    if (released && !resourceWrapper->isDropped())
+    {
+      resourceWrapper->drop();
+    }
+
+    auto result = std::optional<ResourceId>{};
+    if (resourceWrapper->needsProcessing())
+    {
+      const auto notifyingTaskRunner = [&](Task task) {
+        return taskRunner([events = m_events, key, task = std::move(task)]() {
+          try
+          {
+            auto taskResult = task();
+            events->push({key, false});
+            return taskResult;
+          }
+          catch (...)
+          {
+            // the resource fails when the exception is taken from its future
+            events->push({key, false});
+            throw;
+          }
+        });
+      };
+
+      if (resourceWrapper->process(notifyingTaskRunner, processContext))
       {
-        if (resourceWrapper->process(taskRunner, processContext))
-        {
-          result.push_back(resourceWrapper->id());
-        }
+        result = resourceWrapper->id();
       }
+    }
 
-      it = resourceWrapper->useCount() == 1 && resourceWrapper->isDropped()
-             ? m_resources.erase(it)
-             : std::next(it);
+    const auto isLoading = resourceWrapper->isLoading();
+    if (isLoading && !wasLoading)
+    {
+      ++m_loadingCount;
+    }
+    else if (!isLoading && wasLoading)
+    {
+      --m_loadingCount;
+    }
+
+    if (released && resourceWrapper->isDropped())
+    {
+      m_resources.erase(entryIt);
+    }
+    else if (resourceWrapper->needsProcessing() && (!isLoading || wasLoading))
+    {
+      // A resource that has just started loading is queued again when its loader task
+      // completes. The task notifies us just before its future becomes ready, so a
+      // resource that is still loading at this point is queued again right away.
+      m_events->push({key, false});
     }
 
     return result;
@@ -0,0 +1,44 @@
+/*
+ Copyright (C) 2010 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "StateEpoch.h"
+
+#include <atomic>
+
+namespace tb::mdl
+{
+namespace
+{
+
+// nodes may be created and modified in parallel, e.g. when a map is loaded
+auto epoch = std::atomic<std::uint64_t>{0};
+
+} // namespace
+
+std::uint64_t stateEpoch()
+{
+  return epoch.load(std::memory_order_relaxed);
+}
+
+void advanceStateEpoch()
+{
+  epoch.fetch_add(1, std::memory_order_relaxed);
+}
+
+} // namespace tb::mdl
@@ -0,0 +1,40 @@
+/*
+ Copyright (C) 2010 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace tb::mdl
+{
+
+/**
+ * Returns a counter that is advanced whenever the state of any node or brush face changes
+ * in a way that may affect whether it is visible or editable, that is, when its
+ * selection, visibility, lock state, tags or contents change, when it is added to or
+ * removed from a parent, or when it is destroyed.
+ *
+ * Caches of information derived from these states record the epoch in which they were
+ * filled and become invalid once it advances.
+ */
+std::uint64_t stateEpoch();
+
+void advanceStateEpoch();
+
+} // namespace tb::mdl
@@ -19,6 +19,7 @@
 
 #include "Tag.h"
 
+#include "mdl/StateEpoch.h"
 #include "mdl/TagManager.h"
 
 #include "kdl/struct_io.h"
@@ -157,6 +158,7 @@ bool Taggable::addTag(const Tag& tag)
   {
     m_tagMask |= tag.type();
     m_tags.emplace(tag);
+    advanceStateEpoch();
 
     updateAttributeMask();
     return true;
@@ -171,6 +173,7 @@ bool Taggable::removeTag(const Tag& tag)
     m_tagMask &= ~tag.type();
     m_tags.erase(it);
     assert(!hasTag(tag));
+    advanceStateEpoch();
 
     updateAttributeMask();
     return true;
@@ -193,6 +196,10 @@ void Taggable::updateTags(TagManager& tagManager)
 
 void Taggable::clearTags()
 {
+  if (m_tagMask != 0)
+  {
+    advanceStateEpoch();
+  }
   m_tagMask = 0;
   m_tags.clear();
   updateAttributeMask();
@@ -249,6 +256,11 @@ bool TagMatcher::canDisable() const
   return false;
 }
 
+void TagMatcher::compile(
+  BrushFaceTagPlan& /* plan */, const TagType::Type /* tagType */) const
+{
+}
+
 std::ostream& operator<<(std::ostream& str, const TagMatcher& matcher)
 {
   matcher.appendToStream(str);
@@ -297,6 +309,11 @@ void SmartTag::update(Taggable& taggable) const
   }
 }
 
+void SmartTag::compile(BrushFaceTagPlan& plan) const
+{
+  m_matcher->compile(plan, type());
+}
+
 void SmartTag::enable(TagMatcherCallback& callback, MapFacade& facade) const
 {
   m_matcher->enable(callback, facade);
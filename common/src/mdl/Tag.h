@@ -32,6 +32,7 @@
 
 namespace tb::mdl
 {
+class BrushFaceTagPlan;
 class ConstTagVisitor;
 class TagManager;
 class TagVisitor;
@@ -327,6 +328,16 @@ public:
    */
   virtual std::unique_ptr<TagMatcher> clone() const = 0;
 
+  /**
+   * Adds this tag matcher to the given brush face tag plan so that the plan evaluates it
+   * for the tag with the given type. Tag matchers that cannot be expressed by a plan do
+   * nothing, which is the default.
+   *
+   * @param plan the plan to add this matcher to
+   * @param tagType the type of the tag that this matcher belongs to
+   */
+  virtual void compile(BrushFaceTagPlan& plan, TagType::Type tagType) const;
+
   virtual void appendToStream(std::ostream& str) const = 0;
 };
 
@@ -374,6 +385,13 @@ public:
    */
   void update(Taggable& taggable) const;
 
+  /**
+   * Adds this smart tag to the given brush face tag plan if its matcher supports it.
+   *
+   * @param plan the plan to add this tag to
+   */
+  void compile(BrushFaceTagPlan& plan) const;
+
   /**
    * Modifies the current selection so that this tag would match it.
    *
@@ -20,17 +20,44 @@
 #include "TagManager.h"
 
 #include "Ensure.h"
+#include "mdl/BrushFace.h"
 #include "mdl/Tag.h"
 #include "mdl/TagType.h"
 
+#include "kdl/hash_utils.h"
+#include "kdl/task_manager.h"
+
 #include <fmt/format.h>
 
 #include <algorithm>
+#include <optional>
 #include <stdexcept>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 
 namespace tb::mdl
 {
+namespace
+{
+
+struct MaterialKey
+{
+  const Material* material;
+  std::string_view materialName;
+
+  bool operator==(const MaterialKey& other) const = default;
+};
+
+struct MaterialKeyHash
+{
+  size_t operator()(const MaterialKey& key) const
+  {
+    return kdl::hash(key.material, key.materialName);
+  }
+};
+
+} // namespace
 
 bool TagManager::TagCmp::operator()(const SmartTag& lhs, const SmartTag& rhs) const
 {
@@ -104,11 +131,18 @@ void TagManager::registerSmartTags(const std::vector<SmartTag>& tags)
 
     it->setIndex(nextIndex);
   }
+
+  m_faceTagPlan = BrushFaceTagPlan{};
+  for (const auto& tag : m_smartTags)
+  {
+    tag.compile(m_faceTagPlan);
+  }
 }
 
 void TagManager::clearSmartTags()
 {
   m_smartTags.clear();
+  m_faceTagPlan = BrushFaceTagPlan{};
 }
 
 void TagManager::updateTags(Taggable& taggable) const
@@ -119,6 +153,78 @@ void TagManager::updateTags(Taggable& taggable) const
   }
 }
 
+void TagManager::updateFaceTags(const std::vector<BrushFace*>& faces) const
+{
+  updateFaceTagsWith(faces, [&](const auto& updateFace) {
+    for (size_t i = 0; i < faces.size(); ++i)
+    {
+      updateFace(i);
+    }
+  });
+}
+
+void TagManager::updateFaceTags(
+  const std::vector<BrushFace*>& faces, kdl::task_manager& taskManager) const
+{
+  updateFaceTagsWith(faces, [&](const auto& updateFace) {
+    taskManager.parallel_for(faces.size(), updateFace);
+  });
+}
+
+template <typename ForEachFace>
+void TagManager::updateFaceTagsWith(
+  const std::vector<BrushFace*>& faces, const ForEachFace& forEachFace) const
+{
+  // Evaluate the material tags once per material. Faces that share a material are
+  // usually adjacent, so the previous material is checked before the cache is.
+  auto materialTags = std::vector<TagType::Type>(faces.size());
+  auto cache = std::unordered_map<MaterialKey, TagType::Type, MaterialKeyHash>{};
+  auto previousKey = std::optional<MaterialKey>{};
+  auto previousTags = TagType::NoType;
+
+  for (size_t i = 0; i < faces.size(); ++i)
+  {
+    const auto& face = *faces[i];
+    const auto key = MaterialKey{face.material(), face.attributes().materialName()};
+    if (key != previousKey)
+    {
+      auto [it, inserted] = cache.try_emplace(key, TagType::NoType);
+      if (inserted)
+      {
+        it->second = m_faceTagPlan.matchMaterial(key.materialName, key.material);
+      }
+      previousKey = key;
+      previousTags = it->second;
+    }
+    materialTags[i] = previousTags;
+  }
+
+  const auto planTagTypes = m_faceTagPlan.tagTypes();
+  forEachFace([&](const size_t i) {
+    auto& face = *faces[i];
+    const auto matchingTags =
+      materialTags[i]
+      | m_faceTagPlan.matchFlags(
+        face.resolvedSurfaceFlags(), face.resolvedSurfaceContents());
+
+    for (const auto& tag : m_smartTags)
+    {
+      if ((planTagTypes & tag.type()) == 0)
+      {
+        tag.update(face);
+      }
+      else if ((matchingTags & tag.type()) != 0)
+      {
+        face.addTag(tag);
+      }
+      else
+      {
+        face.removeTag(tag);
+      }
+    }
+  });
+}
+
 size_t TagManager::freeTagIndex()
 {
   static const size_t Bits = (sizeof(TagType::Type) * 8);
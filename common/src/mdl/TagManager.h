@@ -19,14 +19,22 @@
 
 #pragma once
 
+#include "mdl/BrushFaceTagPlan.h"
 #include "mdl/Tag.h"
 
 #include "kdl/vector_set.h"
 
 #include <string>
+#include <vector>
+
+namespace kdl
+{
+class task_manager;
+} // namespace kdl
 
 namespace tb::mdl
 {
+class BrushFace;
 
 /**
  * Manages the tags used in a document and updates smart tags on taggable objects.
@@ -43,6 +51,7 @@ private:
   };
 
   kdl::vector_set<SmartTag, TagCmp> m_smartTags;
+  BrushFaceTagPlan m_faceTagPlan;
 
 public:
   /**
@@ -113,7 +122,32 @@ public:
    */
   void updateTags(Taggable& taggable) const;
 
+  /**
+   * Update the smart tags of the given brush faces.
+   *
+   * This has the same effect as calling updateTags for each face, but the smart tags that
+   * only depend on the material of a face are evaluated once per material, and the
+   * smart tags that match surface flags or contents are evaluated together.
+   *
+   * @param faces the faces to update
+   */
+  void updateFaceTags(const std::vector<BrushFace*>& faces) const;
+
+  /**
+   * Update the smart tags of the given brush faces like updateFaceTags above, but tag the
+   * faces in parallel using the given task manager.
+   *
+   * @param faces the faces to update
+   * @param taskManager the task manager to run the updates with
+   */
+  void updateFaceTags(
+    const std::vector<BrushFace*>& faces, kdl::task_manager& taskManager) const;
+
 private:
+  template <typename ForEachFace>
+  void updateFaceTagsWith(
+    const std::vector<BrushFace*>& faces, const ForEachFace& forEachFace) const;
+
   size_t freeTagIndex();
 };
 
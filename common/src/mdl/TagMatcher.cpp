@@ -20,6 +20,7 @@
 #include "TagMatcher.h"
 
 #include "mdl/BrushFace.h"
+#include "mdl/BrushFaceTagPlan.h"
 #include "mdl/BrushNode.h"
 #include "mdl/ChangeBrushFaceAttributesRequest.h"
 #include "mdl/Entity.h"
@@ -175,6 +176,15 @@ bool MaterialNameTagMatcher::matches(const Taggable& taggable) const
   return visitor.matches();
 }
 
+void MaterialNameTagMatcher::compile(
+  BrushFaceTagPlan& plan, const TagType::Type tagType) const
+{
+  plan.addMaterialTag(
+    tagType, [matcher = *this](const auto materialName, const auto*) {
+      return matcher.matchesMaterialName(materialName);
+    });
+}
+
 void MaterialNameTagMatcher::appendToStream(std::ostream& str) const
 {
   kdl::struct_stream{str} << "MaterialNameTagMatcher"
@@ -226,6 +236,14 @@ bool SurfaceParmTagMatcher::matches(const Taggable& taggable) const
   return visitor.matches();
 }
 
+void SurfaceParmTagMatcher::compile(
+  BrushFaceTagPlan& plan, const TagType::Type tagType) const
+{
+  plan.addMaterialTag(tagType, [matcher = *this](const auto, const auto* material) {
+    return matcher.matchesMaterial(material);
+  });
+}
+
 void SurfaceParmTagMatcher::appendToStream(std::ostream& str) const
 {
   kdl::struct_stream{str} << "SurfaceParmTagMatcher"
@@ -376,6 +394,12 @@ std::unique_ptr<TagMatcher> ContentFlagsTagMatcher::clone() const
   return std::make_unique<ContentFlagsTagMatcher>(m_flags);
 }
 
+void ContentFlagsTagMatcher::compile(
+  BrushFaceTagPlan& plan, const TagType::Type tagType) const
+{
+  plan.addContentFlagsTag(tagType, m_flags);
+}
+
 SurfaceFlagsTagMatcher::SurfaceFlagsTagMatcher(const int i_flags)
   : FlagsTagMatcher{
       i_flags,
@@ -393,6 +417,12 @@ std::unique_ptr<TagMatcher> SurfaceFlagsTagMatcher::clone() const
   return std::make_unique<SurfaceFlagsTagMatcher>(m_flags);
 }
 
+void SurfaceFlagsTagMatcher::compile(
+  BrushFaceTagPlan& plan, const TagType::Type tagType) const
+{
+  plan.addSurfaceFlagsTag(tagType, m_flags);
+}
+
 EntityClassNameTagMatcher::EntityClassNameTagMatcher(
   std::string pattern, std::string material)
   : m_pattern{std::move(pattern)}
@@ -517,6 +547,13 @@ bool EntityClassNameTagMatcher::canDisable() const
   return true;
 }
 
+void EntityClassNameTagMatcher::compile(
+  BrushFaceTagPlan& plan, const TagType::Type tagType) const
+{
+  // only brushes are matched against their entity's classname, faces never are
+  plan.addUnmatchedTag(tagType);
+}
+
 void EntityClassNameTagMatcher::appendToStream(std::ostream& str) const
 {
   kdl::struct_stream{str} << "EntityClassNameMatcher"
@@ -36,6 +36,7 @@ namespace tb::mdl
 {
 class BrushNode;
 class BrushFace;
+class BrushFaceTagPlan;
 class ChangeBrushFaceAttributesRequest;
 class Game;
 class MapFacade;
@@ -60,6 +61,7 @@ public:
   explicit MaterialNameTagMatcher(std::string pattern);
   std::unique_ptr<TagMatcher> clone() const override;
   bool matches(const Taggable& taggable) const override;
+  void compile(BrushFaceTagPlan& plan, TagType::Type tagType) const override;
   void appendToStream(std::ostream& str) const override;
 
 private:
@@ -77,6 +79,7 @@ public:
   explicit SurfaceParmTagMatcher(kdl::vector_set<std::string> parameters);
   std::unique_ptr<TagMatcher> clone() const override;
   bool matches(const Taggable& taggable) const override;
+  void compile(BrushFaceTagPlan& plan, TagType::Type tagType) const override;
   void appendToStream(std::ostream& str) const override;
 
 private:
@@ -119,6 +122,7 @@ class ContentFlagsTagMatcher : public FlagsTagMatcher
 public:
   explicit ContentFlagsTagMatcher(int flags);
   std::unique_ptr<TagMatcher> clone() const override;
+  void compile(BrushFaceTagPlan& plan, TagType::Type tagType) const override;
 };
 
 class SurfaceFlagsTagMatcher : public FlagsTagMatcher
@@ -126,6 +130,7 @@ class SurfaceFlagsTagMatcher : public FlagsTagMatcher
 public:
   explicit SurfaceFlagsTagMatcher(int flags);
   std::unique_ptr<TagMatcher> clone() const override;
+  void compile(BrushFaceTagPlan& plan, TagType::Type tagType) const override;
 };
 
 class EntityClassNameTagMatcher : public TagMatcher
@@ -147,6 +152,7 @@ public:
   void disable(TagMatcherCallback& callback, MapFacade& facade) const override;
   bool canEnable() const override;
   bool canDisable() const override;
+  void compile(BrushFaceTagPlan& plan, TagType::Type tagType) const override;
   void appendToStream(std::ostream& str) const override;
 
 private:
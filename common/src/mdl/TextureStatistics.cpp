@@ -0,0 +1,180 @@
+/*
+ Copyright (C) 2010 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TextureStatistics.h"
+
+#include "Ensure.h"
+
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define TB_TEXTURE_STATISTICS_SSE2
+#endif
+
+namespace tb::mdl
+{
+namespace
+{
+
+void accumulatePixel(TextureStatistics& statistics, const unsigned char* pixel)
+{
+  for (size_t i = 0; i < 4; ++i)
+  {
+    statistics.channelSums[i] += pixel[i];
+  }
+  statistics.alphaAnd &= pixel[3];
+}
+
+#if defined(TB_TEXTURE_STATISTICS_SSE2)
+
+constexpr auto SimdWidth = size_t(4);
+
+using SimdPixels = __m128i;
+
+SimdPixels loadPixels(const unsigned char* pixels)
+{
+  return _mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels));
+}
+
+void storePixels(unsigned char* destination, const SimdPixels pixels)
+{
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(destination), pixels);
+}
+
+SimdPixels lookupPixels(const unsigned char* indices, const uint32_t* table)
+{
+  // SSE2 has no gather instruction
+  return _mm_set_epi32(
+    int(table[indices[3]]),
+    int(table[indices[2]]),
+    int(table[indices[1]]),
+    int(table[indices[0]]));
+}
+
+class SimdAccumulator
+{
+private:
+  // every lane holds a partial sum of one channel
+  __m128i m_sums[4] = {
+    _mm_setzero_si128(), _mm_setzero_si128(), _mm_setzero_si128(), _mm_setzero_si128()};
+  __m128i m_and = _mm_set1_epi32(-1);
+
+public:
+  void add(const SimdPixels pixels)
+  {
+    const auto mask = _mm_set1_epi32(0xFF);
+    const auto zero = _mm_setzero_si128();
+
+    // _mm_sad_epu8 sums groups of 8 bytes, so the other channels are masked out
+    m_sums[0] = _mm_add_epi64(m_sums[0], _mm_sad_epu8(_mm_and_si128(pixels, mask), zero));
+    m_sums[1] = _mm_add_epi64(
+      m_sums[1], _mm_sad_epu8(_mm_and_si128(_mm_srli_epi32(pixels, 8), mask), zero));
+    m_sums[2] = _mm_add_epi64(
+      m_sums[2], _mm_sad_epu8(_mm_and_si128(_mm_srli_epi32(pixels, 16), mask), zero));
+    m_sums[3] = _mm_add_epi64(m_sums[3], _mm_sad_epu8(_mm_srli_epi32(pixels, 24), zero));
+    m_and = _mm_and_si128(m_and, pixels);
+  }
+
+  TextureStatistics statistics() const
+  {
+    auto result = TextureStatistics{};
+
+    alignas(16) uint64_t sums[2];
+    for (size_t i = 0; i < 4; ++i)
+    {
+      _mm_store_si128(reinterpret_cast<__m128i*>(sums), m_sums[i]);
+      result.channelSums[i] = sums[0] + sums[1];
+    }
+
+    alignas(16) uint32_t ands[4];
+    _mm_store_si128(reinterpret_cast<__m128i*>(ands), m_and);
+    for (const auto value : ands)
+    {
+      result.alphaAnd &= static_cast<unsigned char>(value >> 24);
+    }
+
+    return result;
+  }
+};
+
+#endif
+
+} // namespace
+
+TextureStatistics computeTextureStatistics(const std::span<const unsigned char> pixels)
+{
+  ensure(pixels.size() % 4 == 0, "pixel buffer size is a multiple of 4");
+
+  const auto pixelCount = pixels.size() / 4;
+  auto result = TextureStatistics{};
+  auto i = size_t(0);
+
+#if defined(TB_TEXTURE_STATISTICS_SSE2)
+  auto accumulator = SimdAccumulator{};
+  for (; i + SimdWidth <= pixelCount; i += SimdWidth)
+  {
+    accumulator.add(loadPixels(pixels.data() + i * 4));
+  }
+  result = accumulator.statistics();
+#endif
+
+  for (; i < pixelCount; ++i)
+  {
+    accumulatePixel(result, pixels.data() + i * 4);
+  }
+
+  return result;
+}
+
+TextureStatistics expandIndexedPixels(
+  const std::span<const unsigned char> indices,
+  const std::span<const unsigned char, 1024> palette,
+  const std::span<unsigned char> pixels)
+{
+  ensure(pixels.size() == indices.size() * 4, "pixel buffer has the correct size");
+
+  // look up whole pixels instead of single bytes
+  uint32_t table[256];
+  std::memcpy(table, palette.data(), palette.size());
+
+  auto result = TextureStatistics{};
+  auto i = size_t(0);
+
+#if defined(TB_TEXTURE_STATISTICS_SSE2)
+  auto accumulator = SimdAccumulator{};
+  for (; i + SimdWidth <= indices.size(); i += SimdWidth)
+  {
+    const auto expanded = lookupPixels(indices.data() + i, table);
+    storePixels(pixels.data() + i * 4, expanded);
+    accumulator.add(expanded);
+  }
+  result = accumulator.statistics();
+#endif
+
+  for (; i < indices.size(); ++i)
+  {
+    std::memcpy(pixels.data() + i * 4, &table[indices[i]], 4);
+    accumulatePixel(result, pixels.data() + i * 4);
+  }
+
+  return result;
+}
+
+} // namespace tb::mdl
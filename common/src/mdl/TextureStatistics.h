@@ -0,0 +1,65 @@
+/*
+ Copyright (C) 2010 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <span>
+
+namespace tb::mdl
+{
+
+struct TextureStatistics
+{
+  /**
+   * The sums of the four channels of all pixels, in the order in which the channels are
+   * stored.
+   */
+  std::array<uint64_t, 4> channelSums = {0, 0, 0, 0};
+
+  /**
+   * The bitwise AND of the fourth channel of all pixels. This is 0xFF if and only if
+   * every pixel is fully opaque.
+   */
+  unsigned char alphaAnd = 0xFF;
+};
+
+/**
+ * Computes the statistics of the given pixels, which are stored with four channels of one
+ * byte each.
+ *
+ * The size of the given buffer must be a multiple of 4.
+ */
+TextureStatistics computeTextureStatistics(std::span<const unsigned char> pixels);
+
+/**
+ * Expands the given palette indices into pixels with four channels and computes the
+ * statistics of the expanded pixels in the same pass.
+ *
+ * @param indices the palette indices
+ * @param palette the palette, 256 entries of 4 bytes each
+ * @param pixels the destination buffer, must be 4 times as large as the given indices
+ */
+TextureStatistics expandIndexedPixels(
+  std::span<const unsigned char> indices,
+  std::span<const unsigned char, 1024> palette,
+  std::span<unsigned char> pixels);
+
+} // namespace tb::mdl
@@ -20,6 +20,7 @@
 #include "WorldNode.h"
 
 #include "Ensure.h"
+#include "bvh.h"
 #include "mdl/BrushFace.h"
 #include "mdl/BrushNode.h"
 #include "mdl/EntityNode.h"
@@ -30,7 +31,6 @@
 #include "mdl/TagVisitor.h"
 #include "mdl/Validator.h"
 #include "mdl/ValidatorRegistry.h"
-#include "octree.h"
 
 #include "kdl/k.h"
 #include "kdl/overload.h"
@@ -38,12 +38,47 @@
 
 #include "vm/bbox_io.h" // IWYU pragma: keep
 
+#include <algorithm>
 #include <sstream>
 #include <string>
 #include <vector>
 
 namespace tb::mdl
 {
+namespace
+{
+
+void copyPersistentIds(const Node& original, Node& copy)
+{
+  original.accept(kdl::overload(
+    [](const WorldNode*) {},
+    [&](const LayerNode* layerNode) {
+      if (const auto& persistentId = layerNode->persistentId())
+      {
+        static_cast<LayerNode&>(copy).setPersistentId(*persistentId);
+      }
+    },
+    [&](const GroupNode* groupNode) {
+      if (const auto& persistentId = groupNode->persistentId())
+      {
+        static_cast<GroupNode&>(copy).setPersistentId(*persistentId);
+      }
+    },
+    [](const EntityNode*) {},
+    [](const BrushNode*) {},
+    [](const PatchNode*) {}));
+
+  const auto& originalChildren = original.children();
+  const auto& copyChildren = copy.children();
+  assert(originalChildren.size() == copyChildren.size());
+
+  for (size_t i = 0; i < originalChildren.size(); ++i)
+  {
+    copyPersistentIds(*originalChildren[i], *copyChildren[i]);
+  }
+}
+
+} // namespace
 
 WorldNode::WorldNode(
   EntityPropertyConfig entityPropertyConfig, Entity entity, const MapFormat mapFormat)
@@ -52,7 +87,7 @@ WorldNode::WorldNode(
   , m_defaultLayer{nullptr}
   , m_entityNodeIndex{std::make_unique<EntityNodeIndex>()}
   , m_validatorRegistry{std::make_unique<ValidatorRegistry>()}
-  , m_nodeTree{std::make_unique<NodeTree>(256.0)}
+  , m_nodeTree{std::make_unique<NodeTree>()}
   , m_updateNodeTree{true}
 {
   entity.addOrUpdateProperty(
@@ -87,6 +122,34 @@ const WorldNode::NodeTree& WorldNode::nodeTree() const
   return *m_nodeTree;
 }
 
+std::unique_ptr<WorldNode> WorldNode::snapshot(const vm::bbox3d& worldBounds) const
+{
+  const auto& myChildren = children();
+  assert(myChildren[0] == m_defaultLayer);
+
+  auto worldNode =
+    std::unique_ptr<WorldNode>{static_cast<WorldNode*>(clone(worldBounds))};
+  worldNode->disableNodeTreeUpdates();
+
+  auto* defaultLayer = worldNode->defaultLayer();
+  defaultLayer->setLayer(m_defaultLayer->layer());
+  defaultLayer->setVisibilityState(m_defaultLayer->visibilityState());
+  defaultLayer->setLockState(m_defaultLayer->lockState());
+  defaultLayer->addChildren(cloneRecursively(worldBounds, m_defaultLayer->children()));
+
+  auto childClones = std::vector<Node*>{};
+  childClones.reserve(myChildren.size() - 1);
+  cloneRecursively(
+    worldBounds,
+    std::next(std::begin(myChildren)),
+    std::end(myChildren),
+    std::back_inserter(childClones));
+  worldNode->addChildren(childClones);
+
+  copyPersistentIds(*this, *worldNode);
+  return worldNode;
+}
+
 LayerNode* WorldNode::defaultLayer()
 {
   ensure(m_defaultLayer != nullptr, "defaultLayer is null");
@@ -182,6 +245,12 @@ const EntityNodeIndex& WorldNode::entityNodeIndex() const
   return *m_entityNodeIndex;
 }
 
+std::vector<Node*> WorldNode::findNodesWithLinkId(const std::string& linkId) const
+{
+  const auto it = m_linkIdIndex.find(linkId);
+  return it != m_linkIdIndex.end() ? it->second : std::vector<Node*>{};
+}
+
 std::vector<const Validator*> WorldNode::registeredValidators() const
 {
   return m_validatorRegistry->registeredValidators();
@@ -194,8 +263,13 @@ std::vector<const IssueQuickFix*> WorldNode::quickFixes(const IssueType issueTyp
 
 void WorldNode::registerValidator(std::unique_ptr<Validator> validator)
 {
+  // only the new validator needs to be applied to nodes whose issues are valid
+  const auto* newValidator = validator.get();
   m_validatorRegistry->registerValidator(std::move(validator));
-  invalidateAllIssues();
+  accept([&](auto&& thisLambda, Node* node) {
+    node->addIssues(*newValidator);
+    node->visitChildren(thisLambda);
+  });
 }
 
 void WorldNode::unregisterAllValidators()
@@ -249,6 +323,7 @@ void WorldNode::rebuildNodeTree()
   {
     m_nodeTree->insert(node->physicalBounds(), node);
   }
+  m_nodeTree->rebuild();
 }
 
 void WorldNode::invalidateAllIssues()
@@ -259,6 +334,29 @@ void WorldNode::invalidateAllIssues()
   });
 }
 
+void WorldNode::addToLinkIdIndex(Node* node, const std::string& linkId)
+{
+  m_linkIdIndex[linkId].push_back(node);
+}
+
+void WorldNode::removeFromLinkIdIndex(Node* node, const std::string& linkId)
+{
+  if (const auto it = m_linkIdIndex.find(linkId); it != m_linkIdIndex.end())
+  {
+    auto& nodes = it->second;
+    // keep the remaining nodes in the order in which they were added
+    if (const auto nodeIt = std::ranges::find(nodes, node); nodeIt != nodes.end())
+    {
+      nodes.erase(nodeIt);
+    }
+
+    if (nodes.empty())
+    {
+      m_linkIdIndex.erase(it);
+    }
+  }
+}
+
 const vm::bbox3d& WorldNode::doGetLogicalBounds() const
 {
   // TODO: this should probably return the world bounds, as it does in
@@ -387,10 +485,14 @@ void WorldNode::doDescendantWasAdded(Node* node, const size_t /* depth */)
     [&](auto&& thisLambda, GroupNode* group) {
       group->visitChildren(thisLambda);
       updatePersistentId(group);
+      addToLinkIdIndex(group, group->linkId());
+    },
+    [&](auto&& thisLambda, EntityNode* entity) {
+      entity->visitChildren(thisLambda);
+      addToLinkIdIndex(entity, entity->linkId());
     },
-    [&](EntityNode*) {},
-    [&](BrushNode*) {},
-    [&](PatchNode*) {}));
+    [&](BrushNode* brush) { addToLinkIdIndex(brush, brush->linkId()); },
+    [&](PatchNode* patch) { addToLinkIdIndex(patch, patch->linkId()); }));
 }
 
 void WorldNode::doDescendantWillBeRemoved(Node* node, const size_t /* depth */)
@@ -418,6 +520,20 @@ void WorldNode::doDescendantWillBeRemoved(Node* node, const size_t /* depth */)
       [&](BrushNode* brush) { doRemove(brush); },
       [&](PatchNode* patch) { doRemove(patch); }));
   }
+
+  node->accept(kdl::overload(
+    [&](auto&& thisLambda, WorldNode* world) { world->visitChildren(thisLambda); },
+    [&](auto&& thisLambda, LayerNode* layer) { layer->visitChildren(thisLambda); },
+    [&](auto&& thisLambda, GroupNode* group) {
+      group->visitChildren(thisLambda);
+      removeFromLinkIdIndex(group, group->linkId());
+    },
+    [&](auto&& thisLambda, EntityNode* entity) {
+      entity->visitChildren(thisLambda);
+      removeFromLinkIdIndex(entity, entity->linkId());
+    },
+    [&](BrushNode* brush) { removeFromLinkIdIndex(brush, brush->linkId()); },
+    [&](PatchNode* patch) { removeFromLinkIdIndex(patch, patch->linkId()); }));
 }
 
 void WorldNode::doDescendantPhysicalBoundsDidChange(Node* node)
@@ -503,6 +619,13 @@ void WorldNode::doRemoveFromIndex(
   m_entityNodeIndex->removeProperty(node, key, value);
 }
 
+void WorldNode::doUpdateLinkIdIndex(
+  Node* node, const std::string& oldLinkId, const std::string& newLinkId)
+{
+  removeFromLinkIdIndex(node, oldLinkId);
+  addToLinkIdIndex(node, newLinkId);
+}
+
 void WorldNode::doPropertiesDidChange(const vm::bbox3d& /* oldBounds */) {}
 
 vm::vec3d WorldNode::doGetLinkSourceAnchor() const
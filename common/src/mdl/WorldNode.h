@@ -20,15 +20,16 @@
 #pragma once
 
 #include "Macros.h"
+#include "bvh.h"
 #include "mdl/EntityNodeBase.h"
 #include "mdl/EntityProperties.h"
 #include "mdl/IdType.h"
 #include "mdl/MapFormat.h"
 #include "mdl/Node.h"
-#include "octree.h"
 
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace tb::mdl
@@ -47,9 +48,10 @@ private:
   MapFormat m_mapFormat;
   LayerNode* m_defaultLayer;
   std::unique_ptr<EntityNodeIndex> m_entityNodeIndex;
+  std::unordered_map<std::string, std::vector<Node*>> m_linkIdIndex;
   std::unique_ptr<ValidatorRegistry> m_validatorRegistry;
 
-  using NodeTree = octree<double, Node*>;
+  using NodeTree = bvh<double, Node*>;
   std::unique_ptr<NodeTree> m_nodeTree;
   bool m_updateNodeTree;
 
@@ -71,6 +73,15 @@ public:
 
   const NodeTree& nodeTree() const;
 
+  /**
+   * Returns a copy of this world and all of its descendants that can be serialized
+   * independently of this world, e.g. on a worker thread while this world is being
+   * edited. Unlike cloneRecursively, the copy retains the persistent IDs of layers and
+   * groups and the attributes of the default layer. The copy does not maintain a node
+   * tree.
+   */
+  std::unique_ptr<WorldNode> snapshot(const vm::bbox3d& worldBounds) const;
+
 public: // layer management
   LayerNode* defaultLayer();
 
@@ -124,6 +135,12 @@ private:
 public: // index
   const EntityNodeIndex& entityNodeIndex() const;
 
+  /**
+   * Returns all groups, entities, brushes and patches in this world that have the given
+   * link ID, in the order in which they were added to this world or given that link ID.
+   */
+  std::vector<Node*> findNodesWithLinkId(const std::string& linkId) const;
+
 public: // validator registration
   std::vector<const Validator*> registeredValidators() const;
   std::vector<const IssueQuickFix*> quickFixes(IssueType issueTypes) const;
@@ -137,6 +154,8 @@ public: // node tree bulk updating
 
 private:
   void invalidateAllIssues();
+  void addToLinkIdIndex(Node* node, const std::string& linkId);
+  void removeFromLinkIdIndex(Node* node, const std::string& linkId);
 
 private: // implement Node interface
   const vm::bbox3d& doGetLogicalBounds() const override;
@@ -174,6 +193,8 @@ private: // implement Node interface
     EntityNodeBase* node, const std::string& key, const std::string& value) override;
   void doRemoveFromIndex(
     EntityNodeBase* node, const std::string& key, const std::string& value) override;
+  void doUpdateLinkIdIndex(
+    Node* node, const std::string& oldLinkId, const std::string& newLinkId) override;
 
 private: // implement EntityNodeBase interface
   void doPropertiesDidChange(const vm::bbox3d& oldBounds) override;
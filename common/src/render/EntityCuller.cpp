@@ -0,0 +1,63 @@
+/*
+ Copyright (C) 2010 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "EntityCuller.h"
+
+#include "mdl/EntityNode.h"
+#include "render/ViewFrustum.h"
+
+namespace tb::render
+{
+
+void EntityCuller::addEntity(const mdl::EntityNode* entityNode)
+{
+  updateEntity(entityNode);
+}
+
+void EntityCuller::removeEntity(const mdl::EntityNode* entityNode)
+{
+  m_tree.remove(entityNode);
+}
+
+void EntityCuller::updateEntity(const mdl::EntityNode* entityNode)
+{
+  const auto bounds = vm::bbox3f{entityNode->physicalBounds()};
+  if (m_tree.contains(entityNode))
+  {
+    m_tree.update(bounds, entityNode);
+  }
+  else
+  {
+    m_tree.insert(bounds, entityNode);
+  }
+}
+
+void EntityCuller::clear()
+{
+  m_tree.clear();
+}
+
+std::vector<const mdl::EntityNode*> EntityCuller::findVisibleEntities(
+  const ViewFrustum& frustum) const
+{
+  return m_tree.find_if(
+    [&](const vm::bbox3f& bounds) { return frustum.intersects(bounds); });
+}
+
+} // namespace tb::render
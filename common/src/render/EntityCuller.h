@@ -0,0 +1,70 @@
+/*
+ Copyright (C) 2010 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "bvh.h"
+
+#include <vector>
+
+namespace tb::mdl
+{
+class EntityNode;
+} // namespace tb::mdl
+
+namespace tb::render
+{
+class ViewFrustum;
+
+/**
+ * A spatial index of the physical bounds of entities that finds the entities that
+ * intersect a view frustum without testing every entity.
+ *
+ * The bounds of an entity are recorded when it is added or updated, so the entity must be
+ * updated whenever its bounds change.
+ */
+class EntityCuller
+{
+private:
+  bvh<float, const mdl::EntityNode*> m_tree;
+
+public:
+  /**
+   * Adds the given entity, or updates it if it was already added.
+   */
+  void addEntity(const mdl::EntityNode* entityNode);
+
+  /**
+   * Removes the given entity. Calling with an unknown entity is allowed, but ignored.
+   */
+  void removeEntity(const mdl::EntityNode* entityNode);
+
+  /**
+   * Records the current bounds of the given entity. Calling with an unknown entity adds
+   * it.
+   */
+  void updateEntity(const mdl::EntityNode* entityNode);
+
+  void clear();
+
+  std::vector<const mdl::EntityNode*> findVisibleEntities(
+    const ViewFrustum& frustum) const;
+};
+
+} // namespace tb::render
@@ -0,0 +1,186 @@
+/*
+ Copyright (C) 2010 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "EntityLinkGraph.h"
+
+#include "mdl/BrushNode.h"
+#include "mdl/EditorContext.h"
+#include "mdl/EntityNode.h"
+#include "mdl/EntityNodeBase.h"
+#include "mdl/GroupNode.h"
+#include "mdl/LayerNode.h"
+#include "mdl/PatchNode.h"
+#include "mdl/WorldNode.h"
+
+#include "kdl/overload.h"
+
+#include <utility>
+
+namespace tb::render
+{
+
+void EntityLinkGraph::invalidate()
+{
+  m_linksBySource.clear();
+  m_sourcesByTarget.clear();
+  m_invalidEntities.clear();
+  m_valid = false;
+}
+
+void EntityLinkGraph::invalidateEntity(const mdl::EntityNodeBase* entityNode)
+{
+  if (!m_valid)
+  {
+    return;
+  }
+
+  m_invalidEntities.insert(entityNode);
+  m_invalidEntities.insert(
+    entityNode->linkSources().begin(), entityNode->linkSources().end());
+  m_invalidEntities.insert(
+    entityNode->killSources().begin(), entityNode->killSources().end());
+
+  // the entity may have lost sources that still link to it
+  if (const auto it = m_sourcesByTarget.find(entityNode); it != m_sourcesByTarget.end())
+  {
+    m_invalidEntities.insert(it->second.begin(), it->second.end());
+  }
+}
+
+void EntityLinkGraph::invalidateSelection(const std::vector<mdl::Node*>& nodes)
+{
+  for (const auto* node : nodes)
+  {
+    node->accept(kdl::overload(
+      [](const mdl::WorldNode*) {},
+      [](const mdl::LayerNode*) {},
+      [](const mdl::GroupNode*) {},
+      [&](const mdl::EntityNode* entityNode) { invalidateEntity(entityNode); },
+      [&](const mdl::BrushNode* brushNode) { invalidateEntity(brushNode->entity()); },
+      [&](const mdl::PatchNode* patchNode) { invalidateEntity(patchNode->entity()); }));
+  }
+}
+
+void EntityLinkGraph::removeEntity(const mdl::EntityNodeBase* entityNode)
+{
+  if (!m_valid)
+  {
+    return;
+  }
+
+  removeLinks(entityNode);
+  m_invalidEntities.erase(entityNode);
+
+  if (const auto it = m_sourcesByTarget.find(entityNode); it != m_sourcesByTarget.end())
+  {
+    m_invalidEntities.insert(it->second.begin(), it->second.end());
+    m_sourcesByTarget.erase(it);
+  }
+}
+
+void EntityLinkGraph::validate(
+  const mdl::WorldNode& worldNode, const mdl::EditorContext& editorContext)
+{
+  if (!m_valid)
+  {
+    worldNode.accept(kdl::overload(
+      [](auto&& thisLambda, const mdl::WorldNode* world) {
+        world->visitChildren(thisLambda);
+      },
+      [](auto&& thisLambda, const mdl::LayerNode* layerNode) {
+        layerNode->visitChildren(thisLambda);
+      },
+      [](auto&& thisLambda, const mdl::GroupNode* groupNode) {
+        groupNode->visitChildren(thisLambda);
+      },
+      [&](const mdl::EntityNode* entityNode) { addLinks(*entityNode, editorContext); },
+      [](const mdl::BrushNode*) {},
+      [](const mdl::PatchNode*) {}));
+
+    m_valid = true;
+    return;
+  }
+
+  for (const auto* entityNode : m_invalidEntities)
+  {
+    removeLinks(entityNode);
+
+    // the world is never a link source
+    if (entityNode != &worldNode)
+    {
+      addLinks(*entityNode, editorContext);
+    }
+  }
+  m_invalidEntities.clear();
+}
+
+void EntityLinkGraph::addLinks(
+  const mdl::EntityNodeBase& source, const mdl::EditorContext& editorContext)
+{
+  if (!editorContext.visible(&source))
+  {
+    return;
+  }
+
+  auto links = std::vector<Link>{};
+  const auto addTargets = [&](const auto& targets) {
+    for (const auto* target : targets)
+    {
+      if (editorContext.visible(target))
+      {
+        links.push_back(Link{
+          &source,
+          target,
+          vm::vec3f{source.linkSourceAnchor()},
+          vm::vec3f{target->linkTargetAnchor()}});
+        m_sourcesByTarget[target].insert(&source);
+      }
+    }
+  };
+
+  addTargets(source.linkTargets());
+  addTargets(source.killTargets());
+
+  if (!links.empty())
+  {
+    m_linksBySource[&source] = std::move(links);
+  }
+}
+
+void EntityLinkGraph::removeLinks(const mdl::EntityNodeBase* source)
+{
+  if (const auto it = m_linksBySource.find(source); it != m_linksBySource.end())
+  {
+    for (const auto& link : it->second)
+    {
+      if (const auto sourcesIt = m_sourcesByTarget.find(link.target);
+          sourcesIt != m_sourcesByTarget.end())
+      {
+        sourcesIt->second.erase(source);
+        if (sourcesIt->second.empty())
+        {
+          m_sourcesByTarget.erase(sourcesIt);
+        }
+      }
+    }
+    m_linksBySource.erase(it);
+  }
+}
+
+} // namespace tb::render
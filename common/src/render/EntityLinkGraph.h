@@ -0,0 +1,122 @@
+/*
+ Copyright (C) 2010 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "vm/vec.h"
+
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace tb::mdl
+{
+class EditorContext;
+class EntityNodeBase;
+class Node;
+class WorldNode;
+} // namespace tb::mdl
+
+namespace tb::render
+{
+
+/**
+ * The target and killtarget links between the visible entities of a map.
+ *
+ * The links are stored per source entity so that only the links that touch changed
+ * entities must be recomputed when the graph is validated. The graph must be told about
+ * every entity that changes or is removed, and it must be invalidated entirely when a
+ * change can affect the visibility of many entities.
+ */
+class EntityLinkGraph
+{
+public:
+  struct Link
+  {
+    const mdl::EntityNodeBase* source;
+    const mdl::EntityNodeBase* target;
+    vm::vec3f sourceAnchor;
+    vm::vec3f targetAnchor;
+  };
+
+private:
+  std::unordered_map<const mdl::EntityNodeBase*, std::vector<Link>> m_linksBySource;
+  std::unordered_map<
+    const mdl::EntityNodeBase*,
+    std::unordered_set<const mdl::EntityNodeBase*>>
+    m_sourcesByTarget;
+  std::unordered_set<const mdl::EntityNodeBase*> m_invalidEntities;
+  bool m_valid = false;
+
+public:
+  /**
+   * Discards all links. They are recomputed from the entire world on the next call to
+   * validate.
+   */
+  void invalidate();
+
+  /**
+   * Marks the links of the given entity as invalid, including the links that point to
+   * it. The entity must be part of the world that is passed to validate.
+   */
+  void invalidateEntity(const mdl::EntityNodeBase* entityNode);
+
+  /**
+   * Marks the links of the entities whose visibility depends on the selection of the
+   * given nodes as invalid. Selected entities are always visible, and a brush entity is
+   * visible if any of its brushes or patches is visible, so this affects the given
+   * entities and the entities that contain the given brushes and patches.
+   *
+   * Call this with the nodes that were selected or deselected.
+   */
+  void invalidateSelection(const std::vector<mdl::Node*>& nodes);
+
+  /**
+   * Removes the links from and to the given entity. The entity is not accessed, so it may
+   * be destroyed afterwards.
+   */
+  void removeEntity(const mdl::EntityNodeBase* entityNode);
+
+  /**
+   * Recomputes the invalid links.
+   */
+  void validate(const mdl::WorldNode& worldNode, const mdl::EditorContext& editorContext);
+
+  /**
+   * Calls the given function for every link. The graph must be valid.
+   */
+  template <typename F>
+  void visitLinks(const F& f) const
+  {
+    for (const auto& entry : m_linksBySource)
+    {
+      for (const auto& link : entry.second)
+      {
+        f(link);
+      }
+    }
+  }
+
+private:
+  void addLinks(
+    const mdl::EntityNodeBase& source, const mdl::EditorContext& editorContext);
+  void removeLinks(const mdl::EntityNodeBase* source);
+};
+
+} // namespace tb::render
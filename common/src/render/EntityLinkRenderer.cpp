@@ -30,6 +30,7 @@
 #include "mdl/PatchNode.h"
 #include "mdl/WorldNode.h"
 #include "ui/MapDocument.h"
+#include "ui/Selection.h"
 
 #include "kdl/memory_utils.h"
 #include "kdl/overload.h"
@@ -84,37 +85,6 @@ void addLink(
   links.emplace_back(vm::vec3f{target.linkTargetAnchor()}, targetColor);
 }
 
-struct CollectAllLinksVisitor
-{
-  const mdl::EditorContext& editorContext;
-  Color defaultColor;
-  Color selectedColor;
-
-  void visit(
-    const mdl::EntityNodeBase& node, std::vector<LinkRenderer::LineVertex>& links)
-  {
-    if (editorContext.visible(&node))
-    {
-      addTargets(node, node.linkTargets(), links);
-      addTargets(node, node.killTargets(), links);
-    }
-  }
-
-  void addTargets(
-    const mdl::EntityNodeBase& source,
-    const std::vector<mdl::EntityNodeBase*>& targets,
-    std::vector<LinkRenderer::LineVertex>& links)
-  {
-    for (const mdl::EntityNodeBase* target : targets)
-    {
-      if (editorContext.visible(target))
-      {
-        addLink(source, *target, defaultColor, selectedColor, links);
-      }
-    }
-  }
-};
-
 struct CollectTransitiveSelectedLinksVisitor
 {
   const mdl::EditorContext& editorContext;
@@ -242,28 +212,28 @@ auto collectSelectedLinks(const mdl::NodeCollection& selectedNodes, Visitor visi
 }
 
 auto getAllLinks(
-  ui::MapDocument& document, const Color& defaultColor, const Color& selectedColor)
+  ui::MapDocument& document,
+  EntityLinkGraph& linkGraph,
+  const Color& defaultColor,
+  const Color& selectedColor)
 {
   auto links = std::vector<LinkRenderer::LineVertex>{};
 
   if (document.world())
   {
-    auto visitor =
-      CollectAllLinksVisitor{document.editorContext(), defaultColor, selectedColor};
-
-    document.world()->accept(kdl::overload(
-      [](auto&& thisLambda, const mdl::WorldNode* worldNode) {
-        worldNode->visitChildren(thisLambda);
-      },
-      [](auto&& thisLambda, const mdl::LayerNode* layerNode) {
-        layerNode->visitChildren(thisLambda);
-      },
-      [](auto&& thisLambda, const mdl::GroupNode* groupNode) {
-        groupNode->visitChildren(thisLambda);
-      },
-      [&](const mdl::EntityNode* entityNode) { visitor.visit(*entityNode, links); },
-      [](const mdl::BrushNode*) {},
-      [](const mdl::PatchNode*) {}));
+    linkGraph.validate(*document.world(), document.editorContext());
+
+    // the links are cached, but their colors depend on the selection
+    linkGraph.visitLinks([&](const auto& link) {
+      const auto anySelected = link.source->selected()
+                               || link.source->descendantSelected()
+                               || link.target->selected()
+                               || link.target->descendantSelected();
+      const auto& color = anySelected ? selectedColor : defaultColor;
+
+      links.emplace_back(link.sourceAnchor, color);
+      links.emplace_back(link.targetAnchor, color);
+    });
   }
 
   return links;
@@ -286,12 +256,15 @@ auto getDirectSelectedLinks(
 }
 
 auto getLinks(
-  ui::MapDocument& document, const Color& defaultColor, const Color& selectedColor)
+  ui::MapDocument& document,
+  EntityLinkGraph& linkGraph,
+  const Color& defaultColor,
+  const Color& selectedColor)
 {
   const auto entityLinkMode = pref(Preferences::EntityLinkMode);
   if (entityLinkMode == Preferences::entityLinkModeAll())
   {
-    return getAllLinks(document, defaultColor, selectedColor);
+    return getAllLinks(document, linkGraph, defaultColor, selectedColor);
   }
   if (entityLinkMode == Preferences::entityLinkModeTransitive())
   {
@@ -304,11 +277,80 @@ auto getLinks(
 
   return std::vector<LinkRenderer::LineVertex>{};
 }
+
+template <typename F>
+void visitEntityNodes(
+  const std::vector<mdl::Node*>& nodes, const bool recurse, const F& f)
+{
+  for (auto* node : nodes)
+  {
+    node->accept(kdl::overload(
+      [&](auto&& thisLambda, const mdl::WorldNode* worldNode) {
+        if (recurse)
+        {
+          worldNode->visitChildren(thisLambda);
+        }
+      },
+      [&](auto&& thisLambda, const mdl::LayerNode* layerNode) {
+        if (recurse)
+        {
+          layerNode->visitChildren(thisLambda);
+        }
+      },
+      [&](auto&& thisLambda, const mdl::GroupNode* groupNode) {
+        if (recurse)
+        {
+          groupNode->visitChildren(thisLambda);
+        }
+      },
+      [&](const mdl::EntityNode* entityNode) { f(entityNode); },
+      [](const mdl::BrushNode*) {},
+      [](const mdl::PatchNode*) {}));
+  }
+}
+
 } // namespace
 
+void EntityLinkRenderer::invalidateLinks()
+{
+  m_linkGraph.invalidate();
+  invalidate();
+}
+
+void EntityLinkRenderer::nodesWereAdded(const std::vector<mdl::Node*>& nodes)
+{
+  visitEntityNodes(nodes, true, [&](const auto* entityNode) {
+    m_linkGraph.invalidateEntity(entityNode);
+  });
+  invalidate();
+}
+
+void EntityLinkRenderer::nodesWereRemoved(const std::vector<mdl::Node*>& nodes)
+{
+  visitEntityNodes(
+    nodes, true, [&](const auto* entityNode) { m_linkGraph.removeEntity(entityNode); });
+  invalidate();
+}
+
+void EntityLinkRenderer::nodesDidChange(const std::vector<mdl::Node*>& nodes)
+{
+  visitEntityNodes(nodes, false, [&](const auto* entityNode) {
+    m_linkGraph.invalidateEntity(entityNode);
+  });
+  invalidate();
+}
+
+void EntityLinkRenderer::selectionDidChange(const ui::Selection& selection)
+{
+  m_linkGraph.invalidateSelection(selection.selectedNodes());
+  m_linkGraph.invalidateSelection(selection.deselectedNodes());
+  invalidate();
+}
+
 std::vector<LinkRenderer::LineVertex> EntityLinkRenderer::getLinks()
 {
-  return render::getLinks(*kdl::mem_lock(m_document), m_defaultColor, m_selectedColor);
+  return render::getLinks(
+    *kdl::mem_lock(m_document), m_linkGraph, m_defaultColor, m_selectedColor);
 }
 
 } // namespace tb::render
@@ -21,15 +21,22 @@
 
 #include "Color.h"
 #include "Macros.h"
+#include "render/EntityLinkGraph.h"
 #include "render/LinkRenderer.h"
 
 #include <memory>
 #include <vector>
 
+namespace tb::mdl
+{
+class Node;
+} // namespace tb::mdl
+
 namespace tb::ui
 {
 class MapDocument; // FIXME: Renderer should not depend on View
-}
+class Selection;
+} // namespace tb::ui
 
 namespace tb::render
 {
@@ -37,6 +44,7 @@ namespace tb::render
 class EntityLinkRenderer : public LinkRenderer
 {
   std::weak_ptr<ui::MapDocument> m_document;
+  EntityLinkGraph m_linkGraph;
 
   Color m_defaultColor = {0.5f, 1.0f, 0.5f, 1.0f};
   Color m_selectedColor = {1.0f, 0.0f, 0.0f, 1.0f};
@@ -47,6 +55,35 @@ public:
   void setDefaultColor(const Color& color);
   void setSelectedColor(const Color& color);
 
+  /**
+   * Recomputes all links when they are rendered next. Call this when the visibility of
+   * many entities may have changed. Changes that only affect the colors of the links
+   * only require calling invalidate.
+   */
+  void invalidateLinks();
+
+  /**
+   * Updates the links of the entities whose visibility depends on the selection of the
+   * selected or deselected nodes, and the colors of all links.
+   */
+  void selectionDidChange(const ui::Selection& selection);
+
+  /**
+   * Updates the links of the entities among the given nodes and their descendants.
+   */
+  void nodesWereAdded(const std::vector<mdl::Node*>& nodes);
+
+  /**
+   * Removes the links of the entities among the given nodes and their descendants.
+   */
+  void nodesWereRemoved(const std::vector<mdl::Node*>& nodes);
+
+  /**
+   * Updates the links of the entities among the given nodes. Descendants are not
+   * considered because they are reported separately.
+   */
+  void nodesDidChange(const std::vector<mdl::Node*>& nodes);
+
 private:
   std::vector<LinkRenderer::LineVertex> getLinks() override;
 
@@ -36,9 +36,11 @@
 #include "render/RenderUtils.h"
 #include "render/Shaders.h"
 #include "render/Transformation.h"
+#include "render/ViewFrustum.h"
 
 #include "vm/mat.h"
 
+#include <optional>
 #include <vector>
 
 namespace tb::render
@@ -70,12 +72,14 @@ void EntityModelRenderer::addEntity(const mdl::EntityNode* entityNode)
   if (renderer != nullptr)
   {
     m_entities.emplace(entityNode, renderer);
+    m_culler.addEntity(entityNode);
   }
 }
 
 void EntityModelRenderer::removeEntity(const mdl::EntityNode* entityNode)
 {
   m_entities.erase(entityNode);
+  m_culler.removeEntity(entityNode);
 }
 
 void EntityModelRenderer::updateEntity(const mdl::EntityNode* entityNode)
@@ -96,16 +100,19 @@ void EntityModelRenderer::updateEntity(const mdl::EntityNode* entityNode)
   if (it == std::end(m_entities))
   {
     m_entities.emplace(entityNode, renderer);
+    m_culler.addEntity(entityNode);
   }
   else
   {
     if (renderer == nullptr)
     {
       m_entities.erase(it);
+      m_culler.removeEntity(entityNode);
     }
-    else if (it->second != renderer)
+    else
     {
       it->second = renderer;
+      m_culler.updateEntity(entityNode);
     }
   }
 }
@@ -113,6 +120,7 @@ void EntityModelRenderer::updateEntity(const mdl::EntityNode* entityNode)
 void EntityModelRenderer::clear()
 {
   m_entities.clear();
+  m_culler.clear();
 }
 
 bool EntityModelRenderer::applyTinting() const
@@ -190,13 +198,19 @@ void EntityModelRenderer::doRender(RenderContext& renderContext)
     const auto& propertyConfig = m_entities.begin()->first->entityPropertyConfig();
     const auto& defaultModelScaleExpression = propertyConfig.defaultModelScaleExpression;
 
-    for (const auto& [entityNode, renderer] : m_entities)
+    const auto maxDistance = prefs.get(Preferences::EntityModelMaxDistance);
+    const auto frustum = ViewFrustum{
+      renderContext.camera(),
+      maxDistance > 0.0f ? std::optional{maxDistance} : std::nullopt};
+    for (const auto* entityNode : m_culler.findVisibleEntities(frustum))
     {
       if (!m_showHiddenEntities && !m_editorContext.visible(entityNode))
       {
         continue;
       }
 
+      auto* renderer = m_entities.at(entityNode);
+
       const auto* model = entityNode->entity().model();
       const auto* modelData = model ? model->data() : nullptr;
       if (!modelData)
@@ -20,6 +20,7 @@
 #pragma once
 
 #include "Color.h"
+#include "render/EntityCuller.h"
 #include "render/Renderable.h"
 
 #include <unordered_map>
@@ -51,6 +52,7 @@ private:
   const mdl::EditorContext& m_editorContext;
 
   std::unordered_map<const mdl::EntityNode*, MaterialRenderer*> m_entities;
+  EntityCuller m_culler;
 
   bool m_applyTinting = false;
   Color m_tintColor;
@@ -32,6 +32,7 @@
 #include "render/RenderContext.h"
 #include "render/RenderService.h"
 #include "render/TextAnchor.h"
+#include "render/ViewFrustum.h"
 
 #include "vm/mat.h"
 #include "vm/mat_ext.h"
@@ -79,6 +80,10 @@ EntityRenderer::EntityRenderer(
 
 void EntityRenderer::invalidate()
 {
+  for (const auto* entity : m_entities)
+  {
+    m_culler.updateEntity(entity);
+  }
   invalidateBounds();
   reloadModels();
 }
@@ -86,6 +91,7 @@ void EntityRenderer::invalidate()
 void EntityRenderer::clear()
 {
   m_entities.clear();
+  m_culler.clear();
   m_pointEntityWireframeBoundsRenderer = DirectEdgeRenderer();
   m_brushEntityWireframeBoundsRenderer = DirectEdgeRenderer();
   m_solidBoundsRenderer = TriangleRenderer();
@@ -101,6 +107,7 @@ void EntityRenderer::addEntity(const mdl::EntityNode* entity)
 {
   if (m_entities.insert(entity).second)
   {
+    m_culler.addEntity(entity);
     m_modelRenderer.addEntity(entity);
     invalidateBounds();
   }
@@ -111,6 +118,7 @@ void EntityRenderer::removeEntity(const mdl::EntityNode* entity)
   if (auto it = m_entities.find(entity); it != std::end(m_entities))
   {
     m_entities.erase(it);
+    m_culler.removeEntity(entity);
     m_modelRenderer.removeEntity(entity);
     invalidateBounds();
   }
@@ -118,6 +126,7 @@ void EntityRenderer::removeEntity(const mdl::EntityNode* entity)
 
 void EntityRenderer::invalidateEntity(const mdl::EntityNode* entity)
 {
+  m_culler.updateEntity(entity);
   m_modelRenderer.updateEntity(entity);
   invalidateBounds();
 }
@@ -288,7 +297,8 @@ void EntityRenderer::renderClassnames(
     renderService.setForegroundColor(m_overlayTextColor);
     renderService.setBackgroundColor(m_overlayBackgroundColor);
 
-    for (const auto* entity : m_entities)
+    const auto frustum = ViewFrustum{renderContext.camera()};
+    for (const auto* entity : m_culler.findVisibleEntities(frustum))
     {
       if (m_showHiddenEntities || m_editorContext.visible(entity))
       {
@@ -314,7 +324,8 @@ void EntityRenderer::renderClassnames(
 
 void EntityRenderer::renderAngles(RenderContext& renderContext, RenderBatch& renderBatch)
 {
-  static constexpr auto maxDistance2 = 500.0f * 500.0f;
+  static constexpr auto maxDistance = 500.0f;
+  static constexpr auto maxDistance2 = maxDistance * maxDistance;
 
   if (m_showAngles)
   {
@@ -324,7 +335,8 @@ void EntityRenderer::renderAngles(RenderContext& renderContext, RenderBatch& ren
     renderService.setShowOccludedObjectsTransparent();
     renderService.setForegroundColor(m_angleColor);
 
-    for (const auto* entityNode : m_entities)
+    const auto frustum = ViewFrustum{renderContext.camera(), maxDistance};
+    for (const auto* entityNode : m_culler.findVisibleEntities(frustum))
     {
       if (!m_showHiddenEntities && !m_editorContext.visible(entityNode))
       {
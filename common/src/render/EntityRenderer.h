@@ -21,6 +21,7 @@
 
 #include "Color.h"
 #include "render/EdgeRenderer.h"
+#include "render/EntityCuller.h"
 #include "render/EntityModelRenderer.h"
 #include "render/Renderable.h"
 #include "render/TriangleRenderer.h"
@@ -52,6 +53,7 @@ private:
   mdl::EntityModelManager& m_entityModelManager;
   const mdl::EditorContext& m_editorContext;
   kdl::vector_set<const mdl::EntityNode*> m_entities;
+  EntityCuller m_culler;
 
   DirectEdgeRenderer m_pointEntityWireframeBoundsRenderer;
   DirectEdgeRenderer m_brushEntityWireframeBoundsRenderer;
@@ -254,7 +254,7 @@ void MapRenderer::clear()
   m_selectionRenderer->clear();
   m_lockedRenderer->clear();
   m_entityDecalRenderer->clear();
-  m_entityLinkRenderer->invalidate();
+  m_entityLinkRenderer->invalidateLinks();
   m_groupLinkRenderer->invalidate();
   m_trackedNodes.clear();
 }
@@ -635,7 +635,7 @@ void MapRenderer::invalidateEntityDecalRenderer()
 
 void MapRenderer::invalidateEntityLinkRenderer()
 {
-  m_entityLinkRenderer->invalidate();
+  m_entityLinkRenderer->invalidateLinks();
 }
 
 void MapRenderer::invalidateGroupLinkRenderer()
@@ -716,7 +716,7 @@ void MapRenderer::nodesWereAdded(const std::vector<mdl::Node*>& nodes)
     updateAndInvalidateNodeRecursive(node);
   }
   invalidateGroupLinkRenderer();
-  invalidateEntityLinkRenderer();
+  m_entityLinkRenderer->nodesWereAdded(nodes);
 }
 
 void MapRenderer::nodesWereRemoved(const std::vector<mdl::Node*>& nodes)
@@ -728,7 +728,7 @@ void MapRenderer::nodesWereRemoved(const std::vector<mdl::Node*>& nodes)
     removeNodeRecursive(node);
   }
   invalidateGroupLinkRenderer();
-  invalidateEntityLinkRenderer();
+  m_entityLinkRenderer->nodesWereRemoved(nodes);
 }
 
 void MapRenderer::nodesDidChange(const std::vector<mdl::Node*>& nodes)
@@ -740,7 +740,7 @@ void MapRenderer::nodesDidChange(const std::vector<mdl::Node*>& nodes)
     // it would cause the entire map to be invalidated on every change.
     updateAndInvalidateNode(node);
   }
-  invalidateEntityLinkRenderer();
+  m_entityLinkRenderer->nodesDidChange(nodes);
   invalidateGroupLinkRenderer();
 }
 
@@ -759,19 +759,25 @@ void MapRenderer::nodeLockingDidChange(const std::vector<mdl::Node*>& nodes)
   {
     updateAndInvalidateNodeRecursive(node);
   }
-  invalidateEntityLinkRenderer();
+  // locking does not affect the visibility of entities, and any selection changes that
+  // go along with it are reported to selectionDidChange
+  m_entityLinkRenderer->invalidate();
 }
 
 void MapRenderer::groupWasOpened(mdl::GroupNode*)
 {
   invalidateGroupLinkRenderer();
-  invalidateEntityLinkRenderer();
+  // opening or closing a group does not affect the visibility of entities, and any
+  // selection changes that go along with it are reported to selectionDidChange
+  m_entityLinkRenderer->invalidate();
 }
 
 void MapRenderer::groupWasClosed(mdl::GroupNode*)
 {
   invalidateGroupLinkRenderer();
-  invalidateEntityLinkRenderer();
+  // opening or closing a group does not affect the visibility of entities, and any
+  // selection changes that go along with it are reported to selectionDidChange
+  m_entityLinkRenderer->invalidate();
 }
 
 void MapRenderer::brushFacesDidChange(const std::vector<mdl::BrushFaceHandle>& faces)
@@ -803,7 +809,7 @@ void MapRenderer::selectionDidChange(const ui::Selection& selection)
     updateAndInvalidateNodeRecursive(node);
   }
 
-  invalidateEntityLinkRenderer();
+  m_entityLinkRenderer->selectionDidChange(selection);
   invalidateGroupLinkRenderer();
 }
 
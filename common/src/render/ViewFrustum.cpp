@@ -0,0 +1,89 @@
+/*
+ Copyright (C) 2010 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ViewFrustum.h"
+
+#include "render/Camera.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace tb::render
+{
+namespace
+{
+
+std::vector<vm::plane3f> frustumPlanes(const Camera& camera)
+{
+  auto top = vm::plane3f{};
+  auto right = vm::plane3f{};
+  auto bottom = vm::plane3f{};
+  auto left = vm::plane3f{};
+  camera.frustumPlanes(top, right, bottom, left);
+  return {top, right, bottom, left};
+}
+
+std::optional<float> effectiveMaxDistance(
+  const Camera& camera, const std::optional<float> maxDistance)
+{
+  return camera.perspectiveProjection() ? maxDistance : std::nullopt;
+}
+
+} // namespace
+
+ViewFrustum::ViewFrustum(
+  std::vector<vm::plane3f> planes,
+  const vm::vec3f& origin,
+  const std::optional<float> maxDistance)
+  : m_planes{std::move(planes)}
+  , m_origin{origin}
+  , m_maxDistance{maxDistance}
+{
+}
+
+ViewFrustum::ViewFrustum(const Camera& camera, const std::optional<float> maxDistance)
+  : ViewFrustum{
+      frustumPlanes(camera),
+      camera.position(),
+      effectiveMaxDistance(camera, maxDistance)}
+{
+}
+
+bool ViewFrustum::intersects(const vm::bbox3f& bounds) const
+{
+  if (m_maxDistance)
+  {
+    const auto closestPoint = vm::max(bounds.min, vm::min(m_origin, bounds.max));
+    if (vm::squared_distance(closestPoint, m_origin) > *m_maxDistance * *m_maxDistance)
+    {
+      return false;
+    }
+  }
+
+  return std::ranges::none_of(m_planes, [&](const auto& plane) {
+    // the corner of the bounds that lies farthest behind the plane
+    const auto corner = vm::vec3f{
+      plane.normal.x() >= 0.0f ? bounds.min.x() : bounds.max.x(),
+      plane.normal.y() >= 0.0f ? bounds.min.y() : bounds.max.y(),
+      plane.normal.z() >= 0.0f ? bounds.min.z() : bounds.max.z()};
+    return plane.point_distance(corner) > 0.0f;
+  });
+}
+
+} // namespace tb::render
@@ -0,0 +1,65 @@
+/*
+ Copyright (C) 2010 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "vm/bbox.h"
+#include "vm/plane.h"
+#include "vm/vec.h"
+
+#include <optional>
+#include <vector>
+
+namespace tb::render
+{
+class Camera;
+
+/**
+ * The part of the world that is visible from a camera, used to skip objects that are not
+ * on screen before they are rendered.
+ *
+ * The frustum is bounded by planes whose normals point away from it, and optionally by a
+ * maximum distance from its origin. The tests are conservative: A bounding box that is
+ * reported as not intersecting the frustum is never visible, but a bounding box that is
+ * reported as intersecting it may still be off screen.
+ */
+class ViewFrustum
+{
+private:
+  std::vector<vm::plane3f> m_planes;
+  vm::vec3f m_origin;
+  std::optional<float> m_maxDistance;
+
+public:
+  ViewFrustum(
+    std::vector<vm::plane3f> planes,
+    const vm::vec3f& origin,
+    std::optional<float> maxDistance = std::nullopt);
+
+  /**
+   * Creates the frustum of the given camera. The maximum distance is only applied for
+   * perspective cameras, since an orthographic camera is usually far away from the map.
+   */
+  explicit ViewFrustum(
+    const Camera& camera, std::optional<float> maxDistance = std::nullopt);
+
+  bool intersects(const vm::bbox3f& bounds) const;
+};
+
+} // namespace tb::render
@@ -1167,6 +1167,16 @@ void ActionManager::createFileMenu()
     std::nullopt,
     QObject::tr("Discards any unsaved changes and reloads the map file."),
   }));
+  fileMenu.addItem(addAction(Action{
+    "Menu/File/Restore Autosave Backup...",
+    QObject::tr("Restore Autosave Backup..."),
+    ActionContext::Any,
+    QKeySequence{},
+    [](auto& context) { context.frame()->restoreAutosaveBackup(); },
+    [](const auto& context) { return context.hasDocument(); },
+    std::nullopt,
+    QObject::tr("Writes an autosave backup of a map to a .map file."),
+  }));
   fileMenu.addItem(addAction(Action{
     "Menu/File/Close",
     QObject::tr("Close Document"),
@@ -21,6 +21,7 @@
 
 #include "Ensure.h"
 #include "Macros.h"
+#include "mdl/ModelUtils.h"
 #include "mdl/Node.h"
 #include "ui/MapDocumentCommandFacade.h"
 
@@ -73,6 +74,24 @@ AddRemoveNodesCommand::AddRemoveNodesCommand(
   }
 }
 
+size_t AddRemoveNodesCommand::memoryUsage() const
+{
+  // the nodes to add are owned by this command until they are added to the document
+  auto result = UpdateLinkedGroupsCommandBase::memoryUsage();
+  for (const auto& [parent, children] : m_nodesToAdd)
+  {
+    result += sizeof(std::pair<mdl::Node*, std::vector<mdl::Node*>>)
+              + children.capacity() * sizeof(mdl::Node*)
+              + mdl::computeMemoryUsage(children);
+  }
+  for (const auto& [parent, children] : m_nodesToRemove)
+  {
+    result += sizeof(std::pair<mdl::Node*, std::vector<mdl::Node*>>)
+              + children.capacity() * sizeof(mdl::Node*);
+  }
+  return result;
+}
+
 std::string AddRemoveNodesCommand::makeName(const Action action)
 {
   switch (action)
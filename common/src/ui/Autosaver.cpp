@@ -19,6 +19,8 @@
 
 #include "Autosaver.h"
 
+#include "Logger.h"
+#include "io/BackupStore.h"
 #include "io/DiskFileSystem.h"
 #include "io/DiskIO.h"
 #include "io/FileSystem.h"
@@ -37,6 +39,9 @@
 
 #include <algorithm>
 #include <cassert>
+#include <string_view>
+#include <tuple>
+#include <vector>
 
 namespace tb::ui
 {
@@ -44,6 +49,8 @@ namespace tb::ui
 namespace
 {
 
+constexpr auto BackupExtension = ".tbbackup";
+
 Result<io::WritableDiskFileSystem> createBackupFileSystem(
   const std::filesystem::path& mapPath)
 {
@@ -92,7 +99,13 @@ Result<std::vector<std::filesystem::path>> thinBackups(
 std::filesystem::path makeBackupName(
   const std::filesystem::path& mapBasename, const size_t index)
 {
-  return kdl::path_add_extension(mapBasename, "." + kdl::str_to_string(index) + ".map");
+  return kdl::path_add_extension(
+    mapBasename, "." + kdl::str_to_string(index) + BackupExtension);
+}
+
+std::filesystem::path makeChunkDirectoryName(const std::filesystem::path& mapBasename)
+{
+  return kdl::path_add_extension(mapBasename, ".chunks");
 }
 
 Result<void> cleanBackups(
@@ -123,12 +136,21 @@ io::PathMatcher makeBackupPathMatcher(std::filesystem::path mapBasename_)
       const auto backupNum = backupExtension.empty() ? "" : backupExtension.substr(1);
 
       return getPathInfo(path) == io::PathInfo::File
-             && kdl::path_to_lower(path.extension()) == ".map"
+             && kdl::path_to_lower(path.extension()) == BackupExtension
              && backupBasename == mapBasename && kdl::str_is_numeric(backupNum)
              && kdl::str_to_size(backupNum).value_or(0u) > 0u;
     };
 }
 
+Result<void> restoreBackup(
+  const std::filesystem::path& backupPath, const std::filesystem::path& mapPath)
+{
+  const auto mapBasename = backupPath.stem().stem();
+  const auto chunkDirectory =
+    backupPath.parent_path() / makeChunkDirectoryName(mapBasename);
+  return io::BackupStore{chunkDirectory}.restoreBackup(backupPath, mapPath);
+}
+
 Autosaver::Autosaver(
   std::weak_ptr<MapDocument> document,
   const std::chrono::milliseconds saveInterval,
@@ -141,8 +163,21 @@ Autosaver::Autosaver(
 {
 }
 
+Autosaver::~Autosaver()
+{
+  if (m_pendingBackup)
+  {
+    m_pendingBackup->result.wait();
+  }
+}
+
 void Autosaver::triggerAutosave(Logger& logger)
 {
+  if (checkPendingBackup(logger))
+  {
+    return;
+  }
+
   if (!kdl::mem_expired(m_document))
   {
     auto document = kdl::mem_lock(m_document);
@@ -155,12 +190,50 @@ void Autosaver::triggerAutosave(Logger& logger)
   }
 }
 
+void Autosaver::waitForPendingBackup(Logger& logger)
+{
+  if (m_pendingBackup)
+  {
+    m_pendingBackup->result.wait();
+    finishPendingBackup(logger);
+  }
+}
+
+bool Autosaver::checkPendingBackup(Logger& logger)
+{
+  if (m_pendingBackup)
+  {
+    using namespace std::chrono_literals;
+    if (m_pendingBackup->result.wait_for(0s) != std::future_status::ready)
+    {
+      return true;
+    }
+    finishPendingBackup(logger);
+  }
+  return false;
+}
+
+void Autosaver::finishPendingBackup(Logger& logger)
+{
+  assert(m_pendingBackup);
+
+  const auto backupFilePath = std::move(m_pendingBackup->path);
+  auto result = m_pendingBackup->result.get();
+  m_pendingBackup = std::nullopt;
+
+  result | kdl::transform([&]() {
+    logger.info() << "Created autosave backup at " << backupFilePath;
+  }) | kdl::transform_error([&](auto e) {
+    logger.error() << "Could not write autosave backup " << backupFilePath << ": "
+                   << e.msg;
+  });
+}
+
 void Autosaver::autosave(Logger& logger, std::shared_ptr<MapDocument> document)
 {
   const auto& mapPath = document->path();
   assert(io::Disk::pathInfo(mapPath) == io::PathInfo::File);
 
-  const auto mapFilename = mapPath.filename();
   const auto mapBasename = mapPath.stem();
 
   createBackupFileSystem(mapPath) | kdl::and_then([&](auto fs) {
@@ -169,18 +242,42 @@ void Autosaver::autosave(Logger& logger, std::shared_ptr<MapDocument> document)
            })
            | kdl::and_then([&](auto remainingBackups) {
                return cleanBackups(fs, remainingBackups, mapBasename)
-                      | kdl::and_then([&]() {
+                      | kdl::transform([&]() {
                           assert(remainingBackups.size() < m_maxBackups);
-                          const auto backupNo = remainingBackups.size() + 1;
-                          return fs.makeAbsolute(makeBackupName(mapBasename, backupNo));
+
+                          // the remaining backups were renumbered, the new one comes last
+                          auto backupFilePaths = std::vector<std::filesystem::path>{};
+                          for (size_t i = 0; i <= remainingBackups.size(); ++i)
+                          {
+                            backupFilePaths.push_back(
+                              fs.root() / makeBackupName(mapBasename, i + 1));
+                          }
+                          auto store = io::BackupStore{
+                            fs.root() / makeChunkDirectoryName(mapBasename)};
+                          return std::tuple{std::move(store), std::move(backupFilePaths)};
                         });
              });
-  }) | kdl::transform([&](const auto& backupFilePath) {
+  }) | kdl::transform([&](auto storeAndBackupFilePaths) {
+    auto [store, backupFilePaths] = std::move(storeAndBackupFilePaths);
+    const auto backupFilePath = backupFilePaths.back();
+
     m_lastSaveTime = Clock::now();
     m_lastModificationCount = document->modificationCount();
-    document->saveDocumentTo(backupFilePath);
 
-    logger.info() << "Created autosave backup at " << backupFilePath;
+    // Chunks that are no longer referenced after thinning the backups are only deleted
+    // once the new backup is written, so that the new backup can reuse them.
+    m_pendingBackup = PendingBackup{
+      backupFilePath,
+      document->saveSnapshot([store = std::move(store),
+                              backupFilePath,
+                              backupFilePaths = std::move(backupFilePaths)](
+                               const std::string_view mapText) {
+        return store.writeBackup(backupFilePath, mapText) | kdl::and_then([&](auto) {
+                 return store.collectGarbage(backupFilePaths);
+               })
+               | kdl::transform([](auto) {});
+      }),
+    };
   }) | kdl::transform_error([&](auto e) {
     logger.error() << "Aborting autosave: " << e.msg;
   });
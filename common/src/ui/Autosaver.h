@@ -19,11 +19,14 @@
 
 #pragma once
 
+#include "Result.h"
 #include "io/PathMatcher.h"
 
 #include <chrono>
 #include <filesystem>
+#include <future>
 #include <memory>
+#include <optional>
 
 namespace tb
 {
@@ -37,6 +40,17 @@ class MapDocument;
 
 io::PathMatcher makeBackupPathMatcher(std::filesystem::path mapBasename);
 
+/**
+ * Writes the contents of the given autosave backup to the given map file.
+ */
+Result<void> restoreBackup(
+  const std::filesystem::path& backupPath, const std::filesystem::path& mapPath);
+
+/**
+ * Periodically writes backups of a document to the autosave directory next to the map
+ * file. Backups are stored in an io::BackupStore, so every backup only writes the parts
+ * of the map that changed since the previous backups.
+ */
 class Autosaver
 {
 private:
@@ -52,6 +66,7 @@ private:
   /**
    * The maximum number of backups to create. When this number is exceeded, old backups
    * are deleted until the number of backups is equal to the number of backups again.
+   * Chunks that are only referenced by deleted backups are deleted along with them.
    */
   size_t m_maxBackups;
 
@@ -65,15 +80,40 @@ private:
    */
   size_t m_lastModificationCount;
 
+  struct PendingBackup
+  {
+    std::filesystem::path path;
+    std::future<Result<void>> result;
+  };
+
+  /**
+   * The backup that is currently being written on a worker thread, if any.
+   */
+  std::optional<PendingBackup> m_pendingBackup;
+
 public:
   explicit Autosaver(
     std::weak_ptr<MapDocument> document,
     std::chrono::milliseconds saveInterval = std::chrono::milliseconds(10 * 60 * 1000),
     size_t maxBackups = 50);
 
+  ~Autosaver();
+
   void triggerAutosave(Logger& logger);
 
+  /**
+   * Blocks until the backup that is currently being written, if any, is finished.
+   */
+  void waitForPendingBackup(Logger& logger);
+
 private:
+  /**
+   * Returns true if a backup is still being written. Reports the result of a finished
+   * backup to the given logger.
+   */
+  bool checkPendingBackup(Logger& logger);
+  void finishPendingBackup(Logger& logger);
+
   void autosave(Logger& logger, std::shared_ptr<ui::MapDocument> document);
 };
 
@@ -73,6 +73,16 @@ public:
   {
   }
 
+  size_t memoryUsage() const override
+  {
+    auto result = size_t(0);
+    for (const auto& command : m_commands)
+    {
+      result += command->memoryUsage();
+    }
+    return result;
+  }
+
 private:
   std::unique_ptr<CommandResult> doPerformDo(MapDocumentCommandFacade& document) override
   {
@@ -201,6 +211,18 @@ const std::string& CommandProcessor::redoCommandName() const
   return m_redoStack.back()->name();
 }
 
+std::vector<size_t> CommandProcessor::undoStackMemoryUsage() const
+{
+  return kdl::vec_transform(
+    m_undoStack, [](const auto& command) { return command->memoryUsage(); });
+}
+
+std::vector<size_t> CommandProcessor::redoStackMemoryUsage() const
+{
+  return kdl::vec_transform(
+    m_redoStack, [](const auto& command) { return command->memoryUsage(); });
+}
+
 void CommandProcessor::startTransaction(std::string name, const TransactionScope scope)
 {
   m_transactionStack.emplace_back(std::move(name), scope);
@@ -165,6 +165,21 @@ public:
    */
   const std::string& redoCommandName() const;
 
+  /**
+   * Returns an estimate of the number of heap allocated bytes held by each command on the
+   * undo stack, ordered from the least recently to the most recently executed command.
+   *
+   * Data that is shared between a command and the document, such as unchanged brush
+   * geometry, is not included.
+   */
+  std::vector<size_t> undoStackMemoryUsage() const;
+
+  /**
+   * Returns an estimate of the number of heap allocated bytes held by each command on the
+   * redo stack, ordered from the least recently to the most recently undone command.
+   */
+  std::vector<size_t> redoStackMemoryUsage() const;
+
   /**
    * Starts a new transaction. If a transaction is currently executing, then the newly
    * started transaction becomes a nested transaction and will be added as a command to
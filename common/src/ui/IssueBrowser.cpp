@@ -24,6 +24,8 @@
 #include <QStringList>
 #include <QVBoxLayout>
 
+#include "mdl/BrushFaceHandle.h"
+#include "mdl/BrushNode.h"
 #include "mdl/Issue.h"
 #include "mdl/Validator.h"
 #include "mdl/WorldNode.h"
@@ -32,6 +34,7 @@
 #include "ui/MapDocument.h"
 
 #include "kdl/memory_utils.h"
+#include "kdl/vector_utils.h"
 
 #include <utility>
 
@@ -77,6 +80,8 @@ QWidget* IssueBrowser::createTabBarPage(QWidget* parent)
 void IssueBrowser::connectObservers()
 {
   auto document = kdl::mem_lock(m_document);
+  m_notifierConnection += document->documentWasClearedNotifier.connect(
+    this, &IssueBrowser::documentWasCleared);
   m_notifierConnection +=
     document->documentWasSavedNotifier.connect(this, &IssueBrowser::documentWasSaved);
   m_notifierConnection += document->documentWasNewedNotifier.connect(
@@ -85,12 +90,23 @@ void IssueBrowser::connectObservers()
     this, &IssueBrowser::documentWasNewedOrLoaded);
   m_notifierConnection +=
     document->nodesWereAddedNotifier.connect(this, &IssueBrowser::nodesWereAdded);
+  m_notifierConnection += document->nodesWillBeRemovedNotifier.connect(
+    this, &IssueBrowser::nodesWillBeRemoved);
   m_notifierConnection +=
-    document->nodesWereRemovedNotifier.connect(this, &IssueBrowser::nodesWereRemoved);
+    document->nodesWillChangeNotifier.connect(this, &IssueBrowser::nodesWillChange);
   m_notifierConnection +=
     document->nodesDidChangeNotifier.connect(this, &IssueBrowser::nodesDidChange);
   m_notifierConnection += document->brushFacesDidChangeNotifier.connect(
     this, &IssueBrowser::brushFacesDidChange);
+  m_notifierConnection += document->entityDefinitionsDidChangeNotifier.connect(
+    this, &IssueBrowser::validatorsDidChange);
+  m_notifierConnection +=
+    document->modsDidChangeNotifier.connect(this, &IssueBrowser::validatorsDidChange);
+}
+
+void IssueBrowser::documentWasCleared(MapDocument*)
+{
+  m_view->clear();
 }
 
 void IssueBrowser::documentWasNewedOrLoaded(MapDocument*)
@@ -104,24 +120,31 @@ void IssueBrowser::documentWasSaved(MapDocument*)
   m_view->update();
 }
 
-void IssueBrowser::nodesWereAdded(const std::vector<mdl::Node*>&)
+void IssueBrowser::nodesWereAdded(const std::vector<mdl::Node*>& nodes)
 {
-  m_view->reload();
+  m_view->addNodes(nodes);
 }
 
-void IssueBrowser::nodesWereRemoved(const std::vector<mdl::Node*>&)
+void IssueBrowser::nodesWillBeRemoved(const std::vector<mdl::Node*>& nodes)
 {
-  m_view->reload();
+  m_view->removeNodes(nodes);
 }
 
-void IssueBrowser::nodesDidChange(const std::vector<mdl::Node*>&)
+void IssueBrowser::nodesWillChange(const std::vector<mdl::Node*>& nodes)
 {
-  m_view->reload();
+  // the entities that the nodes are linked with before the change may lose issues
+  m_view->invalidateNodes(nodes);
 }
 
-void IssueBrowser::brushFacesDidChange(const std::vector<mdl::BrushFaceHandle>&)
+void IssueBrowser::nodesDidChange(const std::vector<mdl::Node*>& nodes)
 {
-  m_view->reload();
+  m_view->invalidateNodes(nodes);
+}
+
+void IssueBrowser::brushFacesDidChange(const std::vector<mdl::BrushFaceHandle>& faces)
+{
+  m_view->invalidateNodes(kdl::vec_transform(
+    faces, [](const auto& handle) -> mdl::Node* { return handle.node(); }));
 }
 
 void IssueBrowser::issueIgnoreChanged(mdl::Issue*)
@@ -129,6 +152,11 @@ void IssueBrowser::issueIgnoreChanged(mdl::Issue*)
   m_view->update();
 }
 
+void IssueBrowser::validatorsDidChange()
+{
+  m_view->reload();
+}
+
 void IssueBrowser::updateFilterFlags()
 {
   auto document = kdl::mem_lock(m_document);
@@ -65,13 +65,16 @@ public:
 
 private:
   void connectObservers();
+  void documentWasCleared(MapDocument* document);
   void documentWasNewedOrLoaded(MapDocument* document);
   void documentWasSaved(MapDocument* document);
   void nodesWereAdded(const std::vector<mdl::Node*>& nodes);
-  void nodesWereRemoved(const std::vector<mdl::Node*>& nodes);
+  void nodesWillBeRemoved(const std::vector<mdl::Node*>& nodes);
+  void nodesWillChange(const std::vector<mdl::Node*>& nodes);
   void nodesDidChange(const std::vector<mdl::Node*>& nodes);
   void brushFacesDidChange(const std::vector<mdl::BrushFaceHandle>& faces);
   void issueIgnoreChanged(mdl::Issue* issue);
+  void validatorsDidChange();
 
   void updateFilterFlags();
 
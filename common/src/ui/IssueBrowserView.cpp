@@ -25,20 +25,14 @@
 #include <QMenu>
 #include <QTableView>
 
-#include "mdl/BrushNode.h"
-#include "mdl/EntityNode.h"
-#include "mdl/GroupNode.h"
 #include "mdl/Issue.h"
 #include "mdl/IssueQuickFix.h"
-#include "mdl/LayerNode.h"
-#include "mdl/PatchNode.h"
 #include "mdl/WorldNode.h"
 #include "ui/MapDocument.h"
 #include "ui/QtUtils.h"
 #include "ui/Transaction.h"
 
 #include "kdl/memory_utils.h"
-#include "kdl/overload.h"
 #include "kdl/vector_set.h"
 #include "kdl/vector_utils.h"
 
@@ -53,6 +47,7 @@ IssueBrowserView::IssueBrowserView(std::weak_ptr<MapDocument> document, QWidget*
 {
   createGui();
   bindEvents();
+  reload();
 }
 
 void IssueBrowserView::createGui()
@@ -97,6 +92,39 @@ void IssueBrowserView::setShowHiddenIssues(const bool show)
 
 void IssueBrowserView::reload()
 {
+  auto document = kdl::mem_lock(m_document);
+  if (auto* world = document->world())
+  {
+    m_issueIndex.reset(*world, world->registeredValidators());
+  }
+  else
+  {
+    m_issueIndex.clear();
+  }
+  invalidate();
+}
+
+void IssueBrowserView::clear()
+{
+  m_issueIndex.clear();
+  invalidate();
+}
+
+void IssueBrowserView::addNodes(const std::vector<mdl::Node*>& nodes)
+{
+  m_issueIndex.addNodes(nodes);
+  invalidate();
+}
+
+void IssueBrowserView::removeNodes(const std::vector<mdl::Node*>& nodes)
+{
+  m_issueIndex.removeNodes(nodes);
+  invalidate();
+}
+
+void IssueBrowserView::invalidateNodes(const std::vector<mdl::Node*>& nodes)
+{
+  m_issueIndex.invalidateNodes(nodes);
   invalidate();
 }
 
@@ -131,44 +159,15 @@ void IssueBrowserView::updateIssues()
   auto document = kdl::mem_lock(m_document);
   if (document->world() != nullptr)
   {
-    const auto validators = document->world()->registeredValidators();
+    m_issueIndex.validate(document->taskManager());
 
-    auto issues = std::vector<const mdl::Issue*>{};
-    const auto collectIssues = [&](auto* node) {
-      for (auto* issue : node->issues(validators))
-      {
-        if (
-          m_showHiddenIssues
-          || (!issue->hidden() && (issue->type() & m_hiddenIssueTypes) == 0))
-        {
-          issues.push_back(issue);
-        }
-      }
-    };
-
-    document->world()->accept(kdl::overload(
-      [&](auto&& thisLambda, mdl::WorldNode* world) {
-        collectIssues(world);
-        world->visitChildren(thisLambda);
-      },
-      [&](auto&& thisLambda, mdl::LayerNode* layer) {
-        collectIssues(layer);
-        layer->visitChildren(thisLambda);
-      },
-      [&](auto&& thisLambda, mdl::GroupNode* group) {
-        collectIssues(group);
-        group->visitChildren(thisLambda);
-      },
-      [&](auto&& thisLambda, mdl::EntityNode* entity) {
-        collectIssues(entity);
-        entity->visitChildren(thisLambda);
-      },
-      [&](mdl::BrushNode* brush) { collectIssues(brush); },
-      [&](mdl::PatchNode* patch) { collectIssues(patch); }));
-
-    issues = kdl::vec_sort(std::move(issues), [](const auto* lhs, const auto* rhs) {
-      return lhs->seqId() > rhs->seqId();
-    });
+    const auto issueTypes = m_showHiddenIssues ? ~mdl::IssueType(0) : ~m_hiddenIssueTypes;
+    auto issues = m_issueIndex.issues(issueTypes);
+    if (!m_showHiddenIssues)
+    {
+      issues = kdl::vec_filter(
+        std::move(issues), [](const auto* issue) { return !issue->hidden(); });
+    }
     m_tableModel->setIssues(std::move(issues));
   }
 }
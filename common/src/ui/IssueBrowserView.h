@@ -22,6 +22,7 @@
 #include <QAbstractItemModel>
 #include <QWidget>
 
+#include "mdl/IssueIndex.h"
 #include "mdl/IssueType.h"
 
 #include <memory>
@@ -36,6 +37,7 @@ namespace mdl
 {
 class Issue;
 class IssueQuickFix;
+class Node;
 } // namespace mdl
 
 namespace ui
@@ -52,6 +54,7 @@ private:
   int m_hiddenIssueTypes = 0;
   bool m_showHiddenIssues = false;
 
+  mdl::IssueIndex m_issueIndex;
   bool m_valid = false;
 
   QTableView* m_tableView = nullptr;
@@ -69,6 +72,10 @@ public:
   void setHiddenIssueTypes(int hiddenIssueTypes);
   void setShowHiddenIssues(bool show);
   void reload();
+  void clear();
+  void addNodes(const std::vector<mdl::Node*>& nodes);
+  void removeNodes(const std::vector<mdl::Node*>& nodes);
+  void invalidateNodes(const std::vector<mdl::Node*>& nodes);
   void deselectAll();
 
 private:
@@ -28,6 +28,7 @@
 #include "io/ExportOptions.h"
 #include "io/GameConfigParser.h"
 #include "io/LoadMaterialCollections.h"
+#include "io/MapCache.h"
 #include "io/MapHeader.h"
 #include "io/NodeReader.h"
 #include "io/NodeWriter.h"
@@ -393,10 +394,8 @@ MapDocument::MapDocument(kdl::task_manager& taskManager)
   , m_entityDefinitionManager{std::make_unique<mdl::EntityDefinitionManager>()}
   , m_entityModelManager{std::make_unique<mdl::EntityModelManager>(
       [&](auto resourceLoader) {
-        auto resource =
-          std::make_shared<mdl::EntityModelDataResource>(std::move(resourceLoader));
-        m_resourceManager->addResource(resource);
-        return resource;
+        return m_resourceManager->addResource(
+          std::make_shared<mdl::EntityModelDataResource>(std::move(resourceLoader)));
       },
       logger())}
   , m_materialManager{std::make_unique<mdl::MaterialManager>(logger())}
@@ -595,11 +594,126 @@ void MapDocument::createEntityDefinitionActions()
 
 namespace
 {
+std::vector<mdl::MapFormat> configMapFormats(const mdl::GameConfig& config)
+{
+  return config.fileFormats | std::views::transform([](const auto& formatConfig) {
+           return mdl::formatFromName(formatConfig.format);
+         })
+         | kdl::to_vector;
+}
+
+Result<std::unique_ptr<mdl::WorldNode>> parseMap(
+  const mdl::GameConfig& config,
+  const mdl::MapFormat mapFormat,
+  const vm::bbox3d& worldBounds,
+  const std::string_view str,
+  const mdl::EntityPropertyConfig& entityPropertyConfig,
+  io::ParserStatus& parserStatus,
+  kdl::task_manager& taskManager)
+{
+  if (mapFormat == mdl::MapFormat::Unknown)
+  {
+    // Try all formats listed in the game config
+    return io::WorldReader::tryRead(
+      str,
+      configMapFormats(config),
+      worldBounds,
+      entityPropertyConfig,
+      parserStatus,
+      taskManager);
+  }
+
+  auto worldReader = io::WorldReader{str, mapFormat, entityPropertyConfig};
+  return worldReader.read(worldBounds, parserStatus, taskManager);
+}
+
+/**
+ * Reads the world from the cache of the map at the given path. Returns an error if there
+ * is no cache or if it is stale.
+ */
+Result<std::unique_ptr<mdl::WorldNode>> loadMapCache(
+  const mdl::GameConfig& config,
+  const mdl::MapFormat mapFormat,
+  const std::filesystem::path& path,
+  const io::MapCacheKey& key,
+  const mdl::EntityPropertyConfig& entityPropertyConfig,
+  io::ParserStatus& parserStatus,
+  kdl::task_manager& taskManager)
+{
+  return io::Disk::openFile(io::mapCachePath(path)) | kdl::and_then([&](auto file) {
+           return io::readMapCache(file->reader(), key, taskManager);
+         })
+         | kdl::and_then(
+           [&](auto cachedMap) -> Result<std::unique_ptr<mdl::WorldNode>> {
+             const auto formatMatches =
+               mapFormat == mdl::MapFormat::Unknown
+                 ? kdl::vec_contains(configMapFormats(config), cachedMap.mapFormat)
+                 : mapFormat == cachedMap.mapFormat;
+             if (!formatMatches)
+             {
+               return Error{"Map cache has a different map format"};
+             }
+
+             auto worldReader =
+               io::WorldReader{{}, cachedMap.mapFormat, entityPropertyConfig};
+             return worldReader.read(
+               std::move(cachedMap.objectInfos),
+               key.worldBounds,
+               parserStatus,
+               taskManager);
+           });
+}
+
+Result<void> writeMapCacheFile(
+  const std::filesystem::path& path,
+  const io::MapCacheKey& key,
+  const mdl::WorldNode& world,
+  kdl::task_manager& taskManager)
+{
+  return io::Disk::withOutputStream(
+    io::mapCachePath(path),
+    std::ios::out | std::ios::binary,
+    [&](auto& stream) { io::writeMapCache(stream, key, world, taskManager); });
+}
+
+/**
+ * Copies the file positions of the given node and its descendants to the given clone,
+ * which must have the same structure.
+ */
+void copyFilePositions(const mdl::Node& node, const mdl::Node& clone)
+{
+  clone.setFilePosition(node.lineNumber(), node.lineCount());
+
+  const auto& children = node.children();
+  const auto& cloneChildren = clone.children();
+  assert(children.size() == cloneChildren.size());
+  for (size_t i = 0; i < children.size(); ++i)
+  {
+    copyFilePositions(*children[i], *cloneChildren[i]);
+  }
+}
+
+Result<void> writeMapFile(
+  const std::filesystem::path& path,
+  const std::string& gameName,
+  const mdl::WorldNode& world,
+  kdl::task_manager& taskManager)
+{
+  return io::Disk::withOutputStream(path, [&](auto& stream) {
+    io::writeMapHeader(stream, gameName, world.mapFormat());
+
+    auto writer = io::NodeWriter{world, stream};
+    writer.setExporting(false);
+    writer.writeMap(taskManager);
+  });
+}
+
 Result<std::unique_ptr<mdl::WorldNode>> loadMap(
   const mdl::GameConfig& config,
   const mdl::MapFormat mapFormat,
   const vm::bbox3d& worldBounds,
   const std::filesystem::path& path,
+  const bool useMapCache,
   kdl::task_manager& taskManager,
   Logger& logger)
 {
@@ -609,27 +723,46 @@ Result<std::unique_ptr<mdl::WorldNode>> loadMap(
   auto parserStatus = io::SimpleParserStatus{logger};
   return io::Disk::openFile(path) | kdl::and_then([&](auto file) {
            auto fileReader = file->reader().buffer();
-           if (mapFormat == mdl::MapFormat::Unknown)
+           if (!useMapCache)
            {
-             // Try all formats listed in the game config
-             const auto possibleFormats =
-               config.fileFormats | std::views::transform([](const auto& formatConfig) {
-                 return mdl::formatFromName(formatConfig.format);
-               })
-               | kdl::to_vector;
-
-             return io::WorldReader::tryRead(
-               fileReader.stringView(),
-               possibleFormats,
+             return parseMap(
+               config,
+               mapFormat,
                worldBounds,
+               fileReader.stringView(),
                entityPropertyConfig,
                parserStatus,
                taskManager);
            }
 
-           auto worldReader =
-             io::WorldReader{fileReader.stringView(), mapFormat, entityPropertyConfig};
-           return worldReader.read(worldBounds, parserStatus, taskManager);
+           const auto key = io::makeMapCacheKey(fileReader.stringView(), worldBounds);
+           return loadMapCache(
+                    config,
+                    mapFormat,
+                    path,
+                    key,
+                    entityPropertyConfig,
+                    parserStatus,
+                    taskManager)
+                  | kdl::or_else([&](const auto& e) {
+                      logger.debug() << "Not using map cache: " << e.msg;
+                      return parseMap(
+                               config,
+                               mapFormat,
+                               worldBounds,
+                               fileReader.stringView(),
+                               entityPropertyConfig,
+                               parserStatus,
+                               taskManager)
+                             | kdl::transform([&](auto worldNode) {
+                                 writeMapCacheFile(path, key, *worldNode, taskManager)
+                                   | kdl::transform_error([&](const auto& e) {
+                                       logger.warn()
+                                         << "Could not write map cache: " << e.msg;
+                                     });
+                                 return worldNode;
+                               });
+                    });
          });
 }
 
@@ -648,7 +781,7 @@ Result<std::unique_ptr<mdl::WorldNode>> newMap(
       && io::Disk::pathInfo(initialMapFilePath) == io::PathInfo::File)
     {
       return loadMap(
-        config, format, worldBounds, initialMapFilePath, taskManager, logger);
+        config, format, worldBounds, initialMapFilePath, false, taskManager, logger);
     }
   }
 
@@ -731,7 +864,14 @@ Result<void> MapDocument::loadDocument(
 
   clearDocument();
 
-  return loadMap(game->config(), mapFormat, worldBounds, path, m_taskManager, logger())
+  return loadMap(
+           game->config(),
+           mapFormat,
+           worldBounds,
+           path,
+           pref(Preferences::CacheMaps),
+           m_taskManager,
+           logger())
          | kdl::transform([&](auto worldNode) {
              setWorld(worldBounds, std::move(worldNode), game, path);
              documentWasLoadedNotifier(this);
@@ -753,15 +893,34 @@ void MapDocument::saveDocumentTo(const std::filesystem::path& path)
   ensure(m_game.get() != nullptr, "game is null");
   ensure(m_world, "world is null");
 
-  io::Disk::withOutputStream(path, [&](auto& stream) {
-    io::writeMapHeader(stream, m_game->config().name, m_world->mapFormat());
+  writeMapFile(path, m_game->config().name, *m_world, m_taskManager)
+    | kdl::transform_error(
+      [&](const auto& e) { error() << "Could not save document: " << e.msg; });
+}
 
-    auto writer = io::NodeWriter{*m_world, stream};
-    writer.setExporting(false);
-    writer.writeMap(m_taskManager);
-  }) | kdl::transform_error([&](const auto& e) {
-    error() << "Could not save document: " << e.msg;
-  });
+std::future<Result<void>> MapDocument::saveSnapshot(
+  std::function<Result<void>(std::string_view)> writeMapText)
+{
+  ensure(m_game.get() != nullptr, "game is null");
+  ensure(m_world, "world is null");
+
+  // std::function requires a copyable task
+  auto snapshot = std::shared_ptr<mdl::WorldNode>{m_world->snapshot(m_worldBounds)};
+  return m_taskManager.run_task<Result<void>>(
+    [&taskManager = m_taskManager,
+     gameName = m_game->config().name,
+     snapshot = std::move(snapshot),
+     writeMapText = std::move(writeMapText)]() {
+      auto stream = std::ostringstream{};
+      io::writeMapHeader(stream, gameName, snapshot->mapFormat());
+
+      auto writer = io::NodeWriter{*snapshot, stream};
+      writer.setExporting(false);
+      writer.setWriteObjectNumbers(false);
+      writer.writeMap(taskManager);
+
+      return writeMapText(stream.view());
+    });
 }
 
 Result<void> MapDocument::exportDocumentAs(const io::ExportOptions& options)
@@ -793,14 +952,50 @@ Result<void> MapDocument::exportDocumentAs(const io::ExportOptions& options)
 
 void MapDocument::doSaveDocument(const std::filesystem::path& path)
 {
+  finishPendingMapCache();
   saveDocumentTo(path);
+  if (pref(Preferences::CacheMaps))
+  {
+    saveMapCache(path);
+  }
   setLastSaveModificationCount();
   setPath(path);
   documentWasSavedNotifier(this);
 }
 
+void MapDocument::saveMapCache(const std::filesystem::path& path)
+{
+  // Saving the map has updated the file positions of the nodes, but the snapshot does
+  // not copy them. The cache is keyed by the contents of the saved file.
+  auto snapshot = std::shared_ptr<mdl::WorldNode>{m_world->snapshot(m_worldBounds)};
+  copyFilePositions(*m_world, *snapshot);
+
+  m_pendingMapCache = m_taskManager.run_task<Result<void>>(
+    [&taskManager = m_taskManager,
+     path,
+     worldBounds = m_worldBounds,
+     snapshot = std::move(snapshot)]() {
+      return io::Disk::openFile(path) | kdl::and_then([&](auto file) {
+               const auto fileReader = file->reader().buffer();
+               const auto key = io::makeMapCacheKey(fileReader.stringView(), worldBounds);
+               return writeMapCacheFile(path, key, *snapshot, taskManager);
+             });
+    });
+}
+
+void MapDocument::finishPendingMapCache()
+{
+  if (m_pendingMapCache.valid())
+  {
+    m_pendingMapCache.get() | kdl::transform_error([&](const auto& e) {
+      warn() << "Could not write map cache: " << e.msg;
+    });
+  }
+}
+
 void MapDocument::clearDocument()
 {
+  finishPendingMapCache();
   clearRepeatableCommands();
   doClearCommandProcessor();
 
@@ -814,6 +1009,7 @@ void MapDocument::clearDocument()
     clearTagActions();
     clearWorld();
     clearModificationCount();
+    mdl::BrushGeometry::releaseUnusedMemory();
 
     documentWasClearedNotifier(this);
   }
@@ -3117,48 +3313,46 @@ bool MapDocument::transformObjects(
   const auto updateAngleProperty =
     m_world->entityPropertyConfig().updateAnglePropertyAfterTransform;
 
-  auto tasks =
-    nodesToTransform | std::views::transform([&](auto& node) {
-      return std::function{[&]() {
-        return node->accept(kdl::overload(
-          [&](mdl::WorldNode*) -> TransformResult {
-            ensure(false, "Unexpected world node");
-          },
-          [&](mdl::LayerNode*) -> TransformResult {
-            ensure(false, "Unexpected layer node");
-          },
-          [&](mdl::GroupNode* groupNode) -> TransformResult {
-            auto group = groupNode->group();
-            group.transform(transformation);
-            return std::make_pair(groupNode, mdl::NodeContents{std::move(group)});
-          },
-          [&](mdl::EntityNode* entityNode) -> TransformResult {
-            auto entity = entityNode->entity();
-            entity.transform(transformation, updateAngleProperty);
-            return std::make_pair(entityNode, mdl::NodeContents{std::move(entity)});
-          },
-          [&](mdl::BrushNode* brushNode) -> TransformResult {
-            const auto* containingGroup = brushNode->containingGroup();
-            const bool lockAlignment =
-            alignmentLock
-            || (containingGroup && containingGroup->closed() && mdl::collectLinkedNodes({m_world.get()}, *brushNode).size() > 1);
-
-            auto brush = brushNode->brush();
-            return brush.transform(m_worldBounds, transformation, lockAlignment)
-                   | kdl::and_then([&]() -> TransformResult {
-                       return std::make_pair(
-                         brushNode, mdl::NodeContents{std::move(brush)});
-                     });
-          },
-          [&](mdl::PatchNode* patchNode) -> TransformResult {
-            auto patch = patchNode->patch();
-            patch.transform(transformation);
-            return std::make_pair(patchNode, mdl::NodeContents{std::move(patch)});
-          }));
-      }};
+  auto transformResults =
+    m_taskManager.parallel_transform(nodesToTransform, [&](mdl::Node* node) {
+      return node->accept(kdl::overload(
+        [&](mdl::WorldNode*) -> TransformResult {
+          ensure(false, "Unexpected world node");
+        },
+        [&](mdl::LayerNode*) -> TransformResult {
+          ensure(false, "Unexpected layer node");
+        },
+        [&](mdl::GroupNode* groupNode) -> TransformResult {
+          auto group = groupNode->group();
+          group.transform(transformation);
+          return std::make_pair(groupNode, mdl::NodeContents{std::move(group)});
+        },
+        [&](mdl::EntityNode* entityNode) -> TransformResult {
+          auto entity = entityNode->entity();
+          entity.transform(transformation, updateAngleProperty);
+          return std::make_pair(entityNode, mdl::NodeContents{std::move(entity)});
+        },
+        [&](mdl::BrushNode* brushNode) -> TransformResult {
+          const auto* containingGroup = brushNode->containingGroup();
+          const bool lockAlignment =
+          alignmentLock
+          || (containingGroup && containingGroup->closed() && mdl::collectLinkedNodes({m_world.get()}, *brushNode).size() > 1);
+
+          auto brush = brushNode->brush();
+          return brush.transform(m_worldBounds, transformation, lockAlignment)
+                 | kdl::and_then([&]() -> TransformResult {
+                     return std::make_pair(
+                       brushNode, mdl::NodeContents{std::move(brush)});
+                   });
+        },
+        [&](mdl::PatchNode* patchNode) -> TransformResult {
+          auto patch = patchNode->patch();
+          patch.transform(transformation);
+          return std::make_pair(patchNode, mdl::NodeContents{std::move(patch)});
+        }));
     });
 
-  return m_taskManager.run_tasks_and_wait(tasks) | kdl::fold
+  return std::move(transformResults) | kdl::fold
          | kdl::and_then([&](auto nodesToUpdate) -> Result<bool> {
              const auto success = swapNodeContents(
                commandName,
@@ -4739,9 +4933,8 @@ void MapDocument::loadMaterials()
     m_game->gameFileSystem(),
     m_game->config().materialConfig,
     [&](auto resourceLoader) {
-      auto resource = std::make_shared<mdl::TextureResource>(std::move(resourceLoader));
-      m_resourceManager->addResource(resource);
-      return resource;
+      return m_resourceManager->addResource(
+        std::make_shared<mdl::TextureResource>(std::move(resourceLoader)));
     },
     m_taskManager);
 }
@@ -4764,7 +4957,8 @@ static auto makeSetMaterialsVisitor(mdl::MaterialManager& manager)
       for (size_t i = 0u; i < brush.faceCount(); ++i)
       {
         const mdl::BrushFace& face = brush.face(i);
-        mdl::Material* material = manager.material(face.attributes().materialName());
+        mdl::Material* material =
+          manager.material(face.attributes().internedMaterialName());
         brushNode->setFaceMaterial(i, material);
       }
     },
@@ -4809,7 +5003,8 @@ void MapDocument::setMaterials(const std::vector<mdl::BrushFaceHandle>& faceHand
   {
     mdl::BrushNode* node = faceHandle.node();
     const mdl::BrushFace& face = faceHandle.face();
-    auto* material = m_materialManager->material(face.attributes().materialName());
+    auto* material =
+      m_materialManager->material(face.attributes().internedMaterialName());
     node->setFaceMaterial(faceHandle.faceIndex(), material);
   }
   materialUsageCountsDidChangeNotifier();
@@ -4925,8 +5120,39 @@ static auto makeUnsetEntityModelsVisitor()
     [](mdl::PatchNode*) {});
 }
 
+void MapDocument::prefetchEntityModels()
+{
+  const auto modelPath = [](const auto& modelSpecification) {
+    return modelSpecification
+           | kdl::transform([](const auto& spec) { return spec.path; })
+           | kdl::value_or(std::filesystem::path{});
+  };
+
+  // the entity model manager logs the errors of models that fail to load
+  auto modelPaths = std::vector<std::filesystem::path>{};
+  m_world->accept(kdl::overload(
+    [](auto&& thisLambda, mdl::WorldNode* world) { world->visitChildren(thisLambda); },
+    [](auto&& thisLambda, mdl::LayerNode* layer) { layer->visitChildren(thisLambda); },
+    [](auto&& thisLambda, mdl::GroupNode* group) { group->visitChildren(thisLambda); },
+    [&](mdl::EntityNode* entityNode) {
+      const auto& entity = entityNode->entity();
+      modelPaths.push_back(modelPath(entity.modelSpecification()));
+      if (const auto* definition = entity.definition())
+      {
+        modelPaths.push_back(
+          modelPath(definition->modelDefinition().defaultModelSpecification()));
+      }
+    },
+    [](mdl::BrushNode*) {},
+    [](mdl::PatchNode*) {}));
+
+  m_entityModelManager->prefetchModels(
+    kdl::vec_sort_and_remove_duplicates(std::move(modelPaths)), m_taskManager);
+}
+
 void MapDocument::setEntityModels()
 {
+  prefetchEntityModels();
   m_world->accept(makeSetEntityModelsVisitor(*m_entityModelManager, *this));
 }
 
@@ -5109,7 +5335,8 @@ const mdl::SmartTag& MapDocument::smartTag(const size_t index) const
   return m_tagManager->smartTag(index);
 }
 
-static auto makeInitializeNodeTagsVisitor(mdl::TagManager& tagManager)
+static auto makeInitializeNodeTagsVisitor(
+  mdl::TagManager& tagManager, std::vector<mdl::BrushNode*>& brushNodes)
 {
   return kdl::overload(
     [&](auto&& thisLambda, mdl::WorldNode* world) {
@@ -5128,7 +5355,7 @@ static auto makeInitializeNodeTagsVisitor(mdl::TagManager& tagManager)
       entity->initializeTags(tagManager);
       entity->visitChildren(thisLambda);
     },
-    [&](mdl::BrushNode* brush) { brush->initializeTags(tagManager); },
+    [&](mdl::BrushNode* brush) { brushNodes.push_back(brush); },
     [&](mdl::PatchNode* patch) { patch->initializeTags(tagManager); });
 }
 
@@ -5159,12 +5386,16 @@ void MapDocument::initializeAllNodeTags(MapDocument* document)
 {
   assert(document == this);
   unused(document);
-  m_world->accept(makeInitializeNodeTagsVisitor(*m_tagManager));
+  auto brushNodes = std::vector<mdl::BrushNode*>{};
+  m_world->accept(makeInitializeNodeTagsVisitor(*m_tagManager, brushNodes));
+  mdl::BrushNode::initializeTags(brushNodes, *m_tagManager, taskManager());
 }
 
 void MapDocument::initializeNodeTags(const std::vector<mdl::Node*>& nodes)
 {
-  mdl::Node::visitAll(nodes, makeInitializeNodeTagsVisitor(*m_tagManager));
+  auto brushNodes = std::vector<mdl::BrushNode*>{};
+  mdl::Node::visitAll(nodes, makeInitializeNodeTagsVisitor(*m_tagManager, brushNodes));
+  mdl::BrushNode::initializeTags(brushNodes, *m_tagManager, taskManager());
 }
 
 void MapDocument::clearNodeTags(const std::vector<mdl::Node*>& nodes)
@@ -5191,13 +5422,15 @@ void MapDocument::updateFaceTags(const std::vector<mdl::BrushFaceHandle>& faceHa
 
 void MapDocument::updateAllFaceTags()
 {
+  auto brushNodes = std::vector<mdl::BrushNode*>{};
   m_world->accept(kdl::overload(
     [](auto&& thisLambda, mdl::WorldNode* world) { world->visitChildren(thisLambda); },
     [](auto&& thisLambda, mdl::LayerNode* layer) { layer->visitChildren(thisLambda); },
     [](auto&& thisLambda, mdl::GroupNode* group) { group->visitChildren(thisLambda); },
     [](auto&& thisLambda, mdl::EntityNode* entity) { entity->visitChildren(thisLambda); },
-    [&](mdl::BrushNode* brush) { brush->initializeTags(*m_tagManager); },
+    [&](mdl::BrushNode* brush) { brushNodes.push_back(brush); },
     [](mdl::PatchNode*) {}));
+  mdl::BrushNode::initializeTags(brushNodes, *m_tagManager, taskManager());
 }
 
 void MapDocument::updateFaceTagsAfterResourcesWhereProcessed(
@@ -38,10 +38,13 @@
 #include "vm/util.h"
 
 #include <filesystem>
+#include <functional>
+#include <future>
 #include <map>
 #include <memory>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace kdl
@@ -143,6 +146,11 @@ protected:
   size_t m_lastSaveModificationCount = 0;
   size_t m_modificationCount = 0;
 
+  /**
+   * The map cache that is currently being written on a worker thread, if any.
+   */
+  std::future<Result<void>> m_pendingMapCache;
+
   mdl::NodeCollection m_selectedNodes;
   std::vector<mdl::BrushFaceHandle> m_selectedBrushFaces;
 
@@ -319,10 +327,24 @@ public: // new, load, save document
   void saveDocument();
   void saveDocumentAs(const std::filesystem::path& path);
   void saveDocumentTo(const std::filesystem::path& path);
+
+  /**
+   * Serializes a snapshot of the document on a worker thread and passes the map text to
+   * the given function on that thread. The snapshot is taken before this function
+   * returns, so the document can be edited while it is being written.
+   *
+   * The map text omits the entity and brush number comments, so that unchanged parts of
+   * the map yield the same text in every snapshot.
+   */
+  std::future<Result<void>> saveSnapshot(
+    std::function<Result<void>(std::string_view)> writeMapText);
+
   Result<void> exportDocumentAs(const io::ExportOptions& options);
 
 private:
   void doSaveDocument(const std::filesystem::path& path);
+  void saveMapCache(const std::filesystem::path& path);
+  void finishPendingMapCache();
   void clearDocument();
 
 public: // text encoding
@@ -755,6 +777,7 @@ protected:
 
   void clearEntityModels();
 
+  void prefetchEntityModels();
   void setEntityModels();
   void setEntityModels(const std::vector<mdl::Node*>& nodes);
   void unsetEntityModels();
@@ -94,6 +94,7 @@
 #include "upd/Updater.h"
 
 #include "kdl/overload.h"
+#include "kdl/path_utils.h"
 #include "kdl/range_to_vector.h"
 #include "kdl/string_format.h"
 #include "kdl/string_utils.h"
@@ -186,9 +187,12 @@ MapFrame::~MapFrame()
   const auto children = this->children();
   qDeleteAll(std::rbegin(children), std::rend(children));
 
-  // let's trigger a final autosave before releasing the document
+  // let's trigger a final autosave before releasing the document, the backup is written
+  // on a worker thread that uses the document's task manager, so we must wait for it
   auto logger = NullLogger{};
+  m_autosaver->waitForPendingBackup(logger);
   m_autosaver->triggerAutosave(logger);
+  m_autosaver->waitForPendingBackup(logger);
 
   m_document->setViewEffectsService(nullptr);
   m_document.reset();
@@ -1015,6 +1019,53 @@ void MapFrame::revertDocument()
   }
 }
 
+bool MapFrame::restoreAutosaveBackup()
+{
+  const auto defaultDir = !m_document->path().empty()
+                            ? io::pathAsQPath(m_document->path().parent_path() / "autosave")
+                            : QString{};
+
+  const auto backupFileName = QFileDialog::getOpenFileName(
+    this, tr("Restore Autosave Backup"), defaultDir, "Autosave backups (*.tbbackup)");
+  if (backupFileName.isEmpty())
+  {
+    return false;
+  }
+
+  const auto backupPath = io::pathFromQString(backupFileName);
+  const auto defaultMapPath = backupPath.parent_path().parent_path()
+                              / kdl::path_add_extension(backupPath.stem(), ".map");
+
+  const auto mapFileName = QFileDialog::getSaveFileName(
+    this, tr("Save Restored Map"), io::pathAsQPath(defaultMapPath), "Map files (*.map)");
+  if (mapFileName.isEmpty())
+  {
+    return false;
+  }
+
+  const auto mapPath = io::pathFromQString(mapFileName);
+  if (mapPath == m_document->path())
+  {
+    QMessageBox::critical(
+      this,
+      "",
+      tr("You can't overwrite the current document.\nPlease choose a different file "
+         "name to restore to."));
+    return false;
+  }
+
+  return restoreBackup(backupPath, mapPath) | kdl::transform([&]() {
+           logger().info() << "Restored " << backupPath << " to " << mapPath;
+           return true;
+         })
+         | kdl::transform_error([&](auto e) {
+             logger().error() << "Could not restore '" << backupPath << "': " + e.msg;
+             QMessageBox::critical(this, "", QString::fromStdString(e.msg));
+             return false;
+           })
+         | kdl::value();
+}
+
 bool MapFrame::exportDocumentAsObj()
 {
   if (!m_objExportDialog)
@@ -200,6 +200,7 @@ public:
   bool saveDocument();
   bool saveDocumentAs();
   void revertDocument();
+  bool restoreAutosaveBackup();
   bool exportDocumentAsObj();
   bool exportDocumentAsMap();
   bool exportDocument(const io::ExportOptions& options);
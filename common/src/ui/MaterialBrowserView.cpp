@@ -27,8 +27,10 @@
 #include "mdl/Material.h"
 #include "mdl/MaterialCollection.h"
 #include "mdl/MaterialManager.h"
+#include "mdl/MaterialNameIndex.h"
 #include "mdl/Texture.h"
 #include "render/ActiveShader.h"
+#include "render/FontDescriptor.h"
 #include "render/FontManager.h"
 #include "render/GLVertexType.h"
 #include "render/PrimType.h"
@@ -47,6 +49,7 @@
 #include "vm/mat_ext.h"
 #include "vm/vec.h"
 
+#include <algorithm>
 #include <string>
 #include <vector>
 
@@ -160,11 +163,19 @@ void MaterialBrowserView::doReloadLayout(Layout& layout)
   const auto fontSize = pref(Preferences::BrowserFontSize);
   assert(fontSize > 0);
 
-  const auto font = render::FontDescriptor{fontPath, size_t(fontSize)};
+  auto& font = fontManager().font(render::FontDescriptor{fontPath, size_t(fontSize)});
+  const auto collections = getCollections();
+
+  // forget the filter results of collections that were removed or disabled
+  std::erase_if(m_filterResults, [&](const auto& entry) {
+    return !std::ranges::any_of(collections, [&](const auto* collection) {
+      return collection->path() == entry.first;
+    });
+  });
 
   if (m_group)
   {
-    for (const auto* collection : getCollections())
+    for (const auto* collection : collections)
     {
       layout.addGroup(collection->path().string(), float(fontSize) + 2.0f);
       addMaterialsToLayout(layout, getMaterials(*collection), font);
@@ -172,14 +183,14 @@ void MaterialBrowserView::doReloadLayout(Layout& layout)
   }
   else
   {
-    addMaterialsToLayout(layout, getMaterials(), font);
+    addMaterialsToLayout(layout, getMaterials(collections), font);
   }
 }
 
 void MaterialBrowserView::addMaterialsToLayout(
   Layout& layout,
   const std::vector<const mdl::Material*>& materials,
-  const render::FontDescriptor& font)
+  render::TextureFont& font)
 {
   for (const auto* material : materials)
   {
@@ -188,12 +199,12 @@ void MaterialBrowserView::addMaterialsToLayout(
 }
 
 void MaterialBrowserView::addMaterialToLayout(
-  Layout& layout, const mdl::Material& material, const render::FontDescriptor& font)
+  Layout& layout, const mdl::Material& material, render::TextureFont& font)
 {
   const auto maxCellWidth = layout.maxCellWidth();
 
   const auto materialName = std::filesystem::path{material.name()}.filename().string();
-  const auto titleHeight = fontManager().font(font).measure(materialName).y();
+  const auto titleHeight = font.measure(materialName).y();
 
   const auto scaleFactor = pref(Preferences::MaterialBrowserIconSize);
   const auto* texture = material.texture();
@@ -226,44 +237,86 @@ std::vector<const mdl::MaterialCollection*> MaterialBrowserView::getCollections(
 }
 
 std::vector<const mdl::Material*> MaterialBrowserView::getMaterials(
-  const mdl::MaterialCollection& collection) const
+  const mdl::MaterialCollection& collection)
 {
-  return sortMaterials(filterMaterials(
-    kdl::vec_transform(collection.materials(), [](const auto& t) { return &t; })));
+  return sortMaterials(filterMaterials(collection));
 }
 
-std::vector<const mdl::Material*> MaterialBrowserView::getMaterials() const
+std::vector<const mdl::Material*> MaterialBrowserView::getMaterials(
+  const std::vector<const mdl::MaterialCollection*>& collections)
 {
-  auto document = kdl::mem_lock(m_document);
   auto materials = std::vector<const mdl::Material*>{};
-  for (const auto& collection : getCollections())
+  for (const auto* collection : collections)
   {
-    for (const auto& material : collection->materials())
-    {
-      materials.push_back(&material);
-    }
+    materials = kdl::vec_concat(std::move(materials), filterMaterials(*collection));
   }
-  return sortMaterials(filterMaterials(materials));
+  return sortMaterials(std::move(materials));
 }
 
 std::vector<const mdl::Material*> MaterialBrowserView::filterMaterials(
-  std::vector<const mdl::Material*> materials) const
+  const mdl::MaterialCollection& collection)
 {
+  const auto& collectionMaterials = collection.materials();
+
+  auto materials = std::vector<const mdl::Material*>{};
+  if (m_filterText.empty())
+  {
+    materials = kdl::vec_transform(collectionMaterials, [](const auto& m) { return &m; });
+  }
+  else
+  {
+    materials = kdl::vec_transform(
+      findMaterialsMatchingFilterText(collection),
+      [&](const auto i) { return &collectionMaterials[i]; });
+  }
+
   if (m_hideUnused)
   {
     materials = kdl::vec_erase_if(std::move(materials), [](const auto* material) {
       return material->usageCount() == 0;
     });
   }
-  if (!m_filterText.empty())
+  return materials;
+}
+
+const std::vector<size_t>& MaterialBrowserView::findMaterialsMatchingFilterText(
+  const mdl::MaterialCollection& collection)
+{
+  const auto& nameIndex = collection.nameIndex();
+  auto& filterResult = m_filterResults[collection.path()];
+
+  if (filterResult.nameIndex == nameIndex && filterResult.filterText == m_filterText)
   {
-    materials = kdl::vec_erase_if(std::move(materials), [&](const auto* material) {
-      return !kdl::all_of(kdl::str_split(m_filterText, " "), [&](const auto& pattern) {
-        return kdl::ci::str_contains(material->name(), pattern);
-      });
-    });
+    return filterResult.materialIndices;
   }
-  return materials;
+
+  // If the previous filter text is a prefix of the current one, every material that
+  // matches the current filter text also matches the previous one. This does not hold
+  // if the previous filter text ends with an escape character.
+  const auto refinePreviousResult = filterResult.nameIndex == nameIndex
+                                    && !filterResult.filterText.empty()
+                                    && !filterResult.filterText.ends_with('\\')
+                                    && m_filterText.starts_with(filterResult.filterText);
+
+  const auto patterns = kdl::str_split(m_filterText, " ");
+  auto materialIndices = std::vector<size_t>{};
+  if (refinePreviousResult)
+  {
+    materialIndices = std::move(filterResult.materialIndices);
+  }
+  else
+  {
+    // the empty string matches every material
+    materialIndices = nameIndex->findMaterials(patterns.empty() ? "" : patterns.front());
+  }
+
+  for (size_t i = refinePreviousResult ? 0u : 1u; i < patterns.size(); ++i)
+  {
+    materialIndices = nameIndex->findMaterials(patterns[i], materialIndices);
+  }
+
+  filterResult = FilterResult{nameIndex, m_filterText, std::move(materialIndices)};
+  return filterResult.materialIndices;
 }
 
 std::vector<const mdl::Material*> MaterialBrowserView::sortMaterials(
@@ -20,9 +20,10 @@
 #pragma once
 
 #include "NotifierConnection.h"
-#include "render/FontDescriptor.h"
 #include "ui/CellView.h"
 
+#include <filesystem>
+#include <map>
 #include <memory>
 #include <string>
 #include <vector>
@@ -33,9 +34,15 @@ namespace tb::mdl
 {
 class Material;
 class MaterialCollection;
+class MaterialNameIndex;
 class ResourceId;
 } // namespace tb::mdl
 
+namespace tb::render
+{
+class TextureFont;
+} // namespace tb::render
+
 namespace tb::ui
 {
 
@@ -59,6 +66,19 @@ private:
   MaterialSortOrder m_sortOrder = MaterialSortOrder::Name;
   std::string m_filterText;
 
+  /**
+   * The materials of a collection whose names match a filter text. If the filter text is
+   * extended, the matching materials are found among these.
+   */
+  struct FilterResult
+  {
+    std::shared_ptr<const mdl::MaterialNameIndex> nameIndex;
+    std::string filterText;
+    std::vector<size_t> materialIndices;
+  };
+
+  std::map<std::filesystem::path, FilterResult> m_filterResults;
+
   const mdl::Material* m_selectedMaterial = nullptr;
 
   NotifierConnection m_notifierConnection;
@@ -91,17 +111,20 @@ private:
   void addMaterialsToLayout(
     Layout& layout,
     const std::vector<const mdl::Material*>& materials,
-    const render::FontDescriptor& font);
+    render::TextureFont& font);
   void addMaterialToLayout(
-    Layout& layout, const mdl::Material& material, const render::FontDescriptor& font);
+    Layout& layout, const mdl::Material& material, render::TextureFont& font);
 
   std::vector<const mdl::MaterialCollection*> getCollections() const;
   std::vector<const mdl::Material*> getMaterials(
-    const mdl::MaterialCollection& collection) const;
-  std::vector<const mdl::Material*> getMaterials() const;
+    const mdl::MaterialCollection& collection);
+  std::vector<const mdl::Material*> getMaterials(
+    const std::vector<const mdl::MaterialCollection*>& collections);
 
   std::vector<const mdl::Material*> filterMaterials(
-    std::vector<const mdl::Material*> materials) const;
+    const mdl::MaterialCollection& collection);
+  const std::vector<size_t>& findMaterialsMatchingFilterText(
+    const mdl::MaterialCollection& collection);
   std::vector<const mdl::Material*> sortMaterials(
     std::vector<const mdl::Material*> materials) const;
 
@@ -41,6 +41,21 @@ ReparentNodesCommand::ReparentNodesCommand(
 {
 }
 
+size_t ReparentNodesCommand::memoryUsage() const
+{
+  // the reparented nodes are always owned by the document
+  auto result = UpdateLinkedGroupsCommandBase::memoryUsage();
+  for (const auto* nodes : {&m_nodesToAdd, &m_nodesToRemove})
+  {
+    for (const auto& [parent, children] : *nodes)
+    {
+      result += sizeof(std::pair<mdl::Node*, std::vector<mdl::Node*>>)
+                + children.capacity() * sizeof(mdl::Node*);
+    }
+  }
+  return result;
+}
+
 std::unique_ptr<CommandResult> ReparentNodesCommand::doPerformDo(
   MapDocumentCommandFacade& document)
 {
@@ -50,6 +50,8 @@ public:
     std::map<mdl::Node*, std::vector<mdl::Node*>> nodesToAdd,
     std::map<mdl::Node*, std::vector<mdl::Node*>> nodesToRemove);
 
+  size_t memoryUsage() const override;
+
 private:
   std::unique_ptr<CommandResult> doPerformDo(MapDocumentCommandFacade& document) override;
   std::unique_ptr<CommandResult> doPerformUndo(
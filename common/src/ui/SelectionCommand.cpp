@@ -114,6 +114,13 @@ SelectionCommand::SelectionCommand(
 
 SelectionCommand::~SelectionCommand() = default;
 
+size_t SelectionCommand::memoryUsage() const
+{
+  return (m_nodes.capacity() + m_previouslySelectedNodes.capacity()) * sizeof(mdl::Node*)
+         + (m_faceRefs.capacity() + m_previouslySelectedFaceRefs.capacity())
+             * sizeof(mdl::BrushFaceReference);
+}
+
 std::string SelectionCommand::makeName(
   const Action action, const size_t nodeCount, const size_t faceCount)
 {
@@ -71,6 +71,8 @@ public:
     std::vector<mdl::BrushFaceHandle> faces);
   ~SelectionCommand() override;
 
+  size_t memoryUsage() const override;
+
 private:
   static std::string makeName(Action action, size_t nodeCount, size_t faceCount);
 
@@ -72,6 +72,16 @@ SetLinkIdsCommand::SetLinkIdsCommand(
 
 SetLinkIdsCommand::~SetLinkIdsCommand() = default;
 
+size_t SetLinkIdsCommand::memoryUsage() const
+{
+  auto result = m_linkIds.capacity() * sizeof(std::tuple<mdl::Node*, std::string>);
+  for (const auto& [node, linkId] : m_linkIds)
+  {
+    result += linkId.capacity();
+  }
+  return result;
+}
+
 std::unique_ptr<CommandResult> SetLinkIdsCommand::doPerformDo(MapDocumentCommandFacade&)
 {
   m_linkIds = setLinkIds(m_linkIds);
@@ -45,6 +45,8 @@ public:
     const std::string& name, std::vector<std::tuple<mdl::Node*, std::string>> linkIds);
   ~SetLinkIdsCommand() override;
 
+  size_t memoryUsage() const override;
+
   std::unique_ptr<CommandResult> doPerformDo(MapDocumentCommandFacade& document) override;
   std::unique_ptr<CommandResult> doPerformUndo(
     MapDocumentCommandFacade& document) override;
@@ -76,6 +76,12 @@ SetLockStateCommand::SetLockStateCommand(
 {
 }
 
+size_t SetLockStateCommand::memoryUsage() const
+{
+  return m_nodes.capacity() * sizeof(mdl::Node*)
+         + m_oldLockState.size() * sizeof(std::pair<mdl::Node* const, mdl::LockState>);
+}
+
 std::string SetLockStateCommand::makeName(const mdl::LockState state)
 {
   switch (state)
@@ -49,6 +49,8 @@ public:
 
   SetLockStateCommand(std::vector<mdl::Node*> nodes, mdl::LockState lockState);
 
+  size_t memoryUsage() const override;
+
 private:
   static std::string makeName(mdl::LockState lockState);
 
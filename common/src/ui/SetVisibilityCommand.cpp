@@ -68,6 +68,12 @@ SetVisibilityCommand::SetVisibilityCommand(
 {
 }
 
+size_t SetVisibilityCommand::memoryUsage() const
+{
+  return m_nodes.capacity() * sizeof(mdl::Node*)
+         + m_oldState.size() * sizeof(std::pair<mdl::Node* const, mdl::VisibilityState>);
+}
+
 std::string SetVisibilityCommand::makeName(const Action action)
 {
   switch (action)
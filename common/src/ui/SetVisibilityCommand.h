@@ -54,6 +54,8 @@ public:
 
   SetVisibilityCommand(std::vector<mdl::Node*> nodes, Action action);
 
+  size_t memoryUsage() const override;
+
 private:
   static std::string makeName(Action action);
 
@@ -68,4 +68,14 @@ bool SwapNodeContentsCommand::doCollateWith(UndoableCommand& command)
   return false;
 }
 
+size_t SwapNodeContentsCommand::memoryUsage() const
+{
+  auto result = m_nodes.capacity() * sizeof(std::pair<mdl::Node*, mdl::NodeContents>);
+  for (const auto& [node, contents] : m_nodes)
+  {
+    result += contents.memoryUsage();
+  }
+  return result;
+}
+
 } // namespace tb::ui
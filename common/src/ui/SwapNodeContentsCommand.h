@@ -51,6 +51,8 @@ public:
 
   bool doCollateWith(UndoableCommand& command) override;
 
+  size_t memoryUsage() const override;
+
   deleteCopyAndMove(SwapNodeContentsCommand);
 };
 
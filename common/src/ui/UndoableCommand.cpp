@@ -73,6 +73,11 @@ bool UndoableCommand::collateWith(UndoableCommand& command)
   return false;
 }
 
+size_t UndoableCommand::memoryUsage() const
+{
+  return 0;
+}
+
 bool UndoableCommand::doCollateWith(UndoableCommand&)
 {
   return false;
@@ -101,4 +101,9 @@ bool UpdateLinkedGroupsCommandBase::collateWith(UndoableCommand& command)
   return false;
 }
 
+size_t UpdateLinkedGroupsCommandBase::memoryUsage() const
+{
+  return m_updateLinkedGroupsHelper.memoryUsage();
+}
+
 } // namespace tb::ui
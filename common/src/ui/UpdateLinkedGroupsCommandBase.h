@@ -49,6 +49,8 @@ public:
 
   bool collateWith(UndoableCommand& command) override;
 
+  size_t memoryUsage() const override;
+
 private:
   deleteCopyAndMove(UpdateLinkedGroupsCommandBase);
 };
@@ -112,6 +112,29 @@ void UpdateLinkedGroupsHelper::collateWith(UpdateLinkedGroupsHelper& other)
   }
 }
 
+size_t UpdateLinkedGroupsHelper::memoryUsage() const
+{
+  return std::visit(
+    kdl::overload(
+      [](const ChangedLinkedGroups& changedLinkedGroups) {
+        return changedLinkedGroups.capacity() * sizeof(mdl::GroupNode*);
+      },
+      [](const LinkedGroupUpdates& linkedGroupUpdates) {
+        auto result =
+          linkedGroupUpdates.capacity() * sizeof(LinkedGroupUpdates::value_type);
+        for (const auto& [groupNode, children] : linkedGroupUpdates)
+        {
+          result += children.capacity() * sizeof(std::unique_ptr<mdl::Node>);
+          for (const auto& child : children)
+          {
+            result += mdl::computeMemoryUsage({child.get()});
+          }
+        }
+        return result;
+      }),
+    m_state);
+}
+
 Result<void> UpdateLinkedGroupsHelper::computeLinkedGroupUpdates(
   MapDocumentCommandFacade& document)
 {
@@ -0,0 +1,184 @@
+/*
+ Copyright (C) 2010 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "io/BackupStore.h"
+#include "io/TestEnvironment.h"
+
+#include "kdl/result.h"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <string>
+#include <unordered_set>
+
+#include "Catch2.h"
+
+namespace tb::io
+{
+namespace
+{
+
+std::string makeMapText(const size_t lineCount)
+{
+  auto result = std::string{};
+  for (size_t i = 0; i < lineCount; ++i)
+  {
+    result +=
+      fmt::format("( {} 0 0 ) ( 0 {} 0 ) ( 0 0 {} ) material 0 0 0 1 1\n", i, i, i);
+  }
+  return result;
+}
+
+size_t countSharedChunks(const std::string_view lhs, const std::string_view rhs)
+{
+  const auto lhsChunks = splitIntoChunks(lhs);
+  const auto lhsChunkSet =
+    std::unordered_set<std::string_view>{lhsChunks.begin(), lhsChunks.end()};
+
+  const auto rhsChunks = splitIntoChunks(rhs);
+  return size_t(std::ranges::count_if(
+    rhsChunks, [&](const auto chunk) { return lhsChunkSet.contains(chunk); }));
+}
+
+} // namespace
+
+TEST_CASE("splitIntoChunks")
+{
+  SECTION("Empty data")
+  {
+    CHECK(splitIntoChunks("").empty());
+  }
+
+  SECTION("Data smaller than the minimum chunk size")
+  {
+    CHECK(splitIntoChunks("some data") == std::vector<std::string_view>{"some data"});
+  }
+
+  SECTION("Chunk sizes")
+  {
+    const auto data = makeMapText(20000);
+    const auto chunks = splitIntoChunks(data);
+    REQUIRE(chunks.size() > 1u);
+
+    auto joined = std::string{};
+    for (const auto chunk : chunks)
+    {
+      CHECK(chunk.size() <= MaxChunkSize);
+      joined += chunk;
+    }
+    CHECK(joined == data);
+
+    CHECK(std::all_of(chunks.begin(), std::prev(chunks.end()), [](const auto chunk) {
+      return chunk.size() >= MinChunkSize;
+    }));
+  }
+
+  SECTION("Local changes only affect nearby chunks")
+  {
+    const auto data = makeMapText(20000);
+    const auto chunkCount = splitIntoChunks(data).size();
+
+    auto changed = data;
+    changed.insert(changed.size() / 2, "( 1 2 3 ) ( 4 5 6 ) ( 7 8 9 ) other 0 0 0 1 1\n");
+    changed.erase(100, 50);
+
+    CHECK(countSharedChunks(data, changed) + 4u >= chunkCount);
+  }
+}
+
+TEST_CASE("BackupStore")
+{
+  auto env = TestEnvironment{};
+  const auto store = BackupStore{env.dir() / "chunks"};
+
+  const auto data = makeMapText(20000);
+  const auto chunkCount = splitIntoChunks(data).size();
+
+  REQUIRE(
+    store.writeBackup(env.dir() / "test.1.tbbackup", data)
+    == Result<size_t>{chunkCount});
+  CHECK(env.fileExists("test.1.tbbackup"));
+  CHECK(env.directoryContents("chunks").size() == chunkCount);
+
+  CHECK(store.readBackup(env.dir() / "test.1.tbbackup") == Result<std::string>{data});
+
+  SECTION("Writing the same contents again writes no chunks")
+  {
+    CHECK(
+      store.writeBackup(env.dir() / "test.2.tbbackup", data) == Result<size_t>{0u});
+    CHECK(store.readBackup(env.dir() / "test.2.tbbackup") == Result<std::string>{data});
+  }
+
+  SECTION("Writing changed contents only writes changed chunks")
+  {
+    auto changed = data;
+    changed.insert(changed.size() / 2, "( 1 2 3 ) ( 4 5 6 ) ( 7 8 9 ) other 0 0 0 1 1\n");
+
+    const auto chunksWritten =
+      store.writeBackup(env.dir() / "test.2.tbbackup", changed) | kdl::value();
+    CHECK(chunksWritten > 0u);
+    CHECK(chunksWritten <= 2u);
+
+    CHECK(store.readBackup(env.dir() / "test.1.tbbackup") == Result<std::string>{data});
+    CHECK(
+      store.readBackup(env.dir() / "test.2.tbbackup") == Result<std::string>{changed});
+
+    SECTION("Collecting garbage deletes unreferenced chunks")
+    {
+      CHECK(
+        store.collectGarbage({env.dir() / "test.1.tbbackup"})
+        == Result<size_t>{chunksWritten});
+      CHECK(env.directoryContents("chunks").size() == chunkCount);
+      CHECK(
+        store.readBackup(env.dir() / "test.1.tbbackup") == Result<std::string>{data});
+      CHECK(store.readBackup(env.dir() / "test.2.tbbackup").is_error());
+    }
+
+    SECTION("Collecting garbage keeps referenced chunks")
+    {
+      CHECK(
+        store.collectGarbage(
+          {env.dir() / "test.1.tbbackup", env.dir() / "test.2.tbbackup"})
+        == Result<size_t>{0u});
+    }
+  }
+
+  SECTION("Restoring a backup")
+  {
+    REQUIRE(
+      store.restoreBackup(env.dir() / "test.1.tbbackup", env.dir() / "restored.map")
+        .is_success());
+    CHECK(env.loadFile("restored.map") == data);
+  }
+
+  SECTION("Reading a backup with a missing chunk fails")
+  {
+    REQUIRE(store.collectGarbage({}) == Result<size_t>{chunkCount});
+    CHECK(store.readBackup(env.dir() / "test.1.tbbackup").is_error());
+  }
+
+  SECTION("Reading a file that is not a manifest fails")
+  {
+    env.createFile("test.2.tbbackup", "some content");
+    CHECK(store.readBackup(env.dir() / "test.2.tbbackup").is_error());
+  }
+}
+
+} // namespace tb::io
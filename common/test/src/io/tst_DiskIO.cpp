@@ -229,6 +229,15 @@ TEST_CASE("DiskIO")
 
     file = Disk::openFile(env.dir() / "linkedTest2.map");
     CHECK(file.is_success());
+
+    // files are only mapped into memory on request
+    CHECK((Disk::openFile(env.dir() / "test.txt") | kdl::value())->memory() == nullptr);
+#ifndef _WIN32
+    CHECK(
+      (Disk::openFile(env.dir() / "test.txt", MemoryMapping::Enabled) | kdl::value())
+        ->memory()
+      != nullptr);
+#endif
   }
 
   SECTION("withStream")
@@ -0,0 +1,330 @@
+/*
+ Copyright (C) 2010 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "io/MapCache.h"
+#include "io/NodeWriter.h"
+#include "io/Reader.h"
+#include "io/TestParserStatus.h"
+#include "io/WorldReader.h"
+#include "mdl/Brush.h"
+#include "mdl/BrushNode.h"
+#include "mdl/LayerNode.h"
+#include "mdl/Node.h"
+#include "mdl/PatchNode.h"
+#include "mdl/WorldNode.h"
+
+#include "kdl/task_manager.h"
+
+#include "vm/bbox.h"
+
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace tb::io
+{
+namespace
+{
+
+std::unique_ptr<mdl::WorldNode> readWorld(
+  const std::string& data,
+  const mdl::MapFormat mapFormat,
+  const vm::bbox3d& worldBounds,
+  kdl::task_manager& taskManager)
+{
+  auto status = TestParserStatus{};
+  auto reader = WorldReader{data, mapFormat, {}};
+  return reader.read(worldBounds, status, taskManager).value();
+}
+
+std::string writeCache(
+  const MapCacheKey& key, const mdl::WorldNode& world, kdl::task_manager& taskManager)
+{
+  auto stream = std::stringstream{};
+  writeMapCache(stream, key, world, taskManager);
+  return stream.str();
+}
+
+Result<CachedMap> readCache(
+  const std::string& cache, const MapCacheKey& key, kdl::task_manager& taskManager)
+{
+  return readMapCache(
+    Reader::from(cache.data(), cache.data() + cache.size()), key, taskManager);
+}
+
+std::string writeMap(const mdl::WorldNode& world, kdl::task_manager& taskManager)
+{
+  auto stream = std::stringstream{};
+  auto writer = NodeWriter{world, stream};
+  writer.writeMap(taskManager);
+  return stream.str();
+}
+
+std::vector<const mdl::Node*> collectNodes(const mdl::Node& node)
+{
+  auto result = std::vector<const mdl::Node*>{&node};
+  for (const auto* child : node.children())
+  {
+    const auto childNodes = collectNodes(*child);
+    result.insert(result.end(), childNodes.begin(), childNodes.end());
+  }
+  return result;
+}
+
+void checkRestoresWorld(
+  const std::string& data,
+  const mdl::MapFormat mapFormat,
+  const vm::bbox3d& worldBounds,
+  kdl::task_manager& taskManager)
+{
+  const auto world = readWorld(data, mapFormat, worldBounds, taskManager);
+  const auto key = makeMapCacheKey(data, worldBounds);
+  const auto cache = writeCache(key, *world, taskManager);
+
+  auto cachedMap = readCache(cache, key, taskManager);
+  REQUIRE(cachedMap.is_success());
+  CHECK(cachedMap.value().mapFormat == mapFormat);
+
+  auto status = TestParserStatus{};
+  auto reader = WorldReader{{}, mapFormat, {}};
+  auto cachedWorld = reader
+                       .read(
+                         std::move(cachedMap.value().objectInfos),
+                         worldBounds,
+                         status,
+                         taskManager)
+                       .value();
+
+  CHECK(writeMap(*cachedWorld, taskManager) == writeMap(*world, taskManager));
+
+  const auto nodes = collectNodes(*world);
+  const auto cachedNodes = collectNodes(*cachedWorld);
+  REQUIRE(cachedNodes.size() == nodes.size());
+
+  for (size_t i = 0; i < nodes.size(); ++i)
+  {
+    CHECK(cachedNodes[i]->lineNumber() == nodes[i]->lineNumber());
+    CHECK(cachedNodes[i]->lineCount() == nodes[i]->lineCount());
+    CHECK(cachedNodes[i]->logicalBounds() == nodes[i]->logicalBounds());
+
+    if (const auto* brushNode = dynamic_cast<const mdl::BrushNode*>(nodes[i]))
+    {
+      const auto* cachedBrushNode = dynamic_cast<const mdl::BrushNode*>(cachedNodes[i]);
+      REQUIRE(cachedBrushNode != nullptr);
+
+      const auto& brush = brushNode->brush();
+      const auto& cachedBrush = cachedBrushNode->brush();
+      CHECK(cachedBrush == brush);
+      CHECK(cachedBrush.vertexPositions() == brush.vertexPositions());
+      CHECK(cachedBrush.edgeCount() == brush.edgeCount());
+
+      for (size_t j = 0; j < brush.faceCount(); ++j)
+      {
+        CHECK(cachedBrush.face(j).vertexPositions() == brush.face(j).vertexPositions());
+        CHECK(cachedBrush.face(j).lineNumber() == brush.face(j).lineNumber());
+        CHECK(cachedBrush.face(j).lineCount() == brush.face(j).lineCount());
+      }
+    }
+  }
+}
+
+} // namespace
+
+TEST_CASE("MapCache")
+{
+  auto taskManager = kdl::task_manager{};
+  const auto worldBounds = vm::bbox3d{8192.0};
+
+  const auto standardData = R"(
+{
+"classname" "worldspawn"
+"message" "cached"
+{
+( -64 -64 -16 ) ( -64 -63 -16 ) ( -64 -64 -15 ) __TB_empty 0 0 0 1 1
+( -64 -64 -16 ) ( -64 -64 -15 ) ( -63 -64 -16 ) __TB_empty 0 0 0 1 1
+( -64 -64 -16 ) ( -63 -64 -16 ) ( -64 -63 -16 ) __TB_empty 0 0 0 1 1
+( 64 64 16 ) ( 64 65 16 ) ( 65 64 16 ) __TB_empty 0 0 0 1 1
+( 64 64 16 ) ( 65 64 16 ) ( 64 64 17 ) __TB_empty 0 0 0 1 1
+( 64 64 16 ) ( 64 64 17 ) ( 64 65 16 ) __TB_empty 0 0 0 1 1
+}
+}
+{
+"classname" "func_group"
+"_tb_type" "_tb_layer"
+"_tb_name" "Layer"
+"_tb_id" "1"
+{
+( 0 0 0 ) ( 0 16 0 ) ( 0 0 16 ) rock 2 3 15 0.5 0.25
+( 0 0 0 ) ( 0 0 16 ) ( 16 0 0 ) rock 2 3 15 0.5 0.25
+( 0 0 0 ) ( 16 0 0 ) ( 0 16 0 ) rock 2 3 15 0.5 0.25
+( 8 8 8 ) ( 8 8 8.5 ) ( 8 8.5 8 ) rock 2 3 15 0.5 0.25
+}
+}
+{
+"classname" "func_door"
+"_tb_layer" "1"
+"angle" "90"
+{
+( -800 288 1024 ) ( -736 288 1024 ) ( -736 224 1024 ) metal 0 0 0 1 1
+( -800 288 1024 ) ( -800 224 1024 ) ( -800 224 576 ) metal 0 0 0 1 1
+( -736 224 1024 ) ( -736 288 1024 ) ( -736 288 576 ) metal 0 0 0 1 1
+( -736 288 1024 ) ( -800 288 1024 ) ( -800 288 576 ) metal 0 0 0 1 1
+( -800 224 1024 ) ( -736 224 1024 ) ( -736 224 576 ) metal 0 0 0 1 1
+( -800 224 576 ) ( -736 224 576 ) ( -736 288 576 ) metal 0 0 0 1 1
+}
+}
+)";
+
+  SECTION("Restores a world in Standard format")
+  {
+    checkRestoresWorld(standardData, mdl::MapFormat::Standard, worldBounds, taskManager);
+  }
+
+  SECTION("Restores a world in Valve format")
+  {
+    const auto data = R"(
+{
+"classname" "worldspawn"
+"mapversion" "220"
+{
+( -800 288 1024 ) ( -736 288 1024 ) ( -736 224 1024 ) METAL4_5 [ 1 0 0 64 ] [ 0 -1 0 0 ] 0 1 1
+( -800 288 1024 ) ( -800 224 1024 ) ( -800 224 576 ) METAL4_5 [ 0 1 0 0 ] [ 0 0 -1 0 ] 0 1 1
+( -736 224 1024 ) ( -736 288 1024 ) ( -736 288 576 ) METAL4_5 [ 0 1 0 0 ] [ 0 0 -1 0 ] 0 1 1
+( -736 288 1024 ) ( -800 288 1024 ) ( -800 288 576 ) METAL4_5 [ 1 0 0 64 ] [ 0 0 -1 0 ] 0 1 1
+( -800 224 1024 ) ( -736 224 1024 ) ( -736 224 576 ) METAL4_5 [ 1 0 0 64 ] [ 0 0 -1 0 ] 0 1 1
+( -800 224 576 ) ( -736 224 576 ) ( -736 288 576 ) METAL4_5 [ 0.6 0.8 0 64 ] [ 0 -1 0 0 ] 0 1 1
+}
+}
+)";
+
+    checkRestoresWorld(data, mdl::MapFormat::Valve, worldBounds, taskManager);
+  }
+
+  SECTION("Restores a world with patches")
+  {
+    const auto data = R"(
+{
+"classname" "worldspawn"
+{
+( 208 190 80 ) ( 208 -62 80 ) ( 208 190 -176 ) gothic_block/blocks18c_3 0 0 0 0.25 0.25 0 0 0
+( 224 200 80 ) ( 208 190 80 ) ( 224 200 -176 ) gothic_block/blocks18c_3 0 0 0 0.25 0.25 0 0 0
+( 224 200 -176 ) ( 208 190 -176 ) ( 224 -52 -176 ) gothic_block/blocks18c_3 0 0 0 0.25 0.25 0 0 0
+( 224 -52 80 ) ( 208 -62 80 ) ( 224 200 80 ) gothic_block/blocks18c_3 0 0 0 0.25 0.25 0 0 0
+( 224 -52 -176 ) ( 208 -62 -176 ) ( 224 -52 80 ) gothic_block/blocks18c_3 0 0 0 0.25 0.25 0 0 0
+( 224 -52 80 ) ( 224 200 80 ) ( 224 -52 -176 ) gothic_block/blocks18c_3 0 0 0 0.25 0.25 0 0 0
+}
+{
+patchDef2
+{
+common/caulk
+( 5 3 0 0 0 )
+(
+( (-64 -64 4 0   0 ) (-64 0 4 0   -0.25 ) (-64 64 4 0   -0.5 ) )
+( (  0 -64 4 0.2 0 ) (  0 0 4 0.2 -0.25 ) (  0 64 4 0.2 -0.5 ) )
+( ( 64 -64 4 0.4 0 ) ( 64 0 4 0.4 -0.25 ) ( 64 64 4 0.4 -0.5 ) )
+( (128 -64 4 0.6 0 ) (128 0 4 0.6 -0.25 ) (128 64 4 0.6 -0.5 ) )
+( (192 -64 4 0.8 0 ) (192 0 4 0.8 -0.25 ) (192 64 4 0.8 -0.5 ) )
+)
+}
+}
+}
+)";
+
+    checkRestoresWorld(data, mdl::MapFormat::Quake3, worldBounds, taskManager);
+  }
+
+  SECTION("Rejects a stale cache")
+  {
+    const auto world =
+      readWorld(standardData, mdl::MapFormat::Standard, worldBounds, taskManager);
+    const auto key = makeMapCacheKey(standardData, worldBounds);
+    const auto cache = writeCache(key, *world, taskManager);
+    REQUIRE(readCache(cache, key, taskManager).is_success());
+
+    const auto otherDataKey =
+      makeMapCacheKey(std::string{standardData} + " ", worldBounds);
+    CHECK(readCache(cache, otherDataKey, taskManager).is_error());
+
+    const auto otherBoundsKey = makeMapCacheKey(standardData, vm::bbox3d{4096.0});
+    CHECK(readCache(cache, otherBoundsKey, taskManager).is_error());
+  }
+
+  SECTION("Builds brushes from their faces if the cached geometry is invalid")
+  {
+    const auto world =
+      readWorld(standardData, mdl::MapFormat::Standard, worldBounds, taskManager);
+    const auto key = makeMapCacheKey(standardData, worldBounds);
+    auto cache = writeCache(key, *world, taskManager);
+
+    // move the vertex at (64 -64 -16) of the worldspawn brush off its face planes
+    const double vertex[] = {64.0, -64.0, -16.0};
+    const auto vertexBytes =
+      std::string_view{reinterpret_cast<const char*>(vertex), sizeof(vertex)};
+    const auto offset = cache.find(vertexBytes);
+    REQUIRE(offset != std::string::npos);
+    REQUIRE(cache.find(vertexBytes, offset + 1) == std::string::npos);
+
+    const auto corrupted = 80.0;
+    std::memcpy(cache.data() + offset, &corrupted, sizeof(corrupted));
+
+    auto cachedMap = readCache(cache, key, taskManager);
+    REQUIRE(cachedMap.is_success());
+
+    auto status = TestParserStatus{};
+    auto reader = WorldReader{{}, mdl::MapFormat::Standard, {}};
+    auto cachedWorld = reader
+                         .read(
+                           std::move(cachedMap.value().objectInfos),
+                           worldBounds,
+                           status,
+                           taskManager)
+                         .value();
+
+    CHECK(writeMap(*cachedWorld, taskManager) == writeMap(*world, taskManager));
+
+    const auto* brushNode =
+      dynamic_cast<const mdl::BrushNode*>(world->defaultLayer()->children().front());
+    const auto* cachedBrushNode = dynamic_cast<const mdl::BrushNode*>(
+      cachedWorld->defaultLayer()->children().front());
+    REQUIRE(brushNode != nullptr);
+    REQUIRE(cachedBrushNode != nullptr);
+    CHECK(
+      cachedBrushNode->brush().vertexPositions() == brushNode->brush().vertexPositions());
+  }
+
+  SECTION("Rejects a truncated cache")
+  {
+    const auto world =
+      readWorld(standardData, mdl::MapFormat::Standard, worldBounds, taskManager);
+    const auto key = makeMapCacheKey(standardData, worldBounds);
+    const auto cache = writeCache(key, *world, taskManager);
+
+    for (const auto size : {size_t(0), size_t(8), cache.size() / 2, cache.size() - 1})
+    {
+      CAPTURE(size);
+      CHECK(readCache(cache.substr(0, size), key, taskManager).is_error());
+    }
+  }
+}
+
+} // namespace tb::io
@@ -25,6 +25,7 @@
 #include <filesystem>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "Catch2.h"
 
@@ -39,10 +40,22 @@ const char* buff()
   return result;
 }
 
-std::shared_ptr<File> file()
+std::shared_ptr<CFile> file()
 {
   static auto result =
-    Disk::openFile(std::filesystem::current_path() / "fixture/test/io/Reader/10byte")
+    createCFile(
+      std::filesystem::current_path() / "fixture/test/io/Reader/10byte",
+      MemoryMapping::Disabled)
+    | kdl::value();
+  return result;
+}
+
+std::shared_ptr<CFile> mappedFile()
+{
+  static auto result =
+    createCFile(
+      std::filesystem::current_path() / "fixture/test/io/Reader/10byte",
+      MemoryMapping::Enabled)
     | kdl::value();
   return result;
 }
@@ -72,9 +85,29 @@ TEST_CASE("FileReaderTest.createEmpty")
   const auto emptyFile =
     Disk::openFile(std::filesystem::current_path() / "fixture/test/io/Reader/empty")
     | kdl::value();
+
+  // empty files cannot be mapped into memory
+  CHECK(emptyFile->memory() == nullptr);
   createEmpty(emptyFile->reader());
 }
 
+TEST_CASE("CFileTest.memory")
+{
+  CHECK(file()->memory() == nullptr);
+#ifndef _WIN32
+  REQUIRE(mappedFile()->memory() != nullptr);
+  CHECK(std::string(mappedFile()->memory(), mappedFile()->size()) == "abcdefghij");
+#endif
+
+  const auto buffer = file()->buffer();
+  const auto mappedBuffer = mappedFile()->buffer();
+  REQUIRE(buffer != nullptr);
+  REQUIRE(mappedBuffer != nullptr);
+  CHECK(
+    buffer->reader().readString(buffer->size())
+    == mappedBuffer->reader().readString(mappedBuffer->size()));
+}
+
 static void createNonEmpty(Reader&& r)
 {
   CHECK(r.size() == 10U);
@@ -110,6 +143,11 @@ TEST_CASE("FileReaderTest.createNonEmpty")
   createNonEmpty(file()->reader());
 }
 
+TEST_CASE("MappedFileReaderTest.createNonEmpty")
+{
+  createNonEmpty(mappedFile()->reader());
+}
+
 static void seekFromBegin(Reader&& r)
 {
   r.seekFromBegin(0U);
@@ -229,4 +267,68 @@ TEST_CASE("FileReaderTest.subReader")
 {
   subReader(file()->reader());
 }
+
+TEST_CASE("MappedFileReaderTest.subReader")
+{
+  subReader(mappedFile()->reader());
+}
+
+static void readBytes(Reader&& r)
+{
+  r.seekFromBegin(2);
+
+  const auto bytes = r.readBytes(3);
+  CHECK(std::string(bytes.begin(), bytes.end()) == "cde");
+  CHECK(r.position() == 5U);
+
+  CHECK(r.readBytes(0).empty());
+  CHECK(r.position() == 5U);
+
+  CHECK_THROWS_AS(r.readBytes(6), ReaderException);
+  CHECK(r.position() == 5U);
+}
+
+TEST_CASE("BufferReaderTest.readBytes")
+{
+  readBytes(Reader::from(buff(), buff() + 10));
+}
+
+TEST_CASE("FileReaderTest.readBytes")
+{
+  readBytes(file()->reader());
+}
+
+TEST_CASE("MappedFileReaderTest.readBytes")
+{
+  readBytes(mappedFile()->reader());
+}
+
+static void readArray(Reader&& r)
+{
+  CHECK(r.readArray<char>(3) == std::vector<char>{'a', 'b', 'c'});
+  CHECK(r.readArray<unsigned char, int>(2) == std::vector<int>{'d', 'e'});
+  CHECK(r.position() == 5U);
+
+  CHECK(
+    r.readVecArray<char, 2, int>(2)
+    == std::vector<vm::vec<int, 2>>{{'f', 'g'}, {'h', 'i'}});
+  CHECK(r.position() == 9U);
+
+  CHECK_THROWS_AS((r.readVecArray<char, 2>(1)), ReaderException);
+}
+
+TEST_CASE("BufferReaderTest.readArray")
+{
+  readArray(Reader::from(buff(), buff() + 10));
+}
+
+TEST_CASE("FileReaderTest.readArray")
+{
+  readArray(file()->reader());
+}
+
+TEST_CASE("MappedFileReaderTest.readArray")
+{
+  readArray(mappedFile()->reader());
+}
 } // namespace tb::io
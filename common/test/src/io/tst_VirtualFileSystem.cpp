@@ -24,6 +24,7 @@
 #include "io/VirtualFileSystem.h"
 
 #include "kdl/result.h"
+#include "kdl/vector_utils.h"
 
 #include <fmt/format.h>
 #include <fmt/std.h>
@@ -34,6 +35,18 @@
 
 namespace tb::io
 {
+namespace
+{
+
+class ImmutableTestFileSystem : public TestFileSystem
+{
+public:
+  using TestFileSystem::TestFileSystem;
+
+  bool isImmutable() const override { return true; }
+};
+
+} // namespace
 
 TEST_CASE("VirtualFileSystem")
 {
@@ -776,4 +789,158 @@ TEST_CASE("VirtualFileSystem")
   }
 }
 
+TEST_CASE("VirtualFileSystem.index")
+{
+  struct MountSpec
+  {
+    std::filesystem::path path;
+    Entry root;
+    std::filesystem::path absolutePathPrefix;
+    bool immutable;
+  };
+
+  const auto mountSpecs = std::vector<MountSpec>{
+    {"",
+     DirectoryEntry{
+       "",
+       {
+         DirectoryEntry{
+           "foo",
+           {
+             DirectoryEntry{"bar", {FileEntry{"baz", makeObjectFile(1)}}},
+           }},
+         DirectoryEntry{
+           "bar",
+           {
+             FileEntry{"foo", makeObjectFile(2)},
+             FileEntry{"cat", makeObjectFile(3)},
+           }},
+       }},
+     "/fs1",
+     true},
+    {"",
+     DirectoryEntry{
+       "",
+       {
+         DirectoryEntry{
+           "bar",
+           {
+             FileEntry{"bat", makeObjectFile(4)},
+             DirectoryEntry{"cat", {}},
+           }},
+       }},
+     "/fs2",
+     false},
+    {"",
+     DirectoryEntry{
+       "",
+       {
+         DirectoryEntry{"bar", {FileEntry{"bat", makeObjectFile(5)}}},
+         DirectoryEntry{"baz", {FileEntry{"foo", makeObjectFile(6)}}},
+       }},
+     "/fs3",
+     true},
+    {"textures/wad",
+     DirectoryEntry{
+       "",
+       {
+         FileEntry{"a", makeObjectFile(7)},
+         FileEntry{"b", makeObjectFile(8)},
+       }},
+     "/fs4",
+     true},
+    {"textures",
+     DirectoryEntry{
+       "",
+       {
+         DirectoryEntry{"wad", {FileEntry{"a", makeObjectFile(9)}}},
+       }},
+     "/fs5",
+     false},
+  };
+
+  const auto mountAll = [&](VirtualFileSystem& vfs, const bool useIndex) {
+    return kdl::vec_transform(mountSpecs, [&](const auto& mountSpec) {
+      return vfs.mount(
+        mountSpec.path,
+        useIndex && mountSpec.immutable
+          ? std::make_unique<ImmutableTestFileSystem>(
+              mountSpec.root,
+              std::unordered_map<std::string, FileSystemMetadata>{},
+              mountSpec.absolutePathPrefix)
+          : std::make_unique<TestFileSystem>(
+              mountSpec.root,
+              std::unordered_map<std::string, FileSystemMetadata>{},
+              mountSpec.absolutePathPrefix));
+    });
+  };
+
+  // every lookup must yield the same result as if no file system was indexed
+  auto expected = VirtualFileSystem{};
+  auto actual = VirtualFileSystem{};
+  const auto expectedIds = mountAll(expected, false);
+  const auto actualIds = mountAll(actual, true);
+
+  const auto checkLookups = [&]() {
+    for (const auto& path : std::vector<std::filesystem::path>{
+           "",
+           "foo",
+           "foo/bar",
+           "foo/bar/baz",
+           "bar",
+           "bar/foo",
+           "bar/bat",
+           "bar/cat",
+           "baz",
+           "baz/foo",
+           "textures",
+           "textures/wad",
+           "textures/wad/a",
+           "textures/wad/b",
+           "does_not_exist",
+           "foo/does_not_exist",
+         })
+    {
+      CAPTURE(path);
+
+      CHECK(actual.pathInfo(path) == expected.pathInfo(path));
+      CHECK(actual.makeAbsolute(path) == expected.makeAbsolute(path));
+      CHECK(actual.openFile(path) == expected.openFile(path));
+
+      if (expected.pathInfo(path) == PathInfo::Directory)
+      {
+        for (const auto& traversalMode : {TraversalMode::Flat, TraversalMode::Recursive})
+        {
+          CHECK_THAT(
+            actual.find(path, traversalMode),
+            MatchesPathsResult(expected.find(path, traversalMode) | kdl::value()));
+        }
+      }
+    }
+  };
+
+  SECTION("with all file systems mounted")
+  {
+    checkLookups();
+  }
+
+  SECTION("after unmounting a file system")
+  {
+    const auto i = GENERATE(0u, 1u, 2u, 3u, 4u);
+    CAPTURE(i);
+
+    REQUIRE(expected.unmount(expectedIds[i]));
+    REQUIRE(actual.unmount(actualIds[i]));
+    checkLookups();
+  }
+
+  SECTION("after unmounting all file systems")
+  {
+    actual.unmountAll();
+    CHECK(actual.pathInfo("") == PathInfo::Unknown);
+    CHECK(actual.pathInfo("textures") == PathInfo::Unknown);
+    CHECK(actual.pathInfo("foo/bar/baz") == PathInfo::Unknown);
+  }
+}
+
 } // namespace tb::io
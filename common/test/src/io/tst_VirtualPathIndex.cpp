@@ -0,0 +1,140 @@
+/*
+ Copyright (C) 2010 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "io/PathInfo.h"
+#include "io/TraversalMode.h"
+#include "io/VirtualPathIndex.h"
+
+#include "kdl/vector_utils.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace tb::io
+{
+namespace
+{
+
+std::vector<std::filesystem::path> findPaths(
+  const VirtualPathIndex& index,
+  const std::filesystem::path& path,
+  const TraversalMode& traversalMode)
+{
+  return kdl::vec_transform(
+    index.find(path, traversalMode), [](const auto& match) { return match.path; });
+}
+
+} // namespace
+
+TEST_CASE("VirtualPathIndex")
+{
+  auto index = VirtualPathIndex{};
+  CHECK_FALSE(index.contains(""));
+  CHECK(index.find("") == nullptr);
+
+  index.add(1, "", PathInfo::Directory);
+  index.add(1, "Textures", PathInfo::Directory);
+  index.add(1, "Textures/Wall.png", PathInfo::File);
+  index.add(2, "models/wad", PathInfo::Directory);
+  index.add(2, "models/wad/a.mdl", PathInfo::File);
+  index.add(3, "", PathInfo::Directory);
+  index.add(3, "textures", PathInfo::Directory);
+  index.add(3, "textures/wall.png", PathInfo::File);
+  index.add(3, "textures/floor.png", PathInfo::File);
+
+  SECTION("Lookups are case insensitive")
+  {
+    REQUIRE(index.find("TEXTURES/WALL.PNG") != nullptr);
+    CHECK(index.find("TEXTURES/WALL.PNG")->pathInfo == PathInfo::File);
+    CHECK(index.find("textures/does_not_exist.png") == nullptr);
+  }
+
+  SECTION("The mount point with the greatest ID takes precedence")
+  {
+    CHECK(index.find("textures/wall.png")->mountPointId == 3u);
+    CHECK(index.find("textures/floor.png")->mountPointId == 3u);
+    CHECK(index.find("models/wad/a.mdl")->mountPointId == 2u);
+  }
+
+  SECTION("Parent directories that were not added are contained, but not found")
+  {
+    CHECK(index.contains("models"));
+    CHECK(index.find("models") == nullptr);
+    CHECK(index.contains("models/wad"));
+    CHECK(index.find("models/wad") != nullptr);
+  }
+
+  SECTION("Finding paths")
+  {
+    CHECK_THAT(
+      findPaths(index, "", TraversalMode::Flat),
+      Catch::Matchers::UnorderedEquals(
+        std::vector<std::filesystem::path>{"textures", "models"}));
+    CHECK_THAT(
+      findPaths(index, "TEXTURES", TraversalMode::Flat),
+      Catch::Matchers::UnorderedEquals(std::vector<std::filesystem::path>{
+        "textures/wall.png", "textures/floor.png"}));
+    CHECK_THAT(
+      findPaths(index, "models", TraversalMode::Recursive),
+      Catch::Matchers::UnorderedEquals(
+        std::vector<std::filesystem::path>{"models/wad", "models/wad/a.mdl"}));
+
+    const auto matches = index.find("", TraversalMode::Flat);
+    const auto modelsMatch = std::ranges::find_if(
+      matches, [](const auto& match) { return match.path == "models"; });
+    REQUIRE(modelsMatch != matches.end());
+    CHECK(modelsMatch->mountPointId == 0u);
+  }
+
+  SECTION("Removing a mount point")
+  {
+    index.remove(3);
+    CHECK(index.find("textures/wall.png")->mountPointId == 1u);
+    CHECK(index.find("textures/floor.png") == nullptr);
+    CHECK_THAT(
+      findPaths(index, "", TraversalMode::Recursive),
+      Catch::Matchers::UnorderedEquals(std::vector<std::filesystem::path>{
+        "Textures",
+        "Textures/Wall.png",
+        "models",
+        "models/wad",
+        "models/wad/a.mdl",
+      }));
+
+    index.remove(2);
+    CHECK_FALSE(index.contains("models"));
+    CHECK(index.contains("textures"));
+
+    index.remove(1);
+    CHECK_FALSE(index.contains(""));
+    CHECK(findPaths(index, "", TraversalMode::Recursive).empty());
+  }
+
+  SECTION("Clearing the index")
+  {
+    index.clear();
+    CHECK_FALSE(index.contains(""));
+    CHECK(index.find("textures/wall.png") == nullptr);
+  }
+}
+
+} // namespace tb::io
@@ -40,6 +40,7 @@
 
 #include <fmt/format.h>
 
+#include <algorithm>
 #include <filesystem>
 #include <string>
 
@@ -1980,6 +1981,148 @@ common/caulk
     REQUIRE(world != nullptr);
     CHECK(world->mapFormat() == mdl::MapFormat::Standard);
   }
+
+  SECTION("parseLargeMapInChunks")
+  {
+    // large enough to be split into several chunks that are parsed in parallel
+    auto data = std::string{};
+
+    const auto currentLine = [&]() {
+      return size_t(std::count(data.begin(), data.end(), '\n')) + 1u;
+    };
+    const auto appendBrush = [&](const int x, const int y, const std::string& material) {
+      data += fmt::format(
+        R"({{
+( {0} {1} -16 ) ( {0} {1} 0 ) ( {2} {1} -16 ) {4} 0 0 0 1 1
+( {0} {1} -16 ) ( {0} {3} -16 ) ( {0} {1} 0 ) {4} 0 0 0 1 1
+( {0} {1} -16 ) ( {2} {1} -16 ) ( {0} {3} -16 ) {4} 0 0 0 1 1
+( {2} {3} 0 ) ( {0} {3} 0 ) ( {2} {3} -16 ) {4} 0 0 0 1 1
+( {2} {3} 0 ) ( {2} {3} -16 ) ( {2} {1} 0 ) {4} 0 0 0 1 1
+( {2} {3} 0 ) ( {2} {1} 0 ) ( {0} {3} 0 ) {4} 0 0 0 1 1
+}}
+)",
+        x,
+        y,
+        x + 64,
+        y + 64,
+        material);
+    };
+
+    const auto worldBrushCount = 2000;
+    const auto pointEntityCount = 2000;
+    const auto brushEntityCount = 500;
+
+    data += "// Game: Quake\n// Format: Standard\n";
+    data += "{\n\"classname\" \"worldspawn\"\n";
+    auto lastWorldBrushLine = size_t(0);
+    for (int i = 0; i < worldBrushCount; ++i)
+    {
+      lastWorldBrushLine = currentLine();
+      // material names containing braces must not confuse the chunking
+      appendBrush(
+        (i % 100) * 64 - 4096, (i / 100) * 64 - 4096, i % 2 ? "{water" : "tex}1");
+    }
+    data += "}\n";
+
+    const auto firstPointEntityLine = currentLine();
+    for (int i = 0; i < pointEntityCount; ++i)
+    {
+      data += fmt::format(
+        R"({{
+"classname" "info_null"
+"message" "{{ }} \" }} {{ {0}"
+}}
+)",
+        i);
+    }
+
+    auto lastBrushEntityBrushLine = size_t(0);
+    for (int i = 0; i < brushEntityCount; ++i)
+    {
+      data += "{\n\"classname\" \"func_door\"\n";
+      lastBrushEntityBrushLine = currentLine();
+      appendBrush((i % 100) * 64 - 4096, (i / 100) * 64, "door");
+      data += "}\n";
+    }
+
+    SECTION("Parse successfully")
+    {
+      auto reader = WorldReader{data, mdl::MapFormat::Standard, {}};
+
+      auto worldResult = reader.read(worldBounds, status, taskManager);
+      REQUIRE(worldResult.is_success());
+
+      const auto& world = worldResult.value();
+      const auto& children = world->defaultLayer()->children();
+      REQUIRE(
+        children.size()
+        == size_t(worldBrushCount + pointEntityCount + brushEntityCount));
+
+      auto* lastWorldBrushNode =
+        dynamic_cast<mdl::BrushNode*>(children[size_t(worldBrushCount - 1)]);
+      REQUIRE(lastWorldBrushNode != nullptr);
+      CHECK(lastWorldBrushNode->lineNumber() == lastWorldBrushLine);
+      CHECK(
+        lastWorldBrushNode->brush().face(0).attributes().materialName() == "{water");
+
+      auto* firstPointEntityNode =
+        dynamic_cast<mdl::EntityNode*>(children[size_t(worldBrushCount)]);
+      REQUIRE(firstPointEntityNode != nullptr);
+      CHECK(firstPointEntityNode->lineNumber() == firstPointEntityLine);
+      CHECK(*firstPointEntityNode->entity().property("message") == R"({ } \" } { 0)");
+
+      auto* lastBrushEntityNode = dynamic_cast<mdl::EntityNode*>(children.back());
+      REQUIRE(lastBrushEntityNode != nullptr);
+      CHECK(lastBrushEntityNode->entity().classname() == "func_door");
+      REQUIRE(lastBrushEntityNode->childCount() == 1u);
+      CHECK(
+        lastBrushEntityNode->children().front()->lineNumber()
+        == lastBrushEntityBrushLine);
+    }
+
+    SECTION("Report errors with the correct location")
+    {
+      const auto errorLine = currentLine() + 3;
+      data += R"({
+"classname" "func_wall"
+{
+( 0 0 0 ) asdf
+}
+}
+)";
+
+      auto reader = WorldReader{data, mdl::MapFormat::Standard, {}};
+
+      auto worldResult = reader.read(worldBounds, status, taskManager);
+      REQUIRE(worldResult.is_error());
+      CHECK_THAT(
+        std::visit([](const auto& e) { return e.msg; }, worldResult.error()),
+        Catch::StartsWith(fmt::format("At line {}, column 11:", errorLine)));
+    }
+
+    SECTION("Report errors in a chunk between other chunks with the correct location")
+    {
+      // the braces of these entities are not separated from their contents
+      const auto offset = data.find("{\n\"classname\" \"info_null\"");
+      const auto errorLine = size_t(std::count(data.begin(), data.begin() + offset, '\n'))
+                             + 1u + 2u;
+      data.insert(
+        offset,
+        R"({"classname" "func_wall"}
+{"classname" "func_wall"{
+( 0 0 0 ) asdf
+}}
+)");
+
+      auto reader = WorldReader{data, mdl::MapFormat::Standard, {}};
+
+      auto worldResult = reader.read(worldBounds, status, taskManager);
+      REQUIRE(worldResult.is_error());
+      CHECK_THAT(
+        std::visit([](const auto& e) { return e.msg; }, worldResult.error()),
+        Catch::StartsWith(fmt::format("At line {}, column 11:", errorLine)));
+    }
+  }
 }
 
 } // namespace tb::io
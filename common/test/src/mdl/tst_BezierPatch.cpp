@@ -53,6 +53,24 @@ TEST_CASE("BezierPatch.evaluate")
   CHECK(patch.evaluate(subdiv) == expectedGrid);
 }
 
+TEST_CASE("BezierPatch.evaluateWithRowAndColumnSubdivisions")
+{
+  // clang-format off
+  const auto patch = BezierPatch{3, 3, { {0, 0, 0}, {1, 0, 1}, {2, 0, 0},
+                                         {0, 1, 1}, {1, 1, 2}, {2, 1, 1},
+                                         {0, 2, 0}, {1, 2, 1}, {2, 2, 0} }, ""};
+
+  CHECK(patch.evaluate(1, 2) == std::vector<BezierPatch::Point>{
+    {0, 0, 0},   {0.5, 0, 0.375}, {1, 0, 0.5}, {1.5, 0, 0.375}, {2, 0, 0},
+    {0, 1, 0.5}, {0.5, 1, 0.875}, {1, 1, 1},   {1.5, 1, 0.875}, {2, 1, 0.5},
+    {0, 2, 0},   {0.5, 2, 0.375}, {1, 2, 0.5}, {1.5, 2, 0.375}, {2, 2, 0} });
+
+  CHECK(patch.evaluate(0, 1) == std::vector<BezierPatch::Point>{
+    {0, 0, 0}, {1, 0, 0.5}, {2, 0, 0},
+    {0, 2, 0}, {1, 2, 0.5}, {2, 2, 0} });
+  // clang-format on
+}
+
 TEST_CASE("BezierPatch.transform")
 {
   // clang-format off
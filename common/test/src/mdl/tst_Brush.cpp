@@ -31,11 +31,14 @@
 #include "kdl/vector_utils.h"
 
 #include "vm/approx.h"
+#include "vm/bbox.h"
+#include "vm/mat_ext.h"
 #include "vm/polygon.h"
 #include "vm/segment.h"
 #include "vm/vec.h"
 #include "vm/vec_ext.h"
 
+#include <algorithm>
 #include <string>
 #include <vector>
 
@@ -267,6 +270,118 @@ TEST_CASE("BrushTest.cloneFaceAttributesFrom")
   CHECK(newBrush == brush);
 }
 
+TEST_CASE("BrushTest.sharedGeometry")
+{
+  const auto worldBounds = vm::bbox3d{4096.0};
+
+  const auto brushBuilder = BrushBuilder{MapFormat::Valve, worldBounds};
+  const auto brush = brushBuilder.createCube(64.0, "material") | kdl::value();
+
+  const auto unsharedMemoryUsage = brush.memoryUsage();
+
+  auto copy = brush;
+  CHECK(copy.sharesGeometryWith(brush));
+  CHECK(std::ranges::all_of(
+    copy.faces(), [](const auto& face) { return face.geometry() != nullptr; }));
+  CHECK(copy.memoryUsage() < unsharedMemoryUsage);
+  CHECK(brush.memoryUsage() < unsharedMemoryUsage);
+
+  SECTION("Modifying face attributes keeps the geometry shared")
+  {
+    auto& face = copy.face(0);
+    auto attributes = face.attributes();
+    attributes.setXOffset(16.0f);
+    face.setAttributes(attributes);
+
+    CHECK(copy.sharesGeometryWith(brush));
+  }
+
+  SECTION("Transforming a copy replaces its geometry")
+  {
+    const auto transform = vm::translation_matrix(vm::vec3d{16, 0, 0});
+    REQUIRE(copy.transform(worldBounds, transform, false).is_success());
+
+    CHECK_FALSE(copy.sharesGeometryWith(brush));
+    CHECK(brush.memoryUsage() == unsharedMemoryUsage);
+    CHECK(brush.bounds() == vm::bbox3d{32.0});
+    CHECK(copy.bounds() == vm::bbox3d{32.0}.translate(vm::vec3d{16, 0, 0}));
+  }
+}
+
+TEST_CASE("BrushTest.translate")
+{
+  const auto worldBounds = vm::bbox3d{4096.0};
+
+  const auto format = GENERATE(MapFormat::Valve, MapFormat::Standard);
+  const auto lockMaterials = GENERATE(false, true);
+  const auto delta = GENERATE(vm::vec3d{16, -8, 32}, vm::vec3d{0.5, 0.25, -1});
+
+  CAPTURE(format, lockMaterials, delta);
+
+  const auto brushBuilder = BrushBuilder{format, worldBounds};
+  const auto brush =
+    brushBuilder.createCuboid(
+      vm::bbox3d{vm::vec3d{-32, -16, 0}, vm::vec3d{48, 64, 40}}, "material")
+    | kdl::value();
+
+  // rebuild the geometry from the translated faces to obtain the expected brush
+  auto expectedFaces = brush.faces();
+  for (auto& face : expectedFaces)
+  {
+    REQUIRE(face.transform(vm::translation_matrix(delta), lockMaterials).is_success());
+  }
+  const auto expectedBrush = Brush::create(worldBounds, expectedFaces) | kdl::value();
+
+  auto translatedBrush = brush;
+
+  SECTION("translate")
+  {
+    REQUIRE(translatedBrush.translate(worldBounds, delta, lockMaterials).is_success());
+  }
+
+  SECTION("transform with a translation matrix")
+  {
+    REQUIRE(translatedBrush
+              .transform(worldBounds, vm::translation_matrix(delta), lockMaterials)
+              .is_success());
+  }
+
+  CHECK(translatedBrush == expectedBrush);
+  CHECK(translatedBrush.bounds() == expectedBrush.bounds());
+  CHECK(
+    kdl::vec_sort(translatedBrush.vertexPositions())
+    == kdl::vec_sort(expectedBrush.vertexPositions()));
+
+  for (size_t i = 0; i < translatedBrush.faceCount(); ++i)
+  {
+    const auto& face = translatedBrush.face(i);
+    const auto& expectedFace = expectedBrush.face(i);
+    CHECK(face.uAxis() == expectedFace.uAxis());
+    CHECK(face.vAxis() == expectedFace.vAxis());
+    CHECK(
+      kdl::vec_sort(face.vertexPositions())
+      == kdl::vec_sort(expectedFace.vertexPositions()));
+  }
+}
+
+TEST_CASE("BrushTest.translateOutOfWorldBounds")
+{
+  const auto worldBounds = vm::bbox3d{4096.0};
+
+  const auto brushBuilder = BrushBuilder{MapFormat::Valve, worldBounds};
+  auto brush = brushBuilder.createCube(64.0, "material") | kdl::value();
+
+  SECTION("Touching the world bounds")
+  {
+    CHECK(brush.translate(worldBounds, vm::vec3d{4064, 0, 0}, false).is_error());
+  }
+
+  SECTION("Leaving the world bounds")
+  {
+    CHECK(brush.translate(worldBounds, vm::vec3d{4096, 0, 0}, false).is_error());
+  }
+}
+
 TEST_CASE("BrushTest.clip")
 {
   const auto worldBounds = vm::bbox3d{4096.0};
@@ -596,6 +596,25 @@ TEST_CASE("BrushFace")
     CHECK(face.vAxis() == vm::approx{newYAxis});
   }
 
+  SECTION("modifyingCopyDoesNotAffectOriginal")
+  {
+    const auto worldBounds = vm::bbox3d{8192.0};
+
+    auto builder = BrushBuilder{MapFormat::Valve, worldBounds};
+    auto cube = builder.createCube(128.0, "") | kdl::value();
+    const auto& original = cube.faces().front();
+
+    const auto originalUAxis = original.uAxis();
+    const auto originalVAxis = original.vAxis();
+
+    auto copy = original;
+    copy.rotateUV(45.0f);
+
+    CHECK(copy.uAxis() != vm::approx{originalUAxis});
+    CHECK(original.uAxis() == originalUAxis);
+    CHECK(original.vAxis() == originalVAxis);
+  }
+
   SECTION("testAlignmentLock_Paraxial")
   {
     const auto worldBounds = vm::bbox3d{8192.0};
@@ -30,6 +30,7 @@
 #include "mdl/LockState.h"
 #include "mdl/MapFormat.h"
 #include "mdl/PatchNode.h"
+#include "mdl/Tag.h"
 #include "mdl/VisibilityState.h"
 #include "mdl/WorldNode.h"
 
@@ -1203,4 +1204,108 @@ TEST_CASE_METHOD(EditorContextTest, "EditorContextTest.testGroupedNodes")
   }
 }
 
+TEST_CASE_METHOD(EditorContextTest, "EditorContextTest.cachedState")
+{
+  auto* layerNode = worldNode.defaultLayer();
+  auto* brushNode = createTopLevelBrush();
+  auto* entityNode = createTopLevelPointEntity();
+
+  REQUIRE(context.visible(brushNode));
+  REQUIRE(context.editable(brushNode));
+  REQUIRE(context.visible(entityNode));
+
+  SECTION("Changing the visibility state of a node")
+  {
+    brushNode->setVisibilityState(V_Hidden);
+    CHECK_FALSE(context.visible(brushNode));
+    CHECK(context.visible(entityNode));
+  }
+
+  SECTION("Changing the visibility state of an ancestor")
+  {
+    layerNode->setVisibilityState(V_Hidden);
+    CHECK_FALSE(context.visible(brushNode));
+    CHECK_FALSE(context.visible(entityNode));
+  }
+
+  SECTION("Changing the lock state of an ancestor")
+  {
+    layerNode->setLockState(L_Locked);
+    CHECK_FALSE(context.editable(brushNode));
+    CHECK_FALSE(context.editable(entityNode));
+  }
+
+  SECTION("Selecting a hidden node")
+  {
+    brushNode->setVisibilityState(V_Hidden);
+    REQUIRE_FALSE(context.visible(brushNode));
+
+    brushNode->select();
+    CHECK(context.visible(brushNode));
+  }
+
+  SECTION("Changing the tags of a node")
+  {
+    auto tag = Tag{"tag", {}};
+    tag.setIndex(0);
+
+    context.setHiddenTags(tag.type());
+    REQUIRE(context.visible(brushNode));
+
+    brushNode->addTag(tag);
+    CHECK_FALSE(context.visible(brushNode));
+
+    brushNode->removeTag(tag);
+    CHECK(context.visible(brushNode));
+  }
+
+  SECTION("Changing the hidden tags")
+  {
+    auto tag = Tag{"tag", {}};
+    tag.setIndex(0);
+
+    brushNode->addTag(tag);
+    REQUIRE(context.visible(brushNode));
+
+    context.setHiddenTags(tag.type());
+    CHECK_FALSE(context.visible(brushNode));
+  }
+
+  SECTION("Changing a preference")
+  {
+    const auto setPref = TemporarilySetPref{Preferences::ShowBrushes, false};
+    PreferenceManager::instance().preferenceDidChangeNotifier(
+      Preferences::ShowBrushes.path());
+
+    CHECK_FALSE(context.visible(brushNode));
+    CHECK(context.visible(entityNode));
+  }
+
+  SECTION("Adding a child to a group")
+  {
+    auto [groupNode, groupedBrushNode] = createGroupedBrush();
+    groupedBrushNode->setVisibilityState(V_Hidden);
+    REQUIRE_FALSE(context.visible(groupNode));
+
+    BrushBuilder builder(worldNode.mapFormat(), worldBounds);
+    groupNode->addChild(
+      new BrushNode{builder.createCube(16.0, "sometex") | kdl::value()});
+    CHECK(context.visible(groupNode));
+  }
+
+  SECTION("Reusing the index of a destroyed node")
+  {
+    brushNode->setVisibilityState(V_Hidden);
+    REQUIRE_FALSE(context.visible(brushNode));
+
+    const auto index = brushNode->index();
+    layerNode->removeChild(brushNode);
+    delete brushNode;
+
+    auto otherEntityNode = EntityNode{Entity{}};
+    REQUIRE(otherEntityNode.index() == index);
+    CHECK(context.visible(&otherEntityNode));
+  }
+}
+
 } // namespace tb::mdl
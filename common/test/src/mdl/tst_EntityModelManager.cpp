@@ -0,0 +1,97 @@
+/*
+ Copyright (C) 2010 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Exceptions.h"
+#include "Logger.h"
+#include "TestLogger.h"
+#include "TestUtils.h"
+#include "mdl/EntityModel.h"
+#include "mdl/EntityModelManager.h"
+#include "mdl/Game.h" // IWYU pragma: keep
+#include "mdl/GameConfig.h" // IWYU pragma: keep
+#include "mdl/ModelSpecification.h"
+#include "mdl/Resource.h"
+
+#include "kdl/task_manager.h"
+
+#include <filesystem>
+#include <memory>
+
+#include "Catch2.h"
+
+namespace tb::mdl
+{
+
+TEST_CASE("EntityModelManager")
+{
+  auto logger = TestLogger{};
+  auto taskManager = kdl::task_manager{};
+  auto [game, gameConfig] = loadGame("Quake");
+
+  // the resources are loaded when they are processed or prefetched
+  auto manager = EntityModelManager{
+    [](auto resourceLoader) {
+      return std::make_shared<EntityModelDataResource>(std::move(resourceLoader));
+    },
+    logger};
+
+  const auto modelPath = std::filesystem::path{"cube.bsp"};
+  const auto missingModelPath = std::filesystem::path{"does_not_exist.mdl"};
+
+  SECTION("Prefetching loads the model data")
+  {
+    manager.setGame(game.get(), taskManager);
+    manager.prefetchModels({modelPath}, taskManager);
+
+    const auto* model = manager.model(modelPath);
+    REQUIRE(model != nullptr);
+    CHECK(model->data() != nullptr);
+    CHECK(manager.frame(ModelSpecification{modelPath, 0, 0}) != nullptr);
+  }
+
+  SECTION("A model that fails to load is logged once")
+  {
+    manager.setGame(game.get(), taskManager);
+
+    const auto errorCount = logger.countMessages(LogLevel::Error);
+    manager.prefetchModels({modelPath, missingModelPath}, taskManager);
+    CHECK(logger.countMessages(LogLevel::Error) == errorCount + 1);
+
+    const auto* missingModel = manager.model(missingModelPath);
+    REQUIRE(missingModel != nullptr);
+    CHECK(missingModel->data() == nullptr);
+    CHECK(manager.frame(ModelSpecification{missingModelPath, 0, 0}) == nullptr);
+
+    manager.prefetchModels({missingModelPath}, taskManager);
+    CHECK(logger.countMessages(LogLevel::Error) == errorCount + 1);
+  }
+
+  SECTION("A model that cannot be created is logged once")
+  {
+    // without a game, no model can be created
+    manager.prefetchModels({modelPath}, taskManager);
+    CHECK(logger.countMessages(LogLevel::Error) == 1);
+
+    CHECK_THROWS_AS(manager.model(modelPath), GameException);
+    CHECK(manager.frame(ModelSpecification{modelPath, 0, 0}) == nullptr);
+    CHECK(logger.countMessages(LogLevel::Error) == 1);
+  }
+}
+
+} // namespace tb::mdl
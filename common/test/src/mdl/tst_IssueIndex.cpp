@@ -0,0 +1,260 @@
+/*
+ Copyright (C) 2010 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mdl/BrushBuilder.h"
+#include "mdl/BrushNode.h"
+#include "mdl/Entity.h"
+#include "mdl/EntityNode.h"
+#include "mdl/EntityProperties.h"
+#include "mdl/Issue.h"
+#include "mdl/IssueIndex.h"
+#include "mdl/LayerNode.h"
+#include "mdl/LinkTargetValidator.h"
+#include "mdl/MapFormat.h"
+#include "mdl/Validator.h"
+#include "mdl/WorldNode.h"
+
+#include "kdl/result.h"
+#include "kdl/task_manager.h"
+#include "kdl/vector_utils.h"
+
+#include <algorithm>
+#include <unordered_set>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace tb::mdl
+{
+namespace
+{
+
+const auto Type1 = freeIssueType();
+const auto Type2 = freeIssueType();
+
+/**
+ * Reports an issue for every brush or entity that is contained in the given set.
+ */
+class TestValidator : public Validator
+{
+private:
+  const std::unordered_set<const Node*>& m_nodesWithIssues;
+
+public:
+  TestValidator(
+    const IssueType type, const std::unordered_set<const Node*>& nodesWithIssues)
+    : Validator{type, "test"}
+    , m_nodesWithIssues{nodesWithIssues}
+  {
+  }
+
+private:
+  void doValidate(
+    EntityNode& entityNode, std::vector<std::unique_ptr<Issue>>& issues) const override
+  {
+    validateNode(entityNode, issues);
+  }
+
+  void doValidate(
+    BrushNode& brushNode, std::vector<std::unique_ptr<Issue>>& issues) const override
+  {
+    validateNode(brushNode, issues);
+  }
+
+  void validateNode(Node& node, std::vector<std::unique_ptr<Issue>>& issues) const
+  {
+    if (m_nodesWithIssues.contains(&node))
+    {
+      issues.push_back(std::make_unique<Issue>(type(), node, "test"));
+    }
+  }
+};
+
+std::vector<Node*> issueNodes(const std::vector<const Issue*>& issues)
+{
+  return kdl::vec_transform(issues, [](const auto* issue) { return &issue->node(); });
+}
+
+} // namespace
+
+TEST_CASE("IssueIndex")
+{
+  constexpr auto worldBounds = vm::bbox3d{8192.0};
+  constexpr auto mapFormat = MapFormat::Quake3;
+
+  auto taskManager = kdl::task_manager{};
+
+  auto nodesWithType1 = std::unordered_set<const Node*>{};
+  auto nodesWithType2 = std::unordered_set<const Node*>{};
+  const auto validator1 = TestValidator{Type1, nodesWithType1};
+  const auto validator2 = TestValidator{Type2, nodesWithType2};
+
+  auto worldNode = WorldNode{{}, {}, mapFormat};
+  auto* layerNode = worldNode.defaultLayer();
+
+  auto builder = BrushBuilder{mapFormat, worldBounds};
+  auto* brushNode1 = new BrushNode{builder.createCube(64.0, "material") | kdl::value()};
+  auto* brushNode2 = new BrushNode{builder.createCube(32.0, "material") | kdl::value()};
+  auto* entityNode = new EntityNode{Entity{}};
+  layerNode->addChildren({brushNode1, brushNode2, entityNode});
+
+  nodesWithType1 = {brushNode1, entityNode};
+  nodesWithType2 = {brushNode2};
+
+  auto index = IssueIndex{};
+  index.reset(worldNode, {&validator1, &validator2});
+  CHECK(index.hasDirtyNodes());
+  CHECK(index.issues(Type1).empty());
+
+  index.validate(taskManager);
+  CHECK_FALSE(index.hasDirtyNodes());
+
+  CHECK_THAT(
+    issueNodes(index.issues(Type1)),
+    Catch::Matchers::UnorderedEquals(std::vector<Node*>{brushNode1, entityNode}));
+  CHECK_THAT(
+    issueNodes(index.issues(Type2)),
+    Catch::Matchers::UnorderedEquals(std::vector<Node*>{brushNode2}));
+  CHECK_THAT(
+    issueNodes(index.issues(Type1 | Type2)),
+    Catch::Matchers::UnorderedEquals(
+      std::vector<Node*>{brushNode1, brushNode2, entityNode}));
+
+  SECTION("Issues are sorted by descending sequence ID")
+  {
+    const auto issues = index.issues(Type1 | Type2);
+    CHECK(std::ranges::is_sorted(issues, [](const auto* lhs, const auto* rhs) {
+      return lhs->seqId() > rhs->seqId();
+    }));
+  }
+
+  SECTION("Only invalidated nodes are validated again")
+  {
+    nodesWithType1 = {brushNode2};
+
+    brushNode1->invalidateIssues();
+    index.invalidateNodes({brushNode1});
+    CHECK(index.hasDirtyNodes());
+    index.validate(taskManager);
+
+    // brushNode2 was not invalidated, so its issues are unchanged
+    CHECK_THAT(
+      issueNodes(index.issues(Type1)),
+      Catch::Matchers::UnorderedEquals(std::vector<Node*>{entityNode}));
+
+    brushNode2->invalidateIssues();
+    index.invalidateNodes({brushNode2});
+    index.validate(taskManager);
+
+    CHECK_THAT(
+      issueNodes(index.issues(Type1)),
+      Catch::Matchers::UnorderedEquals(std::vector<Node*>{brushNode2, entityNode}));
+    CHECK_THAT(
+      issueNodes(index.issues(Type2)),
+      Catch::Matchers::UnorderedEquals(std::vector<Node*>{brushNode2}));
+  }
+
+  SECTION("Added nodes are validated")
+  {
+    auto* brushNode3 =
+      new BrushNode{builder.createCube(16.0, "material") | kdl::value()};
+    nodesWithType2.insert(brushNode3);
+
+    layerNode->addChild(brushNode3);
+    index.addNodes({brushNode3});
+    index.validate(taskManager);
+
+    CHECK_THAT(
+      issueNodes(index.issues(Type2)),
+      Catch::Matchers::UnorderedEquals(std::vector<Node*>{brushNode2, brushNode3}));
+  }
+
+  SECTION("Removed nodes are removed from the index")
+  {
+    index.removeNodes({brushNode1});
+    layerNode->removeChild(brushNode1);
+    index.validate(taskManager);
+
+    CHECK_THAT(
+      issueNodes(index.issues(Type1)),
+      Catch::Matchers::UnorderedEquals(std::vector<Node*>{entityNode}));
+
+    delete brushNode1;
+  }
+
+  SECTION("Clearing the index removes all issues")
+  {
+    index.clear();
+    CHECK_FALSE(index.hasDirtyNodes());
+    CHECK(index.issues(Type1 | Type2).empty());
+  }
+}
+
+TEST_CASE("IssueIndex.linkedEntities")
+{
+  auto taskManager = kdl::task_manager{};
+
+  const auto validator = LinkTargetValidator{};
+
+  auto worldNode = WorldNode{{}, {}, MapFormat::Quake3};
+  auto* layerNode = worldNode.defaultLayer();
+
+  auto* sourceNode = new EntityNode{Entity{{{EntityPropertyKeys::Target, "a"}}}};
+  auto* targetNode = new EntityNode{Entity{{{EntityPropertyKeys::Targetname, "a"}}}};
+  layerNode->addChildren({sourceNode, targetNode});
+
+  auto index = IssueIndex{};
+  index.reset(worldNode, {&validator});
+  index.validate(taskManager);
+  REQUIRE(index.issues(validator.type()).empty());
+
+  SECTION("Removing a link target validates its link sources")
+  {
+    index.removeNodes({targetNode});
+    layerNode->removeChild(targetNode);
+    CHECK(index.hasDirtyNodes());
+    index.validate(taskManager);
+
+    CHECK(
+      issueNodes(index.issues(validator.type())) == std::vector<Node*>{sourceNode});
+
+    SECTION("Adding the link target again validates its link sources")
+    {
+      layerNode->addChild(targetNode);
+      index.addNodes({targetNode});
+      index.validate(taskManager);
+
+      CHECK(index.issues(validator.type()).empty());
+    }
+
+    SECTION("Removing the link source removes its issues")
+    {
+      index.removeNodes({sourceNode});
+      layerNode->removeChild(sourceNode);
+      index.validate(taskManager);
+
+      CHECK(index.issues(validator.type()).empty());
+
+      delete sourceNode;
+      delete targetNode;
+    }
+  }
+}
+
+} // namespace tb::mdl
@@ -0,0 +1,127 @@
+/*
+ Copyright (C) 2010 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mdl/MaterialName.h"
+
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace tb::mdl
+{
+
+TEST_CASE("MaterialName")
+{
+  SECTION("Default constructed names are empty")
+  {
+    CHECK(MaterialName{}.str() == "");
+    CHECK(MaterialName{} == MaterialName{""});
+  }
+
+  SECTION("Equal names are interned once")
+  {
+    const auto name = std::string{"some_material"};
+    const auto lhs = MaterialName{name};
+    const auto rhs = MaterialName{"some_material"};
+
+    CHECK(lhs.str() == name);
+    CHECK(lhs == rhs);
+    CHECK(lhs.id() == rhs.id());
+    CHECK(&lhs.str() == &rhs.str());
+    CHECK(std::hash<MaterialName>{}(lhs) == std::hash<MaterialName>{}(rhs));
+  }
+
+  SECTION("Names are case sensitive")
+  {
+    const auto lower = MaterialName{"base/wall"};
+    const auto mixed = MaterialName{"Base/Wall"};
+    const auto upper = MaterialName{"BASE/WALL"};
+
+    CHECK(mixed.str() == "Base/Wall");
+    CHECK(lower != mixed);
+    CHECK(mixed != upper);
+    CHECK(lower.id() != mixed.id());
+
+    CHECK(lower.foldedId() == lower.id());
+    CHECK(mixed.foldedId() == lower.id());
+    CHECK(upper.foldedId() == lower.id());
+    CHECK(MaterialName{"base/floor"}.foldedId() != lower.foldedId());
+  }
+
+  SECTION("Finding a name does not intern it")
+  {
+    CHECK(MaterialName::find("find/not_interned") == std::nullopt);
+    CHECK(MaterialName::find("find/not_interned") == std::nullopt);
+
+    const auto name = MaterialName{"find/Interned"};
+    CHECK(MaterialName::find("find/Interned") == name);
+
+    // interning a name also interns its lowercase variant
+    const auto foldedName = MaterialName::find("find/interned");
+    REQUIRE(foldedName != std::nullopt);
+    CHECK(foldedName->id() == name.foldedId());
+    CHECK(MaterialName::find("FIND/INTERNED") == std::nullopt);
+  }
+
+  SECTION("Names are ordered lexicographically")
+  {
+    CHECK(MaterialName{"b"} < MaterialName{"c"});
+    CHECK(MaterialName{"B"} < MaterialName{"b"});
+    CHECK(MaterialName{"bc"} > MaterialName{"b"});
+    CHECK((MaterialName{"b"} <=> MaterialName{"b"}) == std::strong_ordering::equal);
+  }
+
+  SECTION("Names can be interned concurrently")
+  {
+    constexpr auto NumThreads = size_t(4);
+    constexpr auto NumNames = size_t(1000);
+
+    auto results = std::vector<std::vector<MaterialName>>(NumThreads);
+    auto threads = std::vector<std::thread>{};
+    for (size_t i = 0; i < NumThreads; ++i)
+    {
+      threads.emplace_back([&, i]() {
+        for (size_t j = 0; j < NumNames; ++j)
+        {
+          results[i].emplace_back("concurrent/MATERIAL_" + std::to_string(j));
+        }
+      });
+    }
+
+    for (auto& thread : threads)
+    {
+      thread.join();
+    }
+
+    for (size_t j = 0; j < NumNames; ++j)
+    {
+      const auto expected = MaterialName{"concurrent/material_" + std::to_string(j)};
+      for (size_t i = 0; i < NumThreads; ++i)
+      {
+        CHECK(results[i][j] == results[0][j]);
+        CHECK(results[i][j].foldedId() == expected.id());
+      }
+    }
+  }
+}
+
+} // namespace tb::mdl
@@ -0,0 +1,101 @@
+/*
+ Copyright (C) 2010 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mdl/Material.h"
+#include "mdl/MaterialNameIndex.h"
+#include "mdl/Texture.h"
+#include "mdl/TextureResource.h"
+
+#include "kdl/vector_utils.h"
+
+#include <string>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace tb::mdl
+{
+namespace
+{
+
+std::vector<Material> makeMaterials(const std::vector<std::string>& names)
+{
+  return kdl::vec_transform(names, [](const auto& name) {
+    return Material{name, createTextureResource(Texture{16, 16})};
+  });
+}
+
+} // namespace
+
+TEST_CASE("MaterialNameIndex")
+{
+  const auto materials = makeMaterials({
+    "base/wall_01",
+    "base/WALL_02",
+    "base/floor_01",
+    "tech/walltrim",
+    "tech/light",
+  });
+
+  const auto index = MaterialNameIndex{materials};
+  CHECK(index.materialCount() == 5);
+
+  SECTION("Empty index")
+  {
+    CHECK(MaterialNameIndex{}.materialCount() == 0);
+    CHECK(MaterialNameIndex{}.findMaterials("wall").empty());
+    CHECK(MaterialNameIndex{}.findMaterials("").empty());
+  }
+
+  SECTION("Finds substrings ignoring case")
+  {
+    CHECK(index.findMaterials("wall") == std::vector<size_t>{0, 1, 3});
+    CHECK(index.findMaterials("WALL_0") == std::vector<size_t>{0, 1});
+    CHECK(index.findMaterials("base/") == std::vector<size_t>{0, 1, 2});
+    CHECK(index.findMaterials("_01") == std::vector<size_t>{0, 2});
+    CHECK(index.findMaterials("tech/light") == std::vector<size_t>{4});
+  }
+
+  SECTION("Finds short strings")
+  {
+    CHECK(index.findMaterials("") == std::vector<size_t>{0, 1, 2, 3, 4});
+    CHECK(index.findMaterials("l") == std::vector<size_t>{0, 1, 2, 3, 4});
+    CHECK(index.findMaterials("Fl") == std::vector<size_t>{2});
+    CHECK(index.findMaterials("xy").empty());
+  }
+
+  SECTION("Requires all trigrams to be present in order")
+  {
+    CHECK(index.findMaterials("wallx").empty());
+    // every trigram occurs in "base/wall_01", but not the entire string
+    CHECK(index.findMaterials("all_all").empty());
+    CHECK(index.findMaterials("base/wall_01x").empty());
+  }
+
+  SECTION("Narrows down candidates")
+  {
+    const auto candidates = index.findMaterials("wall");
+    CHECK(index.findMaterials("wall_", candidates) == std::vector<size_t>{0, 1});
+    CHECK(index.findMaterials("trim", candidates) == std::vector<size_t>{3});
+    CHECK(index.findMaterials("floor", candidates).empty());
+    CHECK(index.findMaterials("", candidates) == candidates);
+  }
+}
+
+} // namespace tb::mdl
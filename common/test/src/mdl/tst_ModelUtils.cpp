@@ -599,6 +599,40 @@ TEST_CASE("ModelUtils.computePhysicalBounds")
     == vm::bbox3d{vm::vec3d{-8, -32, -32}, vm::vec3d{96, 32, 32}});
 }
 
+TEST_CASE("ModelUtils.computeMemoryUsage")
+{
+  constexpr auto worldBounds = vm::bbox3d{8192.0};
+  constexpr auto mapFormat = MapFormat::Quake3;
+
+  auto groupNode = GroupNode{Group{"group"}};
+  auto* entityNode = new EntityNode{Entity{{{"classname", "info_player_start"}}}};
+  auto* brushNode = new BrushNode{
+    BrushBuilder{mapFormat, worldBounds}.createCube(64.0, "material") | kdl::value()};
+
+  // clang-format off
+  auto* patchNode = new PatchNode{BezierPatch{3, 3, {
+    {0, 0, 0}, {1, 0, 1}, {2, 0, 0},
+    {0, 1, 1}, {1, 1, 2}, {2, 1, 1},
+    {0, 2, 0}, {1, 2, 1}, {2, 2, 0} }, "material"}};
+  // clang-format on
+
+  groupNode.addChildren({entityNode, brushNode, patchNode});
+
+  CHECK(computeMemoryUsage({}) == 0);
+  CHECK(
+    computeMemoryUsage({entityNode})
+    == sizeof(EntityNode) + entityNode->entity().memoryUsage());
+  CHECK(
+    computeMemoryUsage({brushNode})
+    == sizeof(BrushNode) + brushNode->brush().memoryUsage());
+  CHECK(
+    computeMemoryUsage({patchNode})
+    > sizeof(PatchNode) + patchNode->patch().memoryUsage());
+  CHECK(
+    computeMemoryUsage({&groupNode})
+    > computeMemoryUsage({entityNode, brushNode, patchNode}) + sizeof(GroupNode));
+}
+
 TEST_CASE("ModelUtils.filterNodes")
 {
   constexpr auto worldBounds = vm::bbox3d{8192.0};
@@ -17,9 +17,12 @@
  along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include "Color.h"
 #include "Result.h"
 #include "io/DiskIO.h"
+#include "io/Reader.h"
 #include "mdl/Palette.h"
+#include "mdl/TextureBuffer.h"
 
 #include "kdl/result.h"
 
@@ -28,45 +31,97 @@
 namespace tb::mdl
 {
 
+namespace
+{
+
+/**
+ * Pads the given RGBA data to 256 entries with the given color.
+ */
+std::vector<unsigned char> pad(
+  std::vector<unsigned char> data, const std::vector<unsigned char>& color)
+{
+  while (data.size() < 1024)
+  {
+    data.insert(data.end(), color.begin(), color.end());
+  }
+  return data;
+}
+
+std::vector<unsigned char> padOpaque(std::vector<unsigned char> data)
+{
+  return pad(std::move(data), {0x00, 0x00, 0x00, 0xFF});
+}
+
+std::vector<unsigned char> padIndex255Transparent(std::vector<unsigned char> data)
+{
+  data = padOpaque(std::move(data));
+  data[4 * 255 + 3] = 0x00;
+  return data;
+}
+
+std::vector<unsigned char> padTransparent(std::vector<unsigned char> data)
+{
+  data.resize(1024, 0x00);
+  return data;
+}
+
+} // namespace
+
 TEST_CASE("makePalette")
 {
   using T =
     std::tuple<std::vector<unsigned char>, PaletteColorFormat, Result<PaletteData>>;
 
+  // clang-format off
   const auto [data, colorFormat, expectedResult] = GENERATE(values<T>({
-    {{}, PaletteColorFormat::Rgb, Result<PaletteData>{PaletteData{{}, {}}}},
-    {{0xF0}, PaletteColorFormat::Rgb, Result<PaletteData>{PaletteData{{}, {}}}},
-    {{0xF0, 0xF1}, PaletteColorFormat::Rgb, Result<PaletteData>{PaletteData{{}, {}}}},
+    {{},
+     PaletteColorFormat::Rgb,
+     Result<PaletteData>{PaletteData{padOpaque({}), padIndex255Transparent({})}}},
+    {{0xF0},
+     PaletteColorFormat::Rgb,
+     Result<PaletteData>{PaletteData{padOpaque({}), padIndex255Transparent({})}}},
+    {{0xF0, 0xF1},
+     PaletteColorFormat::Rgb,
+     Result<PaletteData>{PaletteData{padOpaque({}), padIndex255Transparent({})}}},
     {{0xF0, 0xF1, 0xF2},
      PaletteColorFormat::Rgb,
-     Result<PaletteData>{
-       PaletteData{{0xF0, 0xF1, 0xF2, 0xFF}, {0xF0, 0xF1, 0xF2, 0x00}}}},
+     Result<PaletteData>{PaletteData{
+       padOpaque({0xF0, 0xF1, 0xF2, 0xFF}),
+       padIndex255Transparent({0xF0, 0xF1, 0xF2, 0xFF})}}},
     {{0xF0, 0xF1, 0xF2, 0xF3},
      PaletteColorFormat::Rgb,
-     Result<PaletteData>{
-       PaletteData{{0xF0, 0xF1, 0xF2, 0xFF}, {0xF0, 0xF1, 0xF2, 0x00}}}},
+     Result<PaletteData>{PaletteData{
+       padOpaque({0xF0, 0xF1, 0xF2, 0xFF}),
+       padIndex255Transparent({0xF0, 0xF1, 0xF2, 0xFF})}}},
     {{0xF0, 0xF1, 0xF2, 0xF3, 0xF4},
      PaletteColorFormat::Rgb,
-     Result<PaletteData>{
-       PaletteData{{0xF0, 0xF1, 0xF2, 0xFF}, {0xF0, 0xF1, 0xF2, 0x00}}}},
+     Result<PaletteData>{PaletteData{
+       padOpaque({0xF0, 0xF1, 0xF2, 0xFF}),
+       padIndex255Transparent({0xF0, 0xF1, 0xF2, 0xFF})}}},
     {{0xF0, 0xF1, 0xF2, 0xF3, 0xF4, 0xF5},
      PaletteColorFormat::Rgb,
      Result<PaletteData>{PaletteData{
-       {0xF0, 0xF1, 0xF2, 0xFF, 0xF3, 0xF4, 0xF5, 0xFF},
-       {0xF0, 0xF1, 0xF2, 0xFF, 0xF3, 0xF4, 0xF5, 0x00}}}},
+       padOpaque({0xF0, 0xF1, 0xF2, 0xFF, 0xF3, 0xF4, 0xF5, 0xFF}),
+       padIndex255Transparent({0xF0, 0xF1, 0xF2, 0xFF, 0xF3, 0xF4, 0xF5, 0xFF})}}},
 
-    {{}, PaletteColorFormat::Rgba, Result<PaletteData>{PaletteData{{}, {}}}},
-    {{0xF0}, PaletteColorFormat::Rgba, Result<PaletteData>{PaletteData{{0xF0}, {0xF0}}}},
+    {{},
+     PaletteColorFormat::Rgba,
+     Result<PaletteData>{PaletteData{padTransparent({}), padTransparent({})}}},
+    {{0xF0},
+     PaletteColorFormat::Rgba,
+     Result<PaletteData>{PaletteData{padTransparent({0xF0}), padTransparent({0xF0})}}},
     {{0xF0, 0xF1, 0xF2, 0xFE},
      PaletteColorFormat::Rgba,
-     Result<PaletteData>{
-       PaletteData{{0xF0, 0xF1, 0xF2, 0xFE}, {0xF0, 0xF1, 0xF2, 0xFE}}}},
+     Result<PaletteData>{PaletteData{
+       padTransparent({0xF0, 0xF1, 0xF2, 0xFE}),
+       padTransparent({0xF0, 0xF1, 0xF2, 0xFE})}}},
     {{0xF0, 0xF1, 0xF2, 0xFE, 0xF3, 0xF4, 0xF5, 0xFE},
      PaletteColorFormat::Rgba,
      Result<PaletteData>{PaletteData{
-       {0xF0, 0xF1, 0xF2, 0xFE, 0xF3, 0xF4, 0xF5, 0xFE},
-       {0xF0, 0xF1, 0xF2, 0xFE, 0xF3, 0xF4, 0xF5, 0xFE}}}},
+       padTransparent({0xF0, 0xF1, 0xF2, 0xFE, 0xF3, 0xF4, 0xF5, 0xFE}),
+       padTransparent({0xF0, 0xF1, 0xF2, 0xFE, 0xF3, 0xF4, 0xF5, 0xFE})}}},
   }));
+  // clang-format on
 
   CAPTURE(data, colorFormat);
 
@@ -80,6 +135,54 @@ TEST_CASE("makePalette")
   CHECK(makePalette(data, colorFormat) == expectedPalette);
 }
 
+TEST_CASE("Palette.indexedToRgba")
+{
+  // a palette with only two colors
+  const auto palette =
+    makePalette({0x10, 0x20, 0x30, 0x40, 0x50, 0x60}, PaletteColorFormat::Rgb)
+    | kdl::value();
+
+  const auto indices = std::vector<unsigned char>{0x00, 0x01, 0x02, 0xFF};
+  auto reader = io::Reader::from(
+    reinterpret_cast<const char*>(indices.data()),
+    reinterpret_cast<const char*>(indices.data() + indices.size()));
+
+  auto rgbaImage = TextureBuffer{4 * indices.size()};
+  auto averageColor = Color{};
+
+  SECTION("Opaque")
+  {
+    CHECK_FALSE(palette.indexedToRgba(
+      reader, indices.size(), rgbaImage, PaletteTransparency::Opaque, averageColor));
+    CHECK(
+      std::vector<unsigned char>(rgbaImage.data(), rgbaImage.data() + rgbaImage.size())
+      == std::vector<unsigned char>{
+        0x10, 0x20, 0x30, 0xFF, // 0x00
+        0x40, 0x50, 0x60, 0xFF, // 0x01
+        0x00, 0x00, 0x00, 0xFF, // 0x02 is not part of the palette
+        0x00, 0x00, 0x00, 0xFF, // 0xFF is not part of the palette
+      });
+  }
+
+  SECTION("Index 255 transparent")
+  {
+    CHECK(palette.indexedToRgba(
+      reader,
+      indices.size(),
+      rgbaImage,
+      PaletteTransparency::Index255Transparent,
+      averageColor));
+    CHECK(
+      std::vector<unsigned char>(rgbaImage.data(), rgbaImage.data() + rgbaImage.size())
+      == std::vector<unsigned char>{
+        0x10, 0x20, 0x30, 0xFF, // 0x00
+        0x40, 0x50, 0x60, 0xFF, // 0x01
+        0x00, 0x00, 0x00, 0xFF, // 0x02 is not part of the palette
+        0x00, 0x00, 0x00, 0x00, // 0xFF is transparent
+      });
+  }
+}
+
 TEST_CASE("loadPalette")
 {
   using T = std::tuple<std::string, std::vector<unsigned char>>;
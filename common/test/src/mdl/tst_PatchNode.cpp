@@ -160,6 +160,114 @@ TEST_CASE("PatchNode.makePatchGrid")
     == kdl::vec_transform(expectedPoints, [](const auto& p) { return vm::approx{p}; }));
 }
 
+TEST_CASE("PatchNode.computePatchSubdivisions")
+{
+  using CP = BezierPatch::Point;
+  using T = std::tuple<size_t, size_t, std::vector<CP>, size_t, PatchSubdivisions>;
+
+  // clang-format off
+  const auto
+  [r, c,
+    controlPoints,
+    maxSd, expectedSubdivisions] = GENERATE(values<T>({
+  {3, 3, // flat surface on XY plane
+    {CP{0.0, 2.0, 0.0, 0.0, 0.0}, CP{1.0, 2.0, 0.0, 0.5, 0.0}, CP{2.0, 2.0, 0.0, 1.0, 0.0},
+    CP{0.0, 1.0, 0.0, 0.0, 0.5}, CP{1.0, 1.0, 0.0, 0.5, 0.5}, CP{2.0, 1.0, 0.0, 1.0, 0.5},
+    CP{0.0, 0.0, 0.0, 0.0, 1.0}, CP{1.0, 0.0, 0.0, 0.5, 1.0}, CP{2.0, 0.0, 0.0, 1.0, 1.0}, },
+    3, {0, 0}},
+  {3, 3, // flat surface on XY plane with non-linear UV coordinates
+    {CP{0.0, 2.0, 0.0, 0.0, 0.0}, CP{1.0, 2.0, 0.0, 0.25, 0.0}, CP{2.0, 2.0, 0.0, 1.0, 0.0},
+    CP{0.0, 1.0, 0.0, 0.0, 0.5}, CP{1.0, 1.0, 0.0, 0.25, 0.5}, CP{2.0, 1.0, 0.0, 1.0, 0.5},
+    CP{0.0, 0.0, 0.0, 0.0, 1.0}, CP{1.0, 0.0, 0.0, 0.25, 1.0}, CP{2.0, 0.0, 0.0, 1.0, 1.0}, },
+    3, {0, 2}},
+  {3, 3, // arch along the rows
+    {CP{0.0,  0.0, 0.0}, CP{32.0,  0.0, 64.0}, CP{64.0,  0.0, 0.0},
+    CP{0.0, 32.0, 0.0}, CP{32.0, 32.0, 64.0}, CP{64.0, 32.0, 0.0},
+    CP{0.0, 64.0, 0.0}, CP{32.0, 64.0, 64.0}, CP{64.0, 64.0, 0.0}, },
+    3, {0, 3}},
+  {3, 3, // arch along the rows, limited subdivisions
+    {CP{0.0,  0.0, 0.0}, CP{32.0,  0.0, 64.0}, CP{64.0,  0.0, 0.0},
+    CP{0.0, 32.0, 0.0}, CP{32.0, 32.0, 64.0}, CP{64.0, 32.0, 0.0},
+    CP{0.0, 64.0, 0.0}, CP{32.0, 64.0, 64.0}, CP{64.0, 64.0, 0.0}, },
+    2, {0, 2}},
+  {5, 3, // arch along the columns with a flat second surface
+    {CP{0.0,  0.0,  0.0}, CP{32.0,  0.0,  0.0}, CP{64.0,  0.0,  0.0},
+    CP{0.0, 32.0, 64.0}, CP{32.0, 32.0, 64.0}, CP{64.0, 32.0, 64.0},
+    CP{0.0, 64.0,  0.0}, CP{32.0, 64.0,  0.0}, CP{64.0, 64.0,  0.0},
+    CP{0.0, 96.0,  0.0}, CP{32.0, 96.0,  0.0}, CP{64.0, 96.0,  0.0},
+    CP{0.0, 128.0, 0.0}, CP{32.0, 128.0, 0.0}, CP{64.0, 128.0, 0.0}, },
+    3, {3, 0}},
+  {3, 3, // hill surface bulging towards +Z, the flatness and twist errors add up
+    {CP{0.0, 2.0, 0.0}, CP{1.0, 2.0, 0.0}, CP{2.0, 2.0, 0.0},
+    CP{0.0, 1.0, 0.0}, CP{1.0, 1.0, 4.0}, CP{2.0, 1.0, 0.0},
+    CP{0.0, 0.0, 0.0}, CP{1.0, 0.0, 0.0}, CP{2.0, 0.0, 0.0}, },
+    3, {2, 2}},
+  {3, 3, // bump whose curvature along the rows and columns adds up
+    {CP{0.0, 0.0, 0.0}, CP{1.0, 0.0, 1.0}, CP{2.0, 0.0, 0.0},
+    CP{0.0, 1.0, 1.0}, CP{1.0, 1.0, 2.0}, CP{2.0, 1.0, 1.0},
+    CP{0.0, 2.0, 0.0}, CP{1.0, 2.0, 1.0}, CP{2.0, 2.0, 0.0}, },
+    3, {1, 1}},
+  }));
+  // clang-format on
+
+  CAPTURE(r, c, controlPoints, maxSd);
+  CHECK(
+    computePatchSubdivisions(
+      BezierPatch{r, c, controlPoints, "material"}, 0.5, 1.0 / 64.0, maxSd)
+    == expectedSubdivisions);
+}
+
+TEST_CASE("PatchNode.grid")
+{
+  using P = BezierPatch::Point;
+
+  SECTION("Flat patches have one quad per surface")
+  {
+    // clang-format off
+    const auto patchNode = PatchNode{BezierPatch{5, 3, {
+      P{0.0, 4.0, 0.0}, P{1.0, 4.0, 0.0}, P{2.0, 4.0, 0.0},
+      P{0.0, 3.0, 0.0}, P{1.0, 3.0, 0.0}, P{2.0, 3.0, 0.0},
+      P{0.0, 2.0, 0.0}, P{1.0, 2.0, 0.0}, P{2.0, 2.0, 0.0},
+      P{0.0, 1.0, 0.0}, P{1.0, 1.0, 0.0}, P{2.0, 1.0, 0.0},
+      P{0.0, 0.0, 0.0}, P{1.0, 0.0, 0.0}, P{2.0, 0.0, 0.0},
+    }, "material"}};
+    // clang-format on
+
+    CHECK(patchNode.grid().pointRowCount == 3u);
+    CHECK(patchNode.grid().pointColumnCount == 2u);
+  }
+
+  SECTION("Curved patches are subdivided")
+  {
+    // clang-format off
+    const auto patchNode = PatchNode{BezierPatch{3, 3, {
+      P{0.0,  0.0, 0.0}, P{32.0,  0.0, 64.0}, P{64.0,  0.0, 0.0},
+      P{0.0, 32.0, 0.0}, P{32.0, 32.0, 64.0}, P{64.0, 32.0, 0.0},
+      P{0.0, 64.0, 0.0}, P{32.0, 64.0, 64.0}, P{64.0, 64.0, 0.0},
+    }, "material"}};
+    // clang-format on
+
+    CHECK(patchNode.grid().pointRowCount == 2u);
+    CHECK(patchNode.grid().pointColumnCount == 9u);
+  }
+
+  SECTION("Patches curved along their rows and columns are subdivided in both directions")
+  {
+    // clang-format off
+    const auto patchNode = PatchNode{BezierPatch{3, 3, {
+      P{0.0, 0.0, 0.0}, P{1.0, 0.0, 1.0}, P{2.0, 0.0, 0.0},
+      P{0.0, 1.0, 1.0}, P{1.0, 1.0, 2.0}, P{2.0, 1.0, 1.0},
+      P{0.0, 2.0, 0.0}, P{1.0, 2.0, 1.0}, P{2.0, 2.0, 0.0},
+    }, "material"}};
+    // clang-format on
+
+    CHECK(patchNode.grid().pointRowCount == 3u);
+    CHECK(patchNode.grid().pointColumnCount == 3u);
+    CHECK(
+      patchNode.grid().point(1u, 1u).position == vm::approx{vm::vec3d{1.0, 1.0, 1.0}});
+  }
+}
+
 TEST_CASE("PatchNode.pickFlatPatch")
 {
   using P = BezierPatch::Point;
@@ -22,6 +22,9 @@
 #include "mdl/Polyhedron_IO.h" // IWYU pragma: keep
 #include "mdl/Polyhedron_Instantiation.h"
 
+#include "vm/approx.h"
+#include "vm/bbox.h"
+#include "vm/plane.h"
 #include "vm/vec.h"
 #include "vm/vec_io.h"
 
@@ -365,6 +368,110 @@ TEST_CASE("PolyhedronTest.copy")
   CHECK(Polyhedron3d{p1, p2, p3, p4} == (Polyhedron3d{} = Polyhedron3d{p1, p2, p3, p4}));
 }
 
+TEST_CASE("PolyhedronTest.fromTopology")
+{
+  const auto original = Polyhedron3d{
+    vm::vec3d{0, 0, 8},
+    vm::vec3d{8, 0, 0},
+    vm::vec3d{-8, 0, 0},
+    vm::vec3d{0, 8, 0},
+    vm::vec3d{0, -8, 0}};
+
+  auto positions = std::vector<vm::vec3d>{};
+  for (const auto* vertex : original.vertices())
+  {
+    positions.push_back(vertex->position());
+  }
+
+  auto faceSizes = std::vector<size_t>{};
+  auto faceVertices = std::vector<size_t>{};
+  auto facePlanes = std::vector<vm::plane3d>{};
+  for (const auto* face : original.faces())
+  {
+    faceSizes.push_back(face->boundary().size());
+    for (const auto* halfEdge : face->boundary())
+    {
+      const auto it = std::ranges::find(positions, halfEdge->origin()->position());
+      faceVertices.push_back(size_t(std::distance(positions.begin(), it)));
+    }
+    facePlanes.push_back(face->plane());
+  }
+
+  SECTION("Restores the polyhedron")
+  {
+    const auto restored =
+      Polyhedron3d::fromTopology(positions, faceSizes, faceVertices, facePlanes);
+    REQUIRE(restored);
+    CHECK(*restored == original);
+    CHECK(restored->bounds() == original.bounds());
+    CHECK(restored->edgeCount() == original.edgeCount());
+    CHECK(restored->closed());
+
+    auto originalFace = original.faces().begin();
+    for (const auto* restoredFace : restored->faces())
+    {
+      CHECK(restoredFace->plane() == (*originalFace)->plane());
+      CHECK(restoredFace->vertexPositions() == (*originalFace)->vertexPositions());
+      ++originalFace;
+    }
+  }
+
+  SECTION("Rejects open surfaces")
+  {
+    faceVertices.resize(faceVertices.size() - faceSizes.back());
+    faceSizes.pop_back();
+    facePlanes.pop_back();
+    CHECK(
+      Polyhedron3d::fromTopology(positions, faceSizes, faceVertices, facePlanes)
+      == std::nullopt);
+  }
+
+  SECTION("Rejects inconsistently oriented faces")
+  {
+    std::reverse(faceVertices.begin(), faceVertices.begin() + long(faceSizes.front()));
+    CHECK(
+      Polyhedron3d::fromTopology(positions, faceSizes, faceVertices, facePlanes)
+      == std::nullopt);
+  }
+
+  SECTION("Rejects invalid vertex indices")
+  {
+    faceVertices.front() = positions.size();
+    CHECK(
+      Polyhedron3d::fromTopology(positions, faceSizes, faceVertices, facePlanes)
+      == std::nullopt);
+  }
+
+  SECTION("Rejects unused vertices")
+  {
+    positions.emplace_back(0, 0, -8);
+    CHECK(
+      Polyhedron3d::fromTopology(positions, faceSizes, faceVertices, facePlanes)
+      == std::nullopt);
+  }
+
+  SECTION("Rejects vertices which are not on their face planes")
+  {
+    const auto it = std::ranges::find(positions, vm::vec3d{0, 0, 8});
+    REQUIRE(it != positions.end());
+    *it = vm::vec3d{0, 0, 9};
+    CHECK(
+      Polyhedron3d::fromTopology(positions, faceSizes, faceVertices, facePlanes)
+      == std::nullopt);
+  }
+
+  SECTION("Rejects non convex geometry")
+  {
+    const auto it = std::ranges::find(faceSizes, size_t(4));
+    REQUIRE(it != faceSizes.end());
+    auto& basePlane = facePlanes[size_t(std::distance(faceSizes.begin(), it))];
+    basePlane = basePlane.flip();
+    CHECK(
+      Polyhedron3d::fromTopology(positions, faceSizes, faceVertices, facePlanes)
+      == std::nullopt);
+  }
+}
+
 TEST_CASE("PolyhedronTest.swap")
 {
   const auto p1 = vm::vec3d{0, 0, 8};
@@ -392,6 +499,26 @@ TEST_CASE("PolyhedronTest.swap")
   CHECK(rhs.bounds() == original.bounds());
 }
 
+TEST_CASE("PolyhedronTest.translate")
+{
+  const auto bounds = vm::bbox3d{vm::vec3d{-8, -8, -8}, vm::vec3d{8, 8, 8}};
+  const auto delta = vm::vec3d{16, -4, 2};
+
+  auto p = Polyhedron3d{bounds};
+  p.translate(delta);
+
+  CHECK(p == Polyhedron3d{bounds.translate(delta)});
+  CHECK(p.bounds() == bounds.translate(delta));
+
+  for (const auto* face : p.faces())
+  {
+    for (const auto& position : face->vertexPositions())
+    {
+      CHECK(face->plane().point_distance(position) == vm::approx{0.0});
+    }
+  }
+}
+
 TEST_CASE("PolyhedronTest.clipCubeWithHorizontalPlane")
 {
   const auto p1 = vm::vec3d{-64, -64, -64};
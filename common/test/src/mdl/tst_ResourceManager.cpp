@@ -25,6 +25,8 @@
 #include "kdl/reflection_impl.h"
 #include "kdl/vector_utils.h"
 
+#include <stdexcept>
+
 #include "Catch2.h"
 
 namespace tb::mdl
@@ -86,8 +88,8 @@ TEST_CASE("ResourceManager")
   {
     CHECK(!resourceManager.needsProcessing());
 
-    auto resource1 = std::make_shared<ResourceT>(mockResourceLoader);
-    resourceManager.addResource(resource1);
+    auto resource1 =
+      resourceManager.addResource(std::make_shared<ResourceT>(mockResourceLoader));
 
     REQUIRE(std::holds_alternative<ResourceUnloaded<MockResource>>(resource1->state()));
     CHECK(resourceManager.needsProcessing());
@@ -105,8 +107,8 @@ TEST_CASE("ResourceManager")
     REQUIRE(std::holds_alternative<ResourceReady<MockResource>>(resource1->state()));
     CHECK(!resourceManager.needsProcessing());
 
-    auto resource2 = std::make_shared<ResourceT>(mockResourceLoader);
-    resourceManager.addResource(resource2);
+    auto resource2 =
+      resourceManager.addResource(std::make_shared<ResourceT>(mockResourceLoader));
     REQUIRE(std::holds_alternative<ResourceReady<MockResource>>(resource1->state()));
     REQUIRE(std::holds_alternative<ResourceUnloaded<MockResource>>(resource2->state()));
     CHECK(resourceManager.needsProcessing());
@@ -144,15 +146,15 @@ TEST_CASE("ResourceManager")
 
   SECTION("addResource")
   {
-    auto resource1 = std::make_shared<ResourceT>(mockResourceLoader);
-    resourceManager.addResource(resource1);
+    auto resource1 =
+      resourceManager.addResource(std::make_shared<ResourceT>(mockResourceLoader));
 
     CHECK(resourceManager.resources() == std::vector{resource1});
-    CHECK(resource1.use_count() == 2);
+    CHECK(resource1.use_count() == 1);
     CHECK(std::holds_alternative<ResourceUnloaded<MockResource>>(resource1->state()));
 
-    auto resource2 = std::make_shared<ResourceT>(mockResourceLoader);
-    resourceManager.addResource(resource2);
+    auto resource2 =
+      resourceManager.addResource(std::make_shared<ResourceT>(mockResourceLoader));
 
     CHECK(resourceManager.resources() == std::vector{resource1, resource2});
   }
@@ -161,10 +163,10 @@ TEST_CASE("ResourceManager")
   {
     SECTION("resource loading")
     {
-      auto resource1 = std::make_shared<ResourceT>(mockResourceLoader);
-      auto resource2 = std::make_shared<ResourceT>(mockResourceLoader);
-      resourceManager.addResource(resource1);
-      resourceManager.addResource(resource2);
+      auto resource1 =
+        resourceManager.addResource(std::make_shared<ResourceT>(mockResourceLoader));
+      auto resource2 =
+        resourceManager.addResource(std::make_shared<ResourceT>(mockResourceLoader));
 
       CHECK(
         resourceManager.process(taskRunner, processContext)
@@ -254,8 +256,10 @@ TEST_CASE("ResourceManager")
       const auto resourceIds = kdl::vec_transform(
         sharedResources, [](const auto& resource) { return resource->id(); });
 
-      resourceManager.addResource(sharedResources[0]);
-      resourceManager.addResource(sharedResources[1]);
+      for (auto& resource : sharedResources)
+      {
+        resource = resourceManager.addResource(std::move(resource));
+      }
 
       resourceManager.process(taskRunner, processContext);
       mockTaskRunner.resolveNextPromise();
@@ -285,6 +289,63 @@ TEST_CASE("ResourceManager")
       CHECK(resourceManager.resources().empty());
       CHECK(mockDropCalls[1] == glContextAvailable);
     }
+
+    SECTION("releasing a resource while it is loading")
+    {
+      auto resource1 =
+        resourceManager.addResource(std::make_shared<ResourceT>(mockResourceLoader));
+
+      resourceManager.process(taskRunner, processContext);
+      REQUIRE(std::holds_alternative<ResourceLoading<MockResource>>(resource1->state()));
+
+      resource1.reset();
+      CHECK(resourceManager.process(taskRunner, processContext).empty());
+      CHECK(resourceManager.resources().empty());
+      CHECK(!resourceManager.needsProcessing());
+
+      mockTaskRunner.resolveNextPromise();
+      CHECK(resourceManager.process(taskRunner, processContext).empty());
+      CHECK(!resourceManager.needsProcessing());
+    }
+
+    SECTION("loader throws an exception")
+    {
+      const auto throwingResourceLoader = []() -> Result<MockResource> {
+        throw std::runtime_error{"loader failed"};
+      };
+
+      auto resource1 =
+        resourceManager.addResource(std::make_shared<ResourceT>(throwingResourceLoader));
+
+      resourceManager.process(taskRunner, processContext);
+      REQUIRE(std::holds_alternative<ResourceLoading<MockResource>>(resource1->state()));
+
+      mockTaskRunner.resolveNextPromise();
+      CHECK(resourceManager.needsProcessing());
+      CHECK(
+        resourceManager.process(taskRunner, processContext)
+        == std::vector{resource1->id()});
+      REQUIRE(std::holds_alternative<ResourceFailed>(resource1->state()));
+      CHECK(std::get<ResourceFailed>(resource1->state()).error == "loader failed");
+      CHECK(!resourceManager.needsProcessing());
+    }
+
+    SECTION("timeout")
+    {
+      using namespace std::chrono_literals;
+
+      auto resource1 =
+        resourceManager.addResource(std::make_shared<ResourceT>(mockResourceLoader));
+
+      CHECK(resourceManager.process(taskRunner, processContext, 0ms).empty());
+      CHECK(std::holds_alternative<ResourceUnloaded<MockResource>>(resource1->state()));
+      CHECK(resourceManager.needsProcessing());
+
+      CHECK(
+        resourceManager.process(taskRunner, processContext, 1s)
+        == std::vector{resource1->id()});
+      CHECK(std::holds_alternative<ResourceLoading<MockResource>>(resource1->state()));
+    }
   }
 }
 
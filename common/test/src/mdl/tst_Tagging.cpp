@@ -18,18 +18,69 @@
  */
 
 #include "mdl/BrushBuilder.h"
+#include "mdl/BrushFace.h"
 #include "mdl/BrushNode.h"
 #include "mdl/LayerNode.h"
 #include "mdl/MapFormat.h"
 #include "mdl/Tag.h"
+#include "mdl/TagManager.h"
+#include "mdl/TagMatcher.h"
 #include "mdl/WorldNode.h"
 
 #include "kdl/result.h"
+#include "kdl/task_manager.h"
+#include "kdl/vector_utils.h"
+
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <unordered_map>
+#include <vector>
 
 #include "Catch2.h"
 
 namespace tb::mdl
 {
+namespace
+{
+
+struct MatchCounts
+{
+  std::mutex mutex;
+  std::unordered_map<const Taggable*, size_t> counts;
+};
+
+/**
+ * A matcher that cannot be compiled into a plan and that counts how often it is
+ * evaluated for each taggable.
+ */
+class CountingTagMatcher : public TagMatcher
+{
+private:
+  std::shared_ptr<MatchCounts> m_matchCounts;
+
+public:
+  explicit CountingTagMatcher(std::shared_ptr<MatchCounts> matchCounts)
+    : m_matchCounts{std::move(matchCounts)}
+  {
+  }
+
+  std::unique_ptr<TagMatcher> clone() const override
+  {
+    return std::make_unique<CountingTagMatcher>(m_matchCounts);
+  }
+
+  bool matches(const Taggable& taggable) const override
+  {
+    const auto lock = std::lock_guard{m_matchCounts->mutex};
+    ++m_matchCounts->counts[&taggable];
+    return false;
+  }
+
+  void appendToStream(std::ostream& str) const override { str << "CountingTagMatcher"; }
+};
+
+} // namespace
 
 TEST_CASE("TaggingTest.testTagBrush")
 {
@@ -65,4 +116,103 @@ TEST_CASE("TaggingTest.testTagBrush")
   CHECK_FALSE(brushNode->hasTag(tag2));
 }
 
+TEST_CASE("TaggingTest.updateFaceTags")
+{
+  auto tagManager = TagManager{};
+  tagManager.registerSmartTags({
+    SmartTag{"b", {}, std::make_unique<MaterialNameTagMatcher>("b*")},
+    SmartTag{"detail", {}, std::make_unique<SurfaceFlagsTagMatcher>(1 << 2)},
+    SmartTag{"trigger", {}, std::make_unique<EntityClassNameTagMatcher>("trigger*", "")},
+  });
+
+  const auto& materialTag = tagManager.smartTag("b");
+  const auto& detailTag = tagManager.smartTag("detail");
+  const auto& triggerTag = tagManager.smartTag("trigger");
+
+  const auto worldBounds = vm::bbox3d{4096.0};
+  auto builder = BrushBuilder{MapFormat::Standard, worldBounds};
+  auto brush = builder.createCube(64.0, "left", "right", "front", "back", "top", "bottom")
+               | kdl::value();
+
+  auto faces = kdl::vec_transform(brush.faces(), [](auto& face) { return &face; });
+  auto& leftFace = *faces[*brush.findFace("left")];
+
+  auto attributes = leftFace.attributes();
+  attributes.setSurfaceFlags(1 << 2);
+  leftFace.setAttributes(attributes);
+
+  auto taskManager = kdl::task_manager{};
+
+  SECTION("Serially")
+  {
+    tagManager.updateFaceTags(faces);
+  }
+
+  SECTION("In parallel")
+  {
+    tagManager.updateFaceTags(faces, taskManager);
+  }
+
+  for (const auto* face : faces)
+  {
+    CAPTURE(face->attributes().materialName());
+
+    const auto materialName = face->attributes().materialName();
+    CHECK(face->hasTag(materialTag) == (materialName.front() == 'b'));
+    CHECK(face->hasTag(detailTag) == (face == &leftFace));
+    CHECK_FALSE(face->hasTag(triggerTag));
+
+    // the plan must agree with evaluating every tag on its own
+    for (const auto& tag : tagManager.smartTags())
+    {
+      CHECK(face->hasTag(tag) == tag.matches(*face));
+    }
+  }
+
+  attributes.setSurfaceFlags(0);
+  leftFace.setAttributes(attributes);
+  tagManager.updateFaceTags(faces);
+
+  CHECK_FALSE(leftFace.hasTag(detailTag));
+}
+
+TEST_CASE("TaggingTest.initializeBrushNodeTags")
+{
+  auto matchCounts = std::make_shared<MatchCounts>();
+
+  auto tagManager = TagManager{};
+  tagManager.registerSmartTags({
+    SmartTag{"b", {}, std::make_unique<MaterialNameTagMatcher>("b*")},
+    SmartTag{"counting", {}, std::make_unique<CountingTagMatcher>(matchCounts)},
+  });
+
+  const auto& materialTag = tagManager.smartTag("b");
+
+  const auto worldBounds = vm::bbox3d{4096.0};
+  auto builder = BrushBuilder{MapFormat::Standard, worldBounds};
+
+  auto brushNode1 = BrushNode{
+    builder.createCube(64.0, "left", "right", "front", "back", "top", "bottom")
+    | kdl::value()};
+  auto brushNode2 = BrushNode{builder.createCube(32.0, "bottom") | kdl::value()};
+
+  auto taskManager = kdl::task_manager{};
+  BrushNode::initializeTags({&brushNode1, &brushNode2}, tagManager, taskManager);
+
+  // every node and every face is evaluated exactly once
+  CHECK(matchCounts->counts.size() == 2 + 6 + 6);
+  CHECK(matchCounts->counts[&brushNode1] == 1);
+  CHECK(matchCounts->counts[&brushNode2] == 1);
+  for (const auto* brushNode : {&brushNode1, &brushNode2})
+  {
+    for (const auto& face : brushNode->brush().faces())
+    {
+      CHECK(matchCounts->counts[&face] == 1);
+
+      const auto materialName = face.attributes().materialName();
+      CHECK(face.hasTag(materialTag) == (materialName.front() == 'b'));
+    }
+  }
+}
+
 } // namespace tb::mdl
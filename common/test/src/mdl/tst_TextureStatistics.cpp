@@ -0,0 +1,110 @@
+/*
+ Copyright (C) 2010 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mdl/TextureStatistics.h"
+
+#include <array>
+#include <numeric>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace tb::mdl
+{
+namespace
+{
+
+TextureStatistics computeExpectedStatistics(const std::vector<unsigned char>& pixels)
+{
+  auto result = TextureStatistics{};
+  for (size_t i = 0; i < pixels.size(); ++i)
+  {
+    result.channelSums[i % 4] += pixels[i];
+    if (i % 4 == 3)
+    {
+      result.alphaAnd &= pixels[i];
+    }
+  }
+  return result;
+}
+
+std::vector<unsigned char> makeIndices(const size_t count)
+{
+  auto result = std::vector<unsigned char>(count);
+  for (size_t i = 0; i < count; ++i)
+  {
+    result[i] = static_cast<unsigned char>((i * 37 + i / 7) % 256);
+  }
+  return result;
+}
+
+std::array<unsigned char, 1024> makePalette(const unsigned char alpha)
+{
+  auto result = std::array<unsigned char, 1024>{};
+  for (size_t i = 0; i < 256; ++i)
+  {
+    result[i * 4 + 0] = static_cast<unsigned char>(i);
+    result[i * 4 + 1] = static_cast<unsigned char>(255 - i);
+    result[i * 4 + 2] = static_cast<unsigned char>(i * 3);
+    result[i * 4 + 3] = i == 255 ? alpha : 0xFF;
+  }
+  return result;
+}
+
+} // namespace
+
+TEST_CASE("TextureStatistics")
+{
+  // cover the vectorized loops as well as the remaining pixels
+  const auto pixelCount = GENERATE(size_t(0), 1, 7, 8, 9, 31, 64 * 64, 64 * 64 + 3);
+  CAPTURE(pixelCount);
+
+  const auto alpha = GENERATE(static_cast<unsigned char>(0xFF), 0x00, 0x7F);
+  CAPTURE(alpha);
+
+  const auto palette = makePalette(alpha);
+  const auto indices = makeIndices(pixelCount);
+
+  auto expectedPixels = std::vector<unsigned char>(pixelCount * 4);
+  for (size_t i = 0; i < pixelCount; ++i)
+  {
+    std::copy_n(palette.begin() + indices[i] * 4, 4, expectedPixels.begin() + i * 4);
+  }
+  const auto expectedStatistics = computeExpectedStatistics(expectedPixels);
+
+  SECTION("expandIndexedPixels")
+  {
+    auto pixels = std::vector<unsigned char>(pixelCount * 4);
+    const auto statistics = expandIndexedPixels(indices, palette, pixels);
+
+    CHECK(pixels == expectedPixels);
+    CHECK(statistics.channelSums == expectedStatistics.channelSums);
+    CHECK(statistics.alphaAnd == expectedStatistics.alphaAnd);
+  }
+
+  SECTION("computeTextureStatistics")
+  {
+    const auto statistics = computeTextureStatistics(expectedPixels);
+
+    CHECK(statistics.channelSums == expectedStatistics.channelSums);
+    CHECK(statistics.alphaAnd == expectedStatistics.alphaAnd);
+  }
+}
+
+} // namespace tb::mdl
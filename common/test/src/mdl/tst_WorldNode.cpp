@@ -238,6 +238,109 @@ TEST_CASE("WorldNodeTest.nodeTreeUpdates")
   }
 }
 
+TEST_CASE("WorldNodeTest.linkIdIndex")
+{
+  constexpr auto worldBounds = vm::bbox3d{8192.0};
+  constexpr auto mapFormat = MapFormat::Quake3;
+
+  auto worldNode = WorldNode{{}, {}, mapFormat};
+  auto* groupNode = new GroupNode{Group{"group"}};
+  auto* entityNode = new EntityNode{Entity{}};
+  auto* brushNode = new BrushNode{
+    BrushBuilder{mapFormat, worldBounds}.createCube(64.0, "material") | kdl::value()};
+
+  // clang-format off
+  auto* patchNode = new PatchNode{BezierPatch{3, 3, {
+    {0, 0, 0}, {1, 0, 1}, {2, 0, 0},
+    {0, 1, 1}, {1, 1, 2}, {2, 1, 1},
+    {0, 2, 0}, {1, 2, 1}, {2, 2, 0} }, "material"}};
+  // clang-format on
+
+  groupNode->addChildren({entityNode, brushNode, patchNode});
+
+  SECTION("Adding a subtree adds all objects to the index")
+  {
+    REQUIRE(worldNode.findNodesWithLinkId(brushNode->linkId()).empty());
+
+    worldNode.defaultLayer()->addChild(groupNode);
+    CHECK(
+      worldNode.findNodesWithLinkId(groupNode->linkId())
+      == std::vector<Node*>{groupNode});
+    CHECK(
+      worldNode.findNodesWithLinkId(entityNode->linkId())
+      == std::vector<Node*>{entityNode});
+    CHECK(
+      worldNode.findNodesWithLinkId(brushNode->linkId())
+      == std::vector<Node*>{brushNode});
+    CHECK(
+      worldNode.findNodesWithLinkId(patchNode->linkId())
+      == std::vector<Node*>{patchNode});
+  }
+
+  SECTION("Removing a subtree removes all objects from the index")
+  {
+    worldNode.defaultLayer()->addChild(groupNode);
+    worldNode.defaultLayer()->removeChild(groupNode);
+
+    CHECK(worldNode.findNodesWithLinkId(groupNode->linkId()).empty());
+    CHECK(worldNode.findNodesWithLinkId(entityNode->linkId()).empty());
+    CHECK(worldNode.findNodesWithLinkId(brushNode->linkId()).empty());
+    CHECK(worldNode.findNodesWithLinkId(patchNode->linkId()).empty());
+
+    delete groupNode;
+  }
+
+  SECTION("Setting a link ID updates the index")
+  {
+    worldNode.defaultLayer()->addChild(groupNode);
+
+    const auto oldLinkId = brushNode->linkId();
+    brushNode->setLinkId(patchNode->linkId());
+
+    CHECK(worldNode.findNodesWithLinkId(oldLinkId).empty());
+    CHECK_THAT(
+      worldNode.findNodesWithLinkId(patchNode->linkId()),
+      Catch::UnorderedEquals(std::vector<Node*>{brushNode, patchNode}));
+  }
+
+  SECTION("Nodes are returned in the order in which they were indexed")
+  {
+    worldNode.defaultLayer()->addChild(groupNode);
+
+    const auto linkId = patchNode->linkId();
+    brushNode->setLinkId(linkId);
+    groupNode->setLinkId(linkId);
+    entityNode->setLinkId(linkId);
+
+    CHECK(
+      worldNode.findNodesWithLinkId(linkId)
+      == std::vector<Node*>{patchNode, brushNode, groupNode, entityNode});
+
+    brushNode->setLinkId("some_link_id");
+    CHECK(
+      worldNode.findNodesWithLinkId(linkId)
+      == std::vector<Node*>{patchNode, groupNode, entityNode});
+
+    brushNode->setLinkId(linkId);
+    CHECK(
+      worldNode.findNodesWithLinkId(linkId)
+      == std::vector<Node*>{patchNode, groupNode, entityNode, brushNode});
+  }
+
+  SECTION("Setting a link ID of a node outside of the world does not update the index")
+  {
+    const auto oldLinkId = brushNode->linkId();
+    brushNode->setLinkId("some_link_id");
+
+    CHECK(worldNode.findNodesWithLinkId("some_link_id").empty());
+
+    worldNode.defaultLayer()->addChild(groupNode);
+    CHECK(worldNode.findNodesWithLinkId(oldLinkId).empty());
+    CHECK(
+      worldNode.findNodesWithLinkId("some_link_id") == std::vector<Node*>{brushNode});
+  }
+}
+
 TEST_CASE("WorldNodeTest.rebuildNodeTree")
 {
   constexpr auto worldBounds = vm::bbox3d{8192.0};
@@ -423,4 +526,48 @@ TEST_CASE("WorldNodeTest.setPersistentIdsWhenAddingLayersAndGroups")
   CHECK(groupNode->persistentId() == 2u);
 }
 
+TEST_CASE("WorldNodeTest.snapshot")
+{
+  const auto worldBounds = vm::bbox3d{8192.0};
+
+  auto worldNode =
+    WorldNode{{}, Entity{{{"some_key", "some_value"}}}, MapFormat::Standard};
+  worldNode.defaultLayer()->setLockState(LockState::Locked);
+
+  auto* layerNode = new LayerNode{Layer{"layer"}};
+  auto* groupNode = new GroupNode{Group{"group"}};
+  auto* entityNode = new EntityNode{Entity{}};
+
+  worldNode.addChild(layerNode);
+  layerNode->addChild(groupNode);
+  groupNode->addChild(entityNode);
+
+  layerNode->setPersistentId(7u);
+  groupNode->setPersistentId(9u);
+
+  const auto snapshot = worldNode.snapshot(worldBounds);
+  REQUIRE(snapshot != nullptr);
+
+  CHECK(*snapshot->entity().property("some_key") == "some_value");
+  CHECK(snapshot->defaultLayer()->lockState() == LockState::Locked);
+
+  const auto customLayers = snapshot->customLayers();
+  REQUIRE(customLayers.size() == 1u);
+  CHECK(customLayers[0]->name() == "layer");
+  CHECK(customLayers[0]->persistentId() == 7u);
+
+  REQUIRE(customLayers[0]->childCount() == 1u);
+  auto* groupNodeCopy = dynamic_cast<GroupNode*>(customLayers[0]->children().front());
+  REQUIRE(groupNodeCopy != nullptr);
+  CHECK(groupNodeCopy != groupNode);
+  CHECK(groupNodeCopy->persistentId() == 9u);
+  CHECK(groupNodeCopy->childCount() == 1u);
+
+  SECTION("Changing the original does not affect the snapshot")
+  {
+    groupNode->addChild(new EntityNode{Entity{}});
+    CHECK(groupNodeCopy->childCount() == 1u);
+  }
+}
+
 } // namespace tb::mdl
@@ -0,0 +1,108 @@
+/*
+ Copyright (C) 2010 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mdl/Entity.h"
+#include "mdl/EntityNode.h"
+#include "mdl/EntityProperties.h"
+#include "render/EntityCuller.h"
+#include "render/ViewFrustum.h"
+
+#include "vm/plane.h"
+#include "vm/vec.h"
+
+#include <fmt/format.h>
+
+#include <string>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace tb::render
+{
+namespace
+{
+
+mdl::Entity entityAt(const float x)
+{
+  return mdl::Entity{{
+    {mdl::EntityPropertyKeys::Classname, "point_entity"},
+    {mdl::EntityPropertyKeys::Origin, fmt::format("{} 0 0", x)},
+  }};
+}
+
+} // namespace
+
+TEST_CASE("EntityCuller")
+{
+  // everything with an x coordinate of at least 0
+  const auto frustum =
+    ViewFrustum{{vm::plane3f{vm::vec3f{0, 0, 0}, vm::vec3f{-1, 0, 0}}}, {0, 0, 0}};
+
+  auto entity1 = mdl::EntityNode{entityAt(64)};
+  auto entity2 = mdl::EntityNode{entityAt(-64)};
+  auto entity3 = mdl::EntityNode{entityAt(128)};
+
+  auto culler = EntityCuller{};
+  CHECK(culler.findVisibleEntities(frustum).empty());
+
+  culler.addEntity(&entity1);
+  culler.addEntity(&entity2);
+  culler.addEntity(&entity3);
+
+  CHECK_THAT(
+    culler.findVisibleEntities(frustum),
+    Catch::Matchers::UnorderedEquals(
+      std::vector<const mdl::EntityNode*>{&entity1, &entity3}));
+
+  SECTION("Adding an entity twice updates it")
+  {
+    entity1.setEntity(entityAt(-128));
+    culler.addEntity(&entity1);
+    CHECK(
+      culler.findVisibleEntities(frustum)
+      == std::vector<const mdl::EntityNode*>{&entity3});
+  }
+
+  SECTION("Updating an entity")
+  {
+    entity2.setEntity(entityAt(256));
+    culler.updateEntity(&entity2);
+    CHECK_THAT(
+      culler.findVisibleEntities(frustum),
+      Catch::Matchers::UnorderedEquals(
+        std::vector<const mdl::EntityNode*>{&entity1, &entity2, &entity3}));
+  }
+
+  SECTION("Removing an entity")
+  {
+    culler.removeEntity(&entity3);
+    culler.removeEntity(&entity3);
+    CHECK(
+      culler.findVisibleEntities(frustum)
+      == std::vector<const mdl::EntityNode*>{&entity1});
+  }
+
+  SECTION("Clearing")
+  {
+    culler.clear();
+    CHECK(culler.findVisibleEntities(frustum).empty());
+  }
+}
+
+} // namespace tb::render
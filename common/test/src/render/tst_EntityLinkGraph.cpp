@@ -0,0 +1,239 @@
+/*
+ Copyright (C) 2010 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mdl/BrushBuilder.h"
+#include "mdl/BrushNode.h"
+#include "mdl/EditorContext.h"
+#include "mdl/Entity.h"
+#include "mdl/EntityNode.h"
+#include "mdl/EntityProperties.h"
+#include "mdl/LayerNode.h"
+#include "mdl/MapFormat.h"
+#include "mdl/VisibilityState.h"
+#include "mdl/WorldNode.h"
+#include "render/EntityLinkGraph.h"
+
+#include "kdl/result.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace tb::render
+{
+namespace
+{
+
+using LinkEnds = std::pair<const mdl::EntityNodeBase*, const mdl::EntityNodeBase*>;
+
+std::vector<LinkEnds> collectLinks(
+  EntityLinkGraph& linkGraph,
+  const mdl::WorldNode& worldNode,
+  const mdl::EditorContext& editorContext)
+{
+  linkGraph.validate(worldNode, editorContext);
+
+  auto result = std::vector<LinkEnds>{};
+  linkGraph.visitLinks([&](const auto& link) {
+    result.emplace_back(link.source, link.target);
+  });
+  return result;
+}
+
+} // namespace
+
+TEST_CASE("EntityLinkGraph")
+{
+  const auto editorContext = mdl::EditorContext{};
+
+  auto worldNode = mdl::WorldNode{{}, {}, mdl::MapFormat::Standard};
+  auto* sourceNode = new mdl::EntityNode{mdl::Entity{{
+    {mdl::EntityPropertyKeys::Target, "a"},
+    {mdl::EntityPropertyKeys::Killtarget, "b"},
+  }}};
+  auto* targetNode = new mdl::EntityNode{mdl::Entity{{
+    {mdl::EntityPropertyKeys::Targetname, "a"},
+  }}};
+  auto* killTargetNode = new mdl::EntityNode{mdl::Entity{{
+    {mdl::EntityPropertyKeys::Targetname, "b"},
+  }}};
+  worldNode.defaultLayer()->addChild(sourceNode);
+  worldNode.defaultLayer()->addChild(targetNode);
+  worldNode.defaultLayer()->addChild(killTargetNode);
+
+  auto linkGraph = EntityLinkGraph{};
+  CHECK_THAT(
+    collectLinks(linkGraph, worldNode, editorContext),
+    Catch::UnorderedEquals(std::vector<LinkEnds>{
+      {sourceNode, targetNode},
+      {sourceNode, killTargetNode},
+    }));
+
+  SECTION("Changing a target removes its links")
+  {
+    targetNode->setEntity(mdl::Entity{{{mdl::EntityPropertyKeys::Targetname, "c"}}});
+    linkGraph.invalidateEntity(targetNode);
+
+    CHECK(
+      collectLinks(linkGraph, worldNode, editorContext)
+      == std::vector<LinkEnds>{{sourceNode, killTargetNode}});
+  }
+
+  SECTION("Changing a source updates its links")
+  {
+    sourceNode->setEntity(mdl::Entity{{{mdl::EntityPropertyKeys::Target, "b"}}});
+    linkGraph.invalidateEntity(sourceNode);
+
+    CHECK(
+      collectLinks(linkGraph, worldNode, editorContext)
+      == std::vector<LinkEnds>{{sourceNode, killTargetNode}});
+  }
+
+  SECTION("Moving a target updates its anchor")
+  {
+    targetNode->setEntity(mdl::Entity{{
+      {mdl::EntityPropertyKeys::Targetname, "a"},
+      {mdl::EntityPropertyKeys::Origin, "64 0 0"},
+    }});
+    linkGraph.invalidateEntity(targetNode);
+    linkGraph.validate(worldNode, editorContext);
+
+    auto targetAnchors = std::vector<vm::vec3f>{};
+    linkGraph.visitLinks([&](const auto& link) {
+      if (link.target == targetNode)
+      {
+        targetAnchors.push_back(link.targetAnchor);
+      }
+    });
+    CHECK(
+      targetAnchors
+      == std::vector<vm::vec3f>{vm::vec3f{targetNode->linkTargetAnchor()}});
+  }
+
+  SECTION("Adding a source adds its links")
+  {
+    auto* newSourceNode = new mdl::EntityNode{mdl::Entity{{
+      {mdl::EntityPropertyKeys::Target, "a"},
+    }}};
+    worldNode.defaultLayer()->addChild(newSourceNode);
+    linkGraph.invalidateEntity(newSourceNode);
+
+    CHECK_THAT(
+      collectLinks(linkGraph, worldNode, editorContext),
+      Catch::UnorderedEquals(std::vector<LinkEnds>{
+        {sourceNode, targetNode},
+        {sourceNode, killTargetNode},
+        {newSourceNode, targetNode},
+      }));
+  }
+
+  SECTION("Removing a target removes its links")
+  {
+    worldNode.defaultLayer()->removeChild(targetNode);
+    linkGraph.removeEntity(targetNode);
+    delete targetNode;
+
+    CHECK(
+      collectLinks(linkGraph, worldNode, editorContext)
+      == std::vector<LinkEnds>{{sourceNode, killTargetNode}});
+  }
+
+  SECTION("Removing a source removes its links")
+  {
+    worldNode.defaultLayer()->removeChild(sourceNode);
+    linkGraph.removeEntity(sourceNode);
+    delete sourceNode;
+
+    CHECK(collectLinks(linkGraph, worldNode, editorContext).empty());
+  }
+
+  SECTION("Hidden entities are omitted after invalidating the graph")
+  {
+    killTargetNode->setVisibilityState(mdl::VisibilityState::Hidden);
+    linkGraph.invalidate();
+
+    CHECK(
+      collectLinks(linkGraph, worldNode, editorContext)
+      == std::vector<LinkEnds>{{sourceNode, targetNode}});
+  }
+
+  SECTION("Selecting a hidden entity adds its links")
+  {
+    killTargetNode->setVisibilityState(mdl::VisibilityState::Hidden);
+    linkGraph.invalidate();
+    REQUIRE(
+      collectLinks(linkGraph, worldNode, editorContext)
+      == std::vector<LinkEnds>{{sourceNode, targetNode}});
+
+    killTargetNode->select();
+    linkGraph.invalidateSelection({killTargetNode});
+
+    CHECK_THAT(
+      collectLinks(linkGraph, worldNode, editorContext),
+      Catch::UnorderedEquals(std::vector<LinkEnds>{
+        {sourceNode, targetNode},
+        {sourceNode, killTargetNode},
+      }));
+
+    killTargetNode->deselect();
+    linkGraph.invalidateSelection({killTargetNode});
+
+    CHECK(
+      collectLinks(linkGraph, worldNode, editorContext)
+      == std::vector<LinkEnds>{{sourceNode, targetNode}});
+  }
+
+  SECTION("Selecting a brush of a hidden brush entity adds the links of the entity")
+  {
+    const auto worldBounds = vm::bbox3d{4096.0};
+    auto builder = mdl::BrushBuilder{mdl::MapFormat::Standard, worldBounds};
+
+    auto* brushEntityNode = new mdl::EntityNode{mdl::Entity{{
+      {mdl::EntityPropertyKeys::Target, "a"},
+    }}};
+    auto* brushNode =
+      new mdl::BrushNode{builder.createCube(64.0, "material") | kdl::value()};
+    brushEntityNode->addChild(brushNode);
+    worldNode.defaultLayer()->addChild(brushEntityNode);
+
+    brushNode->setVisibilityState(mdl::VisibilityState::Hidden);
+    linkGraph.invalidateEntity(brushEntityNode);
+    REQUIRE(collectLinks(linkGraph, worldNode, editorContext).size() == 2);
+
+    brushNode->select();
+    linkGraph.invalidateSelection({brushNode});
+
+    CHECK_THAT(
+      collectLinks(linkGraph, worldNode, editorContext),
+      Catch::UnorderedEquals(std::vector<LinkEnds>{
+        {sourceNode, targetNode},
+        {sourceNode, killTargetNode},
+        {brushEntityNode, targetNode},
+      }));
+
+    brushNode->deselect();
+    linkGraph.invalidateSelection({brushNode});
+
+    CHECK(collectLinks(linkGraph, worldNode, editorContext).size() == 2);
+  }
+}
+
+} // namespace tb::render
@@ -0,0 +1,119 @@
+/*
+ Copyright (C) 2010 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "render/OrthographicCamera.h"
+#include "render/PerspectiveCamera.h"
+#include "render/ViewFrustum.h"
+
+#include "vm/bbox.h"
+#include "vm/plane.h"
+#include "vm/vec.h"
+
+#include "Catch2.h"
+
+namespace tb::render
+{
+namespace
+{
+
+vm::bbox3f boxAt(const vm::vec3f& center)
+{
+  return {center - vm::vec3f{8, 8, 8}, center + vm::vec3f{8, 8, 8}};
+}
+
+} // namespace
+
+TEST_CASE("ViewFrustum")
+{
+  SECTION("Planes")
+  {
+    // the cube from -64 to 64 on every axis
+    const auto frustum = ViewFrustum{
+      {
+        vm::plane3f{vm::vec3f{64, 0, 0}, vm::vec3f{1, 0, 0}},
+        vm::plane3f{vm::vec3f{-64, 0, 0}, vm::vec3f{-1, 0, 0}},
+        vm::plane3f{vm::vec3f{0, 64, 0}, vm::vec3f{0, 1, 0}},
+        vm::plane3f{vm::vec3f{0, -64, 0}, vm::vec3f{0, -1, 0}},
+        vm::plane3f{vm::vec3f{0, 0, 64}, vm::vec3f{0, 0, 1}},
+        vm::plane3f{vm::vec3f{0, 0, -64}, vm::vec3f{0, 0, -1}},
+      },
+      vm::vec3f{0, 0, 0}};
+
+    CHECK(frustum.intersects(boxAt({0, 0, 0})));
+    CHECK(frustum.intersects(boxAt({70, 0, 0})));
+    CHECK(frustum.intersects(boxAt({0, -70, 70})));
+    CHECK(frustum.intersects(vm::bbox3f{{-128, -128, -128}, {128, 128, 128}}));
+    CHECK_FALSE(frustum.intersects(boxAt({80, 0, 0})));
+    CHECK_FALSE(frustum.intersects(boxAt({0, 0, -80})));
+  }
+
+  SECTION("Maximum distance")
+  {
+    const auto frustum = ViewFrustum{{}, vm::vec3f{0, 0, 0}, 100.0f};
+
+    CHECK(frustum.intersects(boxAt({0, 0, 0})));
+    CHECK(frustum.intersects(boxAt({100, 0, 0})));
+    CHECK(frustum.intersects(boxAt({0, -108, 0})));
+    CHECK_FALSE(frustum.intersects(boxAt({0, 0, 110})));
+    CHECK_FALSE(frustum.intersects(boxAt({80, 80, 0})));
+  }
+
+  SECTION("Perspective camera")
+  {
+    const auto camera = PerspectiveCamera{
+      90.0f,
+      1.0f,
+      8192.0f,
+      {0, 0, 400, 300},
+      vm::vec3f{0, 0, 0},
+      vm::vec3f{1, 0, 0},
+      vm::vec3f{0, 0, 1}};
+
+    CHECK(ViewFrustum{camera}.intersects(boxAt({256, 0, 0})));
+    CHECK(ViewFrustum{camera}.intersects(boxAt({256, 200, 0})));
+    CHECK(ViewFrustum{camera}.intersects(boxAt({0, 0, 0})));
+    CHECK_FALSE(ViewFrustum{camera}.intersects(boxAt({-256, 0, 0})));
+    CHECK_FALSE(ViewFrustum{camera}.intersects(boxAt({256, 512, 0})));
+    CHECK_FALSE(ViewFrustum{camera}.intersects(boxAt({256, 0, 512})));
+
+    CHECK(ViewFrustum{camera, 512.0f}.intersects(boxAt({256, 0, 0})));
+    CHECK_FALSE(ViewFrustum{camera, 128.0f}.intersects(boxAt({256, 0, 0})));
+  }
+
+  SECTION("Orthographic camera")
+  {
+    const auto camera = OrthographicCamera{
+      1.0f,
+      8192.0f,
+      {0, 0, 400, 300},
+      vm::vec3f{0, 0, 4096},
+      vm::vec3f{0, 0, -1},
+      vm::vec3f{0, 1, 0}};
+
+    CHECK(ViewFrustum{camera}.intersects(boxAt({0, 0, 0})));
+    CHECK(ViewFrustum{camera}.intersects(boxAt({190, 140, -4096})));
+    CHECK_FALSE(ViewFrustum{camera}.intersects(boxAt({256, 0, 0})));
+    CHECK_FALSE(ViewFrustum{camera}.intersects(boxAt({0, -256, 0})));
+
+    // the maximum distance is ignored for orthographic cameras
+    CHECK(ViewFrustum{camera, 128.0f}.intersects(boxAt({0, 0, 0})));
+  }
+}
+
+} // namespace tb::render
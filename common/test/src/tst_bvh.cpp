@@ -0,0 +1,340 @@
+/*
+ Copyright (C) 2010 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "bvh.h"
+
+#include "vm/approx.h"
+#include "vm/bbox_io.h" // IWYU pragma: keep
+#include "vm/intersection.h"
+#include "vm/vec_io.h" // IWYU pragma: keep
+
+#include <algorithm>
+#include <limits>
+#include <optional>
+#include <random>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace tb
+{
+namespace
+{
+
+template <typename T>
+std::vector<T> sorted(std::vector<T> v)
+{
+  std::sort(v.begin(), v.end());
+  return v;
+}
+
+} // namespace
+
+TEST_CASE("bvh.insert")
+{
+  auto tree = bvh<double, int>{};
+  CHECK(tree.empty());
+
+  tree.insert(vm::bbox3d{{0, 0, 0}, {16, 16, 16}}, 1);
+  CHECK_FALSE(tree.empty());
+  CHECK(tree.contains(1));
+
+  tree.insert(vm::bbox3d{{16, 16, 16}, {32, 32, 32}}, 2);
+  CHECK(tree.contains(2));
+
+  SECTION("duplicate data")
+  {
+    CHECK_THROWS_AS(tree.insert(vm::bbox3d{{0, 0, 0}, {1, 1, 1}}, 1), NodeTreeException);
+  }
+
+  SECTION("invalid bounds")
+  {
+    const auto nan = std::numeric_limits<double>::quiet_NaN();
+    CHECK_THROWS_AS(
+      tree.insert(vm::bbox3d{{nan, 0, 0}, {1, 1, 1}}, 3), NodeTreeException);
+    CHECK_FALSE(tree.contains(3));
+  }
+}
+
+TEST_CASE("bvh.remove")
+{
+  auto tree = bvh<double, int>{};
+
+  tree.insert(vm::bbox3d{{0, 0, 0}, {16, 16, 16}}, 1);
+  tree.insert(vm::bbox3d{{16, 16, 16}, {32, 32, 32}}, 2);
+
+  CHECK_FALSE(tree.remove(3));
+
+  CHECK(tree.remove(1));
+  CHECK_FALSE(tree.contains(1));
+  CHECK(tree.contains(2));
+  CHECK(tree.find_containers({8, 8, 8}).empty());
+  CHECK(tree.find_containers({24, 24, 24}) == std::vector<int>{2});
+
+  CHECK(tree.remove(2));
+  CHECK(tree.empty());
+  CHECK(tree.find_containers({24, 24, 24}).empty());
+}
+
+TEST_CASE("bvh.update")
+{
+  auto tree = bvh<double, int>{};
+
+  tree.insert(vm::bbox3d{{0, 0, 0}, {16, 16, 16}}, 1);
+  tree.insert(vm::bbox3d{{16, 16, 16}, {32, 32, 32}}, 2);
+
+  tree.update(vm::bbox3d{{64, 64, 64}, {80, 80, 80}}, 1);
+  CHECK(tree.find_containers({8, 8, 8}).empty());
+  CHECK(tree.find_containers({72, 72, 72}) == std::vector<int>{1});
+
+  CHECK_THROWS_AS(tree.update(vm::bbox3d{{0, 0, 0}, {1, 1, 1}}, 3), NodeTreeException);
+}
+
+TEST_CASE("bvh.find_intersectors-ray")
+{
+  auto tree = bvh<double, int>{};
+
+  SECTION("empty tree")
+  {
+    CHECK(tree.find_intersectors(vm::ray3d{{0, 0, 0}, {1, 0, 0}}).empty());
+  }
+
+  SECTION("single node")
+  {
+    tree.insert({{32, 32, 32}, {64, 64, 64}}, 1);
+
+    // the ray misses the bounds
+    CHECK(tree.find_intersectors(vm::ray3d{{48, 48, 0}, {0, 0, -1}}).empty());
+    CHECK(tree.find_intersectors(vm::ray3d{{0, 0, 0}, {0, 0, 1}}).empty());
+
+    // the bounds contain the ray origin
+    CHECK(
+      tree.find_intersectors(vm::ray3d{{48, 48, 48}, {0, 0, -1}}) == std::vector<int>{1});
+
+    // the ray hits the bounds
+    CHECK(
+      tree.find_intersectors(vm::ray3d{{48, 48, 0}, {0, 0, 1}}) == std::vector<int>{1});
+
+    // the ray is parallel to and touches a face of the bounds
+    CHECK(
+      tree.find_intersectors(vm::ray3d{{32, 48, 0}, {0, 0, 1}}) == std::vector<int>{1});
+  }
+
+  SECTION("results are ordered by distance")
+  {
+    for (int i = 0; i < 16; ++i)
+    {
+      const auto x = double(((i * 7) % 16) * 32);
+      tree.insert({{x, 0, 0}, {x + 16, 16, 16}}, (i * 7) % 16);
+    }
+
+    CHECK(
+      tree.find_intersectors(vm::ray3d{{-16, 8, 8}, {1, 0, 0}})
+      == std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15});
+  }
+}
+
+TEST_CASE("bvh.visit_intersectors")
+{
+  auto tree = bvh<double, int>{};
+  for (int i = 0; i < 64; ++i)
+  {
+    const auto x = double(i * 32);
+    tree.insert({{x, 0, 0}, {x + 16, 16, 16}}, i);
+  }
+
+  const auto ray = vm::ray3d{{-16, 8, 8}, {1, 0, 0}};
+
+  SECTION("stops once a closer hit was found")
+  {
+    auto visited = std::vector<int>{};
+    tree.visit_intersectors(ray, [&](const int data, const double distance) {
+      visited.push_back(data);
+      return data == 3 ? distance : std::numeric_limits<double>::max();
+    });
+
+    CHECK(sorted(visited) == std::vector<int>{0, 1, 2, 3});
+  }
+
+  SECTION("respects the initial maximum distance")
+  {
+    auto visited = std::vector<int>{};
+    tree.visit_intersectors(
+      ray,
+      [&](const int data, const double) {
+        visited.push_back(data);
+        return std::numeric_limits<double>::max();
+      },
+      80.0);
+
+    CHECK(sorted(visited) == std::vector<int>{0, 1, 2});
+  }
+}
+
+TEST_CASE("bvh.find_intersectors-bbox")
+{
+  auto tree = bvh<double, int>{};
+
+  SECTION("empty tree")
+  {
+    CHECK(tree.find_intersectors(vm::bbox3d{{0, 0, 0}, {1, 1, 1}}).empty());
+  }
+
+  SECTION("single node")
+  {
+    tree.insert({{32, 32, 32}, {64, 64, 64}}, 1);
+
+    // not touching
+    CHECK(tree.find_intersectors(vm::bbox3d{{0, 0, 0}, {16, 16, 16}}).empty());
+
+    // share a corner
+    CHECK(
+      tree.find_intersectors(vm::bbox3d{{0, 0, 0}, {32, 32, 32}}) == std::vector<int>{1});
+
+    // fully inside
+    CHECK(
+      tree.find_intersectors(vm::bbox3d{{40, 40, 40}, {48, 48, 48}})
+      == std::vector<int>{1});
+
+    // fully contains
+    CHECK(
+      tree.find_intersectors(vm::bbox3d{{0, 0, 0}, {128, 128, 128}})
+      == std::vector<int>{1});
+  }
+}
+
+TEST_CASE("bvh.find_containers")
+{
+  auto tree = bvh<double, int>{};
+
+  SECTION("empty tree")
+  {
+    CHECK(tree.find_containers({0, 0, 0}).empty());
+  }
+
+  SECTION("single node")
+  {
+    tree.insert({{32, 32, 32}, {64, 64, 64}}, 1);
+
+    CHECK(tree.find_containers({48, 48, 0}).empty());
+    CHECK(tree.find_containers({48, 48, 48}) == std::vector<int>{1});
+    CHECK(tree.find_containers({32, 32, 32}) == std::vector<int>{1});
+    CHECK(tree.find_containers({64, 64, 64}) == std::vector<int>{1});
+  }
+}
+
+TEST_CASE("bvh.find_if")
+{
+  auto tree = bvh<double, int>{};
+
+  const auto below = [](const double z) {
+    return [=](const vm::bbox3d& bounds) { return bounds.min.z() < z; };
+  };
+
+  SECTION("empty tree")
+  {
+    CHECK(tree.find_if(below(0.0)).empty());
+  }
+
+  SECTION("many nodes")
+  {
+    for (int i = 0; i < 32; ++i)
+    {
+      const auto z = double(i * 16);
+      tree.insert({{0, 0, z}, {8, 8, z + 8}}, i);
+    }
+
+    CHECK(tree.find_if(below(0.0)).empty());
+    CHECK(tree.find_if(below(1.0)) == std::vector<int>{0});
+    CHECK(sorted(tree.find_if(below(40.0))) == std::vector<int>{0, 1, 2});
+    CHECK(tree.find_if(below(1000.0)).size() == 32u);
+  }
+}
+
+TEST_CASE("bvh.randomModifications")
+{
+  // compares the results of the bvh to a linear search after random modifications
+  auto rng = std::mt19937{0};
+  auto coord = std::uniform_real_distribution<double>{-1024.0, 1024.0};
+  auto extent = std::uniform_real_distribution<double>{1.0, 128.0};
+  auto action = std::uniform_int_distribution<int>{0, 3};
+
+  const auto randomBounds = [&]() {
+    const auto min = vm::vec3d{coord(rng), coord(rng), coord(rng)};
+    return vm::bbox3d{min, min + vm::vec3d{extent(rng), extent(rng), extent(rng)}};
+  };
+
+  auto tree = bvh<double, int>{};
+  auto bounds = std::vector<std::optional<vm::bbox3d>>(500);
+
+  for (size_t i = 0; i < 5000; ++i)
+  {
+    const auto data = int(rng() % bounds.size());
+    if (!bounds[size_t(data)])
+    {
+      bounds[size_t(data)] = randomBounds();
+      tree.insert(*bounds[size_t(data)], data);
+    }
+    else if (action(rng) == 0)
+    {
+      bounds[size_t(data)] = std::nullopt;
+      REQUIRE(tree.remove(data));
+    }
+    else
+    {
+      bounds[size_t(data)] = randomBounds();
+      tree.update(*bounds[size_t(data)], data);
+    }
+
+    if (i % 100 == 0)
+    {
+      const auto ray = vm::ray3d{
+        vm::vec3d{coord(rng), coord(rng), coord(rng)},
+        vm::normalize(vm::vec3d{coord(rng), coord(rng), coord(rng)})};
+      const auto box = randomBounds();
+
+      auto expectedRayHits = std::vector<int>{};
+      auto expectedBoxHits = std::vector<int>{};
+      for (size_t j = 0; j < bounds.size(); ++j)
+      {
+        if (bounds[j])
+        {
+          CHECK(tree.contains(int(j)));
+          if (bounds[j]->contains(ray.origin) || vm::intersect_ray_bbox(ray, *bounds[j]))
+          {
+            expectedRayHits.push_back(int(j));
+          }
+          if (bounds[j]->intersects(box))
+          {
+            expectedBoxHits.push_back(int(j));
+          }
+        }
+        else
+        {
+          CHECK_FALSE(tree.contains(int(j)));
+        }
+      }
+
+      CHECK(sorted(tree.find_intersectors(ray)) == expectedRayHits);
+      CHECK(sorted(tree.find_intersectors(box)) == expectedBoxHits);
+    }
+  }
+}
+
+} // namespace tb
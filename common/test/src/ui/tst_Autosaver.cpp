@@ -20,6 +20,7 @@
 #include <QString>
 
 #include "Logger.h"
+#include "io/BackupStore.h"
 #include "io/DiskFileSystem.h"
 #include "io/TestEnvironment.h"
 #include "mdl/BrushNode.h" // IWYU pragma: keep
@@ -28,6 +29,7 @@
 #include "ui/Autosaver.h"
 #include "ui/MapDocumentTest.h"
 
+#include "kdl/result.h"
 #include "kdl/vector_utils.h"
 
 #include <fmt/format.h>
@@ -55,12 +57,31 @@ io::TestEnvironment makeTestEnvironment()
   return io::TestEnvironment{dir, [](auto& env) {
                                env.createDirectory("dir");
 
-                               env.createFile("test.1.map", "some content");
-                               env.createFile("test.2.map", "some content");
-                               env.createFile("test.20.map", "some content");
+                               env.createFile("test.1.tbbackup", "some content");
+                               env.createFile("test.2.tbbackup", "some content");
+                               env.createFile("test.20.tbbackup", "some content");
+                               env.createFile("test.3.map", "some content");
                              }};
 }
 
+const auto ChunkDirectory = std::filesystem::path{"autosave/test.chunks"};
+
+void createBackup(
+  const io::TestEnvironment& env,
+  const std::filesystem::path& path,
+  const std::string& contents)
+{
+  REQUIRE(io::BackupStore{env.dir() / ChunkDirectory}
+            .writeBackup(env.dir() / path, contents)
+            .is_success());
+}
+
+std::string loadBackup(const io::TestEnvironment& env, const std::filesystem::path& path)
+{
+  return io::BackupStore{env.dir() / ChunkDirectory}.readBackup(env.dir() / path)
+         | kdl::value();
+}
+
 } // namespace
 
 TEST_CASE("AutosaverTest.makeBackupPathMatcher")
@@ -71,13 +92,14 @@ TEST_CASE("AutosaverTest.makeBackupPathMatcher")
   const auto matcher = makeBackupPathMatcher("test");
   const auto getPathInfo = [&](const auto& p) { return fs.pathInfo(p); };
 
-  CHECK(matcher("test.1.map", getPathInfo));
-  CHECK(matcher("test.2.map", getPathInfo));
-  CHECK(matcher("test.20.map", getPathInfo));
+  CHECK(matcher("test.1.tbbackup", getPathInfo));
+  CHECK(matcher("test.2.tbbackup", getPathInfo));
+  CHECK(matcher("test.20.tbbackup", getPathInfo));
   CHECK_FALSE(matcher("dir", getPathInfo));
-  CHECK_FALSE(matcher("test.map", getPathInfo));
-  CHECK_FALSE(matcher("test.1-crash.map", getPathInfo));
-  CHECK_FALSE(matcher("test.2-crash.map", getPathInfo));
+  CHECK_FALSE(matcher("test.3.map", getPathInfo));
+  CHECK_FALSE(matcher("test.tbbackup", getPathInfo));
+  CHECK_FALSE(matcher("test.1-crash.tbbackup", getPathInfo));
+  CHECK_FALSE(matcher("test.2-crash.tbbackup", getPathInfo));
 }
 
 TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.autosaverNoSaveUntilSaveInterval")
@@ -97,7 +119,9 @@ TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.autosaverNoSaveUntilSaveInter
 
   autosaver.triggerAutosave(logger);
 
-  CHECK_FALSE(env.fileExists("autosave/test.1.map"));
+  autosaver.waitForPendingBackup(logger);
+
+  CHECK_FALSE(env.fileExists("autosave/test.1.tbbackup"));
   CHECK_FALSE(env.directoryExists("autosave"));
 }
 
@@ -113,8 +137,9 @@ TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.autosaverNoSaveOfUnchangedMap
 
   auto autosaver = Autosaver{document, 0s};
   autosaver.triggerAutosave(logger);
+  autosaver.waitForPendingBackup(logger);
 
-  CHECK_FALSE(env.fileExists("autosave/test.1.map"));
+  CHECK_FALSE(env.fileExists("autosave/test.1.tbbackup"));
   CHECK_FALSE(env.directoryExists("autosave"));
 }
 
@@ -137,7 +162,9 @@ TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.autosaverSavesAfterSaveInterv
 
   autosaver.triggerAutosave(logger);
 
-  CHECK(env.fileExists("autosave/test.1.map"));
+  autosaver.waitForPendingBackup(logger);
+
+  CHECK(env.fileExists("autosave/test.1.tbbackup"));
   CHECK(env.directoryExists("autosave"));
 }
 
@@ -160,7 +187,9 @@ TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.autosaverSavesAgainAfterSaveI
 
   autosaver.triggerAutosave(logger);
 
-  CHECK(env.fileExists("autosave/test.1.map"));
+  autosaver.waitForPendingBackup(logger);
+
+  CHECK(env.fileExists("autosave/test.1.tbbackup"));
   CHECK(env.directoryExists("autosave"));
 
   // Wait for 2 seconds.
@@ -168,13 +197,17 @@ TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.autosaverSavesAgainAfterSaveI
   std::this_thread::sleep_for(100ms);
 
   autosaver.triggerAutosave(logger);
-  CHECK_FALSE(env.fileExists("autosave/test.2.map"));
+
+  autosaver.waitForPendingBackup(logger);
+  CHECK_FALSE(env.fileExists("autosave/test.2.tbbackup"));
 
   // modify the map
   document->addNodes({{document->currentLayer(), {createBrushNode("some_material")}}});
 
   autosaver.triggerAutosave(logger);
-  CHECK(env.fileExists("autosave/test.2.map"));
+
+  autosaver.waitForPendingBackup(logger);
+  CHECK(env.fileExists("autosave/test.2.tbbackup"));
 }
 
 TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.autosaverCleanup")
@@ -188,22 +221,24 @@ TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.autosaverCleanup")
   SECTION("Files are rotated")
   {
     const auto initialPaths = std::vector<std::filesystem::path>{
-      "autosave/test.1.map",
-      "autosave/test.2.map",
+      "autosave/test.1.tbbackup",
+      "autosave/test.2.tbbackup",
     };
 
     for (const auto& path : initialPaths)
     {
-      env.createFile(path, path.string());
+      createBackup(env, path, path.string());
     }
 
-    REQUIRE(env.directoryContents("autosave") == initialPaths);
+    REQUIRE(
+      env.directoryContents("autosave")
+      == kdl::vec_push_back(initialPaths, ChunkDirectory));
     REQUIRE(
       kdl::vec_transform(
-        initialPaths, [&](const auto& path) { return env.loadFile(path); })
+        initialPaths, [&](const auto& path) { return loadBackup(env, path); })
       == std::vector<std::string>{
-        "autosave/test.1.map",
-        "autosave/test.2.map",
+        "autosave/test.1.tbbackup",
+        "autosave/test.2.tbbackup",
       });
 
     auto logger = NullLogger{};
@@ -219,22 +254,23 @@ TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.autosaverCleanup")
 
     std::this_thread::sleep_for(100ms);
     autosaver.triggerAutosave(logger);
+    autosaver.waitForPendingBackup(logger);
 
-    const auto allPaths = kdl::vec_push_back(initialPaths, "autosave/test.3.map");
+    const auto allPaths = kdl::vec_push_back(initialPaths, "autosave/test.3.tbbackup");
 
-    CHECK(env.directoryContents("autosave") == allPaths);
     CHECK(
-      kdl::vec_transform(allPaths, [&](const auto& path) { return env.loadFile(path); })
+      env.directoryContents("autosave") == kdl::vec_push_back(allPaths, ChunkDirectory));
+    CHECK(
+      kdl::vec_transform(
+        allPaths, [&](const auto& path) { return loadBackup(env, path); })
       == std::vector<std::string>{
-        "autosave/test.1.map",
-        "autosave/test.2.map",
+        "autosave/test.1.tbbackup",
+        "autosave/test.2.tbbackup",
         R"(// Game: Test
 // Format: Standard
-// entity 0
 {
 "classname" "worldspawn"
 }
-// entity 1
 {
 }
 )",
@@ -245,32 +281,30 @@ TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.autosaverCleanup")
 
     std::this_thread::sleep_for(100ms);
     autosaver.triggerAutosave(logger);
+    autosaver.waitForPendingBackup(logger);
 
-    CHECK(env.directoryContents("autosave") == allPaths);
     CHECK(
-      kdl::vec_transform(allPaths, [&](const auto& path) { return env.loadFile(path); })
+      env.directoryContents("autosave") == kdl::vec_push_back(allPaths, ChunkDirectory));
+    CHECK(
+      kdl::vec_transform(
+        allPaths, [&](const auto& path) { return loadBackup(env, path); })
       == std::vector<std::string>{
-        "autosave/test.2.map",
+        "autosave/test.2.tbbackup",
         R"(// Game: Test
 // Format: Standard
-// entity 0
 {
 "classname" "worldspawn"
 }
-// entity 1
 {
 }
 )",
         R"(// Game: Test
 // Format: Standard
-// entity 0
 {
 "classname" "worldspawn"
 }
-// entity 1
 {
 }
-// entity 2
 {
 }
 )",
@@ -280,22 +314,24 @@ TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.autosaverCleanup")
   SECTION("Gaps are compacted")
   {
     const auto initialPaths = std::vector<std::filesystem::path>{
-      "autosave/test.1.map",
-      "autosave/test.3.map",
+      "autosave/test.1.tbbackup",
+      "autosave/test.3.tbbackup",
     };
 
     for (const auto& path : initialPaths)
     {
-      env.createFile(path, path.string());
+      createBackup(env, path, path.string());
     }
 
-    REQUIRE(env.directoryContents("autosave") == initialPaths);
+    REQUIRE(
+      env.directoryContents("autosave")
+      == kdl::vec_push_back(initialPaths, ChunkDirectory));
     REQUIRE(
       kdl::vec_transform(
-        initialPaths, [&](const auto& path) { return env.loadFile(path); })
+        initialPaths, [&](const auto& path) { return loadBackup(env, path); })
       == std::vector<std::string>{
-        "autosave/test.1.map",
-        "autosave/test.3.map",
+        "autosave/test.1.tbbackup",
+        "autosave/test.3.tbbackup",
       });
 
     auto logger = NullLogger{};
@@ -310,26 +346,27 @@ TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.autosaverCleanup")
 
     std::this_thread::sleep_for(100ms);
     autosaver.triggerAutosave(logger);
+    autosaver.waitForPendingBackup(logger);
 
     const auto allPaths = std::vector<std::filesystem::path>{
-      "autosave/test.1.map",
-      "autosave/test.2.map",
-      "autosave/test.3.map",
+      "autosave/test.1.tbbackup",
+      "autosave/test.2.tbbackup",
+      "autosave/test.3.tbbackup",
     };
 
-    CHECK(env.directoryContents("autosave") == allPaths);
     CHECK(
-      kdl::vec_transform(allPaths, [&](const auto& path) { return env.loadFile(path); })
+      env.directoryContents("autosave") == kdl::vec_push_back(allPaths, ChunkDirectory));
+    CHECK(
+      kdl::vec_transform(
+        allPaths, [&](const auto& path) { return loadBackup(env, path); })
       == std::vector<std::string>{
-        "autosave/test.1.map",
-        "autosave/test.3.map",
+        "autosave/test.1.tbbackup",
+        "autosave/test.3.tbbackup",
         R"(// Game: Test
 // Format: Standard
-// entity 0
 {
 "classname" "worldspawn"
 }
-// entity 1
 {
 }
 )",
@@ -345,7 +382,7 @@ TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.autosaverSavesWhenCrashFilesP
 
   auto env = io::TestEnvironment{};
   env.createDirectory("autosave");
-  env.createFile("autosave/test.1.map", "some content");
+  createBackup(env, "autosave/test.1.tbbackup", "some content");
   env.createFile("autosave/test.1-crash.map", "some content again");
 
   auto logger = NullLogger{};
@@ -360,7 +397,41 @@ TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.autosaverSavesWhenCrashFilesP
 
   autosaver.triggerAutosave(logger);
 
-  CHECK(env.fileExists("autosave/test.2.map"));
+  autosaver.waitForPendingBackup(logger);
+
+  CHECK(env.fileExists("autosave/test.2.tbbackup"));
+}
+
+TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.autosaverRestoreBackup")
+{
+  using namespace std::chrono_literals;
+
+  auto env = io::TestEnvironment{};
+  auto logger = NullLogger{};
+
+  document->saveDocumentAs(env.dir() / "test.map");
+  assert(env.fileExists("test.map"));
+
+  auto autosaver = Autosaver{document, 0s};
+
+  // modify the map
+  document->addNodes({{document->currentLayer(), {new mdl::EntityNode{{}}}}});
+
+  autosaver.triggerAutosave(logger);
+  autosaver.waitForPendingBackup(logger);
+  REQUIRE(env.fileExists("autosave/test.1.tbbackup"));
+
+  CHECK(
+    restoreBackup(env.dir() / "autosave/test.1.tbbackup", env.dir() / "restored.map")
+    == Result<void>{});
+  CHECK(env.loadFile("restored.map") == R"(// Game: Test
+// Format: Standard
+{
+"classname" "worldspawn"
+}
+{
+}
+)");
 }
 
 } // namespace tb::ui
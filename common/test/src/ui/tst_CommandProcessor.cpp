@@ -244,6 +244,21 @@ public:
   }
 };
 
+class SizedCommand : public NullCommand
+{
+private:
+  size_t m_memoryUsage;
+
+public:
+  SizedCommand(std::string name, const size_t memoryUsage)
+    : NullCommand{std::move(name)}
+    , m_memoryUsage{memoryUsage}
+  {
+  }
+
+  size_t memoryUsage() const override { return m_memoryUsage; }
+};
+
 } // namespace
 
 TEST_CASE("CommandProcessorTest.doAndUndoSuccessfulCommand")
@@ -845,4 +860,32 @@ TEST_CASE("CommandProcessorTest.collateTransactions")
   commandProcessor.undo();
 }
 
+TEST_CASE("CommandProcessorTest.memoryUsage")
+{
+  auto taskManager = createTestTaskManager();
+  auto facade = MapDocumentCommandFacade{*taskManager};
+  auto commandProcessor = CommandProcessor{facade};
+
+  CHECK(commandProcessor.undoStackMemoryUsage().empty());
+  CHECK(commandProcessor.redoStackMemoryUsage().empty());
+
+  commandProcessor.executeAndStore(std::make_unique<SizedCommand>("command 1", 10));
+
+  commandProcessor.startTransaction("transaction", TransactionScope::Oneshot);
+  commandProcessor.executeAndStore(std::make_unique<SizedCommand>("command 2", 20));
+  commandProcessor.executeAndStore(std::make_unique<SizedCommand>("command 3", 30));
+  commandProcessor.commitTransaction();
+
+  CHECK(commandProcessor.undoStackMemoryUsage() == std::vector<size_t>{10, 50});
+  CHECK(commandProcessor.redoStackMemoryUsage().empty());
+
+  commandProcessor.undo();
+  CHECK(commandProcessor.undoStackMemoryUsage() == std::vector<size_t>{10});
+  CHECK(commandProcessor.redoStackMemoryUsage() == std::vector<size_t>{50});
+
+  commandProcessor.undo();
+  CHECK(commandProcessor.undoStackMemoryUsage().empty());
+  CHECK(commandProcessor.redoStackMemoryUsage() == std::vector<size_t>{50, 10});
+}
+
 } // namespace tb::ui
@@ -0,0 +1,384 @@
+/*
+ Copyright 2024 Kristian Duske
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ software and associated documentation files (the "Software"), to deal in the Software
+ without restriction, including without limitation the rights to use, copy, modify, merge,
+ publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or
+ substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace kdl
+{
+namespace detail
+{
+
+struct slab_pool_block
+{
+  slab_pool_block* next = nullptr;
+  slab_pool_block* next_batch = nullptr;
+  std::size_t batch_size = 0;
+};
+
+} // namespace detail
+
+/**
+ * A pool of memory blocks of a fixed size and alignment.
+ *
+ * The blocks are carved from slabs of batch_size blocks each. Every thread keeps its own
+ * list of free blocks, so allocating and deallocating a block does not require any
+ * synchronization in the common case. If a thread runs out of free blocks, it takes a
+ * batch of free blocks from a shared depot, or it allocates a new slab if the depot is
+ * empty. If a thread accumulates too many free blocks, it returns a batch of them to the
+ * depot. Therefore, a block may be deallocated on a different thread than the one that
+ * allocated it.
+ *
+ * Slabs are only returned to the system by release_unused.
+ *
+ * @tparam BlockSize the minimal size of the blocks in bytes
+ * @tparam BlockAlign the minimal alignment of the blocks
+ */
+template <std::size_t BlockSize, std::size_t BlockAlign>
+class slab_pool
+{
+private:
+  using block = detail::slab_pool_block;
+
+public:
+  static constexpr std::size_t block_align = std::max(BlockAlign, alignof(block));
+  static constexpr std::size_t block_size =
+    (std::max(BlockSize, sizeof(block)) + block_align - 1u) / block_align * block_align;
+  static constexpr std::size_t batch_size =
+    std::max(std::size_t(16384) / block_size, std::size_t(16));
+
+private:
+  struct batch
+  {
+    block* head = nullptr;
+    std::size_t count = 0;
+  };
+
+  class depot
+  {
+  private:
+    std::mutex m_mutex;
+    block* m_batches = nullptr;
+    // sorted by address
+    std::vector<std::byte*> m_slabs;
+
+  public:
+    batch take()
+    {
+      {
+        const auto lock = std::lock_guard{m_mutex};
+        if (auto* head = m_batches)
+        {
+          m_batches = head->next_batch;
+          return {head, head->batch_size};
+        }
+      }
+
+      return allocate_slab();
+    }
+
+    void give(const batch b)
+    {
+      b.head->batch_size = b.count;
+
+      const auto lock = std::lock_guard{m_mutex};
+      b.head->next_batch = m_batches;
+      m_batches = b.head;
+    }
+
+    std::size_t release_unused()
+    {
+      const auto lock = std::lock_guard{m_mutex};
+
+      const auto slab_index = [&](const block* b) {
+        const auto it =
+          std::ranges::upper_bound(m_slabs, reinterpret_cast<const std::byte*>(b));
+        return std::size_t(std::distance(m_slabs.begin(), it)) - 1u;
+      };
+
+      auto free_counts = std::vector<std::size_t>(m_slabs.size(), 0u);
+      for (auto* head = m_batches; head; head = head->next_batch)
+      {
+        for (auto* b = head; b; b = b->next)
+        {
+          ++free_counts[slab_index(b)];
+        }
+      }
+
+      // rebuild the batches from the blocks of the slabs that are still in use
+      block* batches = nullptr;
+      block* current = nullptr;
+      std::size_t current_count = 0u;
+      for (auto* head = m_batches; head;)
+      {
+        auto* next_head = head->next_batch;
+        for (auto* b = head; b;)
+        {
+          auto* next = b->next;
+          if (free_counts[slab_index(b)] < batch_size)
+          {
+            b->next = current;
+            current = b;
+            if (++current_count == batch_size)
+            {
+              current->batch_size = current_count;
+              current->next_batch = batches;
+              batches = current;
+              current = nullptr;
+              current_count = 0u;
+            }
+          }
+          b = next;
+        }
+        head = next_head;
+      }
+
+      if (current)
+      {
+        current->batch_size = current_count;
+        current->next_batch = batches;
+        batches = current;
+      }
+      m_batches = batches;
+
+      auto released = std::size_t(0);
+      auto remaining_slabs = std::vector<std::byte*>{};
+      for (std::size_t i = 0; i < m_slabs.size(); ++i)
+      {
+        if (free_counts[i] == batch_size)
+        {
+          ::operator delete(m_slabs[i], std::align_val_t{block_align});
+          ++released;
+        }
+        else
+        {
+          remaining_slabs.push_back(m_slabs[i]);
+        }
+      }
+      m_slabs = std::move(remaining_slabs);
+
+      return released;
+    }
+
+  private:
+    batch allocate_slab()
+    {
+      auto* slab = static_cast<std::byte*>(
+        ::operator new(block_size * batch_size, std::align_val_t{block_align}));
+
+      {
+        const auto lock = std::lock_guard{m_mutex};
+        m_slabs.insert(std::ranges::upper_bound(m_slabs, slab), slab);
+      }
+
+      block* head = nullptr;
+      for (std::size_t i = batch_size; i > 0u; --i)
+      {
+        head = new (slab + (i - 1u) * block_size) block{head};
+      }
+      return {head, batch_size};
+    }
+  };
+
+  static depot& get_depot()
+  {
+    // never destroyed because blocks may still be deallocated during static destruction
+    static auto* instance = new depot{};
+    return *instance;
+  }
+
+  class cache
+  {
+  private:
+    block* m_head = nullptr;
+    std::size_t m_count = 0;
+
+  public:
+    cache() = default;
+
+    ~cache()
+    {
+      s_cache_destroyed = true;
+      if (m_head)
+      {
+        get_depot().give({m_head, m_count});
+      }
+    }
+
+    cache(const cache&) = delete;
+    cache& operator=(const cache&) = delete;
+
+    void flush()
+    {
+      if (m_head)
+      {
+        get_depot().give({m_head, m_count});
+        m_head = nullptr;
+        m_count = 0u;
+      }
+    }
+
+    void* pop()
+    {
+      if (!m_head)
+      {
+        const auto b = get_depot().take();
+        m_head = b.head;
+        m_count = b.count;
+      }
+
+      auto* result = m_head;
+      m_head = result->next;
+      --m_count;
+      return result;
+    }
+
+    void push(void* ptr)
+    {
+      m_head = new (ptr) block{m_head};
+      ++m_count;
+
+      if (m_count >= 2u * batch_size)
+      {
+        // return the most recently freed blocks to the depot
+        auto* last = m_head;
+        for (std::size_t i = 1u; i < batch_size; ++i)
+        {
+          last = last->next;
+        }
+
+        auto* head = m_head;
+        m_head = last->next;
+        m_count -= batch_size;
+
+        last->next = nullptr;
+        get_depot().give({head, batch_size});
+      }
+    }
+  };
+
+  static inline thread_local cache s_cache;
+
+  // remains valid after s_cache was destroyed when its thread exits
+  static inline thread_local bool s_cache_destroyed = false;
+
+public:
+  /**
+   * Allocates a block of block_size bytes aligned to block_align.
+   *
+   * @throws std::bad_alloc if a new slab cannot be allocated
+   */
+  static void* allocate()
+  {
+    if (!s_cache_destroyed)
+    {
+      return s_cache.pop();
+    }
+
+    auto& depot = get_depot();
+    auto b = depot.take();
+    auto* result = b.head;
+    if (b.count > 1u)
+    {
+      depot.give({result->next, b.count - 1u});
+    }
+    return result;
+  }
+
+  /**
+   * Returns the given block to this pool. The block must have been allocated by this
+   * pool, but it may have been allocated on a different thread.
+   */
+  static void deallocate(void* ptr) noexcept
+  {
+    if (!s_cache_destroyed)
+    {
+      s_cache.push(ptr);
+    }
+    else
+    {
+      get_depot().give({new (ptr) block{}, 1u});
+    }
+  }
+
+  /**
+   * Returns the slabs whose blocks are all free to the system and returns their number.
+   *
+   * The free blocks of the calling thread are considered, but the free blocks that other
+   * threads keep for themselves are not. A slab with such a block remains allocated.
+   */
+  static std::size_t release_unused()
+  {
+    if (!s_cache_destroyed)
+    {
+      s_cache.flush();
+    }
+    return get_depot().release_unused();
+  }
+};
+
+/**
+ * Base class that makes instances of the derived class T allocate their memory from a
+ * slab_pool when they are created with new.
+ *
+ * Use this for types of which many small instances are created and destroyed
+ * individually.
+ *
+ * @tparam T the derived class
+ */
+template <typename T>
+class slab_allocated
+{
+public:
+  static void* operator new(const std::size_t size)
+  {
+    return size == sizeof(T) ? slab_pool<sizeof(T), alignof(T)>::allocate()
+                             : ::operator new(size);
+  }
+
+  static void operator delete(void* ptr, const std::size_t size) noexcept
+  {
+    if (size == sizeof(T))
+    {
+      slab_pool<sizeof(T), alignof(T)>::deallocate(ptr);
+    }
+    else
+    {
+      ::operator delete(ptr);
+    }
+  }
+
+  /**
+   * Returns the unused slabs of the pool of T to the system, see
+   * slab_pool::release_unused.
+   */
+  static std::size_t release_unused()
+  {
+    return slab_pool<sizeof(T), alignof(T)>::release_unused();
+  }
+};
+
+} // namespace kdl
@@ -22,10 +22,16 @@
 
 #include "kdl/range_to_vector.h"
 
+#include <algorithm>
+#include <atomic>
 #include <condition_variable>
+#include <deque>
+#include <exception>
 #include <functional>
 #include <future>
+#include <memory>
 #include <mutex>
+#include <optional>
 #include <queue>
 #include <ranges>
 #include <thread>
@@ -33,6 +39,167 @@
 
 namespace kdl
 {
+namespace
+{
+
+struct index_range
+{
+  std::size_t begin;
+  std::size_t end;
+};
+
+/**
+ * The chunks owned by one participant of a parallel job. The owner takes chunks from
+ * the front, other participants steal from the back.
+ */
+class chunk_deque
+{
+private:
+  std::mutex m_mutex;
+  std::deque<index_range> m_chunks;
+
+public:
+  void push_back(const index_range chunk)
+  {
+    auto lock = std::lock_guard{m_mutex};
+    m_chunks.push_back(chunk);
+  }
+
+  std::optional<index_range> pop_front()
+  {
+    auto lock = std::lock_guard{m_mutex};
+    if (m_chunks.empty())
+    {
+      return std::nullopt;
+    }
+
+    const auto chunk = m_chunks.front();
+    m_chunks.pop_front();
+    return chunk;
+  }
+
+  std::optional<index_range> steal_back()
+  {
+    auto lock = std::lock_guard{m_mutex};
+    if (m_chunks.empty())
+    {
+      return std::nullopt;
+    }
+
+    const auto chunk = m_chunks.back();
+    m_chunks.pop_back();
+    return chunk;
+  }
+};
+
+/**
+ * The shared state of a call to task_manager::parallel_for. Helper tasks keep the job
+ * alive because they may only start running after the job has been completed by the
+ * other participants.
+ */
+class parallel_job
+{
+private:
+  const std::function<void(std::size_t, std::size_t)>& m_chunk_func;
+  std::vector<chunk_deque> m_deques;
+  std::atomic<std::size_t> m_remaining_chunks;
+  std::atomic<bool> m_failed = false;
+
+  std::mutex m_done_mutex;
+  std::condition_variable m_done_cv;
+  std::exception_ptr m_exception;
+
+public:
+  parallel_job(
+    const std::function<void(std::size_t, std::size_t)>& chunk_func,
+    const std::size_t participant_count,
+    const std::size_t count,
+    const std::size_t chunk_size)
+    : m_chunk_func{chunk_func}
+    , m_deques(participant_count)
+    , m_remaining_chunks{(count + chunk_size - 1) / chunk_size}
+  {
+    // give every participant a contiguous block of chunks
+    const auto chunk_count = m_remaining_chunks.load();
+    for (std::size_t i = 0; i < chunk_count; ++i)
+    {
+      const auto begin = i * chunk_size;
+      const auto end = std::min(begin + chunk_size, count);
+      m_deques[i * participant_count / chunk_count].push_back({begin, end});
+    }
+  }
+
+  void participate(const std::size_t participant)
+  {
+    while (const auto chunk = next_chunk(participant))
+    {
+      run_chunk(*chunk);
+    }
+  }
+
+  void wait_and_rethrow()
+  {
+    auto lock = std::unique_lock{m_done_mutex};
+    m_done_cv.wait(lock, [&] { return m_remaining_chunks == 0; });
+
+    if (m_exception)
+    {
+      std::rethrow_exception(m_exception);
+    }
+  }
+
+private:
+  std::optional<index_range> next_chunk(const std::size_t participant)
+  {
+    if (auto chunk = m_deques[participant].pop_front())
+    {
+      return chunk;
+    }
+
+    for (std::size_t i = 1; i < m_deques.size(); ++i)
+    {
+      const auto victim = (participant + i) % m_deques.size();
+      if (auto chunk = m_deques[victim].steal_back())
+      {
+        return chunk;
+      }
+    }
+
+    return std::nullopt;
+  }
+
+  void run_chunk(const index_range chunk)
+  {
+    if (!m_failed)
+    {
+      try
+      {
+        m_chunk_func(chunk.begin, chunk.end);
+      }
+      catch (...)
+      {
+        auto lock = std::lock_guard{m_done_mutex};
+        if (!m_exception)
+        {
+          m_exception = std::current_exception();
+        }
+        m_failed = true;
+      }
+    }
+
+    if (m_remaining_chunks.fetch_sub(1) == 1)
+    {
+      {
+        // lock so that the notification cannot get lost between the waiting thread
+        // checking the predicate and blocking
+        auto lock = std::lock_guard{m_done_mutex};
+      }
+      m_done_cv.notify_all();
+    }
+  }
+};
+
+} // namespace
 
 std::function<void()> task_manager::make_worker_func()
 {
@@ -60,6 +227,53 @@ std::function<void()> task_manager::make_worker_func()
   };
 }
 
+void task_manager::run_chunks(
+  const std::size_t count,
+  std::size_t chunk_size,
+  const std::function<void(std::size_t, std::size_t)>& chunk_func)
+{
+  if (count == 0)
+  {
+    return;
+  }
+
+  if (m_workers.empty())
+  {
+    chunk_func(0, count);
+    return;
+  }
+
+  const auto max_participant_count = m_workers.size() + 1;
+  if (chunk_size == 0)
+  {
+    // a few chunks per participant leave room for balancing uneven workloads
+    chunk_size = std::max(count / (max_participant_count * 4), std::size_t(1));
+  }
+
+  const auto chunk_count = (count + chunk_size - 1) / chunk_size;
+  const auto participant_count = std::min(max_participant_count, chunk_count);
+  if (participant_count == 1)
+  {
+    chunk_func(0, count);
+    return;
+  }
+
+  auto job =
+    std::make_shared<parallel_job>(chunk_func, participant_count, count, chunk_size);
+
+  {
+    auto lock = std::lock_guard{m_pending_tasks_mutex};
+    for (std::size_t i = 1; i < participant_count; ++i)
+    {
+      m_pending_tasks.push([job, i]() { job->participate(i); });
+    }
+  }
+  m_pending_tasks_cv.notify_all();
+
+  job->participate(0);
+  job->wait_and_rethrow();
+}
+
 task_manager::task_manager(const std::size_t max_concurrent_tasks)
 {
   for (size_t i = 0; i < max_concurrent_tasks; ++i)
@@ -23,12 +23,15 @@
 #include "kdl/range_to_vector.h"
 
 #include <condition_variable>
+#include <cstddef>
 #include <functional>
 #include <future>
 #include <mutex>
+#include <optional>
 #include <queue>
 #include <ranges>
 #include <thread>
+#include <type_traits>
 #include <vector>
 
 namespace kdl
@@ -48,6 +51,11 @@ private:
 
   std::function<void()> make_worker_func();
 
+  void run_chunks(
+    std::size_t count,
+    std::size_t chunk_size,
+    const std::function<void(std::size_t, std::size_t)>& chunk_func);
+
 public:
   explicit task_manager(
     std::size_t max_concurrent_tasks = std::thread::hardware_concurrency());
@@ -94,6 +102,64 @@ public:
     return futures | std::views::transform([](auto& future) { return future.get(); })
            | to_vector;
   }
+
+  /**
+   * Calls the given function once for every index in [0, count) and waits until all
+   * calls have returned.
+   *
+   * Unlike run_tasks, this does not create a task per index. Instead, the index range is
+   * split into chunks of the given size which are distributed among the calling thread
+   * and the worker threads. Every participant processes its own chunks in order and
+   * steals chunks from the other participants once it runs out of work. If chunk_size is
+   * 0, a chunk size is chosen that gives every participant a few chunks.
+   *
+   * The calling thread participates in the work, so it is safe to call this function
+   * from within a task that is run by this task manager.
+   *
+   * If the function throws an exception, the remaining indices are skipped and the first
+   * exception is rethrown once all participants have stopped.
+   */
+  template <typename F>
+  void parallel_for(const std::size_t count, F&& f, const std::size_t chunk_size = 0)
+  {
+    run_chunks(count, chunk_size, [&](const std::size_t begin, const std::size_t end) {
+      for (auto i = begin; i < end; ++i)
+      {
+        f(i);
+      }
+    });
+  }
+
+  /**
+   * Applies the given function to every element of the given range in parallel and
+   * returns a vector containing the results in the order of the range elements.
+   *
+   * The elements are processed as described in parallel_for. The function is called
+   * with a reference to the element, so it may move data out of the range.
+   */
+  template <std::ranges::random_access_range range, typename F>
+  auto parallel_transform(range&& r, F&& f, const std::size_t chunk_size = 0)
+  {
+    using result_type = std::remove_cvref_t<
+      std::invoke_result_t<F&, std::ranges::range_reference_t<range>>>;
+
+    const auto size = static_cast<std::size_t>(std::ranges::distance(r));
+    auto first = std::ranges::begin(r);
+
+    // the results need not be default constructible, so we store them in optionals
+    auto results = std::vector<std::optional<result_type>>(size);
+    parallel_for(
+      size,
+      [&](const std::size_t i) {
+        results[i].emplace(
+          f(first[static_cast<std::ranges::range_difference_t<range>>(i)]));
+      },
+      chunk_size);
+
+    return results
+           | std::views::transform([](auto& result) { return std::move(*result); })
+           | to_vector;
+  }
 };
 
 } // namespace kdl
@@ -0,0 +1,207 @@
+/*
+ Copyright 2024 Kristian Duske
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ software and associated documentation files (the "Software"), to deal in the Software
+ without restriction, including without limitation the rights to use, copy, modify, merge,
+ publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or
+ substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+*/
+
+#include "kdl/slab_pool.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "catch2.h"
+
+namespace kdl
+{
+namespace
+{
+
+struct alignas(32) aligned_item : public slab_allocated<aligned_item>
+{
+  int value;
+
+  explicit aligned_item(const int i_value)
+    : value{i_value}
+  {
+  }
+};
+
+struct derived_item : public aligned_item
+{
+  char padding[64];
+
+  using aligned_item::aligned_item;
+};
+
+template <typename Pool>
+bool is_aligned(const void* ptr)
+{
+  return reinterpret_cast<std::uintptr_t>(ptr) % Pool::block_align == 0u;
+}
+
+} // namespace
+
+TEST_CASE("slab_pool")
+{
+  using pool = slab_pool<24, 8>;
+
+  SECTION("block size and alignment")
+  {
+    CHECK(pool::block_size >= 24u);
+    CHECK(pool::block_size % pool::block_align == 0u);
+    CHECK(pool::block_align >= 8u);
+    CHECK(slab_pool<1, 1>::block_size >= sizeof(void*));
+  }
+
+  SECTION("allocate returns distinct aligned blocks")
+  {
+    auto blocks = std::vector<void*>{};
+    for (std::size_t i = 0; i < 3u * pool::batch_size; ++i)
+    {
+      blocks.push_back(pool::allocate());
+    }
+
+    CHECK(std::ranges::all_of(blocks, is_aligned<pool>));
+    CHECK(std::set<void*>(blocks.begin(), blocks.end()).size() == blocks.size());
+
+    for (auto* block : blocks)
+    {
+      pool::deallocate(block);
+    }
+  }
+
+  SECTION("deallocated blocks are reused")
+  {
+    auto* block = pool::allocate();
+    pool::deallocate(block);
+    CHECK(pool::allocate() == block);
+    pool::deallocate(block);
+  }
+
+  SECTION("blocks can be deallocated on another thread")
+  {
+    auto blocks = std::vector<void*>{};
+    for (std::size_t i = 0; i < 5u * pool::batch_size; ++i)
+    {
+      blocks.push_back(pool::allocate());
+    }
+
+    auto thread = std::thread{[&]() {
+      for (auto* block : blocks)
+      {
+        pool::deallocate(block);
+      }
+    }};
+    thread.join();
+
+    // the other thread returned its free blocks to the depot when it exited
+    auto reused = std::vector<void*>{};
+    for (std::size_t i = 0; i < 5u * pool::batch_size; ++i)
+    {
+      reused.push_back(pool::allocate());
+    }
+
+    CHECK(std::ranges::any_of(reused, [&](auto* block) {
+      return std::ranges::find(blocks, block) != blocks.end();
+    }));
+
+    for (auto* block : reused)
+    {
+      pool::deallocate(block);
+    }
+  }
+}
+
+TEST_CASE("slab_pool.release_unused")
+{
+  // a pool that no other test uses
+  using pool = slab_pool<200, 8>;
+
+  auto blocks = std::vector<void*>{};
+  for (std::size_t i = 0; i < 3u * pool::batch_size; ++i)
+  {
+    blocks.push_back(pool::allocate());
+  }
+
+  SECTION("releases slabs whose blocks are all free")
+  {
+    for (auto* block : blocks)
+    {
+      pool::deallocate(block);
+    }
+
+    CHECK(pool::release_unused() == 3u);
+    CHECK(pool::release_unused() == 0u);
+  }
+
+  SECTION("keeps slabs with allocated blocks")
+  {
+    for (std::size_t i = 1; i < blocks.size(); ++i)
+    {
+      pool::deallocate(blocks[i]);
+    }
+
+    CHECK(pool::release_unused() == 2u);
+
+    // the free blocks of the remaining slab can still be allocated
+    auto reused = std::vector<void*>{};
+    for (std::size_t i = 1; i < pool::batch_size; ++i)
+    {
+      reused.push_back(pool::allocate());
+    }
+    CHECK(std::ranges::all_of(reused, [&](auto* block) {
+      return std::ranges::find(blocks, block) != blocks.end();
+    }));
+
+    pool::deallocate(blocks.front());
+    for (auto* block : reused)
+    {
+      pool::deallocate(block);
+    }
+    CHECK(pool::release_unused() == 1u);
+  }
+}
+
+TEST_CASE("slab_allocated")
+{
+  SECTION("new and delete")
+  {
+    auto items = std::vector<std::unique_ptr<aligned_item>>{};
+    for (int i = 0; i < 1000; ++i)
+    {
+      items.push_back(std::make_unique<aligned_item>(i));
+    }
+
+    for (int i = 0; i < 1000; ++i)
+    {
+      CHECK(items[size_t(i)]->value == i);
+      CHECK(reinterpret_cast<std::uintptr_t>(items[size_t(i)].get()) % 32u == 0u);
+    }
+  }
+
+  SECTION("derived types with a different size")
+  {
+    auto item = std::make_unique<derived_item>(7);
+    CHECK(item->value == 7);
+  }
+}
+
+} // namespace kdl
@@ -21,7 +21,11 @@
 #include "kdl/range_to_vector.h"
 #include "kdl/task_manager.h"
 
+#include <algorithm>
+#include <atomic>
 #include <memory>
+#include <stdexcept>
+#include <string>
 #include <tuple>
 
 #include "catch2.h"
@@ -121,6 +125,76 @@ TEST_CASE("task_manager")
     CHECK(task_ran2);
     CHECK(task_ran3);
   }
+
+  SECTION("parallel_for")
+  {
+    const auto count = GENERATE(0u, 1u, 7u, 1000u);
+    const auto chunk_size = GENERATE(0u, 1u, 3u, 2000u);
+    CAPTURE(count, chunk_size);
+
+    auto calls = std::vector<std::atomic<int>>(count);
+    tm.parallel_for(count, [&](const std::size_t i) { ++calls[i]; }, chunk_size);
+
+    CHECK(std::ranges::all_of(calls, [](const auto& c) { return c == 1; }));
+  }
+
+  SECTION("parallel_for rethrows exceptions")
+  {
+    CHECK_THROWS_AS(
+      tm.parallel_for(
+        100,
+        [](const std::size_t i) {
+          if (i == 42)
+          {
+            throw std::runtime_error{"error"};
+          }
+        }),
+      std::runtime_error);
+  }
+
+  SECTION("parallel_transform")
+  {
+    const auto strings = std::views::iota(0, 1000)
+                         | std::views::transform([](int i) { return std::to_string(i); })
+                         | to_vector;
+
+    CHECK(
+      tm.parallel_transform(strings, [](const std::string& s) { return s + "!"; })
+      == (strings | std::views::transform([](const auto& s) { return s + "!"; })
+          | to_vector));
+
+    SECTION("Results need not be default constructible")
+    {
+      struct wrapper
+      {
+        explicit wrapper(int i)
+          : value{i}
+        {
+        }
+
+        int value;
+      };
+
+      const auto results =
+        tm.parallel_transform(std::vector{1, 2, 3}, [](int i) { return wrapper{i}; });
+      CHECK(
+        (results | std::views::transform([](const auto& w) { return w.value; })
+         | to_vector)
+        == std::vector{1, 2, 3});
+    }
+  }
+
+  SECTION("parallel_for can be called from a task")
+  {
+    auto future = tm.run_task(std::function{[&]() {
+      auto sum = std::atomic<int>{0};
+      tm.parallel_for(100, [&](const std::size_t i) { sum += int(i); });
+      return sum.load();
+    }});
+
+    REQUIRE(future.wait_for(std::chrono::seconds{5}) == std::future_status::ready);
+    CHECK(future.get() == 4950);
+  }
 }
 
 TEST_CASE("task_manager stress test")
@@ -28,6 +28,25 @@
 
 namespace vm
 {
+TEST_CASE("evaluate_quadratic_bezier_curve")
+{
+  using T = std::tuple<std::array<vec3d, 3>, double, vec3d>;
+
+  // clang-format off
+  const auto
+  [ controlPoints,                                     t,    expected           ] = GENERATE(values<T>({
+  { { vec3d{0, 0, 0}, vec3d{1, 0, 1}, vec3d{2, 0, 0} }, 0.0,  vec3d{0, 0, 0}     },
+  { { vec3d{0, 0, 0}, vec3d{1, 0, 1}, vec3d{2, 0, 0} }, 1.0,  vec3d{2, 0, 0}     },
+  { { vec3d{0, 0, 0}, vec3d{1, 0, 1}, vec3d{2, 0, 0} }, 0.5,  vec3d{1, 0, 0.5}   },
+  { { vec3d{0, 0, 0}, vec3d{1, 0, 1}, vec3d{2, 0, 0} }, 0.25, vec3d{0.5, 0, 0.375} },
+  }));
+  // clang-format on
+
+  CAPTURE(controlPoints, t);
+
+  CHECK(evaluate_quadratic_bezier_curve(controlPoints, t) == expected);
+}
+
 TEST_CASE("evaluate_quadratic_bezier_surface")
 {
   using T = std::tuple<std::array<vec3d, 9>, double, double, vec3d>;